@@ -0,0 +1,362 @@
+// array_algebra.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 23:51:30 (jonah)>
+
+// This file defines vector algebra on dynamic arrays: +, -, scaling
+// by a scalar, dot products, norms, axpy, and products of a matrix
+// and a vector. Residual checks, iterative solvers and benchmarks
+// each used to write these loops by hand.
+
+// The operators don't compute anything. They build small expression
+// objects that remember their operands, and the work happens when an
+// expression is assigned to a Dynamic1DArray or reduced by dot() or
+// a norm. So
+//     r = b - A*x;
+// is one pass over r, computing b[i] - (row i of A).x for each i,
+// with no temporary arrays. An expression only refers to its arrays,
+// so it must be used before they go away; don't keep one in an auto
+// variable.
+
+// The matrix of a product can be a Dynamic2DArray, row- or
+// column-major, or the coefficient matrix of a GaussianSystem. The
+// vector of a product must be a Dynamic1DArray, because every row
+// reads all of it; assign an expression to an array first.
+
+// Assigning an expression, or an array, of the same length to a view
+// writes into the memory the view holds. Assigning one of another
+// length makes the view an ordinary array.
+
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <cmath>
+#include <cassert>
+#include <type_traits>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Expressions
+// ----------------------------------------------------------------------
+
+// How an expression keeps an operand. Arrays are kept by reference
+// and expressions, which are small, by value.
+template<typename EXPRESSION>
+struct ExpressionOperand {
+  typedef const EXPRESSION type;
+};
+template<typename TYPE>
+struct ExpressionOperand<Dynamic1DArray<TYPE> > {
+  typedef const Dynamic1DArray<TYPE>& type;
+};
+
+// The element by element operations.
+struct AddOperation {
+  template<typename TYPE>
+  static TYPE apply(TYPE a, TYPE b) {
+    return a + b;
+  }
+};
+struct SubtractOperation {
+  template<typename TYPE>
+  static TYPE apply(TYPE a, TYPE b) {
+    return a - b;
+  }
+};
+
+// left + right or left - right, element by element.
+template<typename LEFT, typename RIGHT, typename OPERATION>
+class ElementwiseExpression
+  : public VectorExpression<ElementwiseExpression<LEFT,RIGHT,OPERATION> > {
+public:
+  typedef typename LEFT::value_type value_type;
+  ElementwiseExpression(const LEFT& l, const RIGHT& r) : left(l), right(r) {
+    assert( l.length() == r.length() && "The vectors are the same length." );
+  }
+  ptrdiff_t length() const {
+    return left.length();
+  }
+  value_type value_at(ptrdiff_t i) const {
+    return OPERATION::apply(left.value_at(i),right.value_at(i));
+  }
+  bool mixes_elements_of(const void* begin, const void* end) const {
+    return left.mixes_elements_of(begin,end)
+      || right.mixes_elements_of(begin,end);
+  }
+private:
+  typename ExpressionOperand<LEFT>::type left;
+  typename ExpressionOperand<RIGHT>::type right;
+};
+
+// scalar*vector.
+template<typename VECTOR>
+class ScaledExpression : public VectorExpression<ScaledExpression<VECTOR> > {
+public:
+  typedef typename VECTOR::value_type value_type;
+  ScaledExpression(value_type s, const VECTOR& v) : scalar(s), vector(v) {}
+  ptrdiff_t length() const {
+    return vector.length();
+  }
+  value_type value_at(ptrdiff_t i) const {
+    return scalar*vector.value_at(i);
+  }
+  bool mixes_elements_of(const void* begin, const void* end) const {
+    return vector.mixes_elements_of(begin,end);
+  }
+private:
+  value_type scalar;
+  typename ExpressionOperand<VECTOR>::type vector;
+};
+
+// Whether the memory from begin to end overlaps the array at all.
+// Every element of a product reads every element of its vector, so
+// any overlap spoils writing in place.
+template<typename TYPE>
+inline bool overlaps(const Dynamic1DArray<TYPE>& array,
+		     const void* begin, const void* end) {
+  const char* first = (const char*)array.data();
+  const char* last = (const char*)(array.data() + array.length());
+  return array.length() > 0 && less<const char*>()(first,(const char*)end)
+    && less<const char*>()((const char*)begin,last);
+}
+
+// The dot product of n contiguous elements. Four partial sums keep
+// the multiplies independent, so they pipeline and vectorize.
+template<typename TYPE>
+inline TYPE contiguous_dot(const TYPE* a, const TYPE* b, ptrdiff_t n) {
+  TYPE sum[4] = {0, 0, 0, 0};
+  ptrdiff_t j = 0;
+  for (; j + 4 <= n; j += 4) {
+    sum[0] += a[j]*b[j];
+    sum[1] += a[j + 1]*b[j + 1];
+    sum[2] += a[j + 2]*b[j + 2];
+    sum[3] += a[j + 3]*b[j + 3];
+  }
+  for (; j < n; j++) {
+    sum[0] += a[j]*b[j];
+  }
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+// A Dynamic2DArray times a vector. Element i is the dot product of
+// row i with the vector.
+template<typename TYPE>
+class MatrixVectorProduct
+  : public VectorExpression<MatrixVectorProduct<TYPE> > {
+public:
+  typedef TYPE value_type;
+  MatrixVectorProduct(const Dynamic2DArray<TYPE>& matrix,
+		      const Dynamic1DArray<TYPE>& v) : vector(v) {
+    assert( matrix.width() == v.length()
+	    && "The matrix has one column per element of the vector." );
+    elements = matrix.data();
+    rows = matrix.height();
+    row_stride = matrix.row_stride();
+    column_stride = matrix.column_stride();
+  }
+  ptrdiff_t length() const {
+    return rows;
+  }
+  TYPE value_at(ptrdiff_t i) const {
+    const TYPE* row = elements + i*row_stride;
+    const TYPE* x = vector.data();
+    ptrdiff_t columns = vector.length();
+    if ( column_stride == 1 ) {
+      return contiguous_dot(row,x,columns);
+    }
+    TYPE sum = 0;
+    for (ptrdiff_t j = 0; j < columns; j++) {
+      sum += row[j*column_stride]*x[j];
+    }
+    return sum;
+  }
+  bool mixes_elements_of(const void* begin, const void* end) const {
+    return overlaps(vector,begin,end);
+  }
+private:
+  const TYPE* elements;
+  ptrdiff_t rows;
+  ptrdiff_t row_stride;
+  ptrdiff_t column_stride;
+  const Dynamic1DArray<TYPE>& vector;
+};
+
+// The coefficient matrix of a GaussianSystem times a vector.
+class SystemVectorProduct
+  : public VectorExpression<SystemVectorProduct> {
+public:
+  typedef double value_type;
+  SystemVectorProduct(const GaussianSystem& g_sys,
+		      const Dynamic1DArray<double>& v)
+    : system(g_sys), vector(v) {
+    assert( g_sys.size() == v.length()
+	    && "The matrix has one column per element of the vector." );
+  }
+  ptrdiff_t length() const {
+    return system.size();
+  }
+  double value_at(ptrdiff_t i) const {
+    const double* row = system.matrix_row(i);
+    const double* x = vector.data();
+    ptrdiff_t columns = vector.length();
+    if ( row != NULL ) {
+      return contiguous_dot(row,x,columns);
+    }
+    double sum = 0;
+    for (ptrdiff_t j = 0; j < columns; j++) {
+      sum += system.matrix_get(i,j)*x[j];
+    }
+    return sum;
+  }
+  bool mixes_elements_of(const void* begin, const void* end) const {
+    return overlaps(vector,begin,end);
+  }
+private:
+  const GaussianSystem& system;
+  const Dynamic1DArray<double>& vector;
+};
+
+// The knowns of a GaussianSystem, in row order, as a vector.
+class SystemKnowns : public VectorExpression<SystemKnowns> {
+public:
+  typedef double value_type;
+  SystemKnowns(const GaussianSystem& g_sys) : system(g_sys) {}
+  ptrdiff_t length() const {
+    return system.size();
+  }
+  double value_at(ptrdiff_t i) const {
+    return system.vector_get(i);
+  }
+  bool mixes_elements_of(const void* begin, const void* end) const {
+    return false;
+  }
+private:
+  const GaussianSystem& system;
+};
+// ----------------------------------------------------------------------
+
+
+// Operators
+// ----------------------------------------------------------------------
+
+template<typename LEFT, typename RIGHT>
+ElementwiseExpression<LEFT,RIGHT,AddOperation>
+operator + (const VectorExpression<LEFT>& left,
+	    const VectorExpression<RIGHT>& right) {
+  return ElementwiseExpression<LEFT,RIGHT,AddOperation>(left.self(),
+							right.self());
+}
+
+template<typename LEFT, typename RIGHT>
+ElementwiseExpression<LEFT,RIGHT,SubtractOperation>
+operator - (const VectorExpression<LEFT>& left,
+	    const VectorExpression<RIGHT>& right) {
+  return ElementwiseExpression<LEFT,RIGHT,SubtractOperation>(left.self(),
+							     right.self());
+}
+
+template<typename VECTOR>
+ScaledExpression<VECTOR>
+operator * (typename VECTOR::value_type scalar,
+	    const VectorExpression<VECTOR>& vector) {
+  return ScaledExpression<VECTOR>(scalar,vector.self());
+}
+
+template<typename VECTOR>
+ScaledExpression<VECTOR>
+operator * (const VectorExpression<VECTOR>& vector,
+	    typename VECTOR::value_type scalar) {
+  return ScaledExpression<VECTOR>(scalar,vector.self());
+}
+
+template<typename VECTOR>
+ScaledExpression<VECTOR> operator - (const VectorExpression<VECTOR>& vector) {
+  return ScaledExpression<VECTOR>(-1,vector.self());
+}
+
+template<typename TYPE>
+MatrixVectorProduct<TYPE> operator * (const Dynamic2DArray<TYPE>& matrix,
+				      const Dynamic1DArray<TYPE>& vector) {
+  return MatrixVectorProduct<TYPE>(matrix,vector);
+}
+
+// The coefficient matrix of g_sys times vector. A template only so
+// that a number, which converts to a GaussianSystem of that size,
+// isn't taken for one in 2*x.
+template<typename SYSTEM>
+typename enable_if<is_same<SYSTEM,GaussianSystem>::value,
+		   SystemVectorProduct>::type
+operator * (const SYSTEM& g_sys, const Dynamic1DArray<double>& vector) {
+  return SystemVectorProduct(g_sys,vector);
+}
+
+// The knowns of g_sys as a vector expression, e.g. for the residual
+// knowns(g_sys) - g_sys*x.
+inline SystemKnowns knowns(const GaussianSystem& g_sys) {
+  return SystemKnowns(g_sys);
+}
+// ----------------------------------------------------------------------
+
+
+// Reductions
+// ----------------------------------------------------------------------
+
+// The dot product of two vectors, in one pass over both.
+template<typename LEFT, typename RIGHT>
+typename LEFT::value_type dot(const VectorExpression<LEFT>& left,
+			      const VectorExpression<RIGHT>& right) {
+  const LEFT& a = left.self();
+  const RIGHT& b = right.self();
+  assert( a.length() == b.length() && "The vectors are the same length." );
+  typename LEFT::value_type sum = 0;
+  ptrdiff_t l = a.length();
+  for (ptrdiff_t i = 0; i < l; i++) {
+    sum += a.value_at(i)*b.value_at(i);
+  }
+  return sum;
+}
+
+// The Euclidean norm of a vector.
+template<typename VECTOR>
+typename VECTOR::value_type norm(const VectorExpression<VECTOR>& vector) {
+  const VECTOR& v = vector.self();
+  typename VECTOR::value_type sum = 0;
+  ptrdiff_t l = v.length();
+  for (ptrdiff_t i = 0; i < l; i++) {
+    typename VECTOR::value_type element = v.value_at(i);
+    sum += element*element;
+  }
+  return sqrt(sum);
+}
+
+// The largest absolute value of an element of a vector.
+template<typename VECTOR>
+typename VECTOR::value_type max_norm(const VectorExpression<VECTOR>& vector) {
+  const VECTOR& v = vector.self();
+  typename VECTOR::value_type largest = 0;
+  ptrdiff_t l = v.length();
+  for (ptrdiff_t i = 0; i < l; i++) {
+    typename VECTOR::value_type element = abs(v.value_at(i));
+    if ( element > largest ) {
+      largest = element;
+    }
+  }
+  return largest;
+}
+
+// y = alpha*x + y, in one pass.
+template<typename TYPE, typename VECTOR>
+void axpy(TYPE alpha, const VectorExpression<VECTOR>& x,
+	  Dynamic1DArray<TYPE>& y) {
+  y += alpha*x;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,203 @@
+// array_algebra_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 23:52:40 (jonah)>
+
+// This file tests the vector algebra on dynamic arrays against
+// hand-written loops, including products that read the array they
+// are assigned to.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <type_traits>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+#include "array_algebra.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// A random vector of length n.
+static Dynamic1DArray<double> random_vector(int n) {
+  Dynamic1DArray<double> output(n);
+  for (int i = 0; i < n; i++) {
+    output[i] = (double)rand()/RAND_MAX - 0.5;
+  }
+  return output;
+}
+
+// Whether a and b agree to rounding.
+static bool close(double a, double b) {
+  return abs(a - b) < 1E-12*(1 + abs(a) + abs(b));
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the array_algebra library.\n"
+       << "BEGIN." << endl;
+  srand(5);
+  int n = 50;
+  int m = 30;
+  Dynamic1DArray<double> a = random_vector(n);
+  Dynamic1DArray<double> b = random_vector(n);
+  Dynamic1DArray<double> c = random_vector(n);
+
+  cout << "\n\nOperators build expressions, not arrays." << endl;
+  static_assert( !is_same<decltype(a + b),Dynamic1DArray<double> >::value
+		 && !is_same<decltype(2.0*a - b),Dynamic1DArray<double> >::value,
+		 "Expressions are evaluated lazily." );
+
+  cout << "\n\nSums, differences and scaling." << endl;
+  Dynamic1DArray<double> d = 2*a - b + c*0.5 + -c;
+  assert( d.length() == n );
+  for (int i = 0; i < n; i++) {
+    assert( close(d[i],2*a[i] - b[i] + 0.5*c[i] - c[i]) );
+  }
+  d = a + b;
+  for (int i = 0; i < n; i++) {
+    assert( close(d[i],a[i] + b[i]) );
+  }
+  d += 3*c;
+  d -= a;
+  for (int i = 0; i < n; i++) {
+    assert( close(d[i],b[i] + 3*c[i]) );
+  }
+
+  cout << "\n\nDot products, norms and axpy." << endl;
+  double expected_dot = 0;
+  double expected_squared = 0;
+  double expected_max = 0;
+  for (int i = 0; i < n; i++) {
+    expected_dot += (a[i] + b[i])*c[i];
+    expected_squared += (a[i] - b[i])*(a[i] - b[i]);
+    expected_max = max(expected_max,abs(a[i] - b[i]));
+  }
+  assert( close(dot(a + b,c),expected_dot) );
+  assert( close(norm(a - b),sqrt(expected_squared)) );
+  assert( max_norm(a - b) == expected_max );
+  Dynamic1DArray<double> y = b;
+  axpy(-0.25,a,y);
+  for (int i = 0; i < n; i++) {
+    assert( close(y[i],b[i] - 0.25*a[i]) );
+  }
+
+  cout << "\n\nThe residual b - A*x for row- and column-major matrices."
+       << endl;
+  Dynamic2DArray<double> A(m,n);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      A.access(i,j) = (double)rand()/RAND_MAX - 0.5;
+    }
+  }
+  Dynamic1DArray<double> knowns_m = random_vector(m);
+  Dynamic1DArray<double> r = knowns_m - A*a;
+  assert( r.length() == m );
+  for (int i = 0; i < m; i++) {
+    double expected = knowns_m[i];
+    for (int j = 0; j < n; j++) {
+      expected -= A.get(i,j)*a[j];
+    }
+    assert( close(r[i],expected) );
+  }
+  double* fortran = new double[m*n];
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      fortran[i + j*m] = A.get(i,j);
+    }
+  }
+  Dynamic2DArray<double> column_major(fortran,m,n,m,COLUMN_MAJOR);
+  Dynamic1DArray<double> s = knowns_m - column_major*a;
+  for (int i = 0; i < m; i++) {
+    assert( close(s[i],r[i]) && "The layout doesn't change the answer." );
+  }
+  delete [] fortran;
+
+  cout << "\n\nAssigning A*x to x itself." << endl;
+  Dynamic2DArray<double> square(n,n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      square.access(i,j) = (double)rand()/RAND_MAX - 0.5;
+    }
+  }
+  Dynamic1DArray<double> x = a;
+  Dynamic1DArray<double> expected_product = square*a;
+  x = square*x;
+  for (int i = 0; i < n; i++) {
+    assert( close(x[i],expected_product[i]) && "x was read before written." );
+  }
+  x = a;
+  x += square*x;
+  for (int i = 0; i < n; i++) {
+    assert( close(x[i],a[i] + expected_product[i]) );
+  }
+  x = A*a;
+  assert( x.length() == m && "A different length reallocates." );
+
+  cout << "\n\nAssigning into a view writes the viewed memory." << endl;
+  double buffer[8];
+  Dynamic1DArray<double> view(buffer,8);
+  Dynamic1DArray<double> ones(8);
+  for (int i = 0; i < 8; i++) {
+    ones[i] = 1;
+    buffer[i] = i;
+  }
+  view = 2*view + ones;
+  assert( view.is_view() );
+  for (int i = 0; i < 8; i++) {
+    assert( buffer[i] == 2*i + 1 );
+  }
+  // Two overlapping views of one buffer, shifted by one.
+  Dynamic1DArray<double> head(buffer,7);
+  Dynamic1DArray<double> tail(buffer + 1,7);
+  head = tail + tail;
+  assert( head.is_view() );
+  for (int i = 0; i < 7; i++) {
+    assert( buffer[i] == 2*(2*(i + 1) + 1)
+	    && "Overlapping views are read before written." );
+  }
+  // An array of the same length is written through too, like an
+  // expression. Another length lets go of the view.
+  view = ones;
+  assert( view.is_view() && buffer[3] == 1
+	  && "Arrays are assigned into views in place." );
+  for (int i = 0; i < 8; i++) {
+    buffer[i] = i;
+  }
+  tail = head;
+  assert( tail.is_view() && buffer[1] == 0 && buffer[7] == 6
+	  && "Overlapping arrays are read before written." );
+  view = Dynamic1DArray<double>(3);
+  assert( !view.is_view() && buffer[0] == 0
+	  && "Another length reallocates." );
+
+  cout << "\n\nThe residual of a GaussianSystem." << endl;
+  GaussianSystem g_sys(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      g_sys.matrix_set(i,j,square.get(i,j));
+    }
+    g_sys.vector_set(i,b[i]);
+  }
+  g_sys.swap(0,7);
+  Dynamic1DArray<double> residual = knowns(g_sys) - g_sys*a;
+  for (int i = 0; i < n; i++) {
+    double expected = g_sys.vector_get(i);
+    for (int j = 0; j < n; j++) {
+      expected -= g_sys.matrix_get(i,j)*a[j];
+    }
+    assert( close(residual[i],expected) && "Rows are read in system order." );
+  }
+  assert( close(norm(knowns(g_sys) - g_sys*a),norm(residual)) );
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
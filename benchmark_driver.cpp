@@ -0,0 +1,1220 @@
+// benchmark_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 20:38:05 (jonah)>
+
+// This file times the pieces of the Gaussian elimination package on
+// random systems. The first argument names the benchmark and the
+// rest are the system sizes to run. i.e.,
+//     ./benchmark_driver.bin elimination 200 400 800
+// runs the elimination benchmark on 200x200, 400x400 and 800x800
+// systems.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "tournament_pivoting.hpp"
+#include "solution_writer.hpp"
+#include "iterative_solvers.hpp"
+#include "strassen_multiply.hpp"
+#include "memory_placement.hpp"
+#include "perf_counters.hpp"
+#include "structure_analysis.hpp"
+#include "hodlr_solver.hpp"
+#include "factorization_cache.hpp"
+#include "array_algebra.hpp"
+#include "gemm.hpp"
+#include "least_squares.hpp"
+#include "solver_backend.hpp"
+#include "trace.hpp"
+#include "system_assembly.hpp"
+#include "wall_time.hpp"
+#include "test_systems.hpp"
+#include <fstream>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BENCHMARK_HAVE_X86
+#endif
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Utilities
+// ----------------------------------------------------------------------
+
+// Fills an nxn Gaussian system with uniform random numbers in
+// [-1,1]. The same seed always gives the same system.
+static GaussianSystem random_system(int n, unsigned seed) {
+  GaussianSystem output(n);
+  srand(seed);
+  for (int row = 0; row < n; row++) {
+    for (int column = 0; column < n+1; column++) {
+      output.set(row,column,2.0*rand()/RAND_MAX - 1.0);
+    }
+  }
+  return output;
+}
+// ----------------------------------------------------------------------
+
+
+// Benchmarks
+// ----------------------------------------------------------------------
+
+// Times standard elimination against recursive elimination. Both
+// are followed by the same back substitution, and the solutions are
+// compared.
+static void benchmark_elimination(int n) {
+  GaussianSystem standard = random_system(n,n);
+  GaussianSystem recursive = standard;
+
+  double start = wall_time();
+  gaussian_elimination(standard,STANDARD_ELIMINATION);
+  double standard_time = wall_time() - start;
+
+  start = wall_time();
+  gaussian_elimination(recursive,RECURSIVE_ELIMINATION);
+  double recursive_time = wall_time() - start;
+
+  double difference = max_difference(back_substitution(standard),
+				     back_substitution(recursive));
+  cout << setw(8) << n
+       << setw(14) << standard_time
+       << setw(14) << recursive_time
+       << setw(10) << standard_time/recursive_time
+       << scientific << setw(14) << difference << fixed << endl;
+}
+
+// Times partial pivoting against tournament pivoting and reports the
+// stability diagnostics of both.
+static void benchmark_pivoting(int n) {
+  GaussianSystem original = random_system(n,n);
+  GaussianSystem standard = original;
+  GaussianSystem tournament = original;
+
+  double start = wall_time();
+  gaussian_elimination(standard,STANDARD_ELIMINATION);
+  double standard_time = wall_time() - start;
+
+  PivotingDiagnostics diagnostics;
+  start = wall_time();
+  tournament_gaussian_elimination(tournament,32,0,&diagnostics);
+  double tournament_time = wall_time() - start;
+
+  double difference = max_difference(back_substitution(standard),
+				     back_substitution(tournament));
+  cout << setw(8) << n
+       << setw(14) << standard_time
+       << setw(14) << tournament_time
+       << setw(12) << growth_factor(original,standard)
+       << setw(12) << diagnostics.growth_factor
+       << setw(12) << diagnostics.largest_multiplier
+       << setw(8) << diagnostics.synchronizations
+       << scientific << setw(14) << difference << fixed << endl;
+}
+
+// Finds the Strassen crossover. Times an n x n classical product
+// against one level of Strassen on top of it, then recursive LU with
+// and without Strassen updates at cutoff n/2, where the biggest
+// update just qualifies. Strassen pays when the times in the
+// "one level" and "LU strassen" columns beat their neighbours to the
+// left. The backward errors show what it costs in accuracy.
+static void benchmark_strassen(int n) {
+  Dynamic1DArray<double> A(n*n), B(n*n), C(n*n);
+  srand(n);
+  for (int i = 0; i < n*n; i++) {
+    A[i] = 2.0*rand()/RAND_MAX - 1.0;
+    B[i] = 2.0*rand()/RAND_MAX - 1.0;
+  }
+  double start = wall_time();
+  classical_multiply(n,n,n,A.data(),n,B.data(),n,C.data(),n);
+  double classical_time = wall_time() - start;
+  start = wall_time();
+  strassen_multiply(n,n,n,A.data(),n,B.data(),n,C.data(),n,n);
+  double strassen_time = wall_time() - start;
+
+  GaussianSystem original = random_system(n,n);
+  GaussianSystem recursive = original;
+  GaussianSystem fast = original;
+  start = wall_time();
+  Dynamic1DArray<double> recursive_solution
+    = solve_system(recursive,RECURSIVE_ELIMINATION);
+  double recursive_time = wall_time() - start;
+  start = wall_time();
+  strassen_gaussian_elimination(fast,n/2);
+  Dynamic1DArray<double> fast_solution = back_substitution(fast);
+  double fast_time = wall_time() - start;
+
+  cout << setw(10) << n
+       << setw(12) << classical_time
+       << setw(12) << strassen_time
+       << setw(12) << recursive_time
+       << setw(12) << fast_time
+       << scientific
+       << setw(14) << backward_error(original,recursive_solution)
+       << setw(14) << backward_error(original,fast_solution)
+       << fixed << endl;
+}
+
+// Times building and eliminating an nxn system with the ordinary
+// allocation and then with huge pages, a parallel first touch and
+// pinned threads. Tournament pivoting is used since it is the
+// elimination that splits rows over threads.
+static void benchmark_placement(int n) {
+  MemoryPlacement placements[2];
+  placements[1].huge_pages = true;
+  placements[1].first_touch = true;
+  placements[1].pin_threads = true;
+  const char* names[2] = {"ordinary", "placed"};
+  for (int p = 0; p < 2; p++) {
+    default_placement() = placements[p];
+    apply_thread_pinning(placements[p]);
+    double start = wall_time();
+    GaussianSystem g_sys = random_system(n,n);
+    double build_time = wall_time() - start;
+    start = wall_time();
+    tournament_gaussian_elimination(g_sys);
+    double elimination_time = wall_time() - start;
+    cout << setw(10) << n << setw(10) << names[p]
+	 << setw(12) << build_time
+	 << setw(14) << elimination_time
+	 << setw(14) << huge_page_bytes(g_sys.matrix_data())/(1 << 20)
+	 << endl;
+  }
+  default_placement() = MemoryPlacement();
+  apply_thread_pinning(MemoryPlacement());
+}
+
+// Profiles standard and recursive elimination of an nxn system with
+// the hardware counters, phase by phase. Metrics the machine can't
+// count print as n/a.
+static void benchmark_counters(int n) {
+  EliminationMethod methods[2] = {STANDARD_ELIMINATION, RECURSIVE_ELIMINATION};
+  const char* names[2] = {"standard", "recursive"};
+  for (int m = 0; m < 2; m++) {
+    GaussianSystem g_sys = random_system(n,n);
+    PerfProfiler profiler;
+    elimination_profiler = &profiler;
+    solve_system(g_sys,methods[m]);
+    elimination_profiler = NULL;
+    cout << "\n" << names[m] << " elimination, n = " << n << "\n";
+    profiler.report(cout,2.0/3*n*(double)n*n);
+  }
+}
+
+// Times solving a system held in the caller's own column-major
+// buffers: copied in element by element with set(), as before views,
+// against a view that solves in place. Recursive elimination packs
+// the view in place, so no second copy of the matrix is made.
+static void benchmark_views(int n) {
+  Dynamic1DArray<double> matrix(n*n);
+  Dynamic1DArray<double> knowns(n);
+  srand(n);
+  for (int k = 0; k < n*n; k++) {
+    matrix[k] = 2.0*rand()/RAND_MAX - 1.0;
+  }
+  for (int k = 0; k < n; k++) {
+    knowns[k] = 2.0*rand()/RAND_MAX - 1.0;
+  }
+
+  double start = wall_time();
+  GaussianSystem copied(n);
+  for (int row = 0; row < n; row++) {
+    for (int column = 0; column < n; column++) {
+      copied.set(row,column,matrix[row + column*n]);
+    }
+    copied.set(row,n,knowns[row]);
+  }
+  double copy_time = wall_time() - start;
+  Dynamic1DArray<double> copied_solution
+    = solve_system(copied,RECURSIVE_ELIMINATION);
+  double copied_time = wall_time() - start;
+
+  start = wall_time();
+  GaussianSystem view(n,matrix.data(),n,COLUMN_MAJOR,knowns.data());
+  Dynamic1DArray<double> view_solution
+    = solve_system(view,RECURSIVE_ELIMINATION);
+  double view_time = wall_time() - start;
+  cout << setw(10) << n
+       << setw(12) << copy_time
+       << setw(12) << copied_time
+       << setw(12) << view_time
+       << setw(12) << (n*(double)n*sizeof(double))/(1 << 20)
+       << setw(14) << scientific
+       << max_difference(view_solution,copied_solution)
+       << fixed << endl;
+}
+
+// Times recursive elimination against the structural fast paths
+// on an upper triangular system, eight interleaved decoupled
+// subsystems, and a general system, where the analysis is pure
+// overhead.
+static void benchmark_structure(int n) {
+  GaussianSystem general = random_system(n,n);
+  GaussianSystem triangular = general;
+  GaussianSystem decoupled = general;
+  for (int row = 0; row < n; row++) {
+    for (int column = 0; column < n; column++) {
+      if ( column < row ) {
+	triangular.matrix_set(row,column,0);
+      }
+      if ( column % 8 != row % 8 ) {
+	decoupled.matrix_set(row,column,0);
+      }
+    }
+  }
+  GaussianSystem* systems[3] = {&triangular, &decoupled, &general};
+  const char* names[3] = {"triangular", "decoupled", "general"};
+  for (int s = 0; s < 3; s++) {
+    GaussianSystem direct = *systems[s];
+    double start = wall_time();
+    Dynamic1DArray<double> direct_solution
+      = solve_system(direct,RECURSIVE_ELIMINATION);
+    double direct_time = wall_time() - start;
+
+    start = wall_time();
+    StructureAnalysis analysis = analyze_structure(*systems[s]);
+    double analysis_time = wall_time() - start;
+
+    GaussianSystem structured = *systems[s];
+    start = wall_time();
+    Dynamic1DArray<double> structured_solution
+      = structured_solve_system(structured,RECURSIVE_ELIMINATION,0,&analysis);
+    double structured_time = wall_time() - start;
+    cout << setw(10) << n << setw(12) << names[s]
+	 << setw(12) << direct_time
+	 << setw(12) << analysis_time
+	 << setw(12) << structured_time
+	 << setw(10) << direct_time/structured_time
+	 << setw(14) << scientific
+	 << max_difference(structured_solution,direct_solution)
+	 << fixed << "  ";
+    print_structure(cout,analysis);
+    cout << endl;
+  }
+}
+
+// Times recursive elimination against the Krylov solvers on a
+// diagonally dominant system, where a Krylov method should need only
+// a handful of iterations.
+static void benchmark_iterative(int n) {
+  GaussianSystem original = random_system(n,n);
+  for (int i = 0; i < n; i++) {
+    original.matrix_set(i,i,n/2.0);
+  }
+  GaussianSystem direct = original;
+  double start = wall_time();
+  Dynamic1DArray<double> direct_solution
+    = solve_system(direct,RECURSIVE_ELIMINATION);
+  double direct_time = wall_time() - start;
+  cout << setw(10) << n << setw(24) << "recursive LU"
+       << setw(12) << direct_time << endl;
+
+  KrylovMethod methods[2] = {BICGSTAB, GMRES};
+  const char* names[2] = {"BiCGSTAB + Jacobi", "GMRES + Jacobi"};
+  for (int m = 0; m < 2; m++) {
+    IterativeOptions options;
+    options.method = methods[m];
+    options.tolerance = 1E-12;
+    start = wall_time();
+    IterativeResult result = iterative_solve(original,options);
+    double iterative_time = wall_time() - start;
+    cout << setw(10) << n << setw(24) << names[m]
+	 << setw(12) << iterative_time
+	 << setw(12) << result.iterations
+	 << setw(14) << scientific
+	 << max_difference(result.solution,direct_solution)
+	 << fixed << endl;
+  }
+}
+
+// Times recursive elimination against the HODLR solver on a Gaussian
+// kernel matrix of n points along a line, plus a nugget, as in kernel
+// regression. Reports the compression and the residual of each
+// against the dense system.
+static void benchmark_hodlr(int n) {
+  vector<double> points(n);
+  for (int i = 0; i < n; i++) {
+    points[i] = (double)i/n;
+  }
+  MatrixEntries kernel = [&points](int i, int j) {
+    double distance = (points[i] - points[j])/0.1;
+    return exp(-distance*distance) + (i == j ? 0.1 : 0.0);
+  };
+  GaussianSystem original(n);
+  srand(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      original.matrix_set(i,j,kernel(i,j));
+    }
+    original.vector_set(i,2.0*rand()/RAND_MAX - 1.0);
+  }
+  GaussianSystem direct = original;
+  double start = wall_time();
+  Dynamic1DArray<double> direct_solution
+    = solve_system(direct,RECURSIVE_ELIMINATION);
+  double direct_time = wall_time() - start;
+  cout << setw(8) << n << setw(12) << "dense"
+       << setw(12) << direct_time
+       << setw(8) << "-"
+       << setw(12) << "1.000"
+       << setw(14) << scientific
+       << relative_residual(original,direct_solution)
+       << fixed << endl;
+
+  double tolerances[2] = {1E-6, 1E-10};
+  for (int t = 0; t < 2; t++) {
+    HodlrOptions options;
+    options.tolerance = tolerances[t];
+    start = wall_time();
+    HodlrMatrix matrix(n,kernel,options);
+    matrix.factor();
+    Dynamic1DArray<double> knowns(n);
+    for (int i = 0; i < n; i++) {
+      knowns[i] = original.vector_get(i);
+    }
+    Dynamic1DArray<double> solution = matrix.solve(knowns);
+    double hodlr_time = wall_time() - start;
+    cout << setw(8) << n << setw(12) << scientific << setprecision(0)
+	 << tolerances[t] << fixed << setprecision(3)
+	 << setw(12) << hodlr_time
+	 << setw(8) << matrix.largest_rank()
+	 << setw(12) << (double)matrix.compressed_entries()/((double)n*n)
+	 << setw(14) << scientific << relative_residual(original,solution)
+	 << fixed << endl;
+  }
+}
+
+// Times back substitution one unknown at a time through get(), the
+// way back_substitution() used to work, against the blocked
+// triangular solve on one thread and on every thread, for 1 and 32
+// right-hand sides.
+static void benchmark_substitution(int n) {
+  GaussianSystem reduced = random_system(n,n);
+  gaussian_elimination(reduced,RECURSIVE_ELIMINATION);
+  int widths[2] = {1, 32};
+  for (int w = 0; w < 2; w++) {
+    int width = widths[w];
+    Dynamic2DArray<double> knowns(n,width);
+    for (int i = 0; i < n; i++) {
+      for (int c = 0; c < width; c++) {
+	knowns.access(i,c) = (c == 0) ? reduced.vector_get(i) : sin(i + c);
+      }
+    }
+    double start = wall_time();
+    Dynamic1DArray<double> serial(n);
+    for (int c = 0; c < width; c++) {
+      for (int i = n - 1; i >= 0; i--) {
+	serial[i] = knowns.get(i,c);
+	for (int j = i + 1; j < n; j++) {
+	  serial[i] -= reduced.get(i,j)*serial[j];
+	}
+	serial[i] = serial[i]/reduced.get(i,i);
+      }
+    }
+    double serial_time = wall_time() - start;
+
+    Dynamic2DArray<double> one_thread = knowns;
+    start = wall_time();
+    triangular_solve(reduced,one_thread,1);
+    double one_thread_time = wall_time() - start;
+
+    Dynamic2DArray<double> threaded = knowns;
+    start = wall_time();
+    triangular_solve(reduced,threaded,0);
+    double threaded_time = wall_time() - start;
+
+    double difference = 0;
+    for (int i = 0; i < n; i++) {
+      difference = max(difference,abs(threaded.get(i,width - 1) - serial[i]));
+    }
+    cout << setw(8) << n << setw(8) << width
+	 << setw(12) << serial_time
+	 << setw(12) << one_thread_time
+	 << setw(12) << threaded_time
+	 << setw(10) << serial_time/threaded_time
+	 << scientific << setw(14) << difference << fixed << endl;
+  }
+}
+
+// Times ten solves of one matrix with different knowns, eliminating
+// every time against going through a factorization cache.
+static void benchmark_cache(int n) {
+  const int REPEATS = 10;
+  GaussianSystem original = random_system(n,n);
+  double start = wall_time();
+  for (int k = 0; k < REPEATS; k++) {
+    GaussianSystem copy = original;
+    copy.vector_set(k % n,k);
+    Dynamic1DArray<double> solution = solve_system(copy,
+						   RECURSIVE_ELIMINATION);
+  }
+  double uncached_time = wall_time() - start;
+
+  FactorizationCache cache;
+  start = wall_time();
+  for (int k = 0; k < REPEATS; k++) {
+    GaussianSystem copy = original;
+    copy.vector_set(k % n,k);
+    Dynamic1DArray<double> solution;
+    cache.solve(copy,solution);
+  }
+  double cached_time = wall_time() - start;
+  FactorizationCacheStatistics statistics = cache.statistics();
+  cout << setw(8) << n << setw(10) << REPEATS
+       << setw(12) << uncached_time
+       << setw(12) << cached_time
+       << setw(10) << uncached_time/cached_time
+       << setw(8) << statistics.hits << endl;
+}
+
+// Times the residual r = b - A*x on an n x n matrix three ways:
+// written out with get(), as separate passes through a temporary
+// A*x, and as a single fused expression.
+static void benchmark_algebra(int n) {
+  const int REPEATS = 20;
+  Dynamic2DArray<double> A(n,n);
+  Dynamic1DArray<double> x(n);
+  Dynamic1DArray<double> b(n);
+  srand(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      A.access(i,j) = 2.0*rand()/RAND_MAX - 1.0;
+    }
+    x[i] = 2.0*rand()/RAND_MAX - 1.0;
+    b[i] = 2.0*rand()/RAND_MAX - 1.0;
+  }
+
+  Dynamic1DArray<double> by_hand(n);
+  double start = wall_time();
+  for (int k = 0; k < REPEATS; k++) {
+    for (int i = 0; i < n; i++) {
+      double residual = b.get(i);
+      for (int j = 0; j < n; j++) {
+	residual -= A.get(i,j)*x.get(j);
+      }
+      by_hand.set(i,residual);
+    }
+  }
+  double hand_time = wall_time() - start;
+
+  Dynamic1DArray<double> by_passes(n);
+  start = wall_time();
+  for (int k = 0; k < REPEATS; k++) {
+    Dynamic1DArray<double> product(n);
+    for (int i = 0; i < n; i++) {
+      product[i] = 0;
+      for (int j = 0; j < n; j++) {
+	product[i] += A.get(i,j)*x[j];
+      }
+    }
+    for (int i = 0; i < n; i++) {
+      by_passes[i] = b[i] - product[i];
+    }
+  }
+  double passes_time = wall_time() - start;
+
+  Dynamic1DArray<double> fused(n);
+  start = wall_time();
+  for (int k = 0; k < REPEATS; k++) {
+    fused = b - A*x;
+  }
+  double fused_time = wall_time() - start;
+  cout << setw(8) << n
+       << setw(12) << hand_time
+       << setw(12) << passes_time
+       << setw(12) << fused_time
+       << setw(10) << hand_time/fused_time
+       << setw(12) << max(max_difference(by_hand,fused),
+			  max_difference(by_passes,fused)) << endl;
+}
+
+#ifdef BENCHMARK_HAVE_X86
+// The double-precision GFLOP/s of one core doing nothing but AVX2
+// FMAs, which is as close to peak as code gets. Twelve independent
+// chains cover the FMA latency on two ports.
+__attribute__((target("avx2,fma")))
+static double avx2_peak_gflops() {
+  const long STEPS = 20000000;
+  __m256d x = _mm256_set1_pd(0.999999);
+  __m256d y = _mm256_set1_pd(1E-7);
+  __m256d c[12];
+  for (int r = 0; r < 12; r++) {
+    c[r] = x;
+  }
+  double start = wall_time();
+  for (long s = 0; s < STEPS; s++) {
+    c[0] = _mm256_fmadd_pd(c[0],x,y);
+    c[1] = _mm256_fmadd_pd(c[1],x,y);
+    c[2] = _mm256_fmadd_pd(c[2],x,y);
+    c[3] = _mm256_fmadd_pd(c[3],x,y);
+    c[4] = _mm256_fmadd_pd(c[4],x,y);
+    c[5] = _mm256_fmadd_pd(c[5],x,y);
+    c[6] = _mm256_fmadd_pd(c[6],x,y);
+    c[7] = _mm256_fmadd_pd(c[7],x,y);
+    c[8] = _mm256_fmadd_pd(c[8],x,y);
+    c[9] = _mm256_fmadd_pd(c[9],x,y);
+    c[10] = _mm256_fmadd_pd(c[10],x,y);
+    c[11] = _mm256_fmadd_pd(c[11],x,y);
+  }
+  double seconds = wall_time() - start;
+  __m256d sum = c[0];
+  for (int r = 1; r < 12; r++) {
+    sum = _mm256_add_pd(sum,c[r]);
+  }
+  double lanes[4];
+  _mm256_storeu_pd(lanes,sum);
+  // Keep the loop from being optimized away.
+  if ( lanes[0] == 12345 ) {
+    cout << "";
+  }
+  return 96.0*STEPS/seconds/1E9;
+}
+#endif
+
+// Times n x n x n products: the classical triple loop, then gemm()
+// on one thread and on every thread, in double GFLOP/s. On AVX2
+// machines the single-thread rate is also given as a fraction of
+// one core's FMA peak. Shared machines are noisy, so the gemm() rates
+// and the peak are the best of three runs.
+static void benchmark_gemm(int n) {
+  const int RUNS = 3;
+  Dynamic1DArray<double> A(n*n), B(n*n), C(n*n), D(n*n);
+  srand(n);
+  for (int i = 0; i < n*n; i++) {
+    A[i] = 2.0*rand()/RAND_MAX - 1.0;
+    B[i] = 2.0*rand()/RAND_MAX - 1.0;
+  }
+  double flops = 2.0*n*n*n/1E9;
+  double start = wall_time();
+  classical_multiply(n,n,n,A.data(),n,B.data(),n,C.data(),n);
+  double classical_rate = flops/(wall_time() - start);
+  double single_rate = 0;
+  double parallel_rate = 0;
+  double peak = 0;
+  for (int run = 0; run < RUNS; run++) {
+    start = wall_time();
+    gemm(NO_TRANSPOSE,NO_TRANSPOSE,n,n,n,1.0,A.data(),n,B.data(),n,
+	 0.0,D.data(),n,1);
+    single_rate = max(single_rate,flops/(wall_time() - start));
+    start = wall_time();
+    gemm(NO_TRANSPOSE,NO_TRANSPOSE,n,n,n,1.0,A.data(),n,B.data(),n,
+	 0.0,D.data(),n);
+    parallel_rate = max(parallel_rate,flops/(wall_time() - start));
+#ifdef BENCHMARK_HAVE_X86
+    if ( gemm_kernel() == AVX2_KERNEL ) {
+      peak = max(peak,avx2_peak_gflops());
+    }
+#endif
+  }
+  cout << setw(8) << n
+       << setw(12) << classical_rate
+       << setw(12) << single_rate
+       << setw(12) << parallel_rate;
+  if ( peak > 0 ) {
+    cout << setw(11) << 100*single_rate/peak << "%";
+  } else {
+    cout << setw(12) << "-";
+  }
+  cout << setw(12) << max_difference(C,D) << endl;
+}
+
+// Times the loops whose index arithmetic went from 32 to 64 bits:
+// sweeps of get() over a row-major array and a column-major view,
+// a sweep of matrix_get() over a system, and the standard and
+// tournament eliminations, which index through the system and
+// through raw row offsets.
+static void benchmark_indexing(int n) {
+  const int SWEEPS = 20;
+  Dynamic2DArray<double> array(n,n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      array.access(i,j) = i - j;
+    }
+  }
+  Dynamic2DArray<double> view(array.data(),n,n,n,COLUMN_MAJOR);
+  GaussianSystem original = random_system(n,n);
+  double times[5];
+  double sum = 0;
+
+  double start = wall_time();
+  for (int s = 0; s < SWEEPS; s++) {
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+	sum += array.get(i,j);
+      }
+    }
+  }
+  times[0] = wall_time() - start;
+  start = wall_time();
+  for (int s = 0; s < SWEEPS; s++) {
+    for (int j = 0; j < n; j++) {
+      for (int i = 0; i < n; i++) {
+	sum += view.get(i,j);
+      }
+    }
+  }
+  times[1] = wall_time() - start;
+  start = wall_time();
+  for (int s = 0; s < SWEEPS; s++) {
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+	sum += original.matrix_get(i,j);
+      }
+    }
+  }
+  times[2] = wall_time() - start;
+  GaussianSystem standard = original;
+  start = wall_time();
+  gaussian_elimination(standard,STANDARD_ELIMINATION);
+  times[3] = wall_time() - start;
+  GaussianSystem tournament = original;
+  start = wall_time();
+  gaussian_elimination(tournament,TOURNAMENT_ELIMINATION);
+  times[4] = wall_time() - start;
+
+  cout << setw(8) << n;
+  for (int t = 0; t < 5; t++) {
+    cout << setw(12) << times[t];
+  }
+  // Printed so the sweeps can't be optimized away.
+  cout << setw(14) << scientific << sum << fixed << endl;
+}
+
+// Times elimination of an n x n system by the native standard and
+// recursive methods and by the LAPACK backend, to find where routing
+// systems to LAPACK starts to pay. The difference is between the
+// recursive and LAPACK solutions.
+static void benchmark_backend(int n) {
+  GaussianSystem original = random_system(n,n);
+  GaussianSystem standard = original;
+  GaussianSystem recursive = original;
+
+  double start = wall_time();
+  gaussian_elimination(standard,STANDARD_ELIMINATION);
+  double standard_time = wall_time() - start;
+  start = wall_time();
+  gaussian_elimination(recursive,RECURSIVE_ELIMINATION);
+  double recursive_time = wall_time() - start;
+
+  cout << setw(8) << n
+       << setw(12) << standard_time
+       << setw(12) << recursive_time;
+  if ( !backend_available(LAPACK_BACKEND) ) {
+    cout << setw(12) << "n/a" << endl;
+    return;
+  }
+  GaussianSystem lapack = original;
+  start = wall_time();
+  lapack_gaussian_elimination(lapack);
+  double lapack_time = wall_time() - start;
+  double difference = max_difference(back_substitution(recursive),
+				     back_substitution(lapack));
+  cout << setw(12) << lapack_time
+       << setw(10) << min(standard_time,recursive_time)/lapack_time
+       << setw(12) << scientific << difference << fixed << endl;
+}
+
+// Times standard elimination and back substitution of an n x n
+// system, best of three, with tracing off and on, and counts the
+// events a traced run records. Standard elimination has two traced
+// phases per column, the most of any method.
+static void benchmark_tracing(int n) {
+  GaussianSystem original = random_system(n,n);
+  double times[2];
+  long long events = 0;
+  for (int traced = 0; traced < 2; traced++) {
+    if ( traced ) {
+      clear_trace();
+      start_tracing();
+    }
+    for (int trial = 0; trial < 3; trial++) {
+      GaussianSystem g_sys = original;
+      double start = wall_time();
+      gaussian_elimination(g_sys,STANDARD_ELIMINATION);
+      back_substitution(g_sys);
+      double elapsed = wall_time() - start;
+      times[traced] = (trial == 0) ? elapsed : min(times[traced],elapsed);
+    }
+    if ( traced ) {
+      stop_tracing();
+      events = trace_events_recorded()/3;
+      clear_trace();
+    }
+  }
+  cout << setw(8) << n
+       << setw(12) << times[0]
+       << setw(12) << times[1]
+       << setw(10) << 100*(times[1] - times[0])/times[0]
+       << setw(10) << events << endl;
+}
+
+// Times assembling an n x n system from 20n elements of eight
+// nearby unknowns each: one entry at a time through access(), then
+// by assemble() on one thread and on every thread. The difference is
+// the largest against access(), which should be zero.
+static void benchmark_assembly(int n) {
+  srand(n);
+  AssemblyBatch batch;
+  int indices[8];
+  double matrix[64];
+  double knowns[8];
+  for (int e = 0; e < 20*n; e++) {
+    int base = rand()%n;
+    for (int i = 0; i < 8; i++) {
+      indices[i] = (base + rand()%32)%n;
+      knowns[i] = 2.0*rand()/RAND_MAX - 1.0;
+    }
+    for (int i = 0; i < 64; i++) {
+      matrix[i] = 2.0*rand()/RAND_MAX - 1.0;
+    }
+    batch.add(8,indices,matrix,knowns);
+  }
+
+  GaussianSystem serial(n);
+  double start = wall_time();
+  for (int e = 0; e < batch.elements(); e++) {
+    const int* element_indices = batch.element_indices(e);
+    const double* element_matrix = batch.element_matrix(e);
+    const double* element_vector = batch.element_vector(e);
+    for (int i = 0; i < 8; i++) {
+      for (int j = 0; j < 8; j++) {
+	serial.access(element_indices[i],element_indices[j])
+	  += element_matrix[8*i + j];
+      }
+      serial.access(element_indices[i],n) += element_vector[i];
+    }
+  }
+  double access_time = wall_time() - start;
+
+  double times[2];
+  double difference = 0;
+  for (int parallel = 0; parallel < 2; parallel++) {
+    GaussianSystem g_sys(n);
+    start = wall_time();
+    assemble(g_sys,batch,parallel ? 0 : 1);
+    times[parallel] = wall_time() - start;
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j <= n; j++) {
+	difference = max(difference,abs(g_sys.get(i,j) - serial.get(i,j)));
+      }
+    }
+  }
+  cout << setw(8) << n
+       << setw(12) << access_time
+       << setw(12) << times[0]
+       << setw(12) << times[1]
+       << setw(12) << scientific << difference << fixed << endl;
+}
+
+// Times solving 4096 n x n systems one at a time, by standard
+// elimination and back substitution, against batched_solve() sixteen
+// at a time, the way the solver service batches them. The
+// difference is the largest between the two.
+static void benchmark_batch(int n) {
+  const int count = 4096;
+  const int batch = 16;
+  vector<GaussianSystem> systems;
+  for (int s = 0; s < count; s++) {
+    systems.push_back(random_system(n,s));
+  }
+  vector<Dynamic1DArray<double> > alone(count);
+  double start = wall_time();
+  for (int s = 0; s < count; s++) {
+    GaussianSystem g_sys = systems[s];
+    gaussian_elimination(g_sys);
+    alone[s] = back_substitution(g_sys);
+  }
+  double alone_time = wall_time() - start;
+
+  vector<Dynamic1DArray<double> > together(count);
+  vector<const GaussianSystem*> pointers(count);
+  for (int s = 0; s < count; s++) {
+    pointers[s] = &systems[s];
+  }
+  start = wall_time();
+  for (int s = 0; s < count; s += batch) {
+    batched_solve(pointers.data() + s,batch,together.data() + s);
+  }
+  double together_time = wall_time() - start;
+  double difference = 0;
+  for (int s = 0; s < count; s++) {
+    difference = max(difference,max_difference(alone[s],together[s]));
+  }
+  cout << setw(8) << n
+       << setw(12) << alone_time
+       << setw(12) << together_time
+       << setw(10) << alone_time/together_time
+       << setw(12) << scientific << difference << fixed << endl;
+}
+
+// Times least-squares fits of 4n equations in n unknowns, by the
+// normal equations and by Householder QR one column at a time,
+// blocked, and blocked on every thread. The matrix is G D H, with G
+// and H random and D scaling over six orders of magnitude, so the
+// fit is ill-conditioned enough that squaring it shows. The error is
+// against the exact fit.
+static void benchmark_least_squares(int n) {
+  int m = 4*n;
+  Dynamic2DArray<double> G(m,n);
+  Dynamic2DArray<double> H(n,n);
+  Dynamic1DArray<double> truth(n);
+  srand(n);
+  for (int j = 0; j < n; j++) {
+    double scale = pow(10.0,-6.0*j/max(n - 1,1));
+    for (int i = 0; i < m; i++) {
+      G.access(i,j) = scale*(2.0*rand()/RAND_MAX - 1.0);
+    }
+    for (int i = 0; i < n; i++) {
+      H.access(i,j) = 2.0*rand()/RAND_MAX - 1.0;
+    }
+    truth[j] = 2.0*rand()/RAND_MAX - 1.0;
+  }
+  LeastSquaresSystem original(m,n);
+  Dynamic2DArray<double> A(original.matrix_data(),m,n,n);
+  gemm(1.0,G,NO_TRANSPOSE,H,NO_TRANSPOSE,0.0,A);
+  for (int i = 0; i < m; i++) {
+    double sum = 0;
+    for (int j = 0; j < n; j++) {
+      sum += A.get(i,j)*truth[j];
+    }
+    original.vector_set(i,sum);
+  }
+
+  // A^T A and A^T b by gemm, then elimination.
+  double start = wall_time();
+  GaussianSystem normal(n);
+  Dynamic2DArray<double> product(n,n);
+  gemm(TRANSPOSE,NO_TRANSPOSE,n,n,m,1.0,original.matrix_data(),n,
+       original.matrix_data(),n,0.0,product.data(),n);
+  for (int i = 0; i < n; i++) {
+    double sum = 0;
+    for (int p = 0; p < m; p++) {
+      sum += original.matrix_get(p,i)*original.vector_get(p);
+    }
+    for (int j = 0; j < n; j++) {
+      normal.matrix_set(i,j,product.get(i,j));
+    }
+    normal.vector_set(i,sum);
+  }
+  Dynamic1DArray<double> normal_solution
+    = solve_system(normal,RECURSIVE_ELIMINATION);
+  double normal_time = wall_time() - start;
+
+  double times[3];
+  Dynamic1DArray<double> solution;
+  int block_sizes[3] = {1, DEFAULT_QR_BLOCK_SIZE, DEFAULT_QR_BLOCK_SIZE};
+  int threads[3] = {1, 1, 0};
+  for (int k = 0; k < 3; k++) {
+    LeastSquaresSystem ls_sys = original;
+    start = wall_time();
+    solution = least_squares_solve(ls_sys,block_sizes[k],threads[k]);
+    times[k] = wall_time() - start;
+  }
+  cout << setw(8) << n
+       << setw(8) << m
+       << setw(12) << normal_time
+       << setw(12) << times[0]
+       << setw(12) << times[1]
+       << setw(12) << times[2]
+       << setw(10) << times[0]/times[1]
+       << scientific
+       << setw(12) << (normal_solution.length() == n
+		       ? max_difference(normal_solution,truth) : INFINITY)
+       << setw(12) << max_difference(solution,truth)
+       << fixed << endl;
+}
+
+// Times print_solution() against the fast text and binary writers
+// on a vector of n values. Everything goes to /dev/null.
+static void benchmark_output(int n) {
+  Dynamic1DArray<double> values(n);
+  srand(n);
+  for (int i = 0; i < n; i++) {
+    values[i] = 2.0*rand()/RAND_MAX - 1.0;
+  }
+  ofstream sink("/dev/null");
+
+  double start = wall_time();
+  print_solution(sink,values,0);
+  double pretty_time = wall_time() - start;
+
+  start = wall_time();
+  {
+    BufferedWriter writer(sink);
+    write_solution_text(writer,values,1);
+  }
+  double text_time = wall_time() - start;
+
+  start = wall_time();
+  {
+    BufferedWriter writer(sink);
+    write_solution_text(writer,values,0,1);
+  }
+  double parallel_time = wall_time() - start;
+
+  start = wall_time();
+  {
+    BufferedWriter writer(sink);
+    write_solution_binary(writer,values);
+  }
+  double binary_time = wall_time() - start;
+
+  cout << setw(10) << n
+       << setw(14) << pretty_time
+       << setw(14) << text_time
+       << setw(14) << parallel_time
+       << setw(14) << binary_time << endl;
+}
+// ----------------------------------------------------------------------
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+  const char* benchmark = (argc > 1) ? argv[1] : "elimination";
+  int default_sizes[] = {100, 200, 400, 800};
+  int number_of_sizes = (argc > 2) ? argc - 2 : 4;
+  Dynamic1DArray<int> sizes(number_of_sizes);
+  for (int i = 0; i < number_of_sizes; i++) {
+    sizes[i] = (argc > 2) ? atoi(argv[i+2]) : default_sizes[i];
+  }
+
+  cout << fixed << setprecision(3);
+  if ( strcmp(benchmark,"elimination") == 0 ) {
+    cout << "Standard vs. recursive elimination (seconds).\n"
+	 << setw(8) << "n"
+	 << setw(14) << "standard"
+	 << setw(14) << "recursive"
+	 << setw(10) << "speedup"
+	 << setw(14) << "max |dx|" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_elimination(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"pivoting") == 0 ) {
+    cout << "Partial vs. tournament pivoting (seconds, growth factors).\n"
+	 << setw(8) << "n"
+	 << setw(14) << "partial"
+	 << setw(14) << "tournament"
+	 << setw(12) << "growth(PP)"
+	 << setw(12) << "growth(TP)"
+	 << setw(12) << "max |l|"
+	 << setw(8) << "syncs"
+	 << setw(14) << "max |dx|" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_pivoting(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"strassen") == 0 ) {
+    cout << "Classical against Strassen products and LU updates (seconds).\n"
+	 << setw(10) << "n"
+	 << setw(12) << "classical"
+	 << setw(12) << "one level"
+	 << setw(12) << "LU"
+	 << setw(12) << "LU strassen"
+	 << setw(14) << "error"
+	 << setw(14) << "error (fast)" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_strassen(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"counters") == 0 ) {
+    cout << "Hardware counters by elimination phase." << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_counters(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"placement") == 0 ) {
+    cout << "Ordinary against placed matrix storage (seconds). NUMA nodes: "
+	 << numa_node_count() << "\n"
+	 << setw(10) << "n"
+	 << setw(10) << "storage"
+	 << setw(12) << "build"
+	 << setw(14) << "elimination"
+	 << setw(14) << "huge MB" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_placement(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"views") == 0 ) {
+    cout << "Copying caller memory in against solving a view (seconds).\n"
+	 << setw(10) << "n"
+	 << setw(12) << "copy in"
+	 << setw(12) << "copied"
+	 << setw(12) << "view"
+	 << setw(12) << "MB saved"
+	 << setw(14) << "max |dx|" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_views(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"structure") == 0 ) {
+    cout << "Elimination against structural fast paths (seconds).\n"
+	 << setw(10) << "n"
+	 << setw(12) << "system"
+	 << setw(12) << "eliminate"
+	 << setw(12) << "analyze"
+	 << setw(12) << "structured"
+	 << setw(10) << "speedup"
+	 << setw(14) << "max |dx|" << "  path" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_structure(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"iterative") == 0 ) {
+    cout << "Direct against iterative solves (seconds).\n"
+	 << setw(10) << "n"
+	 << setw(24) << "method"
+	 << setw(12) << "time"
+	 << setw(12) << "iterations"
+	 << setw(14) << "difference" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_iterative(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"hodlr") == 0 ) {
+    cout << "Dense against HODLR solves of a kernel matrix (seconds).\n"
+	 << setw(8) << "n"
+	 << setw(12) << "tolerance"
+	 << setw(12) << "time"
+	 << setw(8) << "rank"
+	 << setw(12) << "storage"
+	 << setw(14) << "residual" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_hodlr(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"substitution") == 0 ) {
+    cout << "Serial against blocked back substitution (seconds).\n"
+	 << setw(8) << "n"
+	 << setw(8) << "rhs"
+	 << setw(12) << "serial"
+	 << setw(12) << "blocked"
+	 << setw(12) << "threaded"
+	 << setw(10) << "speedup"
+	 << setw(14) << "max |dx|" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_substitution(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"cache") == 0 ) {
+    cout << "Repeated solves of one matrix, uncached and cached (seconds).\n"
+	 << setw(8) << "n"
+	 << setw(10) << "solves"
+	 << setw(12) << "uncached"
+	 << setw(12) << "cached"
+	 << setw(10) << "speedup"
+	 << setw(8) << "hits" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_cache(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"algebra") == 0 ) {
+    cout << "The residual b - A*x, 20 times (seconds).\n"
+	 << setw(8) << "n"
+	 << setw(12) << "get()"
+	 << setw(12) << "two passes"
+	 << setw(12) << "fused"
+	 << setw(10) << "speedup"
+	 << setw(12) << "difference" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_algebra(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"gemm") == 0 ) {
+    cout << "n x n x n products (GFLOP/s).\n"
+	 << setw(8) << "n"
+	 << setw(12) << "classical"
+	 << setw(12) << "gemm"
+	 << setw(12) << "gemm (par)"
+	 << setw(12) << "of peak"
+	 << setw(12) << "difference" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_gemm(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"indexing") == 0 ) {
+    cout << "Loops that index with 64-bit offsets (seconds).\n"
+	 << setw(8) << "n"
+	 << setw(12) << "get()"
+	 << setw(12) << "col view"
+	 << setw(12) << "system"
+	 << setw(12) << "standard"
+	 << setw(12) << "tournament"
+	 << setw(14) << "checksum" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_indexing(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"backend") == 0 ) {
+    cout << "Elimination by backend (seconds).\n"
+	 << setw(8) << "n"
+	 << setw(12) << "standard"
+	 << setw(12) << "recursive"
+	 << setw(12) << "lapack"
+	 << setw(10) << "speedup"
+	 << setw(12) << "difference" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_backend(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"tracing") == 0 ) {
+    cout << "Standard elimination with tracing off and on (seconds).\n"
+	 << setw(8) << "n"
+	 << setw(12) << "off"
+	 << setw(12) << "on"
+	 << setw(10) << "cost (%)"
+	 << setw(10) << "events" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_tracing(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"assembly") == 0 ) {
+    cout << "Assembling 20n elements of 8 unknowns (seconds).\n"
+	 << setw(8) << "n"
+	 << setw(12) << "access"
+	 << setw(12) << "1 thread"
+	 << setw(12) << "threads"
+	 << setw(12) << "difference" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_assembly(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"batch") == 0 ) {
+    cout << "Solving 4096 small systems alone and together (seconds).\n"
+	 << setw(8) << "n"
+	 << setw(12) << "alone"
+	 << setw(12) << "together"
+	 << setw(10) << "speedup"
+	 << setw(12) << "difference" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_batch(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"leastsquares") == 0 ) {
+    cout << "Least-squares fits, normal equations against QR (seconds).\n"
+	 << setw(8) << "n"
+	 << setw(8) << "m"
+	 << setw(12) << "normal"
+	 << setw(12) << "unblocked"
+	 << setw(12) << "blocked"
+	 << setw(12) << "blk (par)"
+	 << setw(10) << "speedup"
+	 << setw(12) << "normal err"
+	 << setw(12) << "QR err" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_least_squares(sizes[i]);
+    }
+  } else if ( strcmp(benchmark,"output") == 0 ) {
+    cout << "Writing a solution vector of n values (seconds).\n"
+	 << setw(10) << "n"
+	 << setw(14) << "pretty"
+	 << setw(14) << "text"
+	 << setw(14) << "text (par)"
+	 << setw(14) << "binary" << endl;
+    for (int i = 0; i < sizes.length(); i++) {
+      benchmark_output(sizes[i]);
+    }
+  } else {
+    cout << "Unknown benchmark: " << benchmark << "\n"
+	 << "Available benchmarks are: elimination pivoting strassen placement\n"
+	 << "counters views structure iterative hodlr substitution cache algebra\n"
+	 << "gemm leastsquares indexing backend tracing assembly batch "
+	 << "output" << endl;
+    return 1;
+  }
+  return 0;
+}
+// ----------------------------------------------------------------------
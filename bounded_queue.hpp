@@ -0,0 +1,176 @@
+// bounded_queue.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 13:48:20 (jonah)>
+
+// This file defines a lock-free bounded queue that any number of
+// threads can push to and pop from at once. It is a ring of cells,
+// each stamped with a sequence number that says whether the cell is
+// ready to be written or read. Neither push nor pop ever blocks: when
+// the queue is full or empty they just return false. A blocking
+// version for pipelines is at the bottom.
+
+// Include guard
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+template<typename TYPE>
+class BoundedQueue {
+public: // constructors and destructors
+  // Makes an empty queue that holds at least capacity elements. The
+  // capacity is rounded up to a power of two.
+  BoundedQueue(size_t capacity) {
+    size_t rounded = 1;
+    while ( rounded < capacity ) {
+      rounded *= 2;
+    }
+    mask = rounded - 1;
+    cells = new Cell[rounded];
+    for (size_t i = 0; i < rounded; i++) {
+      cells[i].sequence.store(i,memory_order_relaxed);
+    }
+    push_position.store(0,memory_order_relaxed);
+    pop_position.store(0,memory_order_relaxed);
+  }
+  // Returns the cells to the heap. Anything left in the queue is
+  // simply dropped.
+  ~BoundedQueue() {
+    delete [] cells;
+  }
+private: // Copying a queue that other threads are using makes no sense.
+  BoundedQueue(const BoundedQueue &rhs);
+  BoundedQueue& operator = (const BoundedQueue &rhs);
+
+private:
+  // A slot in the ring. If sequence equals the position about to be
+  // pushed, the slot is free. If it equals that position plus one,
+  // the slot holds data waiting to be popped.
+  struct Cell {
+    atomic<size_t> sequence;
+    TYPE data;
+  };
+  Cell* cells;
+  size_t mask; // capacity - 1
+  // The two ends of the queue live on separate cache lines so
+  // pushers and poppers don't fight over them.
+  alignas(64) atomic<size_t> push_position;
+  alignas(64) atomic<size_t> pop_position;
+
+public: // Interface
+  // The number of elements the queue can hold.
+  size_t capacity() const {
+    return mask + 1;
+  }
+  // Roughly how many elements are in the queue. Only exact when
+  // nobody else is using it.
+  size_t approximate_size() const {
+    size_t pushed = push_position.load(memory_order_relaxed);
+    size_t popped = pop_position.load(memory_order_relaxed);
+    return (pushed > popped) ? pushed - popped : 0;
+  }
+  // Adds element to the back of the queue. Returns false if the queue
+  // is full.
+  bool try_push(const TYPE& element) {
+    size_t position = push_position.load(memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells[position & mask];
+      size_t sequence = cell.sequence.load(memory_order_acquire);
+      long difference = (long)sequence - (long)position;
+      if ( difference == 0 ) {
+	if ( push_position.compare_exchange_weak(position,position + 1,
+						 memory_order_relaxed) ) {
+	  cell.data = element;
+	  cell.sequence.store(position + 1,memory_order_release);
+	  return true;
+	}
+      } else if ( difference < 0 ) {
+	return false; // full
+      } else {
+	position = push_position.load(memory_order_relaxed);
+      }
+    }
+  }
+  // Takes the element at the front of the queue and puts it in
+  // element. Returns false if the queue is empty.
+  bool try_pop(TYPE& element) {
+    size_t position = pop_position.load(memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells[position & mask];
+      size_t sequence = cell.sequence.load(memory_order_acquire);
+      long difference = (long)sequence - (long)(position + 1);
+      if ( difference == 0 ) {
+	if ( pop_position.compare_exchange_weak(position,position + 1,
+						memory_order_relaxed) ) {
+	  element = cell.data;
+	  cell.sequence.store(position + mask + 1,memory_order_release);
+	  return true;
+	}
+      } else if ( difference < 0 ) {
+	return false; // empty
+      } else {
+	position = pop_position.load(memory_order_relaxed);
+      }
+    }
+  }
+};
+
+// A bounded queue for pipelines, where a stage should sleep rather
+// than spin when it has nothing to do. Built on BoundedQueue. push
+// waits while the queue is full and pop waits while it is empty. Once
+// the queue is closed, pop drains what is left and then returns
+// false.
+template<typename TYPE>
+class BlockingQueue {
+public: // constructors
+  // Makes an empty open queue that holds at least capacity elements.
+  BlockingQueue(size_t capacity) : queue(capacity) {
+    closed = false;
+  }
+private: // Not copyable, like BoundedQueue.
+  BlockingQueue(const BlockingQueue &rhs);
+  BlockingQueue& operator = (const BlockingQueue &rhs);
+
+private:
+  BoundedQueue<TYPE> queue;
+  atomic<bool> closed;
+  mutex state_mutex;
+  condition_variable changed;
+
+public: // Interface
+  // Adds element to the back of the queue, waiting for room.
+  void push(const TYPE& element) {
+    while ( !queue.try_push(element) ) {
+      unique_lock<mutex> lock(state_mutex);
+      changed.wait_for(lock,chrono::milliseconds(1));
+    }
+    { lock_guard<mutex> lock(state_mutex); }
+    changed.notify_all();
+  }
+  // Takes the element at the front of the queue, waiting for one.
+  // Returns false if the queue is closed and empty.
+  bool pop(TYPE& element) {
+    for (;;) {
+      if ( queue.try_pop(element) ) {
+	{ lock_guard<mutex> lock(state_mutex); }
+	changed.notify_all();
+	return true;
+      }
+      unique_lock<mutex> lock(state_mutex);
+      if ( closed.load() && queue.approximate_size() == 0 ) {
+	return false;
+      }
+      changed.wait_for(lock,chrono::milliseconds(1));
+    }
+  }
+  // Says nothing more will be pushed. Wakes everyone waiting.
+  void close() {
+    { lock_guard<mutex> lock(state_mutex); closed = true; }
+    changed.notify_all();
+  }
+};
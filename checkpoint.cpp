@@ -0,0 +1,413 @@
+// checkpoint.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 23:58:12 (jonah)>
+
+// This file implements checkpoint and restart for long eliminations.
+
+// The checkpoint file is, in native byte order,
+//   -- 8 bytes of magic, "GECKPT01",
+//   -- the size n, the next column, whether the system is still
+//      nondegenerate, and a zero, as 32-bit integers,
+//   -- the fingerprint of the original system, 64 bits,
+//   -- the permutation vector, n 32-bit integers,
+//   -- the rows of the system in memory order, each n coefficients
+//      and then the known, as doubles,
+//   -- a 64-bit checksum of everything before it.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "checkpoint.hpp"
+#include "gaussian_elimination.hpp"
+#include "solution_writer.hpp"
+#include "wall_time.hpp"
+#include "fingerprint.hpp"
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Utilities
+// ----------------------------------------------------------------------
+
+static const char MAGIC[8] = {'G','E','C','K','P','T','0','1'};
+
+// A 64-bit hash of the system in row order.
+unsigned long long system_fingerprint(const GaussianSystem& g_sys) {
+  int n = g_sys.size();
+  unsigned long long hash = fingerprint_mix(FINGERPRINT_START,&n,
+					    sizeof(n));
+  vector<double> row(n + 1);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j <= n; j++) {
+      row[j] = g_sys.get(i,j);
+    }
+    hash = fingerprint_mix(hash,row.data(),row.size()*sizeof(double));
+  }
+  return hash;
+}
+
+// The row of g_sys in each row of memory: the inverse of the
+// permutation.
+static vector<int> rows_in_memory_order(const GaussianSystem& g_sys) {
+  vector<int> output(g_sys.size());
+  for (int i = 0; i < g_sys.size(); i++) {
+    output[g_sys.memory_row(i)] = i;
+  }
+  return output;
+}
+// ----------------------------------------------------------------------
+
+
+// Writing and reading
+// ----------------------------------------------------------------------
+
+// Everything in a checkpoint. fill_row(r,values) sets the n+1 values
+// of memory row r.
+struct CheckpointContents {
+  int size;
+  int next_column;
+  bool nondegenerate;
+  unsigned long long fingerprint;
+  vector<int> permutation;
+  function<void(int,double*)> fill_row;
+};
+
+// Flushes the directory that holds path, so a rename in it lasts.
+static void sync_directory(const string& path) {
+  size_t slash = path.rfind('/');
+  string directory = (slash == string::npos) ? "." : path.substr(0,slash + 1);
+  int descriptor = open(directory.c_str(),O_RDONLY);
+  if ( descriptor >= 0 ) {
+    fsync(descriptor);
+    close(descriptor);
+  }
+}
+
+// Writes contents to path + ".tmp", flushes it to disk, and renames
+// it over path.
+static bool write_contents(const string& path,
+			   const CheckpointContents& contents) {
+  string temporary = path + ".tmp";
+  int descriptor = open(temporary.c_str(),O_WRONLY | O_CREAT | O_TRUNC,0644);
+  if ( descriptor < 0 ) {
+    return false;
+  }
+  unsigned long long hash = FINGERPRINT_START;
+  bool good = true;
+  {
+    BufferedWriter writer(descriptor);
+    auto put = [&](const void* bytes, size_t count) {
+      hash = fingerprint_mix(hash,bytes,count);
+      writer.write((const char*)bytes,count);
+    };
+    int header[4] = {contents.size, contents.next_column,
+		     contents.nondegenerate ? 1 : 0, 0};
+    put(MAGIC,sizeof(MAGIC));
+    put(header,sizeof(header));
+    put(&contents.fingerprint,sizeof(contents.fingerprint));
+    put(contents.permutation.data(),contents.size*sizeof(int));
+    vector<double> row(contents.size + 1);
+    for (int r = 0; r < contents.size; r++) {
+      contents.fill_row(r,row.data());
+      put(row.data(),row.size()*sizeof(double));
+    }
+    unsigned long long checksum = hash;
+    writer.write((const char*)&checksum,sizeof(checksum));
+    writer.flush();
+    good = writer.good();
+  }
+  good = (fsync(descriptor) == 0) && good;
+  good = (close(descriptor) == 0) && good;
+  if ( !good || rename(temporary.c_str(),path.c_str()) != 0 ) {
+    unlink(temporary.c_str());
+    return false;
+  }
+  sync_directory(path);
+  return true;
+}
+
+// Writes a checkpoint of g_sys straight from the system.
+bool write_checkpoint(const string& path, const GaussianSystem& g_sys,
+		      int next_column, bool nondegenerate,
+		      unsigned long long fingerprint) {
+  int n = g_sys.size();
+  vector<int> rows = rows_in_memory_order(g_sys);
+  CheckpointContents contents;
+  contents.size = n;
+  contents.next_column = next_column;
+  contents.nondegenerate = nondegenerate;
+  contents.fingerprint = fingerprint;
+  contents.permutation.resize(n);
+  for (int i = 0; i < n; i++) {
+    contents.permutation[i] = g_sys.memory_row(i);
+  }
+  contents.fill_row = [&](int r, double* values) {
+    for (int j = 0; j <= n; j++) {
+      values[j] = g_sys.get(rows[r],j);
+    }
+  };
+  return write_contents(path,contents);
+}
+
+// Reads the header of a checkpoint. Returns false if it isn't one.
+static bool read_header(ifstream& input, int header[4],
+			unsigned long long& fingerprint) {
+  char magic[sizeof(MAGIC)];
+  input.read(magic,sizeof(magic));
+  input.read((char*)header,4*sizeof(int));
+  input.read((char*)&fingerprint,sizeof(fingerprint));
+  return input.good() && memcmp(magic,MAGIC,sizeof(MAGIC)) == 0
+    && header[0] >= 0;
+}
+
+// Reads a checkpoint into g_sys. The file is read twice: once to
+// check it, so g_sys is left alone if it is bad, and once to load it,
+// so no second copy of the system is needed.
+bool read_checkpoint(const string& path, GaussianSystem& g_sys,
+		     int& next_column, bool& nondegenerate,
+		     unsigned long long fingerprint) {
+  int header[4];
+  unsigned long long saved_fingerprint;
+  ifstream input(path.c_str(),ios::binary);
+  if ( !input || !read_header(input,header,saved_fingerprint)
+       || header[0] != g_sys.size() || saved_fingerprint != fingerprint ) {
+    return false;
+  }
+  int n = header[0];
+
+  // Check the checksum.
+  unsigned long long hash = FINGERPRINT_START;
+  hash = fingerprint_mix(hash,MAGIC,sizeof(MAGIC));
+  hash = fingerprint_mix(hash,header,sizeof(header));
+  hash = fingerprint_mix(hash,&saved_fingerprint,
+			 sizeof(saved_fingerprint));
+  Dynamic1DArray<int> permutation(n);
+  input.read((char*)permutation.data(),n*sizeof(int));
+  hash = fingerprint_mix(hash,permutation.data(),n*sizeof(int));
+  vector<double> row(n + 1);
+  for (int r = 0; r < n && input.good(); r++) {
+    input.read((char*)row.data(),row.size()*sizeof(double));
+    hash = fingerprint_mix(hash,row.data(),row.size()*sizeof(double));
+  }
+  unsigned long long checksum;
+  input.read((char*)&checksum,sizeof(checksum));
+  if ( !input.good() || checksum != hash || input.peek() != EOF ) {
+    return false;
+  }
+
+  // Load it. With the identity permutation, row r of the system is
+  // memory row r.
+  input.clear();
+  input.seekg(sizeof(MAGIC) + 4*sizeof(int) + sizeof(saved_fingerprint)
+	      + n*sizeof(int));
+  for (int i = 0; i < n; i++) {
+    permutation[i] = i;
+  }
+  g_sys.set_permutation(permutation);
+  for (int r = 0; r < n; r++) {
+    input.read((char*)row.data(),row.size()*sizeof(double));
+    for (int j = 0; j <= n; j++) {
+      g_sys.set(r,j,row[j]);
+    }
+  }
+  input.seekg(sizeof(MAGIC) + 4*sizeof(int) + sizeof(saved_fingerprint));
+  input.read((char*)permutation.data(),n*sizeof(int));
+  g_sys.set_permutation(permutation);
+  next_column = header[1];
+  nondegenerate = (header[2] != 0);
+  return true;
+}
+// ----------------------------------------------------------------------
+
+
+// The background writer
+// ----------------------------------------------------------------------
+
+// Writes snapshots of the system in a thread of its own, one at a
+// time.
+class CheckpointWriter {
+public:
+  CheckpointWriter(const string& checkpoint_path) {
+    path = checkpoint_path;
+    busy = false;
+    stopping = false;
+    written = 0;
+    worker = thread(&CheckpointWriter::work,this);
+  }
+  ~CheckpointWriter() {
+    {
+      lock_guard<mutex> lock(state_mutex);
+      stopping = true;
+    }
+    state_changed.notify_all();
+    worker.join();
+  }
+  // Takes a snapshot of g_sys and starts writing it. Returns false,
+  // without taking a snapshot, if the last one is still being
+  // written.
+  bool try_write(const GaussianSystem& g_sys, int next_column,
+		 bool nondegenerate, unsigned long long fingerprint) {
+    {
+      lock_guard<mutex> lock(state_mutex);
+      if ( busy ) {
+	return false;
+      }
+    }
+    // The worker is idle, so the snapshot is ours until busy is set.
+    int n = g_sys.size();
+    vector<int> rows = rows_in_memory_order(g_sys);
+    snapshot.size = n;
+    snapshot.next_column = next_column;
+    snapshot.nondegenerate = nondegenerate;
+    snapshot.fingerprint = fingerprint;
+    snapshot.permutation.resize(n);
+    snapshot_values.resize((size_t)n*(n + 1));
+    for (int i = 0; i < n; i++) {
+      snapshot.permutation[i] = g_sys.memory_row(i);
+    }
+    for (int r = 0; r < n; r++) {
+      double* values = snapshot_values.data() + (size_t)r*(n + 1);
+      for (int j = 0; j <= n; j++) {
+	values[j] = g_sys.get(rows[r],j);
+      }
+    }
+    {
+      lock_guard<mutex> lock(state_mutex);
+      busy = true;
+    }
+    state_changed.notify_all();
+    return true;
+  }
+  // Waits for the write in progress, if any. Returns how many
+  // checkpoints have been written.
+  int wait() {
+    unique_lock<mutex> lock(state_mutex);
+    state_changed.wait(lock,[this]() { return !busy; });
+    return written;
+  }
+private:
+  void work() {
+    unique_lock<mutex> lock(state_mutex);
+    while ( true ) {
+      state_changed.wait(lock,[this]() { return busy || stopping; });
+      if ( !busy ) {
+	return;
+      }
+      lock.unlock();
+      int n = snapshot.size;
+      snapshot.fill_row = [this,n](int r, double* values) {
+	memcpy(values,snapshot_values.data() + (size_t)r*(n + 1),
+	       (n + 1)*sizeof(double));
+      };
+      bool good = write_contents(path,snapshot);
+      lock.lock();
+      if ( good ) {
+	written++;
+      }
+      busy = false;
+      state_changed.notify_all();
+    }
+  }
+  string path;
+  CheckpointContents snapshot;
+  vector<double> snapshot_values;
+  mutex state_mutex;
+  condition_variable state_changed;
+  bool busy;
+  bool stopping;
+  int written;
+  thread worker;
+};
+// ----------------------------------------------------------------------
+
+
+// Checkpointed elimination
+// ----------------------------------------------------------------------
+
+bool checkpointed_gaussian_elimination(GaussianSystem& g_sys,
+				       const CheckpointOptions& options,
+				       CheckpointReport* report/*= NULL*/) {
+  int n = g_sys.size();
+  unsigned long long fingerprint = system_fingerprint(g_sys);
+  int column = 0;
+  bool nondegenerate = true;
+  if ( options.resume ) {
+    if ( !read_checkpoint(options.path,g_sys,column,nondegenerate,
+			  fingerprint) ) {
+      column = 0;
+      nondegenerate = true;
+    }
+  }
+  int resumed_column = column;
+  int last = n;
+  if ( options.column_limit > 0 && options.column_limit < n ) {
+    last = max(column,options.column_limit);
+  }
+
+  CheckpointWriter* writer = NULL;
+  if ( options.asynchronous ) {
+    writer = new CheckpointWriter(options.path);
+  }
+  int written = 0;
+  int skipped = 0;
+  int last_checkpoint_column = column;
+  double last_checkpoint_time = wall_time();
+  while ( column < last ) {
+    nondegenerate = eliminate_columns(g_sys,column,column + 1)
+      && nondegenerate;
+    column++;
+    bool due = (options.every_columns > 0
+		&& column - last_checkpoint_column >= options.every_columns)
+      || (options.every_seconds > 0
+	  && wall_time() - last_checkpoint_time >= options.every_seconds);
+    if ( !due || column == n ) {
+      continue;
+    }
+    if ( writer == NULL ) {
+      written += write_checkpoint(options.path,g_sys,column,nondegenerate,
+				  fingerprint) ? 1 : 0;
+    } else if ( !writer->try_write(g_sys,column,nondegenerate,fingerprint) ) {
+      skipped++;
+      continue;
+    }
+    last_checkpoint_column = column;
+    last_checkpoint_time = wall_time();
+  }
+  if ( writer != NULL ) {
+    written += writer->wait();
+    delete writer;
+  }
+
+  bool finished = (column == n);
+  if ( finished && options.remove_when_done ) {
+    unlink(options.path.c_str());
+  } else if ( !finished && last_checkpoint_column != column ) {
+    // Stopping early. Save where we stopped.
+    written += write_checkpoint(options.path,g_sys,column,nondegenerate,
+				fingerprint) ? 1 : 0;
+  }
+  if ( report != NULL ) {
+    report->resumed_column = resumed_column;
+    report->stopped_column = column;
+    report->written = written;
+    report->skipped = skipped;
+    report->finished = finished;
+  }
+  return nondegenerate;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,119 @@
+// checkpoint.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 23:24:50 (jonah)>
+
+// This file prototypes checkpoint and restart for long eliminations.
+// A big enough system takes hours to eliminate, and
+// gaussian_elimination() keeps its progress only in memory, so a
+// preempted job loses everything. Here standard elimination saves the
+// partially eliminated system every so often: the matrix and knowns
+// in memory order, the permutation vector and the next column. A
+// restarted job picks up from the last checkpoint and gets exactly
+// the same bits as a run that was never interrupted, since
+// elimination between columns depends on nothing else.
+
+// Checkpoints are written by a background thread from a snapshot, so
+// elimination only stalls for the copy. A checkpoint goes to a
+// temporary file that is flushed to disk and then renamed over the
+// old one, so the file on disk is always a whole checkpoint. A
+// checksum catches files damaged some other way, and a fingerprint of
+// the original system stops a checkpoint being resumed into the
+// wrong system.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <string>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// When and where to checkpoint.
+struct CheckpointOptions {
+  // The checkpoint file. path + ".tmp" is used while writing.
+  string path;
+  // Checkpoint after this many columns since the last one. 0 means
+  // don't count columns.
+  int every_columns;
+  // Checkpoint once this many seconds have passed since the last
+  // one. 0 means don't watch the clock.
+  double every_seconds;
+  // Write from a snapshot in a background thread. The snapshot is a
+  // second copy of the system. If false, elimination waits for each
+  // write but needs no extra memory. A checkpoint that comes due
+  // while the last one is still being written is skipped.
+  bool asynchronous;
+  // Pick up from the checkpoint at path, if there is a good one of
+  // this system.
+  bool resume;
+  // Stop, with a checkpoint, once this many columns are done, so a
+  // job can run in slices. 0 means run to the end.
+  int column_limit;
+  // Delete the checkpoint once elimination is finished.
+  bool remove_when_done;
+  // Sets the defaults: every 10 minutes, asynchronous, resuming.
+  CheckpointOptions() {
+    every_columns = 0;
+    every_seconds = 600;
+    asynchronous = true;
+    resume = true;
+    column_limit = 0;
+    remove_when_done = true;
+  }
+};
+
+// What checkpointed_gaussian_elimination() did.
+struct CheckpointReport {
+  // The column elimination resumed at. 0 if it started fresh.
+  int resumed_column;
+  // The column elimination stopped at. size() if it finished.
+  int stopped_column;
+  // Checkpoints written, and checkpoints skipped because the writer
+  // was still busy.
+  int written;
+  int skipped;
+  // Whether every column is done, so the system is ready for
+  // back_substitution().
+  bool finished;
+};
+
+// Does the same job as gaussian_elimination() with
+// STANDARD_ELIMINATION, checkpointing as options asks. If the
+// elimination stops early at options.column_limit, g_sys is only
+// partly eliminated, and the latest checkpoint holds it. Returns
+// true if every column done so far, including those before a resume,
+// had a pivot. If report is not NULL, fills it in.
+bool checkpointed_gaussian_elimination(GaussianSystem& g_sys,
+				       const CheckpointOptions& options,
+				       CheckpointReport* report = NULL);
+
+// Writes a checkpoint of g_sys, with elimination done up to
+// next_column, to path atomically and durably. fingerprint is
+// system_fingerprint() of the original system. Returns false if the
+// file can't be written, in which case any old checkpoint is still
+// there.
+bool write_checkpoint(const string& path, const GaussianSystem& g_sys,
+		      int next_column, bool nondegenerate,
+		      unsigned long long fingerprint);
+
+// Reads a checkpoint from path into g_sys, restoring the matrix,
+// knowns and permutation exactly. Returns false, and leaves g_sys
+// alone, if there is no checkpoint, it is damaged, or its
+// fingerprint isn't fingerprint.
+bool read_checkpoint(const string& path, GaussianSystem& g_sys,
+		     int& next_column, bool& nondegenerate,
+		     unsigned long long fingerprint);
+
+// A 64-bit hash of the size and every entry of g_sys, in row order.
+unsigned long long system_fingerprint(const GaussianSystem& g_sys);
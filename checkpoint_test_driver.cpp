@@ -0,0 +1,154 @@
+// checkpoint_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 23:59:40 (jonah)>
+
+// This file tests checkpoint and restart. An interrupted and resumed
+// elimination must give exactly the bits of one that ran straight
+// through.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstdio>
+#include <cassert>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "checkpoint.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Asserts that a and b hold exactly the same rows, bit for bit.
+static void assert_identical(const GaussianSystem& a,
+			     const GaussianSystem& b) {
+  assert( a.size() == b.size() && "The systems are the same size." );
+  for (int i = 0; i < a.size(); i++) {
+    for (int j = 0; j <= a.size(); j++) {
+      assert( a.get(i,j) == b.get(i,j) && "The systems are identical." );
+    }
+  }
+}
+
+// Returns true if the file at path exists.
+static bool exists(const string& path) {
+  ifstream input(path.c_str());
+  return input.good();
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the checkpoint library.\n"
+       << "BEGIN." << endl;
+  srand(11);
+  int n = 120;
+  string path = "checkpoint_test_driver.ckpt";
+  remove(path.c_str());
+
+  GaussianSystem original(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j <= n; j++) {
+      original.set(i,j,(double)rand()/RAND_MAX - 0.5);
+    }
+  }
+
+  cout << "\n\nEliminating straight through for reference." << endl;
+  GaussianSystem reference = original;
+  assert( gaussian_elimination(reference) && "The reference is solved." );
+  Dynamic1DArray<double> reference_solution = back_substitution(reference);
+
+  cout << "\n\nStopping at column 50." << endl;
+  CheckpointOptions options;
+  options.path = path;
+  options.every_seconds = 0;
+  options.column_limit = 50;
+  CheckpointReport report;
+  GaussianSystem first_job = original;
+  checkpointed_gaussian_elimination(first_job,options,&report);
+  cout << "Stopped at column " << report.stopped_column << " with "
+       << report.written << " checkpoint(s) written." << endl;
+  assert( !report.finished && report.stopped_column == 50
+	  && report.written == 1 && exists(path)
+	  && "The job stops with a checkpoint." );
+
+  cout << "\n\nResuming in a fresh copy of the system." << endl;
+  options.column_limit = 0;
+  GaussianSystem second_job = original;
+  bool nondegenerate = checkpointed_gaussian_elimination(second_job,options,
+							 &report);
+  cout << "Resumed at column " << report.resumed_column << "." << endl;
+  assert( nondegenerate && report.finished && report.resumed_column == 50
+	  && "The job resumes where it stopped." );
+  assert( !exists(path) && "The checkpoint is removed when done." );
+  assert_identical(second_job,reference);
+  Dynamic1DArray<double> solution = back_substitution(second_job);
+  for (int i = 0; i < n; i++) {
+    assert( solution[i] == reference_solution[i]
+	    && "The resumed solution is bit for bit the same." );
+  }
+
+  cout << "\n\nCheckpointing every 7 columns in the background." << endl;
+  options.every_columns = 7;
+  options.remove_when_done = false;
+  GaussianSystem background = original;
+  checkpointed_gaussian_elimination(background,options,&report);
+  cout << report.written << " checkpoint(s) written and " << report.skipped
+       << " skipped." << endl;
+  assert( report.finished && report.written > 0
+	  && report.written <= (n - 1)/7
+	  && "Checkpoints are written, at most one per 7 columns." );
+  assert_identical(background,reference);
+
+  cout << "\n\nRestoring the last background checkpoint directly." << endl;
+  GaussianSystem restored = original;
+  int next_column;
+  unsigned long long fingerprint = system_fingerprint(original);
+  assert( read_checkpoint(path,restored,next_column,nondegenerate,
+			  fingerprint)
+	  && next_column > 0 && next_column < n
+	  && "The checkpoint reads back." );
+  assert( eliminate_columns(restored,next_column,n) );
+  assert_identical(restored,reference);
+
+  cout << "\n\nA different system ignores the checkpoint." << endl;
+  GaussianSystem other = original;
+  other.set(0,0,other.get(0,0) + 1);
+  assert( !read_checkpoint(path,other,next_column,nondegenerate,
+			   system_fingerprint(other))
+	  && "The fingerprint doesn't match." );
+
+  cout << "\n\nA truncated checkpoint is ignored." << endl;
+  write_checkpoint(path,original,0,true,fingerprint);
+  {
+    ifstream input(path.c_str(),ios::binary);
+    string contents((istreambuf_iterator<char>(input)),
+		    istreambuf_iterator<char>());
+    ofstream output(path.c_str(),ios::binary | ios::trunc);
+    output.write(contents.data(),contents.size() - 100);
+  }
+  restored = original;
+  restored.set(3,3,42);
+  assert( !read_checkpoint(path,restored,next_column,nondegenerate,
+			   fingerprint)
+	  && restored.get(3,3) == 42
+	  && "A damaged checkpoint is refused and the system left alone." );
+  options.every_columns = 0;
+  options.remove_when_done = true;
+  GaussianSystem fresh = original;
+  checkpointed_gaussian_elimination(fresh,options,&report);
+  assert( report.resumed_column == 0 && report.finished
+	  && "A damaged checkpoint means starting over." );
+  assert_identical(fresh,reference);
+  remove(path.c_str());
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,451 @@
+// distributed_elimination.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 23:12:40 (jonah)>
+
+// This file implements the distributed-memory Gaussian elimination
+// library. A system too big for one node is spread over a PxQ grid of
+// MPI processes in a 2D block-cyclic layout and solved in place.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "distributed_elimination.hpp"
+#include <cmath>
+#include <cassert>
+#include <climits>
+#include <float.h>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Utilities
+// ----------------------------------------------------------------------
+
+// The number of indices in [0,n) that land on process coordinate p
+// of P when dealt out block-cyclically in blocks of size block.
+static int block_cyclic_count(int n, int block, int p, int P) {
+  int whole_blocks = n/block;
+  int output = (whole_blocks/P)*block;
+  int extra_blocks = whole_blocks % P;
+  if ( p < extra_blocks ) {
+    output += block;
+  } else if ( p == extra_blocks ) {
+    output += n % block;
+  }
+  return output;
+}
+
+// Picks the grid closest to square for processes processes, unless
+// P and Q are both given.
+static void choose_grid(int processes, int& P, int& Q) {
+  if ( P <= 0 || Q <= 0 ) {
+    P = 1;
+    for (int candidate = 1; candidate*candidate <= processes; candidate++) {
+      if ( processes % candidate == 0 ) {
+	P = candidate;
+      }
+    }
+    Q = processes/P;
+  }
+  assert( P*Q == processes && "The grid uses every process." );
+}
+
+// count as the int an MPI call takes. A message of more than INT_MAX
+// elements has to be split, which this library doesn't do.
+static int message_count(size_t count) {
+  assert( count <= (size_t)INT_MAX && "The message fits in one MPI call." );
+  return (int)count;
+}
+// ----------------------------------------------------------------------
+
+
+// Constructors and destructors
+// ----------------------------------------------------------------------
+
+// Creates an empty distributed nxn system over the processes in comm.
+DistributedSystem::DistributedSystem(MPI_Comm comm, int n, int block_size,
+				     int P, int Q, double* local_memory) {
+  int processes, rank;
+  MPI_Comm_size(comm,&processes);
+  choose_grid(processes,P,Q);
+  assert( block_size > 0 && "The block size is positive." );
+
+  system_size = n;
+  block = block_size;
+  grid_rows = P;
+  grid_columns = Q;
+  MPI_Comm_dup(comm,&grid_comm);
+  MPI_Comm_rank(grid_comm,&rank);
+  my_row = rank / grid_columns;
+  my_column = rank % grid_columns;
+  MPI_Comm_split(grid_comm,my_row,my_column,&row_comm);
+  MPI_Comm_split(grid_comm,my_column,my_row,&column_comm);
+
+  // The knowns vector is column n of the augmented matrix.
+  int rows = block_cyclic_count(n,block,my_row,grid_rows);
+  int columns = block_cyclic_count(n+1,block,my_column,grid_columns);
+  if ( local_memory != NULL ) {
+    Dynamic2DArray<double> view(local_memory,rows,columns,columns);
+    local_matrix.swap(view);
+    return;
+  }
+  local_matrix.reset(rows,columns);
+  for (int l = 0; l < local_rows(); l++) {
+    for (int c = 0; c < local_columns(); c++) {
+      local_access(l,c) = 0;
+    }
+  }
+}
+
+// Returns the communicators to MPI.
+DistributedSystem::~DistributedSystem() {
+  MPI_Comm_free(&row_comm);
+  MPI_Comm_free(&column_comm);
+  MPI_Comm_free(&grid_comm);
+}
+
+// The size of this process's piece of the system.
+size_t DistributedSystem::local_cells(MPI_Comm comm, int n, int block_size,
+				      int P, int Q) {
+  int processes, rank;
+  MPI_Comm_size(comm,&processes);
+  MPI_Comm_rank(comm,&rank);
+  choose_grid(processes,P,Q);
+  return (size_t)block_cyclic_count(n,block_size,rank/Q,P)
+    *block_cyclic_count(n+1,block_size,rank % Q,Q);
+}
+// ----------------------------------------------------------------------
+
+
+// Interface
+// ----------------------------------------------------------------------
+
+// The number of local rows whose global index is below i.
+int DistributedSystem::local_rows_before(int i) const {
+  return block_cyclic_count(i,block,my_row,grid_rows);
+}
+
+// The number of local columns whose global index is below j.
+int DistributedSystem::local_columns_before(int j) const {
+  return block_cyclic_count(j,block,my_column,grid_columns);
+}
+
+// Sends the pieces of g_sys from the process root to their owners.
+void DistributedSystem::scatter(const GaussianSystem& g_sys, int root) {
+  int rank, processes;
+  MPI_Comm_rank(grid_comm,&rank);
+  MPI_Comm_size(grid_comm,&processes);
+  if ( rank != root ) {
+    if ( local_matrix.cell_number() > 0 ) {
+      MPI_Recv(local_matrix.data(),message_count(local_matrix.cell_number()),
+	       MPI_DOUBLE,root,0,grid_comm,MPI_STATUS_IGNORE);
+    }
+    return;
+  }
+  assert( g_sys.size() == system_size && "The system sizes agree." );
+  // Pack each process's piece in its local order and send it.
+  for (int target = 0; target < processes; target++) {
+    int target_row = target / grid_columns;
+    int target_column = target % grid_columns;
+    int rows = block_cyclic_count(system_size,block,target_row,grid_rows);
+    int columns = block_cyclic_count(system_size+1,block,
+				     target_column,grid_columns);
+    int count = message_count((size_t)rows*columns);
+    if ( count == 0 ) {
+      continue;
+    }
+    Dynamic1DArray<double> piece(count);
+    for (int l = 0; l < rows; l++) {
+      int i = ((l/block)*grid_rows + target_row)*block + l % block;
+      for (int c = 0; c < columns; c++) {
+	int j = ((c/block)*grid_columns + target_column)*block + c % block;
+	piece[l*columns + c] = g_sys.get(i,j);
+      }
+    }
+    if ( target == root ) {
+      for (int k = 0; k < count; k++) {
+	local_matrix.data()[k] = piece[k];
+      }
+    } else {
+      MPI_Send(piece.data(),count,MPI_DOUBLE,target,0,grid_comm);
+    }
+  }
+}
+
+// Fills the system without ever holding it on one process.
+void DistributedSystem::fill(const function<double(int,int)>& entry) {
+  for (int l = 0; l < local_rows(); l++) {
+    for (int c = 0; c < local_columns(); c++) {
+      local_access(l,c) = entry(global_row(l),global_column(c));
+    }
+  }
+}
+
+// Swaps global rows row1 and row2 across the whole grid. Each process
+// column swaps its own piece of the two rows independently.
+void DistributedSystem::swap(int row1, int row2) {
+  if ( row1 == row2 || local_columns() == 0 ) {
+    return;
+  }
+  int owner1 = owner_row(row1);
+  int owner2 = owner_row(row2);
+  if ( my_row == owner1 && my_row == owner2 ) {
+    double* first = &local_access(local_row(row1),0);
+    double* second = &local_access(local_row(row2),0);
+    for (int c = 0; c < local_columns(); c++) {
+      double temp = first[c];
+      first[c] = second[c];
+      second[c] = temp;
+    }
+  } else if ( my_row == owner1 ) {
+    MPI_Sendrecv_replace(&local_access(local_row(row1),0),local_columns(),
+			 MPI_DOUBLE,owner2,1,owner2,1,column_comm,
+			 MPI_STATUS_IGNORE);
+  } else if ( my_row == owner2 ) {
+    MPI_Sendrecv_replace(&local_access(local_row(row2),0),local_columns(),
+			 MPI_DOUBLE,owner1,1,owner1,1,column_comm,
+			 MPI_STATUS_IGNORE);
+  }
+}
+// ----------------------------------------------------------------------
+
+
+// Reduces the distributed system to upper-triangular form by
+// Gaussian elimination with partial pivoting.
+// ----------------------------------------------------------------------
+
+// Factors the panel of columns [first,last), which all live in one
+// process column. Returns true if every column had a pivot.
+static bool factor_panel(DistributedSystem& d_sys, int first, int last) {
+  bool nondegenerate = true;
+  int panel_column = d_sys.owner_column(first);
+  bool in_panel = (d_sys.process_column() == panel_column);
+  Dynamic1DArray<double> pivot_row(last - first);
+
+  for (int j = first; j < last; j++) {
+    // Find the pivot. Ties go to the lowest row, just like pivot().
+    int pivot_info[2] = {j, 0}; // The pivot row and whether it's good.
+    if ( in_panel ) {
+      struct { double value; int row; } local_best, best;
+      local_best.value = -1;
+      local_best.row = j;
+      int c = d_sys.local_column(j);
+      for (int l = d_sys.local_rows_before(j); l < d_sys.local_rows(); l++) {
+	double value = abs(d_sys.local_access(l,c));
+	if ( value > local_best.value ) {
+	  local_best.value = value;
+	  local_best.row = d_sys.global_row(l);
+	}
+      }
+      MPI_Allreduce(&local_best,&best,1,MPI_DOUBLE_INT,MPI_MAXLOC,
+		    d_sys.column_communicator());
+      pivot_info[0] = best.row;
+      pivot_info[1] = (best.value > 0);
+    }
+    MPI_Bcast(pivot_info,2,MPI_INT,panel_column,d_sys.row_communicator());
+    if ( !pivot_info[1] ) {
+      nondegenerate = false;
+      continue;
+    }
+    d_sys.swap(j,pivot_info[0]);
+
+    // Scale the column and update the rest of the panel. The pivot
+    // row's share of the panel comes down the process column.
+    if ( in_panel ) {
+      int width = last - j;
+      int c = d_sys.local_column(j);
+      int pivot_owner = d_sys.owner_row(j);
+      if ( d_sys.process_row() == pivot_owner ) {
+	for (int k = 0; k < width; k++) {
+	  pivot_row[k] = d_sys.local_access(d_sys.local_row(j),c + k);
+	}
+      }
+      MPI_Bcast(pivot_row.data(),width,MPI_DOUBLE,pivot_owner,
+		d_sys.column_communicator());
+      for (int l = d_sys.local_rows_before(j+1); l < d_sys.local_rows(); l++) {
+	double* row = &d_sys.local_access(l,c);
+	row[0] /= pivot_row[0];
+	for (int k = 1; k < width; k++) {
+	  row[k] -= row[0]*pivot_row[k];
+	}
+      }
+    }
+  }
+  return nondegenerate;
+}
+
+// Performs the distributed elimination, one panel at a time.
+bool distributed_gaussian_elimination(DistributedSystem& d_sys) {
+  bool nondegenerate = true;
+  int n = d_sys.size();
+  int block = d_sys.block_size();
+
+  for (int first = 0; first < n; first += block) {
+    int last = min(first + block, n);
+    int width = last - first;
+    int panel_column = d_sys.owner_column(first);
+    int panel_row = d_sys.owner_row(first);
+    nondegenerate = factor_panel(d_sys,first,last) && nondegenerate;
+
+    // Broadcast the factored panel along the process rows. Every
+    // process gets the multipliers for its own rows at or below first.
+    int row_start = d_sys.local_rows_before(first);
+    int rows = d_sys.local_rows() - row_start;
+    int panel_count = message_count((size_t)rows*width);
+    Dynamic1DArray<double> panel(panel_count);
+    if ( d_sys.process_column() == panel_column ) {
+      int c = d_sys.local_column(first);
+      for (int l = 0; l < rows; l++) {
+	for (int k = 0; k < width; k++) {
+	  panel[l*width + k] = d_sys.local_access(row_start + l,c + k);
+	}
+      }
+    }
+    if ( panel_count > 0 ) {
+      MPI_Bcast(panel.data(),panel_count,MPI_DOUBLE,panel_column,
+		d_sys.row_communicator());
+    }
+
+    // The rows of U to the right of the panel: A12 = L11^{-1} A12,
+    // then broadcast them down the process columns.
+    int column_start = d_sys.local_columns_before(last);
+    int columns = d_sys.local_columns() - column_start;
+    int u_count = message_count((size_t)width*columns);
+    Dynamic1DArray<double> u_rows(u_count);
+    if ( d_sys.process_row() == panel_row ) {
+      int top = d_sys.local_row(first);
+      for (int r = 0; r < width; r++) {
+	double* target = &d_sys.local_access(top + r,column_start);
+	for (int t = 0; t < r; t++) {
+	  double multiplier = panel[r*width + t];
+	  const double* source = &d_sys.local_access(top + t,column_start);
+	  for (int c = 0; c < columns; c++) {
+	    target[c] -= multiplier*source[c];
+	  }
+	}
+	for (int c = 0; c < columns; c++) {
+	  u_rows[r*columns + c] = target[c];
+	}
+      }
+    }
+    if ( u_count > 0 ) {
+      MPI_Bcast(u_rows.data(),u_count,MPI_DOUBLE,panel_row,
+		d_sys.column_communicator());
+    }
+
+    // The trailing update: A22 = A22 - L21*U12.
+    int trailing_start = d_sys.local_rows_before(last);
+    for (int l = trailing_start; l < d_sys.local_rows(); l++) {
+      const double* multipliers = panel.data() + (l - row_start)*width;
+      double* target = &d_sys.local_access(l,column_start);
+      for (int t = 0; t < width; t++) {
+	const double* source = u_rows.data() + t*columns;
+	for (int c = 0; c < columns; c++) {
+	  target[c] -= multipliers[t]*source[c];
+	}
+      }
+    }
+  }
+  return nondegenerate;
+}
+// ----------------------------------------------------------------------
+
+
+// Performs back substitution on a distributed system.
+// ----------------------------------------------------------------------
+Dynamic1DArray<double> distributed_back_substitution(DistributedSystem& d_sys) {
+  int n = d_sys.size();
+  int block = d_sys.block_size();
+  Dynamic1DArray<double> output(n);
+
+  // partial[l] holds sum_j U(l,j) x_j - b_l over the x_j found so far.
+  Dynamic1DArray<double> partial(d_sys.local_rows());
+  for (int l = 0; l < d_sys.local_rows(); l++) {
+    partial[l] = 0;
+  }
+  if ( d_sys.process_column() == d_sys.owner_column(n) ) {
+    int c = d_sys.local_column(n);
+    for (int l = 0; l < d_sys.local_rows(); l++) {
+      partial[l] = -d_sys.local_access(l,c);
+    }
+  }
+
+  Dynamic1DArray<double> sums(block);
+  Dynamic1DArray<double> totals(block);
+  for (int first = ((n-1)/block)*block; first >= 0; first -= block) {
+    int last = min(first + block, n);
+    int width = last - first;
+    int diagonal_row = d_sys.owner_row(first);
+    int diagonal_column = d_sys.owner_column(first);
+
+    // Collect the partial sums for this block on the diagonal owner.
+    if ( d_sys.process_row() == diagonal_row ) {
+      int top = d_sys.local_row(first);
+      for (int t = 0; t < width; t++) {
+	sums[t] = partial[top + t];
+      }
+      MPI_Reduce(sums.data(),totals.data(),width,MPI_DOUBLE,MPI_SUM,
+		 diagonal_column,d_sys.row_communicator());
+      // Solve the diagonal block.
+      if ( d_sys.process_column() == diagonal_column ) {
+	int left = d_sys.local_column(first);
+	for (int t = width-1; t >= 0; t--) {
+	  double value = -totals[t];
+	  for (int s = t+1; s < width; s++) {
+	    value -= d_sys.local_access(top + t,left + s)*output[first + s];
+	  }
+	  double diagonal = d_sys.local_access(top + t,left + t);
+	  // Checks for non-degeneracy.
+	  assert ( abs(diagonal) > DBL_EPSILON
+		   && "The matrix is non-degenerate." );
+	  output[first + t] = value/diagonal;
+	}
+      }
+    }
+    MPI_Bcast(output.data() + first,width,MPI_DOUBLE,
+	      d_sys.grid_rank(diagonal_row,diagonal_column),d_sys.grid());
+
+    // Fold the new unknowns into the partial sums of the rows above.
+    if ( d_sys.process_column() == diagonal_column ) {
+      int left = d_sys.local_column(first);
+      int rows_above = d_sys.local_rows_before(first);
+      for (int l = 0; l < rows_above; l++) {
+	for (int s = 0; s < width; s++) {
+	  partial[l] += d_sys.local_access(l,left + s)*output[first + s];
+	}
+      }
+    }
+  }
+  return output;
+}
+// ----------------------------------------------------------------------
+
+
+// Solves g_sys over the processes in comm.
+// ----------------------------------------------------------------------
+Dynamic1DArray<double> distributed_solve_system(const GaussianSystem& g_sys,
+						MPI_Comm comm,
+						int block_size/*= 64*/,
+						int root/*= 0*/) {
+  int rank;
+  MPI_Comm_rank(comm,&rank);
+  int n = (rank == root) ? g_sys.size() : 0;
+  MPI_Bcast(&n,1,MPI_INT,root,comm);
+
+  DistributedSystem d_sys(comm,n,block_size);
+  d_sys.scatter(g_sys,root);
+  Dynamic1DArray<double> output(0);
+  if ( distributed_gaussian_elimination(d_sys) ) {
+    output = distributed_back_substitution(d_sys);
+  } else if ( rank == root ) {
+    cout << "Matrix degenerate and back substitution not possible."
+	 << endl;
+  }
+  return output;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,192 @@
+// distributed_elimination.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 23:12:05 (jonah)>
+
+// This file prototypes the distributed-memory Gaussian elimination
+// library. A system too big for one node is spread over a PxQ grid of
+// MPI processes in a 2D block-cyclic layout and solved in place.
+
+// This library is designed to be used with the gaussian_system data
+// structure. Build it with an MPI compiler wrapper such as mpicxx.
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <mpi.h>
+#include <functional>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// A Gaussian system distributed over a PxQ process grid. The
+// augmented matrix [A|b] is cut into block_size x block_size blocks,
+// and block (I,J) lives on process (I mod P, J mod Q). The knowns
+// vector is just the last column of the augmented matrix, so row
+// swaps and updates apply to it for free.
+class DistributedSystem {
+public: // Constructors and destructors.
+  // Creates an empty distributed nxn system over the processes in
+  // comm. The grid is grid_rows x grid_columns. If either is zero,
+  // picks the grid closest to square. Every process in comm must
+  // call this with the same arguments. If local_memory is given, this
+  // process's piece is kept there, packed row-major, instead of in
+  // memory of its own. It must hold local_cells() doubles and outlive
+  // the system, and it isn't cleared.
+  DistributedSystem(MPI_Comm comm, int n, int block_size = 64,
+		    int grid_rows = 0, int grid_columns = 0,
+		    double* local_memory = NULL);
+  // Returns the communicators to MPI.
+  ~DistributedSystem();
+  // The number of elements of the piece this process would hold of
+  // the system built from the same arguments.
+  static size_t local_cells(MPI_Comm comm, int n, int block_size = 64,
+			    int grid_rows = 0, int grid_columns = 0);
+private: // Communicators can't be copied sensibly.
+  DistributedSystem(const DistributedSystem &rhs);
+  DistributedSystem& operator = (const DistributedSystem &rhs);
+
+private: // Implementation details.
+  int system_size; // The system is system_size x system_size.
+  int block; // The blocks are block x block.
+  int grid_rows; // P
+  int grid_columns; // Q
+  int my_row; // This process's row in the grid.
+  int my_column; // This process's column in the grid.
+  MPI_Comm grid_comm; // Every process in the grid.
+  MPI_Comm row_comm; // The processes in my grid row. Rank = column.
+  MPI_Comm column_comm; // The processes in my grid column. Rank = row.
+  // The part of the augmented matrix stored here. Local rows and
+  // columns are in increasing global order.
+  Dynamic2DArray<double> local_matrix;
+
+public: // Index arithmetic for the block-cyclic layout.
+  // Gives n, where the system has n equations and n unknowns.
+  int size() const {
+    return system_size;
+  }
+  // The block size of the layout.
+  int block_size() const {
+    return block;
+  }
+  // The number of process rows, P.
+  int process_rows() const {
+    return grid_rows;
+  }
+  // The number of process columns, Q.
+  int process_columns() const {
+    return grid_columns;
+  }
+  // This process's row and column in the grid.
+  int process_row() const {
+    return my_row;
+  }
+  int process_column() const {
+    return my_column;
+  }
+  // The grid row that owns global row i.
+  int owner_row(int i) const {
+    return (i/block) % grid_rows;
+  }
+  // The grid column that owns global column j. j = size() is the
+  // knowns vector.
+  int owner_column(int j) const {
+    return (j/block) % grid_columns;
+  }
+  // The rank in grid_comm of the process at (row,column).
+  int grid_rank(int row, int column) const {
+    return row*grid_columns + column;
+  }
+  // Local index of global row i. Only meaningful on its owner.
+  int local_row(int i) const {
+    return (i/(block*grid_rows))*block + i % block;
+  }
+  // Local index of global column j. Only meaningful on its owner.
+  int local_column(int j) const {
+    return (j/(block*grid_columns))*block + j % block;
+  }
+  // Global index of local row l.
+  int global_row(int l) const {
+    return ((l/block)*grid_rows + my_row)*block + l % block;
+  }
+  // Global index of local column l.
+  int global_column(int l) const {
+    return ((l/block)*grid_columns + my_column)*block + l % block;
+  }
+  // The number of local rows whose global index is below i. This is
+  // also the local index of the first local row at or below i.
+  int local_rows_before(int i) const;
+  // Like local_rows_before, but for columns.
+  int local_columns_before(int j) const;
+  // The number of rows and columns stored on this process.
+  int local_rows() const {
+    return local_matrix.height();
+  }
+  int local_columns() const {
+    return local_matrix.width();
+  }
+  // Returns the local (l,c) element of the augmented matrix by
+  // reference. Not bounds checked.
+  double& local_access(int l, int c) {
+    return local_matrix.data()[(ptrdiff_t)l*local_matrix.row_stride() + c];
+  }
+  // Gives the communicators of the grid.
+  MPI_Comm grid() const {
+    return grid_comm;
+  }
+  MPI_Comm row_communicator() const {
+    return row_comm;
+  }
+  MPI_Comm column_communicator() const {
+    return column_comm;
+  }
+
+public: // Interface.
+  // Sends the pieces of g_sys from the process root to their
+  // owners. g_sys is only read on root.
+  void scatter(const GaussianSystem& g_sys, int root = 0);
+  // Fills the system without ever holding it on one process. entry
+  // gives the (i,j)th element of the augmented matrix; j = size() is
+  // the knowns vector. Each process only asks for what it owns.
+  void fill(const function<double(int,int)>& entry);
+  // Swaps global rows row1 and row2 across the whole grid. Every
+  // process must call this.
+  void swap(int row1, int row2);
+};
+
+
+// Reduces the distributed system to upper-triangular form by
+// Gaussian elimination with partial pivoting. Pivots are found by a
+// reduction down the process column that owns the current column,
+// broadcast along process rows, and swapped across the grid. Each
+// factored panel is broadcast along process rows and the matching
+// rows of U along process columns before the trailing update. Uses
+// the same pivot rule as pivot(). Returns true on every process if
+// back substitution is possible.
+bool distributed_gaussian_elimination(DistributedSystem& d_sys);
+
+
+// Performs back substitution on a distributed system that has been
+// through distributed_gaussian_elimination. Walks the diagonal blocks
+// from the bottom up. Each block's partial sums are reduced along its
+// process row, solved by the diagonal owner and broadcast. Returns
+// the solution on every process. Assumes the system is
+// non-degenerate. If it is degenerate, raises an error.
+Dynamic1DArray<double> distributed_back_substitution(DistributedSystem& d_sys);
+
+
+// Solves g_sys over the processes in comm. g_sys is only read on
+// root. Returns the solution on every process. Like solve_system, if
+// the system is degenerate, says so on root and returns an empty
+// vector.
+Dynamic1DArray<double> distributed_solve_system(const GaussianSystem& g_sys,
+						MPI_Comm comm,
+						int block_size = 64,
+						int root = 0);
@@ -0,0 +1,185 @@
+// distributed_elimination_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 23:15:30 (jonah)>
+
+// This file tests the distributed elimination library against the
+// serial solve_system(). Run it under MPI, i.e.,
+//     mpirun -np 4 ./distributed_elimination_test_driver.bin
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <climits>
+#include <float.h>
+#include <mpi.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "distributed_elimination.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The (i,j)th element of a made-up system. Deterministic, so every
+// process can generate its own piece.
+static double made_up_entry(int i, int j) {
+  return sin(1.0 + 3*i + 7*j) + ((i == j) ? 0.5 : 0.0);
+}
+
+// Compares a distributed solution against the serial one on root.
+static void compare(const GaussianSystem& original,
+		    const Dynamic1DArray<double>& distributed, int rank) {
+  if ( rank != 0 ) {
+    return;
+  }
+  GaussianSystem serial = original;
+  Dynamic1DArray<double> expected = solve_system(serial);
+  double difference = 0;
+  for (int i = 0; i < expected.length(); i++) {
+    difference = max(difference,abs(expected[i] - distributed.get(i)));
+  }
+  cout << "The largest difference from the serial solution is "
+       << difference << endl;
+  assert( difference < 1E-10 && "Distributed and serial solutions agree." );
+}
+
+// Reserves bytes of address space backed by only chunk bytes of
+// memory, mapped over and over, so a piece far bigger than the
+// machine can be written end to end. Later writes land on earlier
+// ones. Returns NULL if the system won't hand it out.
+static double* reserve_aliased_space(size_t bytes, size_t chunk) {
+#ifdef __linux__
+  bytes = (bytes + chunk - 1)/chunk*chunk;
+  int file = memfd_create("distributed_test",0);
+  if ( file < 0 || ftruncate(file,chunk) != 0 ) {
+    return NULL;
+  }
+  void* memory = mmap(NULL,bytes,PROT_NONE,
+		      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,-1,0);
+  bool mapped = memory != MAP_FAILED;
+  for (size_t offset = 0; mapped && offset < bytes; offset += chunk) {
+    mapped = mmap((char*)memory + offset,chunk,PROT_READ | PROT_WRITE,
+		  MAP_SHARED | MAP_FIXED,file,0) != MAP_FAILED;
+  }
+  close(file);
+  if ( memory != MAP_FAILED && !mapped ) {
+    munmap(memory,bytes);
+  }
+  return mapped ? (double*)memory : NULL;
+#else
+  return NULL;
+#endif
+}
+// ----------------------------------------------------------------------
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+  MPI_Init(&argc,&argv);
+  int rank, processes;
+  MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+  MPI_Comm_size(MPI_COMM_WORLD,&processes);
+
+  if ( rank == 0 ) {
+    cout << "Testing the distributed_elimination library on "
+	 << processes << " processes.\n"
+	 << "BEGIN." << endl;
+    cout << "\nWe will first solve the extremely simple 2x2 system:"
+	 << endl;
+  }
+  GaussianSystem testing1;
+  if ( rank == 0 ) {
+    ifstream infile;
+    infile.open("test_system.txt");
+    infile >> testing1;
+    testing1.print(cout,0);
+  }
+  Dynamic1DArray<double> solution1
+    = distributed_solve_system(testing1,MPI_COMM_WORLD,1);
+  if ( rank == 0 ) {
+    cout << "Got it! The solution is:" << endl;
+    print_solution(cout,solution1,DBL_EPSILON);
+  }
+  compare(testing1,solution1,rank);
+
+  if ( rank == 0 ) {
+    cout << "\n\nNow a 37x37 system in 4x4 blocks, scattered from root."
+	 << endl;
+  }
+  int testing2_size = 37;
+  GaussianSystem testing2;
+  if ( rank == 0 ) {
+    testing2 = GaussianSystem(testing2_size);
+    for (int i = 0; i < testing2_size; i++) {
+      for (int j = 0; j <= testing2_size; j++) {
+	testing2.set(i,j,made_up_entry(i,j));
+      }
+    }
+  }
+  Dynamic1DArray<double> solution2
+    = distributed_solve_system(testing2,MPI_COMM_WORLD,4);
+  compare(testing2,solution2,rank);
+
+  if ( rank == 0 ) {
+    cout << "\n\nNow the same system built in place with fill()." << endl;
+  }
+  { // The system has to be gone before MPI_Finalize.
+    DistributedSystem testing3(MPI_COMM_WORLD,testing2_size,4);
+    testing3.fill(made_up_entry);
+    if ( rank == 0 ) {
+      cout << "The process grid is " << testing3.process_rows()
+	     << "x" << testing3.process_columns() << "." << endl;
+    }
+    bool nondegenerate = distributed_gaussian_elimination(testing3);
+    assert( nondegenerate && "The system is non-degenerate." );
+    Dynamic1DArray<double> solution3 = distributed_back_substitution(testing3);
+    compare(testing2,solution3,rank);
+  }
+
+  if ( rank == 0 ) {
+    cout << "\n\nFilling a local piece past the old 32-bit limit." << endl;
+    // On one process the piece is n x (n+1), which doesn't fit in an
+    // int. Only the last rows are checked, since nothing is written
+    // over them.
+    const int n = 46341;
+    size_t cells = DistributedSystem::local_cells(MPI_COMM_SELF,n,64,1,1);
+    assert( cells > (size_t)INT_MAX && "The piece is past 2^31 cells." );
+    size_t bytes = cells*sizeof(double);
+    size_t chunk = (size_t)1 << 26;
+    double* big_piece = reserve_aliased_space(bytes,chunk);
+    if ( big_piece == NULL ) {
+      cout << "This machine won't reserve " << bytes << " bytes. Skipping."
+	   << endl;
+    } else {
+      DistributedSystem big(MPI_COMM_SELF,n,64,1,1,big_piece);
+      big.fill([](int i, int j) { return 65536.0*i + j; });
+      assert( &big.local_access(n - 1,n) == big_piece + cells - 1
+	      && big.local_access(n - 1,n) == 65536.0*(n - 1) + n
+	      && big.local_access(n - 2,3) == 65536.0*(n - 2) + 3
+	      && "Rows past 2^31 cells are where they should be." );
+      big.swap(n - 2,n - 1);
+      assert( big.local_access(n - 1,3) == 65536.0*(n - 2) + 3
+	      && big.local_access(n - 2,n) == 65536.0*(n - 1) + n
+	      && "Rows past 2^31 cells are swapped." );
+      munmap(big_piece,(bytes + chunk - 1)/chunk*chunk);
+    }
+  }
+
+  if ( rank == 0 ) {
+    cout << "\n\nThis concludes the test." << endl;
+  }
+  MPI_Finalize();
+  return 0;
+}
+// ----------------------------------------------------------------------
@@ -6,66 +6,208 @@
 // This file defines a library for using dynamic arrays of one and two
 // dimensions. Useful for Gaussian Elimination.
 
+// Arrays normally own their memory. They can also be views of memory
+// someone else owns, such as the buffers of a simulation, so that
+// big problems don't have to be copied in element by element. A view
+// never frees its memory. Copying a view, by copy constructor or
+// assignment, makes an ordinary array that owns a copy.
+
+// Lengths, cell counts, strides and offsets are 64-bit, ptrdiff_t
+// or size_t, so an array can hold more than 2^31 elements. The
+// dimensions of a 2D array are still ints.
+
 // Include guard
 #pragma once
 
 #include<cstdlib>
+#include<cstddef> // for ptrdiff_t
+#include<cstdint> // for PTRDIFF_MAX
+#include<new> // for bad_array_new_length
 #include<iostream> // streams needed for print functions
+#include<type_traits>
+#include<cassert>
+#include<utility> // for swap
+#include<functional> // for less
+#include "memory_placement.hpp" // for placing big 2D arrays
 using namespace std;
 
+// How the elements of a 2D view are laid out in memory.
+enum ArrayLayout {
+  ROW_MAJOR, // Rows are contiguous, like an ordinary Dynamic2DArray.
+  COLUMN_MAJOR // Columns are contiguous, like Fortran.
+};
+
+// The base of every vector expression in array_algebra.hpp, such as
+// a + b or A*x. A Dynamic1DArray is one too, so arrays and
+// expressions mix freely. An expression knows its length() and
+// computes its ith element with value_at(i) only when asked.
+template<typename EXPRESSION>
+class VectorExpression {
+public:
+  const EXPRESSION& self() const {
+    return static_cast<const EXPRESSION&>(*this);
+  }
+};
+
 // A class for 1-dimensional dynamic arrays.
 template<typename TYPE>
-class Dynamic1DArray {
+class Dynamic1DArray : public VectorExpression<Dynamic1DArray<TYPE> > {
 public: // constructors, destructors, and assignment operators
   // Generates an empty dynamic 1D array of length l.
-  Dynamic1DArray(int l) {
+  Dynamic1DArray(ptrdiff_t l) {
     array_length = l;
+    my_array = NULL;
+    owns_memory = true;
     if (array_length > 0) {
       my_array = new TYPE[l];
     }
   }
   // Allows the user to generate an empty dynamic 1D array.
   Dynamic1DArray() {
+    my_array = NULL;
     array_length = 0;
+    owns_memory = true;
+  }
+  // Generates a view of the l elements starting at external. The
+  // memory must outlive the view, and is never freed by it.
+  Dynamic1DArray(TYPE* external, ptrdiff_t l) {
+    my_array = external;
+    array_length = l;
+    owns_memory = false;
   }
   // Copy constructor. Generates an exact copy of the input dynamic array.
   Dynamic1DArray(const Dynamic1DArray<TYPE> &rhs) {
     array_length = rhs.length();
+    my_array = NULL;
+    owns_memory = true;
     if (array_length > 0) {
       my_array = new TYPE[array_length];
-      for (int i = 0; i < array_length; i++) {
+      for (ptrdiff_t i = 0; i < array_length; i++) {
 	set(i,rhs.get(i));
       }
     }
   }
   // Destructor. Returns all dynamic memory used by the object to the heap.
   ~Dynamic1DArray() {
-    if (array_length > 0) {
+    if (owns_memory && array_length > 0) {
       delete [] my_array;
     }
   }
-  // Assignment operator. Copies one Dynamic1DArray into another.
+  // Assignment operator. Copies one Dynamic1DArray into another. If
+  // the lengths match, the elements are copied in place, so a view
+  // writes into the memory it views, just as assigning an expression
+  // does. Otherwise this array lets go of what it held, view or not,
+  // and owns the copy. Use reset() first to detach a view.
   Dynamic1DArray<TYPE>& operator = (const Dynamic1DArray<TYPE> &rhs) {
-    if (array_length > 0) {
+    if (this == &rhs) {
+      return *this;
+    }
+    if (rhs.length() == array_length) {
+      if (rhs.mixes_elements_of(my_array,my_array + array_length)) {
+	Dynamic1DArray<TYPE> copy(rhs);
+	evaluate(copy);
+      } else {
+	evaluate(rhs);
+      }
+      return *this;
+    }
+    if (owns_memory && array_length > 0) {
       delete [] my_array;
     }
     array_length = rhs.length();
+    my_array = NULL;
+    owns_memory = true;
     if (array_length > 0) {
       my_array = new TYPE[array_length];
-      for (int i = 0; i < array_length; i++) {
+      for (ptrdiff_t i = 0; i < array_length; i++) {
 	set(i,rhs.get(i));
       }
     }
     return *this;
   }
+  // Evaluates a vector expression, like b - A*x, into a new array in
+  // a single pass.
+  template<typename EXPRESSION>
+  Dynamic1DArray(const VectorExpression<EXPRESSION> &rhs) {
+    array_length = 0;
+    my_array = NULL;
+    owns_memory = true;
+    *this = rhs;
+  }
+  // Evaluates a vector expression into this array in a single pass,
+  // with no temporaries. If the lengths match, the elements are
+  // written in place, so a view writes into the memory it views. If
+  // the expression reads this array in a way that writing in place
+  // would spoil, such as x = A*x, it is evaluated into a temporary
+  // first.
+  template<typename EXPRESSION>
+  Dynamic1DArray<TYPE>& operator = (const VectorExpression<EXPRESSION> &rhs) {
+    const EXPRESSION& expression = rhs.self();
+    ptrdiff_t l = expression.length();
+    if ( l != array_length ) {
+      Dynamic1DArray<TYPE> output(l);
+      output.evaluate(expression);
+      swap(output);
+    } else if ( expression.mixes_elements_of(my_array,
+					     my_array + array_length) ) {
+      Dynamic1DArray<TYPE> output(l);
+      output.evaluate(expression);
+      evaluate(output);
+    } else {
+      evaluate(expression);
+    }
+    return *this;
+  }
+  // Adds a vector expression to this array, element by element.
+  template<typename EXPRESSION>
+  Dynamic1DArray<TYPE>& operator += (const VectorExpression<EXPRESSION> &rhs) {
+    const EXPRESSION& expression = rhs.self();
+    assert( expression.length() == array_length
+	    && "The vectors are the same length." );
+    if ( expression.mixes_elements_of(my_array,my_array + array_length) ) {
+      Dynamic1DArray<TYPE> copy(expression);
+      return *this += copy;
+    }
+    for (ptrdiff_t i = 0; i < array_length; i++) {
+      my_array[i] += expression.value_at(i);
+    }
+    return *this;
+  }
+  // Subtracts a vector expression from this array, element by
+  // element.
+  template<typename EXPRESSION>
+  Dynamic1DArray<TYPE>& operator -= (const VectorExpression<EXPRESSION> &rhs) {
+    const EXPRESSION& expression = rhs.self();
+    assert( expression.length() == array_length
+	    && "The vectors are the same length." );
+    if ( expression.mixes_elements_of(my_array,my_array + array_length) ) {
+      Dynamic1DArray<TYPE> copy(expression);
+      return *this -= copy;
+    }
+    for (ptrdiff_t i = 0; i < array_length; i++) {
+      my_array[i] -= expression.value_at(i);
+    }
+    return *this;
+  }
 private:
+  // Writes every element of an expression of the same length into
+  // the array.
+  template<typename EXPRESSION>
+  void evaluate(const EXPRESSION& expression) {
+    TYPE* output = my_array;
+    for (ptrdiff_t i = 0; i < array_length; i++) {
+      output[i] = expression.value_at(i);
+    }
+  }
   // The pointer to the dynamic array.
   TYPE * my_array;
   // The length of the array. If 0, the array is uninitialized.
-  int array_length;
+  ptrdiff_t array_length;
+  // False for a view of someone else's memory.
+  bool owns_memory;
   // Test whether integer n is between 0 and the length of the
   // array. If not, throw an exception.
-  void test_allocation(int n) const {
+  void test_allocation(ptrdiff_t n) const {
     if ( n >= array_length || n < 0 ) {
       cout << "You've accessed memory out of the array.\n"
 	   << "The element you've accessed was: " << n << ".\n"
@@ -76,45 +218,85 @@ private:
     
 public:
   // This function gives the length of the array.
-  int length() const {
+  ptrdiff_t length() const {
     return array_length;
   }
+  // Whether the array is a view of memory it doesn't own.
+  bool is_view() const {
+    return !owns_memory;
+  }
   // This function returns the nth element of the array. Not passed by
   // reference. Prevents reading from the wrong memory areas.
-  TYPE get(int n) const {
+  TYPE get(ptrdiff_t n) const {
     test_allocation(n);
     return my_array[n];
   }
   // This function sets the nth element of the array to t. Prevents
   // writing to the wrong memory areas.
-  void set(int n, TYPE t) {
+  void set(ptrdiff_t n, TYPE t) {
     test_allocation(n);
     my_array[n] = t;
   }
   // This function returns the nth element of the array by reference.
-  TYPE& access(int n) {
+  TYPE& access(ptrdiff_t n) {
     test_allocation(n);
     return my_array[n];
   }
   // Syntactic sugar for the access method.
-  TYPE& operator [] (int n) {
+  TYPE& operator [] (ptrdiff_t n) {
     return access(n);
   }
+  // Returns a pointer to the first element of the array. Useful for
+  // handing the array to a fast kernel. No bounds checking, so use
+  // with care.
+  TYPE* data() {
+    return my_array;
+  }
+  const TYPE* data() const {
+    return my_array;
+  }
+  // The element type, and unchecked access to the nth element, for
+  // vector expressions.
+  typedef TYPE value_type;
+  TYPE value_at(ptrdiff_t n) const {
+    return my_array[n];
+  }
+  // Whether writing the memory from begin to end element by element
+  // could change an element of this array before it is read. True
+  // when the memory overlaps the array without lining up with it
+  // exactly, as two views of the same buffer can.
+  bool mixes_elements_of(const void* begin, const void* end) const {
+    const char* first = (const char*)my_array;
+    const char* last = (const char*)(my_array + array_length);
+    return array_length > 0 && first != (const char*)begin
+      && less<const char*>()(first,(const char*)end)
+      && less<const char*>()((const char*)begin,last);
+  }
   
-  // Clears out the array and resets its length to l.
-  void reset(int l) {
-    if (array_length > 0) {
+  // Clears out the array and resets its length to l. A view lets go
+  // of the viewed memory.
+  void reset(ptrdiff_t l) {
+    if (owns_memory && array_length > 0) {
       delete [] my_array;
     }
     array_length = l;
+    my_array = NULL;
+    owns_memory = true;
     if (array_length > 0) {
       my_array = new TYPE[l];
     }
   }
+  // Exchanges the contents of two arrays, views or not, without
+  // copying any elements.
+  void swap(Dynamic1DArray<TYPE>& other) {
+    std::swap(my_array,other.my_array);
+    std::swap(array_length,other.array_length);
+    std::swap(owns_memory,other.owns_memory);
+  }
   // Prints out the array as a 1D row vector.
   void print(ostream& s = cout) const {
     s << "[";
-    for (int i=0; i < length()-1; i++) {
+    for (ptrdiff_t i=0; i < length()-1; i++) {
       s << get(i) << ", ";
     }
     s << get(length()-1) << "]";
@@ -135,25 +317,63 @@ public: // constructors, assignment operator, and destructors.
   Dynamic2DArray(int i, int j) {
     array_height = i;
     array_width = j;
-    array_cell_number = array_height * array_width;
-    if (array_cell_number > 0) {
-      my_array = new TYPE [array_cell_number];
+    array_cell_number = count_cells(array_height,array_width);
+    allocate(MemoryPlacement());
+  }
+  // Generates a view of an array of height i and width j that starts
+  // at external. leading_dimension is the distance between
+  // consecutive rows for ROW_MAJOR, or consecutive columns for
+  // COLUMN_MAJOR, so a view can be a block of a bigger array. The
+  // memory must outlive the view, and is never freed by it.
+  Dynamic2DArray(TYPE* external, int i, int j, ptrdiff_t leading_dimension,
+		 ArrayLayout layout = ROW_MAJOR) {
+    array_height = i;
+    array_width = j;
+    array_cell_number = count_cells(array_height,array_width);
+    if (layout == ROW_MAJOR) {
+      assert( leading_dimension >= j && "Rows don't overlap." );
+      row_step = leading_dimension;
+      column_step = 1;
+    } else {
+      assert( leading_dimension >= i && "Columns don't overlap." );
+      row_step = 1;
+      column_step = leading_dimension;
     }
+    my_array = external;
+    mapped_bytes = 0;
+    owns_memory = false;
+  }
+  // Generates an array of width i and height j, placed in memory as
+  // placement asks. See memory_placement.hpp. The elements start out
+  // zero. Only for plain types like double, since no constructors
+  // are run. Falls back on new[] if the placement can't be had.
+  Dynamic2DArray(int i, int j, const MemoryPlacement& placement) {
+    static_assert(is_trivially_copyable<TYPE>::value,
+		  "Only plain types can be placed.");
+    array_height = i;
+    array_width = j;
+    array_cell_number = count_cells(array_height,array_width);
+    allocate(placement,true);
   }
   // Default constructor. Allows the user to generate an uninitialized
   // dynamic 2D array.
   Dynamic2DArray() {
     array_height = 0;
     array_width = 0;
-    array_cell_number = array_height * array_width;
+    array_cell_number = count_cells(array_height,array_width);
+    my_array = NULL;
+    mapped_bytes = 0;
+    row_step = 0;
+    column_step = 1;
+    owns_memory = true;
   }
   // Copy constructor. Generates an exact copy of another array.
   Dynamic2DArray(const Dynamic2DArray<TYPE> &rhs) {
     array_width = rhs.width();
     array_height = rhs.height();
-    array_cell_number = array_width * array_height;
+    array_cell_number = count_cells(array_height,array_width);
+    allocate(MemoryPlacement());
     if (array_cell_number > 0) {
-      my_array = new TYPE [array_cell_number];
       for (int row = 0; row < array_height; row++) {
 	for (int column = 0; column < array_width; column++) {
 	  set(row,column,rhs.get(row,column));
@@ -163,20 +383,21 @@ public: // constructors, assignment operator, and destructors.
   }
   // Returns all dynamic memory to the heap.
   ~Dynamic2DArray() {
-    if (array_cell_number > 0) {
-      delete[] my_array;
-    }
+    release();
   }
-  // Assignment operator. Copies one object into another.
+  // Assignment operator. Copies one object into another. If this
+  // array was a view, it lets go of the viewed memory and owns the
+  // copy.
   Dynamic2DArray<TYPE>& operator = (const Dynamic2DArray<TYPE> &rhs) {
-    if (array_cell_number > 0) {
-      delete [] my_array;
+    if (this == &rhs) {
+      return *this;
     }
+    release();
     array_width = rhs.width();
     array_height = rhs.height();
-    array_cell_number = array_width * array_height;
+    array_cell_number = count_cells(array_height,array_width);
+    allocate(MemoryPlacement());
     if (array_cell_number > 0) {
-      my_array = new TYPE [array_cell_number];
       for (int row = 0; row < array_height; row++) {
 	for (int column = 0; column < array_width; column++) {
 	  set(row,column,rhs.get(row,column));
@@ -194,7 +415,59 @@ private:
   int array_width;
   // The array has a number of cells equal to the width times the
   // height. If this value is zero, the array is empty.
-  int array_cell_number;
+  size_t array_cell_number;
+  // The length of the mapping behind a placed array. Zero if the
+  // array came from new[].
+  size_t mapped_bytes;
+  // The distances in memory between consecutive rows and consecutive
+  // columns. An array that owns its memory is always packed row-major,
+  // width() and 1.
+  ptrdiff_t row_step;
+  ptrdiff_t column_step;
+  // False for a view of someone else's memory.
+  bool owns_memory;
+  // Allocates my_array for array_cell_number elements. If zero is
+  // set, they start out zero wherever the memory comes from.
+  void allocate(const MemoryPlacement& placement, bool zero = false) {
+    my_array = NULL;
+    mapped_bytes = 0;
+    row_step = array_width;
+    column_step = 1;
+    owns_memory = true;
+    if (array_cell_number > 0) {
+      my_array = (TYPE*)placed_allocate(array_cell_number*sizeof(TYPE),
+					array_width*sizeof(TYPE),
+					placement,mapped_bytes);
+      if (my_array == NULL && zero) {
+	my_array = new TYPE [array_cell_number]();
+      } else if (my_array == NULL) {
+	my_array = new TYPE [array_cell_number];
+      }
+    }
+  }
+  // Returns my_array to wherever it came from.
+  void release() {
+    if (!owns_memory) {
+      // Not ours to free.
+    } else if (mapped_bytes > 0) {
+      placed_release(my_array,mapped_bytes);
+    } else if (array_cell_number > 0) {
+      delete [] my_array;
+    }
+    my_array = NULL;
+    mapped_bytes = 0;
+  }
+  // The number of cells in an i x j array. Checked, since the product
+  // of two ints overflows an int past 46340 x 46340. Throws
+  // bad_array_new_length, as new[] does, if the dimensions are
+  // negative or the array would be too big to index.
+  static size_t count_cells(int i, int j) {
+    if ( i < 0 || j < 0 || (j > 0 && (size_t)i
+			    > (size_t)PTRDIFF_MAX/sizeof(TYPE)/(size_t)j) ) {
+      throw bad_array_new_length();
+    }
+    return (size_t)i*(size_t)j;
+  }
   // Test whether coordinates are valid.
   void test_allocation(int i, int j) const {
     if ( i >= array_height || j >= array_width || i < 0 || j < 0 ) {
@@ -206,9 +479,9 @@ private:
     }
   }
   // Convert row,column coordinates into a cell index for the 1-dimensional array.
-  int to_1d_index(int i, int j) const {
+  ptrdiff_t to_1d_index(int i, int j) const {
     test_allocation(i,j); // ensure the coordinates are valid.
-    return i*array_width + j;
+    return i*row_step + j*column_step;
   }
 public:
   // This function gives the width of the array.
@@ -220,9 +493,26 @@ public:
     return array_height;
   }
   // This function returns the number of elements the array can contain.
-  int cell_number() const {
+  size_t cell_number() const {
     return array_cell_number;
   }
+  // Whether the array is a view of memory it doesn't own.
+  bool is_view() const {
+    return !owns_memory;
+  }
+  // The distance in memory between consecutive rows.
+  ptrdiff_t row_stride() const {
+    return row_step;
+  }
+  // The distance in memory between consecutive columns.
+  ptrdiff_t column_stride() const {
+    return column_step;
+  }
+  // Whether the elements are packed row-major, with rows contiguous
+  // and width() elements apart.
+  bool is_packed() const {
+    return column_step == 1 && row_step == array_width;
+  }
   // This function returns the (i,j)th element of the array. Not
   // passed by reference. Prevents reading from the wrong memory
   // areas.
@@ -248,18 +538,76 @@ public:
     test_allocation(i,j);
     return my_array[to_1d_index(i,j)];
   }
+  // Returns a pointer to the first element of the array. Rows are
+  // stored contiguously, width() elements apart, unless this is a
+  // view that isn't packed. See pack(). Useful for handing the array
+  // to a fast kernel. No bounds checking, so use with care.
+  TYPE* data() {
+    return my_array;
+  }
+  const TYPE* data() const {
+    return my_array;
+  }
 
   // Clears out the array and resets its dimensions to (i,j).
   void reset(int i, int j) {
-    if (array_cell_number > 0) {
-      delete [] my_array;
-    }
+    release();
     array_height = i;
     array_width = j;
-    array_cell_number = array_width * array_height;
-    if (array_cell_number > 0) {
-      my_array = new TYPE [array_cell_number];
+    array_cell_number = count_cells(array_height,array_width);
+    allocate(MemoryPlacement());
+  }
+  // Like reset, but places the new array as placement asks. See the
+  // placement constructor.
+  void reset(int i, int j, const MemoryPlacement& placement) {
+    static_assert(is_trivially_copyable<TYPE>::value,
+		  "Only plain types can be placed.");
+    release();
+    array_height = i;
+    array_width = j;
+    array_cell_number = count_cells(array_height,array_width);
+    allocate(placement,true);
+  }
+  // Rearranges the elements of a view in place, in the memory it
+  // already has, so that it is packed row-major. Column-major views
+  // are transposed, which needs a square array. Afterwards the view
+  // uses the first cell_number() elements of its memory.
+  void pack() {
+    if (is_packed()) {
+      return;
     }
+    if (row_step == 1 && column_step != 1) {
+      assert( array_height == array_width
+	      && "Only square column-major views can be packed." );
+      // Transpose in place: (i,j) now lives where (j,i) was.
+      for (int i = 0; i < array_height; i++) {
+	for (int j = i + 1; j < array_width; j++) {
+	  std::swap(my_array[i + j*column_step],my_array[j + i*column_step]);
+	}
+      }
+      row_step = column_step;
+      column_step = 1;
+    }
+    // Slide the rows together. Each row moves down in memory, and
+    // never onto a row that hasn't moved yet.
+    for (int i = 1; i < array_height; i++) {
+      for (int j = 0; j < array_width; j++) {
+	my_array[(ptrdiff_t)i*array_width + j] = my_array[i*row_step + j];
+      }
+    }
+    row_step = array_width;
+  }
+  // Exchanges the contents of two arrays, views or not, without
+  // copying any elements.
+  void swap(Dynamic2DArray<TYPE>& other) {
+    std::swap(my_array,other.my_array);
+    std::swap(array_height,other.array_height);
+    std::swap(array_width,other.array_width);
+    std::swap(array_cell_number,other.array_cell_number);
+    std::swap(mapped_bytes,other.mapped_bytes);
+    std::swap(row_step,other.row_step);
+    std::swap(column_step,other.column_step);
+    std::swap(owns_memory,other.owns_memory);
   }
   // Prints the array as a 2D matrix.
   // Quick and dirty. No formatting.
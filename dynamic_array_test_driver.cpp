@@ -6,6 +6,9 @@
 // This file is a test driver for the dynamic_array.cpp
 
 #include <iostream>
+#include <cassert>
+#include <climits>
+#include <new>
 #include "dynamic_array.hpp"
 using namespace std;
 
@@ -115,6 +118,75 @@ int main() {
        << testing10
        << endl;
 
+  cout << "\nTesting views of outside memory." << endl;
+  int outside[12] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  Dynamic1DArray<int> view1(outside,12);
+  view1[0] = 100;
+  cout << "A 1D view sees: " << view1 << endl;
+  assert( outside[0] == 100 && view1.is_view() && "1D views write through." );
+  Dynamic1DArray<int> owned1 = view1;
+  assert( !owned1.is_view() && owned1.data() != outside
+	  && "Copies of views own their memory." );
+  outside[0] = 1;
+
+  // A 3x3 matrix in column-major order, with a leading dimension of 4.
+  Dynamic2DArray<int> view2(outside,3,3,4,COLUMN_MAJOR);
+  cout << "A column-major 2D view:" << view2 << endl;
+  assert( view2.get(0,1) == 5 && view2.get(2,0) == 3
+	  && "Column-major views index by column." );
+  Dynamic2DArray<int> packed_copy = view2;
+  view2.pack();
+  cout << "Packed in place:" << view2 << endl;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      assert( view2.get(i,j) == packed_copy.get(i,j)
+	      && outside[i*3 + j] == packed_copy.get(i,j)
+	      && "Packing keeps the values and packs them row-major." );
+    }
+  }
+  assert( view2.is_packed() && view2.is_view() && "Packed views are views." );
+
+  cout << "\nTesting arrays past the old 32-bit limit." << endl;
+  {
+    // 46341^2 cells don't fit in an int. Only the corners are
+    // touched, so the memory is almost never really used.
+    const int side = 46341;
+    Dynamic2DArray<char> big(side,side);
+    assert( big.cell_number() == (size_t)side*side
+	    && big.cell_number() > (size_t)INT_MAX );
+    big.access(0,0) = 'a';
+    big.access(side - 1,0) = 'b';
+    big.access(side - 1,side - 1) = 'c';
+    assert( &big.access(side - 1,side - 1) - big.data()
+	    == (ptrdiff_t)big.cell_number() - 1
+	    && big.get(0,0) == 'a' && big.get(side - 1,0) == 'b'
+	    && "Offsets past 2^31 are exact." );
+  }
+  {
+    ptrdiff_t length = (ptrdiff_t)INT_MAX + 2;
+    Dynamic1DArray<char> long_array(length);
+    long_array[0] = 'a';
+    long_array[length - 1] = 'z';
+    assert( long_array.length() == length && long_array.get(0) == 'a'
+	    && long_array.get(length - 1) == 'z'
+	    && "1D arrays index past 2^31 too." );
+  }
+  cout << "Arrays too big to index are refused when allocated." << endl;
+  bool refused = false;
+  try {
+    Dynamic2DArray<double> impossible(1 << 30,1 << 30);
+  } catch (const bad_array_new_length&) {
+    refused = true;
+  }
+  assert( refused && "2^60 doubles can't be indexed." );
+  refused = false;
+  try {
+    Dynamic2DArray<double> negative(-1,5);
+  } catch (const bad_array_new_length&) {
+    refused = true;
+  }
+  assert( refused && "Negative dimensions are refused." );
+
   cout << "\n\nThe test is now complete!" << endl;
   return 0;
 }
@@ -0,0 +1,261 @@
+// factorization_cache.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 09:58:31 (jonah)>
+
+// This file implements a thread-safe LRU cache of LU
+// factorizations, keyed by coefficient matrix.
+
+// The lock only guards the list and the index. Hashing, checking a
+// candidate's coefficients, factoring and solving all happen outside
+// it, on entries that are never changed once cached. An entry that
+// is evicted while another thread is solving with it lives on until
+// that thread is done with it.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "factorization_cache.hpp"
+#include "gaussian_elimination.hpp"
+#include "fingerprint.hpp"
+#include <cmath>
+#include <cstring>
+#include <float.h>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Utilities
+// ----------------------------------------------------------------------
+
+// A 64-bit hash of the size and coefficient matrix of g_sys.
+unsigned long long matrix_fingerprint(const GaussianSystem& g_sys) {
+  int n = g_sys.size();
+  unsigned long long hash = fingerprint_mix(FINGERPRINT_START,&n,
+					    sizeof(n));
+  vector<double> row(n);
+  for (int i = 0; i < n; i++) {
+    const double* values = g_sys.matrix_row(i);
+    if ( values == NULL ) {
+      for (int j = 0; j < n; j++) {
+	row[j] = g_sys.matrix_get(i,j);
+      }
+      values = row.data();
+    }
+    hash = fingerprint_mix(hash,values,n*sizeof(double));
+  }
+  return hash;
+}
+
+// Whether coefficients holds exactly the coefficient matrix of g_sys,
+// bit for bit.
+static bool same_matrix(const vector<double>& coefficients,
+			const GaussianSystem& g_sys) {
+  int n = g_sys.size();
+  if ( coefficients.size() != (size_t)n*n ) {
+    return false;
+  }
+  for (int i = 0; i < n; i++) {
+    const double* expected = coefficients.data() + (size_t)i*n;
+    const double* values = g_sys.matrix_row(i);
+    if ( values != NULL ) {
+      if ( memcmp(expected,values,n*sizeof(double)) != 0 ) {
+	return false;
+      }
+      continue;
+    }
+    for (int j = 0; j < n; j++) {
+      double value = g_sys.matrix_get(i,j);
+      if ( memcmp(expected + j,&value,sizeof(double)) != 0 ) {
+	return false;
+      }
+    }
+  }
+  return true;
+}
+// ----------------------------------------------------------------------
+
+
+// Constructors and destructors
+// ----------------------------------------------------------------------
+
+FactorizationCache::FactorizationCache(size_t budget/*= DEFAULT_BUDGET*/) {
+  memory_budget = budget;
+  used_bytes = 0;
+  hit_count = 0;
+  miss_count = 0;
+  eviction_count = 0;
+  collision_count = 0;
+}
+// ----------------------------------------------------------------------
+
+
+// Implementation details
+// ----------------------------------------------------------------------
+
+size_t FactorizationCache::Entry::bytes() const {
+  return sizeof(Entry) + (coefficients.size() + factors.size())*sizeof(double)
+    + pivots.size()*sizeof(int);
+}
+
+// Finds a cached entry for g_sys and marks it used.
+FactorizationCache::EntryPointer
+FactorizationCache::find(const GaussianSystem& g_sys,
+			 unsigned long long fingerprint) {
+  vector<EntryPointer> candidates;
+  {
+    lock_guard<mutex> lock(cache_mutex);
+    auto range = index.equal_range(fingerprint);
+    for (auto it = range.first; it != range.second; ++it) {
+      candidates.push_back(*it->second);
+    }
+  }
+  // Check the coefficients without holding the lock.
+  EntryPointer found;
+  long collisions = 0;
+  for (size_t c = 0; c < candidates.size() && !found; c++) {
+    if ( candidates[c]->size == g_sys.size()
+	 && same_matrix(candidates[c]->coefficients,g_sys) ) {
+      found = candidates[c];
+    } else {
+      collisions++;
+    }
+  }
+  lock_guard<mutex> lock(cache_mutex);
+  collision_count += collisions;
+  if ( !found ) {
+    miss_count++;
+    return found;
+  }
+  hit_count++;
+  // Move it to the front, unless it was evicted meanwhile.
+  auto range = index.equal_range(fingerprint);
+  for (auto it = range.first; it != range.second; ++it) {
+    if ( *it->second == found ) {
+      recency.splice(recency.begin(),recency,it->second);
+      break;
+    }
+  }
+  return found;
+}
+
+// Caches entry, evicting the least recently used entries to make
+// room.
+void FactorizationCache::insert(const EntryPointer& entry) {
+  size_t bytes = entry->bytes();
+  lock_guard<mutex> lock(cache_mutex);
+  if ( bytes > memory_budget ) {
+    return;
+  }
+  // Another thread may have cached the same matrix meanwhile.
+  auto range = index.equal_range(entry->fingerprint);
+  for (auto it = range.first; it != range.second; ++it) {
+    const Entry& other = **it->second;
+    if ( other.size == entry->size
+	 && other.coefficients == entry->coefficients ) {
+      return;
+    }
+  }
+  while ( used_bytes + bytes > memory_budget ) {
+    EntryPointer oldest = recency.back();
+    auto candidates = index.equal_range(oldest->fingerprint);
+    for (auto it = candidates.first; it != candidates.second; ++it) {
+      if ( *it->second == oldest ) {
+	index.erase(it);
+	break;
+      }
+    }
+    recency.pop_back();
+    used_bytes -= oldest->bytes();
+    eviction_count++;
+  }
+  recency.push_front(entry);
+  index.insert(make_pair(entry->fingerprint,recency.begin()));
+  used_bytes += bytes;
+}
+// ----------------------------------------------------------------------
+
+
+// Interface
+// ----------------------------------------------------------------------
+
+// Solves g_sys with cached factors, factoring on a miss.
+bool FactorizationCache::solve(const GaussianSystem& g_sys,
+			       Dynamic1DArray<double>& solution,
+			       bool* hit/*= NULL*/) {
+  int n = g_sys.size();
+  unsigned long long fingerprint = matrix_fingerprint(g_sys);
+  EntryPointer entry = find(g_sys,fingerprint);
+  if ( hit != NULL ) {
+    *hit = (entry != NULL);
+  }
+  if ( !entry ) {
+    shared_ptr<Entry> fresh = make_shared<Entry>();
+    fresh->fingerprint = fingerprint;
+    fresh->size = n;
+    fresh->coefficients.resize((size_t)n*n);
+    GaussianSystem factored(n);
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+	double value = g_sys.matrix_get(i,j);
+	fresh->coefficients[(size_t)i*n + j] = value;
+	factored.matrix_set(i,j,value);
+      }
+    }
+    Dynamic1DArray<int> pivots;
+    fresh->nondegenerate = lu_factorization(factored,pivots);
+    // Check the diagonal the way the solver service does, rather
+    // than dividing by a tiny pivot later.
+    const double* factors = factored.matrix_data();
+    for (int i = 0; i < n; i++) {
+      if ( !(abs(factors[(size_t)i*n + i]) > DBL_EPSILON) ) {
+	fresh->nondegenerate = false;
+      }
+    }
+    fresh->factors.assign(factors,factors + (size_t)n*n);
+    fresh->pivots.assign(pivots.data(),pivots.data() + n);
+    entry = fresh;
+    insert(entry);
+  }
+
+  if ( !entry->nondegenerate ) {
+    solution.reset(0);
+    return false;
+  }
+  solution.reset(n);
+  for (int i = 0; i < n; i++) {
+    solution[i] = g_sys.vector_get(i);
+  }
+  for (int j = 0; j < n; j++) {
+    swap(solution[j],solution[entry->pivots[j]]);
+  }
+  lu_solve(entry->factors.data(),n,solution.data());
+  return true;
+}
+
+// A snapshot of the counters.
+FactorizationCacheStatistics FactorizationCache::statistics() const {
+  lock_guard<mutex> lock(cache_mutex);
+  FactorizationCacheStatistics output;
+  output.hits = hit_count;
+  output.misses = miss_count;
+  output.evictions = eviction_count;
+  output.collisions = collision_count;
+  output.entries = recency.size();
+  output.bytes = used_bytes;
+  output.budget = memory_budget;
+  return output;
+}
+
+// Drops every entry.
+void FactorizationCache::clear() {
+  lock_guard<mutex> lock(cache_mutex);
+  recency.clear();
+  index.clear();
+  used_bytes = 0;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,122 @@
+// factorization_cache.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 09:12:44 (jonah)>
+
+// This file prototypes a cache of LU factorizations. The same
+// coefficient matrix often comes back again and again with different
+// knowns, and every solve_system() call eliminates it from scratch
+// at O(n^3). The cache keeps the LU factors and pivots of recent
+// matrices, so a repeat costs only the O(n^2) forward and back
+// substitution.
+
+// Matrices are looked up by a fast 64-bit hash of the coefficients,
+// and a hit is confirmed by comparing the coefficients with a copy
+// kept alongside the factors, so a hash collision can never give a
+// wrong answer. Entries are evicted least recently used first to
+// stay within a memory budget. Any number of threads may use one
+// cache at once.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Counters for a factorization cache.
+struct FactorizationCacheStatistics {
+  long hits; // Solves that reused cached factors.
+  long misses; // Solves that had to factor.
+  long evictions; // Entries dropped to stay within the budget.
+  long collisions; // Hash matches whose coefficients differed.
+  long entries; // Entries held right now.
+  size_t bytes; // Memory held by the entries right now.
+  size_t budget; // The most memory the entries may hold.
+};
+
+// A thread-safe LRU cache of LU factorizations, keyed by coefficient
+// matrix.
+class FactorizationCache {
+public: // Constructors and destructors.
+  // An empty cache whose entries may hold up to budget bytes. An
+  // entry for an n x n matrix takes about 16 n^2 bytes: the factors
+  // and the copy of the coefficients it is checked against.
+  FactorizationCache(size_t budget = DEFAULT_BUDGET);
+private: // A cache can't be copied.
+  FactorizationCache(const FactorizationCache &rhs);
+  FactorizationCache& operator = (const FactorizationCache &rhs);
+
+public: // Interface.
+  // 256 MB.
+  static const size_t DEFAULT_BUDGET = (size_t)256 << 20;
+
+  // Solves g_sys, reusing the factors of its coefficient matrix if
+  // they are cached and factoring and caching them if not. g_sys is
+  // not changed, and nothing is printed. Factors by recursive LU with
+  // partial pivoting, like RECURSIVE_ELIMINATION. Returns false, with
+  // solution empty, if the matrix is degenerate; that is cached too.
+  // If hit is not NULL, sets it to whether the factors were cached.
+  // Two threads that miss on the same matrix at once both factor it,
+  // and only the first result is kept.
+  bool solve(const GaussianSystem& g_sys, Dynamic1DArray<double>& solution,
+	     bool* hit = NULL);
+  // A snapshot of the counters.
+  FactorizationCacheStatistics statistics() const;
+  // Drops every entry. The counters are kept.
+  void clear();
+
+private: // Implementation details.
+  // The factors of one matrix. Never changed once cached, so readers
+  // can use an entry outside the lock.
+  struct Entry {
+    unsigned long long fingerprint;
+    int size;
+    bool nondegenerate;
+    vector<double> coefficients; // The original matrix, by rows.
+    vector<double> factors; // L and U, as lu_factorization leaves them.
+    vector<int> pivots;
+    size_t bytes() const;
+  };
+  typedef shared_ptr<const Entry> EntryPointer;
+  // Most recently used first.
+  typedef list<EntryPointer> RecencyList;
+
+  // Finds a cached entry for g_sys and marks it used, or returns
+  // NULL. Counts collisions.
+  EntryPointer find(const GaussianSystem& g_sys,
+		    unsigned long long fingerprint);
+  // Caches entry, evicting old entries to make room, unless it is
+  // bigger than the budget or an equal entry got there first.
+  void insert(const EntryPointer& entry);
+
+  size_t memory_budget;
+  mutable mutex cache_mutex;
+  RecencyList recency;
+  unordered_multimap<unsigned long long,RecencyList::iterator> index;
+  size_t used_bytes;
+  long hit_count;
+  long miss_count;
+  long eviction_count;
+  long collision_count;
+};
+
+// A 64-bit hash of the size and coefficient matrix of g_sys, in row
+// order. The knowns don't count.
+unsigned long long matrix_fingerprint(const GaussianSystem& g_sys);
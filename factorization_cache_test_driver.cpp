@@ -0,0 +1,161 @@
+// factorization_cache_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 10:37:05 (jonah)>
+
+// This file tests the factorization cache: hits and misses, LRU
+// eviction under the budget, degenerate matrices, and many threads
+// sharing one cache.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "factorization_cache.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// A random n x n system. The same seed always gives the same matrix;
+// the knowns come from knowns_seed.
+static GaussianSystem random_system(int n, unsigned seed,
+				    unsigned knowns_seed) {
+  GaussianSystem output(n);
+  srand(seed);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      output.matrix_set(i,j,(double)rand()/RAND_MAX - 0.5);
+    }
+  }
+  srand(knowns_seed);
+  for (int i = 0; i < n; i++) {
+    output.vector_set(i,(double)rand()/RAND_MAX - 0.5);
+  }
+  return output;
+}
+
+// Solves g_sys through the cache and checks the answer against
+// solve_system() on a copy. Returns whether it was a hit.
+static bool check(FactorizationCache& cache, const GaussianSystem& g_sys) {
+  Dynamic1DArray<double> solution;
+  bool hit;
+  assert( cache.solve(g_sys,solution,&hit) && "The system is solved." );
+  GaussianSystem copy = g_sys;
+  Dynamic1DArray<double> expected = solve_system(copy,RECURSIVE_ELIMINATION);
+  for (int i = 0; i < g_sys.size(); i++) {
+    assert( abs(solution[i] - expected[i]) < 1E-9*(1 + abs(expected[i]))
+	    && "The cached solve agrees with elimination." );
+  }
+  return hit;
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the factorization_cache library.\n"
+       << "BEGIN." << endl;
+  int n = 100;
+
+  cout << "\n\nOne matrix with five sets of knowns." << endl;
+  FactorizationCache cache;
+  for (int k = 0; k < 5; k++) {
+    bool hit = check(cache,random_system(n,1,100 + k));
+    assert( hit == (k > 0) && "Only the first solve factors." );
+  }
+  FactorizationCacheStatistics statistics = cache.statistics();
+  assert( statistics.hits == 4 && statistics.misses == 1
+	  && statistics.entries == 1 && statistics.collisions == 0 );
+
+  cout << "\n\nThe same matrix with two rows swapped is a different matrix."
+       << endl;
+  GaussianSystem swapped = random_system(n,1,100);
+  swapped.swap(3,4);
+  assert( !check(cache,swapped) && "Row order matters." );
+  assert( check(cache,swapped) );
+
+  cout << "\n\nA budget with room for two matrices." << endl;
+  GaussianSystem a = random_system(n,11,0);
+  GaussianSystem b = random_system(n,12,0);
+  GaussianSystem c = random_system(n,13,0);
+  FactorizationCache small((size_t)2*16*n*n + 4096);
+  check(small,a);
+  check(small,b);
+  assert( check(small,a) && "a is still cached." );
+  check(small,c); // Evicts b, the least recently used.
+  statistics = small.statistics();
+  cout << statistics.entries << " entries, " << statistics.bytes
+       << " of " << statistics.budget << " bytes, "
+       << statistics.evictions << " eviction(s)." << endl;
+  assert( statistics.entries == 2 && statistics.evictions == 1
+	  && statistics.bytes <= statistics.budget );
+  assert( check(small,a) && check(small,c) && !check(small,b)
+	  && "The least recently used entry went first." );
+
+  cout << "\n\nA matrix bigger than the budget is never cached." << endl;
+  FactorizationCache tiny(1000);
+  check(tiny,a);
+  assert( !check(tiny,a) && tiny.statistics().entries == 0 );
+
+  cout << "\n\nA degenerate matrix is cached as degenerate." << endl;
+  GaussianSystem degenerate = random_system(n,21,0);
+  for (int j = 0; j < n; j++) {
+    degenerate.matrix_set(7,j,2*degenerate.matrix_get(2,j));
+  }
+  Dynamic1DArray<double> solution;
+  bool hit;
+  assert( !cache.solve(degenerate,solution,&hit) && !hit
+	  && solution.length() == 0 );
+  assert( !cache.solve(degenerate,solution,&hit) && hit
+	  && "The second look is a hit." );
+
+  cout << "\n\nEight threads sharing a cache of four matrices." << endl;
+  FactorizationCache shared;
+  vector<GaussianSystem> matrices;
+  for (int m = 0; m < 4; m++) {
+    matrices.push_back(random_system(60,31 + m,0));
+  }
+  vector<Dynamic1DArray<double> > expected;
+  for (int m = 0; m < 4; m++) {
+    GaussianSystem copy = matrices[m];
+    expected.push_back(solve_system(copy,RECURSIVE_ELIMINATION));
+  }
+  atomic<int> wrong(0);
+  vector<thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.push_back(thread([&,t]() {
+	  for (int k = 0; k < 50; k++) {
+	    int m = (t + k) % 4;
+	    Dynamic1DArray<double> x;
+	    shared.solve(matrices[m],x);
+	    for (int i = 0; i < x.length(); i++) {
+	      if ( abs(x[i] - expected[m][i]) > 1E-9*(1 + abs(expected[m][i])) ) {
+		wrong++;
+	      }
+	    }
+	  }
+	}));
+  }
+  for (size_t t = 0; t < threads.size(); t++) {
+    threads[t].join();
+  }
+  statistics = shared.statistics();
+  cout << statistics.hits << " hits and " << statistics.misses
+       << " misses." << endl;
+  assert( wrong == 0 && statistics.hits + statistics.misses == 400
+	  && statistics.entries == 4 && "Every thread got the right answer." );
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
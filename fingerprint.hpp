@@ -0,0 +1,40 @@
+// fingerprint.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 22:48:30 (jonah)>
+
+// This file defines the 64-bit FNV-1a style hash the Gaussian
+// elimination package fingerprints systems and checkpoints with.
+// It isn't cryptographic. It is only there to tell matrices and files
+// apart quickly.
+
+// Include guard
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+using namespace std;
+
+// The hash of nothing.
+const unsigned long long FINGERPRINT_START = 14695981039346656037ULL;
+
+// Mixes count bytes into hash, eight bytes at a time for speed and
+// then byte by byte.
+inline unsigned long long fingerprint_mix(unsigned long long hash,
+					  const void* bytes, size_t count) {
+  const unsigned long long prime = 1099511628211ULL;
+  const char* data = (const char*)bytes;
+  while ( count >= 8 ) {
+    unsigned long long word;
+    memcpy(&word,data,8);
+    hash = (hash ^ word)*prime;
+    data += 8;
+    count -= 8;
+  }
+  while ( count > 0 ) {
+    hash = (hash ^ (unsigned char)*data)*prime;
+    data++;
+    count--;
+  }
+  return hash;
+}
@@ -15,10 +15,20 @@
 
 // Includes
 #include "gaussian_elimination.hpp"
+#include "tournament_pivoting.hpp"
+#include "strassen_multiply.hpp"
+#include "gemm.hpp"
+#include "perf_counters.hpp"
+#include "tuning.hpp"
+#include "solver_backend.hpp"
+#include "parallel_for.hpp"
+#include "structure_analysis.hpp"
 #include <cmath>
 #include <cassert>
 #include <float.h>
 #include <iomanip>
+#include <algorithm>
+#include <vector>
 using namespace std;
 // ----------------------------------------------------------------------
 
@@ -40,7 +50,7 @@ bool pivot(GaussianSystem& g_sys, int i, int j) {
       largest_value = abs(g_sys.matrix_get(largest_row,j));
     }
   }
-  if (largest_row > 0) {
+  if (largest_value > 0) {
     g_sys.swap(i,largest_row);
     return true;
   } else {
@@ -102,7 +112,39 @@ void row_reduce(GaussianSystem& g_sys, int index) {
 // to a triangular matrix. Returns true if back substitution is
 // possible on the gaussian-reduced matrix. Returns false otherwise.
 // ----------------------------------------------------------------------
-bool gaussian_elimination(GaussianSystem& g_sys) {
+bool gaussian_elimination(GaussianSystem& g_sys,
+			  EliminationMethod method/*= STANDARD_ELIMINATION*/) {
+  if ( backend_for(g_sys.size()) == LAPACK_BACKEND ) {
+    return lapack_gaussian_elimination(g_sys);
+  }
+  if ( method == TUNED_ELIMINATION ) {
+    TuningParameters tuned = tuned_parameters(g_sys.size());
+    if ( tuned.method == TOURNAMENT_ELIMINATION ) {
+      return tournament_gaussian_elimination(g_sys,tuned.panel_width);
+    }
+    if ( tuned.method == STRASSEN_ELIMINATION ) {
+      return strassen_gaussian_elimination(g_sys,tuned.strassen_cutoff);
+    }
+    method = tuned.method;
+  }
+  if ( method == RECURSIVE_ELIMINATION ) {
+    return recursive_gaussian_elimination(g_sys);
+  }
+  if ( method == TOURNAMENT_ELIMINATION ) {
+    return tournament_gaussian_elimination(g_sys);
+  }
+  if ( method == STRASSEN_ELIMINATION ) {
+    return strassen_gaussian_elimination(g_sys);
+  }
+
+  return eliminate_columns(g_sys,0,g_sys.size());
+}
+// ----------------------------------------------------------------------
+
+
+// Performs standard elimination on columns [first,last) only.
+// ----------------------------------------------------------------------
+bool eliminate_columns(GaussianSystem& g_sys, int first, int last) {
   // Whether or not the system can be solved by back
   // substitution. Assumed to be true initially.
   bool nondegenerate = true;
@@ -113,10 +155,14 @@ bool gaussian_elimination(GaussianSystem& g_sys) {
 
   // The main loop. Iterate through the columns, row-reducing below
   // the diagonal in each column.
-  for (int column = 0; column < g_sys.size(); column++) {
-    good_column = pivot(g_sys,column,column);
+  for (int column = first; column < last; column++) {
+    {
+      ProfiledPhase phase(PIVOT_PHASE);
+      good_column = pivot(g_sys,column,column);
+    }
     nondegenerate = nondegenerate && good_column;
     if ( good_column ) {
+      ProfiledPhase phase(ROW_REDUCE_PHASE);
       row_reduce(g_sys,column);
 
     }
@@ -126,6 +172,382 @@ bool gaussian_elimination(GaussianSystem& g_sys) {
 // ----------------------------------------------------------------------
 
 
+// Recursive LU factorization. The helpers below work directly on the
+// row-major memory of the system. matrix is the coefficient matrix,
+// knowns is the vector of knowns, and size is the size of the
+// system, which is also the distance between rows. size is a
+// ptrdiff_t so that offsets like row*size can't overflow.
+// ----------------------------------------------------------------------
+
+// Swaps two rows of the system in memory, knowns included.
+static void swap_rows_in_memory(double* matrix, double* knowns,
+				ptrdiff_t size, int row1, int row2) {
+  double* first = matrix + row1*size;
+  double* second = matrix + row2*size;
+  for (int column = 0; column < size; column++) {
+    double temp = first[column];
+    first[column] = second[column];
+    second[column] = temp;
+  }
+  double temp = knowns[row1];
+  knowns[row1] = knowns[row2];
+  knowns[row2] = temp;
+}
+
+// Settings and bookkeeping shared by the helpers during one
+// factorization.
+struct FactorizationState {
+  // Trailing updates with every dimension at least this big use
+  // strassen_multiply(). 0 means never.
+  int strassen_cutoff;
+  // If not NULL, pivots[j] is set to the row swapped with row j.
+  int* pivots;
+  // The number of trailing updates done by strassen_multiply().
+  int fast_updates;
+};
+
+// Factors the single column j from row j down. Chooses the pivot by
+// the same rule as pivot(), swaps it into place, and overwrites the
+// column below the diagonal with the multipliers. Returns false if
+// the column has no non-zero entries.
+static bool factor_column(double* matrix, double* knowns, ptrdiff_t size,
+			  int j, FactorizationState& state) {
+  ProfiledPhase phase(PANEL_PHASE);
+  int largest_row = j;
+  double largest_value = abs(matrix[j*size + j]);
+  for (int k = j; k < size; k++) {
+    if (abs(matrix[k*size + j]) > largest_value) {
+      largest_row = k;
+      largest_value = abs(matrix[k*size + j]);
+    }
+  }
+  if ( state.pivots != NULL ) {
+    state.pivots[j] = largest_row;
+  }
+  if ( !(largest_value > 0) ) {
+    return false;
+  }
+  if ( largest_row != j ) {
+    swap_rows_in_memory(matrix,knowns,size,j,largest_row);
+  }
+  double divisor = matrix[j*size + j];
+  for (int row = j + 1; row < size; row++) {
+    matrix[row*size + j] /= divisor;
+  }
+  return true;
+}
+
+// Trailing updates with at least this many multiply-adds go through
+// gemm(). Below it, packing costs more than it saves.
+static const double MIN_GEMM_UPDATE = 1 << 15;
+
+// Updates the bottom right block of columns [middle,last) after the
+// left half [first,middle) is factored: A22 = A22 - L21*A12. Big
+// enough blocks form the product by Strassen's recursion first, and
+// the rest of the big ones use gemm().
+static void update_trailing_block(double* matrix, ptrdiff_t size, int first,
+				  int middle, int last,
+				  FactorizationState& state) {
+  ProfiledPhase phase(TRAILING_UPDATE_PHASE);
+  int below = size - middle;
+  int inner = middle - first;
+  int right = last - middle;
+  if ( state.strassen_cutoff > 0
+       && min(below,min(inner,right)) >= state.strassen_cutoff ) {
+    Dynamic1DArray<double> product((ptrdiff_t)below*right);
+    strassen_multiply(below,inner,right,
+		      matrix + middle*size + first,size,
+		      matrix + first*size + middle,size,
+		      product.data(),right,state.strassen_cutoff);
+    for (int row = middle; row < size; row++) {
+      double* target = matrix + row*size + middle;
+      const double* source = product.data() + (ptrdiff_t)(row - middle)*right;
+      for (int column = 0; column < right; column++) {
+	target[column] -= source[column];
+      }
+    }
+    state.fast_updates++;
+  } else if ( (double)below*inner*right >= MIN_GEMM_UPDATE ) {
+    // On the calling thread, since elimination is serial and may be
+    // running on a solver service worker.
+    gemm(NO_TRANSPOSE,NO_TRANSPOSE,below,right,inner,-1.0,
+	 matrix + middle*size + first,size,
+	 matrix + first*size + middle,size,
+	 1.0,matrix + middle*size + middle,size,1);
+  } else {
+    for (int row = middle; row < size; row++) {
+      double* target = matrix + row*size;
+      for (int k = first; k < middle; k++) {
+	double multiplier = target[k];
+	const double* source = matrix + k*size;
+	for (int column = middle; column < last; column++) {
+	  target[column] -= multiplier*source[column];
+	}
+      }
+    }
+  }
+}
+
+// Factors columns [first,last) from row first down. Returns false if
+// any of the columns had no pivot.
+static bool factor_columns(double* matrix, double* knowns, ptrdiff_t size,
+			   int first, int last, FactorizationState& state) {
+  if ( last - first == 1 ) {
+    return factor_column(matrix,knowns,size,first,state);
+  }
+  int middle = first + (last - first)/2;
+
+  // Factor the left half.
+  bool nondegenerate = factor_columns(matrix,knowns,size,first,middle,state);
+
+  // Triangular solve. The top right block becomes the matching rows
+  // of U: A12 = L11^{-1} A12, where L11 has a unit diagonal.
+  {
+    ProfiledPhase phase(TRIANGULAR_SOLVE_PHASE);
+    for (int row = first + 1; row < middle; row++) {
+      double* target = matrix + row*size;
+      for (int k = first; k < row; k++) {
+	double multiplier = target[k];
+	const double* source = matrix + k*size;
+	for (int column = middle; column < last; column++) {
+	  target[column] -= multiplier*source[column];
+	}
+      }
+    }
+  }
+
+  // Update the bottom right block: A22 = A22 - L21*A12.
+  update_trailing_block(matrix,size,first,middle,last,state);
+
+  // Factor the right half.
+  bool right_nondegenerate = factor_columns(matrix,knowns,size,middle,last,
+					    state);
+  return nondegenerate && right_nondegenerate;
+}
+
+// Factors g_sys in place into L and U.
+bool lu_factorization(GaussianSystem& g_sys, Dynamic1DArray<int>& pivots,
+		      int strassen_cutoff/*= 0*/, int* fast_updates/*= NULL*/) {
+  int size = g_sys.size();
+  pivots.reset(size);
+  FactorizationState state;
+  state.strassen_cutoff = strassen_cutoff;
+  state.pivots = pivots.data();
+  state.fast_updates = 0;
+  bool nondegenerate = true;
+  if ( size > 0 ) {
+    g_sys.apply_permutation();
+    nondegenerate = factor_columns(g_sys.matrix_data(),g_sys.vector_data(),
+				   size,0,size,state);
+  }
+  if ( fast_updates != NULL ) {
+    *fast_updates = state.fast_updates;
+  }
+  return nondegenerate;
+}
+
+// Does the same job as gaussian_elimination, but by recursive LU
+// factorization.
+bool recursive_gaussian_elimination(GaussianSystem& g_sys) {
+  Dynamic1DArray<int> pivots;
+  bool nondegenerate = lu_factorization(g_sys,pivots);
+  forward_substitution(g_sys);
+  return nondegenerate;
+}
+
+// Does the same job as recursive_gaussian_elimination, but with
+// Strassen trailing updates.
+bool strassen_gaussian_elimination(GaussianSystem& g_sys,
+				   int cutoff/*= DEFAULT_STRASSEN_CUTOFF*/) {
+  Dynamic1DArray<int> pivots;
+  bool nondegenerate = lu_factorization(g_sys,pivots,cutoff);
+  forward_substitution(g_sys);
+  return nondegenerate;
+}
+// ----------------------------------------------------------------------
+
+
+// Finishes an in-place LU factorization of the system.
+// ----------------------------------------------------------------------
+void forward_substitution(GaussianSystem& g_sys) {
+  ProfiledPhase phase(FORWARD_SUBSTITUTION_PHASE);
+  ptrdiff_t size = g_sys.size();
+  double* matrix = g_sys.matrix_data();
+  double* knowns = g_sys.vector_data();
+  // Forward substitution with the unit lower triangle, then clear it.
+  for (int row = 1; row < size; row++) {
+    double* multipliers = matrix + row*size;
+    for (int k = 0; k < row; k++) {
+      knowns[row] -= multipliers[k]*knowns[k];
+      multipliers[k] = 0;
+    }
+  }
+}
+// ----------------------------------------------------------------------
+
+
+// Returns the growth factor of an elimination.
+// ----------------------------------------------------------------------
+double growth_factor(const GaussianSystem& original,
+		     const GaussianSystem& reduced) {
+  double largest_original = 0;
+  double largest_reduced = 0;
+  for (int row = 0; row < original.size(); row++) {
+    for (int column = 0; column < original.size(); column++) {
+      largest_original = max(largest_original,
+			     abs(original.matrix_get(row,column)));
+      if ( column >= row ) {
+	largest_reduced = max(largest_reduced,
+			      abs(reduced.matrix_get(row,column)));
+      }
+    }
+  }
+  if ( largest_original == 0 ) {
+    return 0;
+  }
+  return largest_reduced/largest_original;
+}
+// ----------------------------------------------------------------------
+
+
+// Iterative refinement on top of an LU factorization.
+// ----------------------------------------------------------------------
+
+// Solves LU x = rhs in place.
+void lu_solve(const double* matrix, ptrdiff_t size, double* rhs) {
+  for (int row = 1; row < size; row++) {
+    const double* multipliers = matrix + row*size;
+    for (int k = 0; k < row; k++) {
+      rhs[row] -= multipliers[k]*rhs[k];
+    }
+  }
+  for (int row = size-1; row >= 0; row--) {
+    const double* u = matrix + row*size;
+    for (int k = row+1; k < size; k++) {
+      rhs[row] -= u[k]*rhs[k];
+    }
+    rhs[row] /= u[row];
+  }
+}
+
+// Sets residual to b - A x and returns the normwise backward error.
+static double compute_residual(const GaussianSystem& original,
+			       const Dynamic1DArray<double>& solution,
+			       Dynamic1DArray<double>& residual) {
+  int size = original.size();
+  double matrix_norm = 0;
+  double solution_norm = 0;
+  double knowns_norm = 0;
+  double residual_norm = 0;
+  for (int row = 0; row < size; row++) {
+    double sum = original.vector_get(row);
+    double row_sum = 0;
+    for (int column = 0; column < size; column++) {
+      double a = original.matrix_get(row,column);
+      sum -= a*solution.get(column);
+      row_sum += abs(a);
+    }
+    residual[row] = sum;
+    matrix_norm = max(matrix_norm,row_sum);
+    solution_norm = max(solution_norm,abs(solution.get(row)));
+    knowns_norm = max(knowns_norm,abs(original.vector_get(row)));
+    residual_norm = max(residual_norm,abs(sum));
+  }
+  double scale = matrix_norm*solution_norm + knowns_norm;
+  return (scale > 0) ? residual_norm/scale : 0;
+}
+
+// Returns the normwise backward error of a solution.
+double backward_error(const GaussianSystem& original,
+		      const Dynamic1DArray<double>& solution) {
+  Dynamic1DArray<double> residual(original.size());
+  return compute_residual(original,solution,residual);
+}
+
+// Solves g_sys by LU factorization with Strassen trailing updates,
+// then iteratively refines the solution.
+Dynamic1DArray<double> refined_solve_system(GaussianSystem& g_sys,
+					    int strassen_cutoff
+					    /*= DEFAULT_STRASSEN_CUTOFF*/,
+					    int max_refinements/*= 3*/,
+					    RefinementReport* report
+					    /*= NULL*/) {
+  int size = g_sys.size();
+  GaussianSystem original = g_sys;
+  Dynamic1DArray<int> pivots;
+  int fast_updates;
+  bool nondegenerate = lu_factorization(g_sys,pivots,strassen_cutoff,
+					&fast_updates);
+  Dynamic1DArray<double> output(0);
+  if ( report != NULL ) {
+    report->fast_updates = fast_updates;
+    report->refinements = 0;
+    report->initial_backward_error = 0;
+    report->final_backward_error = 0;
+  }
+  if ( !nondegenerate ) {
+    forward_substitution(g_sys);
+    cout << "Matrix degenerate and back substitution not possible.\n"
+	 << "Here's the best I can do:\n"
+	 << g_sys
+	 << endl;
+    return output;
+  }
+
+  // The knowns were permuted along with the rows.
+  const double* matrix = g_sys.matrix_data();
+  output.reset(size);
+  for (int row = 0; row < size; row++) {
+    output[row] = g_sys.vector_get(row);
+  }
+  lu_solve(matrix,size,output.data());
+
+  // Each step solves A d = b - A x with the same factors and adds d
+  // to x. Stops when the error is at roundoff or stops shrinking.
+  Dynamic1DArray<double> residual(size);
+  double error = compute_residual(original,output,residual);
+  int refinements = 0;
+  if ( report != NULL ) {
+    report->initial_backward_error = error;
+  }
+  while ( refinements < max_refinements && error > DBL_EPSILON ) {
+    for (int j = 0; j < size; j++) {
+      if ( pivots[j] != j ) {
+	double temp = residual[j];
+	residual[j] = residual[pivots[j]];
+	residual[pivots[j]] = temp;
+      }
+    }
+    lu_solve(matrix,size,residual.data());
+    Dynamic1DArray<double> refined(output);
+    for (int row = 0; row < size; row++) {
+      refined[row] += residual[row];
+    }
+    Dynamic1DArray<double> refined_residual(size);
+    double refined_error = compute_residual(original,refined,
+					    refined_residual);
+    refinements++;
+    if ( !(refined_error < error) ) {
+      break;
+    }
+    bool converging = refined_error < error/2;
+    output = refined;
+    residual = refined_residual;
+    error = refined_error;
+    if ( !converging ) {
+      break;
+    }
+  }
+  if ( report != NULL ) {
+    report->refinements = refinements;
+    report->final_backward_error = error;
+  }
+  forward_substitution(g_sys);
+  return output;
+}
+// ----------------------------------------------------------------------
+
+
 // Performs back substitution to extract the values for all unknowns
 // of the gaussian system. System is assumed to be
 // upper-triangular. However, you can test for upper triangularity if
@@ -135,41 +557,254 @@ bool gaussian_elimination(GaussianSystem& g_sys) {
 // error.
 // ----------------------------------------------------------------------
 Dynamic1DArray<double> back_substitution(const GaussianSystem& g_sys,
-					 bool check_triangularity/*= false*/) {
+					 bool check_triangularity/*= false*/,
+					 int threads/*= 1*/) {
+  // Size of the Gaussian system
+  int size = g_sys.size();
+
+  // The knowns become the solution in place.
+  Dynamic2DArray<double> knowns(size,1);
+  for (int i = 0; i < size; i++) {
+    knowns.access(i,0) = g_sys.vector_get(i);
+  }
+  triangular_solve(g_sys,knowns,threads,check_triangularity);
+
+  // Outputs the solution
+  Dynamic1DArray<double> output(size);
+  for (int i = 0; i < size; i++) {
+    output[i] = knowns.get(i,0);
+  }
+  return output;
+}
+
+// Updates smaller than this many multiply-adds aren't worth starting
+// threads for. parallel_for() starts and joins fresh threads every
+// time, which costs tens of microseconds, about a million
+// multiply-adds of streaming through memory.
+static const long long MIN_PARALLEL_UPDATE = 1 << 20;
+
+// Solves U X = B in place by blocks.
+void triangular_solve(const GaussianSystem& g_sys,
+		      Dynamic2DArray<double>& right_hand_sides,
+		      int threads/*= 0*/, bool check_triangularity/*= false*/,
+		      int block_size/*= 0*/) {
+  ProfiledPhase phase(BACK_SUBSTITUTION_PHASE);
   // Check for upper-triangularity
   if ( check_triangularity ) {
     assert( g_sys.is_upper_triangular()
 	    && "The system is upper triangular." );
   }
-
-  // Size of the Gaussian system
   int size = g_sys.size();
+  int width = right_hand_sides.width();
+  // Each block's update reads a block of U this many columns wide,
+  // which should stay in cache while it is applied to every row
+  // above.
+  if ( threads < 1 || block_size < 1 ) {
+    TuningParameters tuned = tuned_parameters(size);
+    if ( threads < 1 ) {
+      threads = tuned.substitution_threads;
+    }
+    if ( block_size < 1 ) {
+      block_size = tuned.substitution_block;
+    }
+  }
+  assert( right_hand_sides.height() == size
+	  && right_hand_sides.column_stride() == 1
+	  && "One row of right-hand sides per unknown, stored by row." );
+
+  // Pointers to the rows of U, so the inner loops skip the
+  // permutation and the bounds checks. A column-major view is copied
+  // by rows first.
+  vector<const double*> rows(size);
+  Dynamic2DArray<double> row_major;
+  if ( size > 0 && g_sys.matrix_row(0) == NULL ) {
+    row_major.reset(size,size);
+    for (int i = 0; i < size; i++) {
+      for (int j = i; j < size; j++) {
+	row_major.access(i,j) = g_sys.matrix_get(i,j);
+      }
+    }
+  }
+  for (int i = 0; i < size; i++) {
+    rows[i] = (row_major.cell_number() > 0)
+      ? row_major.data() + (size_t)i*size : g_sys.matrix_row(i);
+  }
+  double* b = right_hand_sides.data();
+  size_t stride = right_hand_sides.row_stride();
 
-  // The list of values x values attained by back substitution
-  Dynamic1DArray<double> output(size);
-
-  // Iterates through the Gaussian system and finds the output by
-  // back_substitution.
-  for (int i = size-1; i >= 0; i--) {
+  for (int high = size; high > 0; high -= block_size) {
+    int low = max(0,high - block_size);
     // Checks for non-degeneracy.
-    assert ( abs(g_sys.matrix_get(i,i)) > DBL_EPSILON
-	     && "The matrix is non-degenerate." );
+    for (int i = high - 1; i >= low; i--) {
+      assert ( abs(rows[i][i]) > DBL_EPSILON
+	       && "The matrix is non-degenerate." );
+    }
+
+    // The diagonal block, one unknown at a time, split over the
+    // right-hand sides.
+    long long work = (long long)(high - low)*(high - low)*width/2;
+    int block_threads = (work >= MIN_PARALLEL_UPDATE) ? threads : 1;
+    parallel_for(0,width,block_threads,[&](int first, int last) {
+	for (int i = high - 1; i >= low; i--) {
+	  const double* u = rows[i];
+	  double* x = b + i*stride;
+	  for (int j = i + 1; j < high; j++) {
+	    const double* solved = b + j*stride;
+	    for (int c = first; c < last; c++) {
+	      x[c] -= u[j]*solved[c];
+	    }
+	  }
+	  for (int c = first; c < last; c++) {
+	    x[c] = x[c]/u[i];
+	  }
+	}
+      });
+
+    // B[0:low] -= U[0:low,low:high] X[low:high], split over rows.
+    work = (long long)low*(high - low)*width;
+    int update_threads = (work >= MIN_PARALLEL_UPDATE) ? threads : 1;
+    parallel_for(0,low,update_threads,[&](int first, int last) {
+	for (int i = first; i < last; i++) {
+	  const double* u = rows[i];
+	  double* x = b + i*stride;
+	  if ( width == 1 ) {
+	    // A dot product, which vectorizes.
+	    double sum = 0;
+	    for (int j = low; j < high; j++) {
+	      sum += u[j]*b[j*stride];
+	    }
+	    x[0] -= sum;
+	    continue;
+	  }
+	  for (int j = low; j < high; j++) {
+	    double coefficient = u[j];
+	    if ( coefficient == 0 ) {
+	      continue;
+	    }
+	    const double* solved = b + j*stride;
+	    for (int c = 0; c < width; c++) {
+	      x[c] -= coefficient*solved[c];
+	    }
+	  }
+	}
+      });
+  }
+}
+// ----------------------------------------------------------------------
+
+
+// Solves same-size systems together. Entry (row,column) of system s
+// lives at ((row*(size + 1) + column)*count + s), knowns in column
+// size, so the innermost loops run over the systems. The arithmetic
+// is that of pivot(), row_reduce() and back substitution one unknown
+// at a time.
+// ----------------------------------------------------------------------
+int batched_solve(const GaussianSystem* const* systems, int count,
+		  Dynamic1DArray<double>* solutions) {
+  if ( count < 1 ) {
+    return 0;
+  }
+  int size = systems[0]->size();
+  ptrdiff_t width = size + 1;
+  for (int s = 0; s < count; s++) {
+    assert( systems[s]->size() == size
+	    && "Systems solved together are the same size." );
+  }
+  vector<double> a(width*size*count);
+  for (int row = 0; row < size; row++) {
+    for (int column = 0; column <= size; column++) {
+      double* entry = a.data() + (row*width + column)*count;
+      for (int s = 0; s < count; s++) {
+	entry[s] = systems[s]->get(row,column);
+      }
+    }
+  }
+  vector<char> degenerate(count,0);
+  vector<int> pivot_row(count);
+  vector<double> largest(count);
+  vector<double> multiplier(count);
+
+  for (int column = 0; column < size; column++) {
+    // Each system's pivot, as pivot() would pick it.
+    const double* entry = a.data() + (column*width + column)*count;
+    for (int s = 0; s < count; s++) {
+      pivot_row[s] = column;
+      largest[s] = abs(entry[s]);
+    }
+    for (int row = column + 1; row < size; row++) {
+      entry = a.data() + (row*width + column)*count;
+      for (int s = 0; s < count; s++) {
+	if ( abs(entry[s]) > largest[s] ) {
+	  pivot_row[s] = row;
+	  largest[s] = abs(entry[s]);
+	}
+      }
+    }
+    for (int s = 0; s < count; s++) {
+      if ( !(largest[s] > 0) ) {
+	degenerate[s] = 1;
+      }
+      if ( pivot_row[s] == column ) {
+	continue;
+      }
+      double* top = a.data() + column*width*count + s;
+      double* bottom = a.data() + pivot_row[s]*width*count + s;
+      for (int j = column; j <= size; j++) {
+	swap(top[j*count],bottom[j*count]);
+      }
+    }
 
-    // After Gauss-Jordan elimination, the solution is just the knowns vector.
-    output[i] = g_sys.vector_get(i);
+    // The row reduction. A degenerate system divides by zero here,
+    // which only spoils its own entries.
+    const double* pivot_entries = a.data() + column*width*count;
+    const double* divisor = pivot_entries + column*count;
+    for (int row = column + 1; row < size; row++) {
+      double* target = a.data() + row*width*count;
+      for (int s = 0; s < count; s++) {
+	multiplier[s] = target[column*count + s];
+	target[column*count + s] = 0;
+      }
+      for (int j = column + 1; j <= size; j++) {
+	double* x = target + j*count;
+	const double* y = pivot_entries + j*count;
+	for (int s = 0; s < count; s++) {
+	  x[s] = x[s] - (multiplier[s]*y[s])/divisor[s];
+	}
+      }
+    }
+  }
 
-    // But we didn't do Gauss-Jordan elimination. We did Gaussian
-    // elimination. So to find the ith element of the solution, we
-    // need to subtract the jth elements of the solution with
-    // appropriate coefficients, where m > n.
-    for (int j = i+1; j < size; j++) {
-      output[i] -= g_sys.get(i,j) * output[j];
+  // Back substitution, into the knowns column.
+  for (int i = size - 1; i >= 0; i--) {
+    double* x = a.data() + (i*width + size)*count;
+    for (int j = i + 1; j < size; j++) {
+      const double* u = a.data() + (i*width + j)*count;
+      const double* solved = a.data() + (j*width + size)*count;
+      for (int s = 0; s < count; s++) {
+	x[s] -= u[s]*solved[s];
+      }
+    }
+    const double* diagonal = a.data() + (i*width + i)*count;
+    for (int s = 0; s < count; s++) {
+      if ( !(abs(diagonal[s]) > DBL_EPSILON) ) {
+	degenerate[s] = 1;
+      }
+      x[s] = x[s]/diagonal[s];
     }
-    // Finally, we need to divide by the coefficient in front of the
-    // ith unknown.
-    output[i] = output[i]/g_sys.get(i,i);
   }
-  // Outputs the solution
+
+  int output = 0;
+  for (int s = 0; s < count; s++) {
+    if ( degenerate[s] ) {
+      solutions[s] = Dynamic1DArray<double>();
+      continue;
+    }
+    solutions[s] = Dynamic1DArray<double>(size);
+    for (int i = 0; i < size; i++) {
+      solutions[s][i] = a[(i*width + size)*count + s];
+    }
+    output++;
+  }
   return output;
 }
 // ----------------------------------------------------------------------
@@ -208,13 +843,27 @@ void print_solution(ostream& output_stream,
 // Solves the matrix equation by Gaussian elimination and back
 // substitution. Prints the solution and returns a solution vector.
 // ----------------------------------------------------------------------
-Dynamic1DArray<double> solve_system(GaussianSystem& g_sys) {
+Dynamic1DArray<double> solve_system(GaussianSystem& g_sys,
+				    EliminationMethod method
+				    /*= STANDARD_ELIMINATION*/,
+				    bool analyze/*= true*/) {
   bool back_substitution_possible;
   Dynamic1DArray<double> output(0);
-  back_substitution_possible = gaussian_elimination(g_sys);
-  if ( back_substitution_possible ) {
-    output = back_substitution(g_sys);
+  StructureAnalysis analysis;
+  analysis.structure = GENERAL_STRUCTURE;
+  if ( analyze ) {
+    analysis = analyze_structure(g_sys);
+  }
+  if ( analysis.structure != GENERAL_STRUCTURE ) {
+    back_substitution_possible = structured_solve(g_sys,analysis,output,
+						  method);
   } else {
+    back_substitution_possible = gaussian_elimination(g_sys,method);
+    if ( back_substitution_possible ) {
+      output = back_substitution(g_sys);
+    }
+  }
+  if ( !back_substitution_possible ) {
     cout << "Matrix degenerate and back substitution not possible.\n"
 	 << "Here's the best I can do:\n"
 	 << g_sys
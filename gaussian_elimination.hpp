@@ -25,6 +25,31 @@ using namespace std;
 // ----------------------------------------------------------------------
 
 
+// The algorithms available for reducing a system to triangular form.
+enum EliminationMethod {
+  // Column-by-column elimination using pivot() and row_reduce().
+  STANDARD_ELIMINATION,
+  // Cache-oblivious recursive LU factorization. See
+  // recursive_gaussian_elimination().
+  RECURSIVE_ELIMINATION,
+  // Communication-avoiding LU with tournament pivoting. See
+  // tournament_gaussian_elimination() in tournament_pivoting.hpp.
+  TOURNAMENT_ELIMINATION,
+  // Recursive LU where the big trailing updates are done by
+  // Strassen's recursion. See strassen_gaussian_elimination().
+  STRASSEN_ELIMINATION,
+  // Whichever of the above, with whatever block sizes, the tuning
+  // profile says is fastest for the size of the system. See
+  // tuning.hpp.
+  TUNED_ELIMINATION
+};
+
+// Trailing updates with every dimension at least this big use
+// Strassen's recursion, which also stops at this size. Found with
+// ./benchmark_driver.bin strassen on a single core.
+const int DEFAULT_STRASSEN_CUTOFF = 256;
+
+
 // Looks for the row k of gaussian system g_sys below row i such that
 // the element in the kth row and jth column is the largest element in
 // column j. Swaps the rows i and k. It is possible that there are no
@@ -40,8 +65,111 @@ void row_reduce(GaussianSystem& g_sys, int index);
 
 // Performs Gaussian elimination to reduce the gaussian system g_sys
 // to a triangular matrix. Returns true if back substitution is
-// possible on the gaussian-reduced matrix. Returns false otherwise.
-bool gaussian_elimination(GaussianSystem& g_sys);
+// possible on the gaussian-reduced matrix. Returns false
+// otherwise. The method selects the algorithm used, unless the
+// routing rules in solver_backend.hpp send systems of this size to
+// another backend.
+bool gaussian_elimination(GaussianSystem& g_sys,
+			  EliminationMethod method = STANDARD_ELIMINATION);
+
+
+// Does standard elimination, pivot() and row_reduce(), on columns
+// [first,last) only. Eliminating [0,k) and then [k,n) is exactly the
+// same as eliminating [0,n) at once, so long elimination can stop and
+// pick up between columns. See checkpoint.hpp. Returns true if every
+// column had a pivot.
+bool eliminate_columns(GaussianSystem& g_sys, int first, int last);
+
+
+// Does the same job as gaussian_elimination, but by recursive LU
+// factorization. The column range is split in half, the left half is
+// factored, the right half is updated with a triangular solve and a
+// matrix multiply, and then the right half is factored. There are no
+// block sizes to tune, and every level of the memory hierarchy gets
+// good reuse. Pivots are chosen by the same rule as pivot(). Works on
+// raw memory, so the rows of g_sys are physically permuted
+// afterwards. Returns true if back substitution is possible.
+bool recursive_gaussian_elimination(GaussianSystem& g_sys);
+
+// Does the same job as recursive_gaussian_elimination, but each
+// trailing update A22 = A22 - L21*A12 with every dimension at least
+// cutoff forms L21*A12 by strassen_multiply() in
+// strassen_multiply.hpp. Above a few thousand unknowns those updates
+// are almost all of the work, so this saves time, but the error bound
+// is weaker. Check it with refined_solve_system(). Returns true if
+// back substitution is possible.
+bool strassen_gaussian_elimination(GaussianSystem& g_sys,
+				   int cutoff = DEFAULT_STRASSEN_CUTOFF);
+
+// The recursive LU factorization behind the two functions above. The
+// rows of g_sys are physically permuted and overwritten with L below
+// the diagonal (the unit diagonal is implied) and U on and above
+// it. The knowns are permuted along with the rows but otherwise left
+// alone. pivots[j] is set to the row that was swapped with row j, in
+// order. strassen_cutoff is as for strassen_gaussian_elimination; 0
+// means never use Strassen. If fast_updates is not NULL, it is set
+// to the number of Strassen updates. Returns true if back
+// substitution is possible.
+bool lu_factorization(GaussianSystem& g_sys, Dynamic1DArray<int>& pivots,
+		      int strassen_cutoff = 0, int* fast_updates = NULL);
+
+// Solves LU x = rhs in place, where matrix holds the size x size
+// output of lu_factorization(): L below the diagonal and U on and
+// above it, packed by rows. rhs must already be row-permuted, by
+// swapping entries j and pivots[j] for each j in order.
+void lu_solve(const double* matrix, ptrdiff_t size, double* rhs);
+
+// Finishes an in-place LU factorization of the system. The
+// multipliers stored below the diagonal are applied to the knowns by
+// forward substitution and then cleared, so the system looks just
+// like the output of gaussian_elimination. Works on raw memory, so
+// assumes the permutation has been applied.
+void forward_substitution(GaussianSystem& g_sys);
+
+
+// Returns the growth factor of an elimination: the largest entry of
+// the reduced upper triangle over the largest entry of the original
+// coefficient matrix. Partial pivoting keeps this small in
+// practice. Large values mean accuracy has been lost.
+double growth_factor(const GaussianSystem& original,
+		     const GaussianSystem& reduced);
+
+
+// Returns the normwise backward error of solution as a solution of
+// original: |b - Ax|/(|A||x| + |b|) in the infinity norm. A stable
+// solver gives a small multiple of the machine epsilon.
+double backward_error(const GaussianSystem& original,
+		      const Dynamic1DArray<double>& solution);
+
+
+// What refined_solve_system() did.
+struct RefinementReport {
+  // The number of trailing updates done by Strassen's recursion.
+  int fast_updates;
+  // The backward error straight after the factorization. Compare
+  // with a classical solve to see the accuracy Strassen lost.
+  double initial_backward_error;
+  // The backward error after refinement.
+  double final_backward_error;
+  // The number of refinement steps taken.
+  int refinements;
+};
+
+// Solves the matrix equation by LU factorization with Strassen
+// trailing updates (see strassen_gaussian_elimination), then
+// iteratively refines the solution: computes the residual
+// r = b - Ax with the original matrix, solves A d = r with the same
+// factors, and adds d to x. Stops after max_refinements steps, or
+// once the backward error is at roundoff or stops halving. This wins
+// back the accuracy Strassen gives up for O(n^2) work a step. g_sys
+// is left reduced, like solve_system. If report is not NULL, fills
+// it in.
+Dynamic1DArray<double> refined_solve_system(GaussianSystem& g_sys,
+					    int strassen_cutoff
+					    = DEFAULT_STRASSEN_CUTOFF,
+					    int max_refinements = 3,
+					    RefinementReport* report = NULL);
+
 
 // Performs back substitution to extract the values for all unknowns
 // of the gaussian system. System is assumed to be
@@ -49,9 +177,42 @@ bool gaussian_elimination(GaussianSystem& g_sys);
 // you like. If you test for upper-triangularity, raises an error if
 // the matrix is not upper-triangular, raises an error. Assumes the
 // matrix is non-degenerate. If the matrix is degenerate, raises an
-// error.
+// error. Uses triangular_solve() with one right-hand side. That is
+// memory bound and rarely worth threads, and callers like the solver
+// service are parallel already, so it runs on one thread unless
+// threads asks for more. Less than 1 means as for triangular_solve().
 Dynamic1DArray<double> back_substitution(const GaussianSystem& g_sys,
-					 bool check_triangularity = false);
+					 bool check_triangularity = false,
+					 int threads = 1);
+
+// Solves U X = B in place, where U is the upper triangle of the
+// reduced system g_sys and B has one right-hand side per column, one
+// row per unknown. B must be stored by row. The knowns of g_sys are
+// ignored. Works down the diagonal in blocks from the bottom: each
+// diagonal block is solved in turn, its right-hand sides in
+// parallel, and then the block's columns of U above it are applied to
+// the rows above as one matrix multiply, split over threads by rows.
+// Each row is only ever updated by one thread, in the same order, so
+// the answer doesn't depend on threads. block_size is the order of
+// the diagonal blocks. If threads or block_size is less than 1, uses
+// tuned_parameters() in tuning.hpp, which without a tuning profile
+// means one thread per hardware thread and blocks of 64. Raises the
+// same errors as back_substitution().
+void triangular_solve(const GaussianSystem& g_sys,
+		      Dynamic2DArray<double>& right_hand_sides,
+		      int threads = 0, bool check_triangularity = false,
+		      int block_size = 0);
+
+// Solves count systems of the same size together, by standard
+// elimination and back substitution. The systems are interleaved in
+// memory, entry by entry, so every step works on all of them at once
+// in one vectorizable loop, and each still pivots its own way. Worth
+// it for many small systems, where one at a time the loops are too
+// short to vectorize. The systems are left alone. solutions[s] gets
+// the solution of systems[s], or is left empty if a diagonal entry
+// ends up no bigger than DBL_EPSILON. Returns the number solved.
+int batched_solve(const GaussianSystem* const* systems, int count,
+		  Dynamic1DArray<double>* solutions);
 
 // Outputs a Dynamic1DArray vector in a nice format indicating the
 // solution to a matrix equation. Sends it to the appropriate stream
@@ -61,4 +222,12 @@ void print_solution(ostream& output_stream,
 
 // Solves the matrix equation by Gaussian elimination and back
 // substitution. Prints the solution and returns a solution vector.
-Dynamic1DArray<double> solve_system(GaussianSystem& g_sys);
+// The method selects the elimination algorithm. If analyze is set,
+// the system goes through analyze_structure() first, and a diagonal,
+// triangular or block structured one is solved by structured_solve()
+// instead, leaving g_sys alone; see structure_analysis.hpp. Pass
+// false to always eliminate, e.g. to time or test a method.
+Dynamic1DArray<double> solve_system(GaussianSystem& g_sys,
+				    EliminationMethod method
+				    = STANDARD_ELIMINATION,
+				    bool analyze = true);
@@ -11,14 +11,35 @@
 
 // Includes
 #include <iostream>
+#include <cstdlib>
 #include <fstream>
 #include "gaussian_system.hpp"
 #include "gaussian_elimination.hpp"
 #include <float.h>
+#include <cmath>
+#include <cassert>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 using namespace std;
 // ----------------------------------------------------------------------
 
 
+// Reserves bytes of address space that only takes memory where it
+// is touched, for views far bigger than the machine. Returns NULL if
+// the system won't hand out that much.
+static double* reserve_address_space(size_t bytes) {
+#ifdef __linux__
+  void* memory = mmap(NULL,bytes,PROT_READ | PROT_WRITE,
+		      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,-1,0);
+  return memory == MAP_FAILED ? NULL : (double*)memory;
+#else
+  return NULL;
+#endif
+}
+// ----------------------------------------------------------------------
+
+
 // Main function
 // ----------------------------------------------------------------------
 int main() {
@@ -84,6 +105,272 @@ int main() {
   cout << "And here's the original matrix...\n"
        << testing2 << endl;
   
+  cout << "\n\nNow testing recursive elimination on the same matrix.\n"
+       << endl;
+
+  GaussianSystem testing3(testing2_size);
+  testing3.matrix_set(0,0,2);
+  testing3.matrix_set(0,1,4);
+  testing3.matrix_set(0,2,-2);
+  testing3.matrix_set(1,0,4);
+  testing3.matrix_set(1,1,9);
+  testing3.matrix_set(1,2,-3);
+  testing3.matrix_set(2,0,-2);
+  testing3.matrix_set(2,1,-3);
+  testing3.matrix_set(2,2,7);
+  testing3.vector_set(0,2);
+  testing3.vector_set(1,8);
+  testing3.vector_set(2,10);
+
+  Dynamic1DArray<double> solution3;
+  solution3 = solve_system(testing3,RECURSIVE_ELIMINATION);
+  cout << "Got it! The solution is:" << endl;
+  print_solution(cout,solution3,DBL_EPSILON);
+  for (int i = 0; i < testing2_size; i++) {
+    assert( abs(solution3[i] - solution2[i]) < 1E-12
+	    && "Recursive and standard elimination agree." );
+  }
+  cout << "It agrees with standard elimination.\n"
+       << "And here's the reduced matrix...\n"
+       << testing3 << endl;
+
+  cout << "\n\nNow testing Strassen elimination with iterative refinement\n"
+       << "on a random 300x300 system, with a small cutoff so the\n"
+       << "Strassen updates actually run." << endl;
+  int testing4_size = 300;
+  GaussianSystem testing4(testing4_size);
+  srand(4);
+  for (int i = 0; i < testing4_size; i++) {
+    for (int j = 0; j <= testing4_size; j++) {
+      testing4.set(i,j,2.0*rand()/RAND_MAX - 1.0);
+    }
+  }
+  GaussianSystem original4 = testing4;
+  GaussianSystem recursive4 = testing4;
+  GaussianSystem strassen4 = testing4;
+  Dynamic1DArray<double> solution4
+    = solve_system(recursive4,RECURSIVE_ELIMINATION);
+  assert( strassen_gaussian_elimination(strassen4,16)
+	  && "The random system is not degenerate." );
+  Dynamic1DArray<double> strassen_solution4 = back_substitution(strassen4);
+  RefinementReport report;
+  Dynamic1DArray<double> refined4 = refined_solve_system(testing4,16,3,&report);
+  cout << "Strassen updates:           " << report.fast_updates << "\n"
+       << "Classical backward error:   "
+       << backward_error(original4,solution4) << "\n"
+       << "Strassen backward error:    "
+       << backward_error(original4,strassen_solution4) << "\n"
+       << "Before refinement:          " << report.initial_backward_error << "\n"
+       << "After " << report.refinements << " refinements:       "
+       << report.final_backward_error << endl;
+  assert( report.fast_updates > 0 && "Strassen was used." );
+  assert( report.final_backward_error <= report.initial_backward_error
+	  && report.final_backward_error < 1E-14
+	  && "Refinement gives a backward stable solution." );
+  for (int i = 0; i < testing4_size; i++) {
+    assert( abs(refined4[i] - solution4[i]) < 1E-9
+	    && abs(strassen_solution4[i] - solution4[i]) < 1E-9
+	    && "Strassen and recursive elimination agree." );
+  }
+  assert( testing4.is_upper_triangular()
+	  && "The refined solve leaves the system reduced." );
+  cout << "They agree with recursive elimination." << endl;
+
+  cout << "\n\nNow solving views of caller memory, in both layouts and\n"
+       << "with padded leading dimensions, by each method." << endl;
+  int n5 = 40;
+  EliminationMethod methods5[3] = {STANDARD_ELIMINATION,
+				   RECURSIVE_ELIMINATION,
+				   TOURNAMENT_ELIMINATION};
+  ArrayLayout layouts5[2] = {ROW_MAJOR, COLUMN_MAJOR};
+  for (int l = 0; l < 2; l++) {
+    for (int m = 0; m < 3; m++) {
+      for (int preserve = 0; preserve < 2; preserve++) {
+	int leading_dimension = n5 + 3;
+	Dynamic1DArray<double> matrix5(n5*leading_dimension);
+	Dynamic1DArray<double> knowns5(n5);
+	GaussianSystem reference5(n5);
+	for (int i = 0; i < n5; i++) {
+	  for (int j = 0; j < n5; j++) {
+	    double value = sin(1.0 + 3*i + 7*j) + ((i == j) ? 2 : 0);
+	    reference5.set(i,j,value);
+	    if ( layouts5[l] == ROW_MAJOR ) {
+	      matrix5[i*leading_dimension + j] = value;
+	    } else {
+	      matrix5[i + j*leading_dimension] = value;
+	    }
+	  }
+	  knowns5[i] = cos(1.0 + i);
+	  reference5.set(i,n5,knowns5[i]);
+	}
+	Dynamic1DArray<double> untouched5 = matrix5;
+	GaussianSystem view5(n5,matrix5.data(),leading_dimension,layouts5[l],
+			     knowns5.data(),
+			     preserve ? PRESERVE_CALLER_MEMORY
+			     : OVERWRITE_CALLER_MEMORY);
+	assert( view5.is_view() && view5.get(3,5) == reference5.get(3,5)
+		&& "The view sees the caller's system." );
+	Dynamic1DArray<double> expected5 = solve_system(reference5,methods5[m]);
+	Dynamic1DArray<double> solution5 = solve_system(view5,methods5[m]);
+	for (int i = 0; i < n5; i++) {
+	  assert( abs(solution5[i] - expected5[i]) < 1E-12
+		  && "Solving a view gives the same answer." );
+	}
+	bool caller_untouched = true;
+	for (int k = 0; k < matrix5.length(); k++) {
+	  caller_untouched = caller_untouched && matrix5[k] == untouched5[k];
+	}
+	if ( preserve ) {
+	  assert( caller_untouched && !view5.is_view()
+		  && "Preserving views copy before writing." );
+	} else {
+	  assert( !caller_untouched && view5.is_view()
+		  && "Overwriting views solve in the caller's memory." );
+	}
+      }
+    }
+  }
+  cout << "Every view agrees with an ordinary system." << endl;
+
+  cout << "\n\nNow testing the blocked triangular solve on a 300x300\n"
+       << "system with seven right-hand sides." << endl;
+  int n6 = 300;
+  int width6 = 7;
+  GaussianSystem testing6(n6);
+  srand(6);
+  for (int i = 0; i < n6; i++) {
+    for (int j = 0; j <= n6; j++) {
+      testing6.set(i,j,(double)rand()/RAND_MAX - 0.5);
+    }
+  }
+  assert( gaussian_elimination(testing6) );
+  Dynamic1DArray<double> serial6(n6);
+  for (int i = n6 - 1; i >= 0; i--) {
+    serial6[i] = testing6.vector_get(i);
+    for (int j = i + 1; j < n6; j++) {
+      serial6[i] -= testing6.get(i,j)*serial6[j];
+    }
+    serial6[i] /= testing6.get(i,i);
+  }
+  Dynamic1DArray<double> solution6 = back_substitution(testing6,true,1);
+  Dynamic1DArray<double> threaded6 = back_substitution(testing6,false,4);
+  for (int i = 0; i < n6; i++) {
+    assert( abs(solution6[i] - serial6[i]) < 1E-10*(1 + abs(serial6[i]))
+	    && "The blocked solve agrees with one unknown at a time." );
+    assert( solution6[i] == threaded6[i]
+	    && "The answer doesn't depend on the number of threads." );
+  }
+  Dynamic2DArray<double> knowns6(n6,width6);
+  for (int i = 0; i < n6; i++) {
+    knowns6.access(i,0) = testing6.vector_get(i);
+    for (int c = 1; c < width6; c++) {
+      knowns6.access(i,c) = sin(1.0 + i*c);
+    }
+  }
+  Dynamic2DArray<double> unknowns6 = knowns6;
+  triangular_solve(testing6,unknowns6,3);
+  for (int i = 0; i < n6; i++) {
+    assert( abs(unknowns6.get(i,0) - solution6[i])
+	    < 1E-10*(1 + abs(solution6[i]))
+	    && "Each right-hand side is solved as if it were alone." );
+    for (int c = 1; c < width6; c++) {
+      double product = 0;
+      for (int j = i; j < n6; j++) {
+	product += testing6.get(i,j)*unknowns6.get(j,c);
+      }
+      assert( abs(product - knowns6.get(i,c)) < 1E-9
+	      && "Every right-hand side is solved." );
+    }
+  }
+  cout << "Every right-hand side is solved." << endl;
+  // Enough right-hand sides that the updates are split over threads.
+  Dynamic2DArray<double> wide6(n6,n6);
+  for (int i = 0; i < n6; i++) {
+    for (int c = 0; c < n6; c++) {
+      wide6.access(i,c) = cos(1.0 + i + 3*c);
+    }
+  }
+  Dynamic2DArray<double> wide_threaded6 = wide6;
+  triangular_solve(testing6,wide6,1);
+  triangular_solve(testing6,wide_threaded6,4);
+  for (int i = 0; i < n6; i++) {
+    for (int c = 0; c < n6; c++) {
+      assert( wide6.get(i,c) == wide_threaded6.get(i,c)
+	      && "Many right-hand sides don't depend on threads either." );
+    }
+  }
+
+  cout << "\n\nSolving nine 7x7 systems together, one degenerate." << endl;
+  const int n8 = 7;
+  const int count8 = 9;
+  vector<GaussianSystem> systems8(count8,GaussianSystem(n8));
+  vector<const GaussianSystem*> pointers8(count8);
+  for (int s = 0; s < count8; s++) {
+    for (int i = 0; i < n8; i++) {
+      for (int j = 0; j <= n8; j++) {
+	// Row i of system 4 is twice row i - 1, from row 4 on.
+	double value = (double)rand()/RAND_MAX - 0.5;
+	if ( s == 4 && i == 4 ) {
+	  value = 2*systems8[s].get(3,j);
+	}
+	systems8[s].set(i,j,value);
+      }
+    }
+    pointers8[s] = &systems8[s];
+  }
+  vector<Dynamic1DArray<double> > solutions8(count8);
+  int solved8 = batched_solve(pointers8.data(),count8,solutions8.data());
+  assert( solved8 == count8 - 1 && "Every system but one is solved." );
+  for (int s = 0; s < count8; s++) {
+    if ( s == 4 ) {
+      assert( solutions8[s].length() == 0 && "The degenerate one isn't." );
+      continue;
+    }
+    GaussianSystem reduced8 = systems8[s];
+    gaussian_elimination(reduced8);
+    Dynamic1DArray<double> expected8 = back_substitution(reduced8);
+    for (int i = 0; i < n8; i++) {
+      assert( abs(solutions8[s][i] - expected8[i])
+	      < 1E-12*(1 + abs(expected8[i]))
+	      && "Solving together agrees with solving alone." );
+    }
+  }
+  cout << "Solving together agrees with solving alone." << endl;
+
+  cout << "\n\nSolving a column-major view whose columns are 2^30 apart."
+       << endl;
+  // The offsets of the last column are past 2^31.
+  const int n7 = 3;
+  const ptrdiff_t leading7 = ((ptrdiff_t)1 << 30) + 3;
+  size_t bytes7 = (size_t)n7*leading7*sizeof(double);
+  double* memory7 = reserve_address_space(bytes7);
+  if ( memory7 == NULL ) {
+    cout << "This machine won't reserve " << bytes7 << " bytes. Skipping."
+	 << endl;
+  } else {
+    double matrix7[n7][n7] = {{2, 1, 1}, {1, 3, 2}, {1, 0, 0}};
+    double expected7[n7] = {1, -2, 3};
+    EliminationMethod methods7[2] = {STANDARD_ELIMINATION,
+				     RECURSIVE_ELIMINATION};
+    for (int m = 0; m < 2; m++) {
+      double knowns7[n7];
+      for (int i = 0; i < n7; i++) {
+	knowns7[i] = 0;
+	for (int j = 0; j < n7; j++) {
+	  memory7[i + j*leading7] = matrix7[i][j];
+	  knowns7[i] += matrix7[i][j]*expected7[j];
+	}
+      }
+      GaussianSystem testing7(n7,memory7,leading7,COLUMN_MAJOR,knowns7);
+      Dynamic1DArray<double> solution7 = solve_system(testing7,methods7[m]);
+      for (int i = 0; i < n7; i++) {
+	assert( abs(solution7[i] - expected7[i]) < 1E-12
+		&& "Huge leading dimensions are indexed in 64 bits." );
+      }
+    }
+    munmap(memory7,bytes7);
+  }
+
   cout << "\n\nThis conlcudes the test." << endl;
 }
 // ----------------------------------------------------------------------
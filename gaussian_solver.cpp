@@ -0,0 +1,270 @@
+// gaussian_solver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 14:58:02 (jonah)>
+
+// This file is a command-line solver for streams of systems. The
+// input is any number of systems in the format build() reads, one
+// after another, i.e.,
+// 2
+// 0 1 3
+// 1 0 4
+// 3
+// 1 0 0 1
+// 0 1 0 1
+// 0 0 1 1
+// Parsing, solving and writing run at the same time: the main thread
+// parses and submits systems to a SolverService, and a writer thread
+// prints the solutions in input order as they finish. The queues
+// between the stages are bounded, so memory use stays flat however
+// long the input is. Throughput is reported on cerr at the end.
+
+// Usage: gaussian_solver.bin [options] [input file]
+// With no input file, or with -, reads standard input.
+// Options:
+//   -j N            Use N solver threads. Default: one per core.
+//   -b N            Keep at most N systems in flight. Default: 256.
+//   -m METHOD       standard, recursive, tournament, strassen or
+//                   tuned. Default: standard. tuned uses the tuning
+//                   profile; see tuning.hpp.
+//   -l N            Eliminate systems of N or more unknowns with
+//                   LAPACK, if the Makefile found it. See
+//                   solver_backend.hpp.
+//   -s              Analyze the structure of each system first, and
+//                   solve triangular, diagonal and decoupled systems
+//                   by the fast paths of structure_analysis.hpp.
+//   -c MB           Cache the LU factors of up to MB megabytes of
+//                   matrices, so a matrix that comes back with new
+//                   knowns is only substituted. See
+//                   factorization_cache.hpp.
+//   -o FILE         Write to FILE instead of standard output.
+//   -f FORMAT       pretty, text or binary. Default: pretty. pretty
+//                   is print_solution(). text and binary are the
+//                   fast formats of solution_writer.hpp; a degenerate
+//                   system comes out as an empty solution.
+// Set the environment variable GAUSSIAN_TRACE to a file name to
+// write a timeline of parsing, solving and writing there, for
+// chrome://tracing or Perfetto. See trace.hpp.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <future>
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "solver_service.hpp"
+#include "bounded_queue.hpp"
+#include "solution_writer.hpp"
+#include "tuning.hpp"
+#include "solver_backend.hpp"
+#include "trace.hpp"
+#include "wall_time.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Utilities
+// ----------------------------------------------------------------------
+
+// Prints how to use the program and quits.
+static void usage(const char* program) {
+  cerr << "Usage: " << program << " [options] [input file]\n"
+       << "  -j N       Use N solver threads. Default: one per core.\n"
+       << "  -b N       Keep at most N systems in flight. Default: 256.\n"
+       << "  -m METHOD  standard, recursive, tournament, strassen or tuned.\n"
+       << "  -l N       Use LAPACK for N or more unknowns, if built in.\n"
+       << "  -s         Take structural fast paths where possible.\n"
+       << "  -c MB      Cache up to MB megabytes of factorizations.\n"
+       << "  -o FILE    Write to FILE instead of standard output.\n"
+       << "  -f FORMAT  pretty, text or binary. Default: pretty."
+       << endl;
+  exit(1);
+}
+
+// Skips whitespace and says whether there is another system to read.
+static bool another_system(istream& input) {
+  input >> ws;
+  return input.good() && input.peek() != EOF;
+}
+
+// The output formats.
+enum OutputFormat {
+  PRETTY_OUTPUT, // print_solution()
+  TEXT_OUTPUT, // write_solution_text()
+  BINARY_OUTPUT // write_solution_binary()
+};
+
+// The writer stage. Waits on each future in input order and writes
+// it. Counts the systems it writes.
+static void write_solutions(BlockingQueue<future<SolveResult>*>& in_flight,
+			    ostream& output, OutputFormat format,
+			    long& written) {
+  if ( tracing() ) {
+    set_trace_thread_name("writer");
+  }
+  BufferedWriter writer(output);
+  future<SolveResult>* result;
+  while ( in_flight.pop(result) ) {
+    SolveResult outcome;
+    {
+      TracedScope waiting("wait_for_result","scheduling");
+      outcome = result->get();
+    }
+    delete result;
+    if ( format == TEXT_OUTPUT ) {
+      write_solution_text(writer,outcome.solution);
+    } else if ( format == BINARY_OUTPUT ) {
+      write_solution_binary(writer,outcome.solution);
+    } else if ( outcome.status == SOLVED ) {
+      output << "# system " << written << "\n";
+      print_solution(output,outcome.solution,0);
+    } else {
+      output << "# system " << written << ": degenerate\n" << endl;
+    }
+    written++;
+  }
+  writer.flush();
+  output.flush();
+}
+// ----------------------------------------------------------------------
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+  SolverServiceOptions options;
+  int in_flight_limit = 256;
+  const char* input_name = "-";
+  const char* output_name = NULL;
+  OutputFormat format = PRETTY_OUTPUT;
+  for (int a = 1; a < argc; a++) {
+    if ( strcmp(argv[a],"-j") == 0 && a+1 < argc ) {
+      options.worker_threads = atoi(argv[++a]);
+    } else if ( strcmp(argv[a],"-b") == 0 && a+1 < argc ) {
+      in_flight_limit = atoi(argv[++a]);
+    } else if ( strcmp(argv[a],"-m") == 0 && a+1 < argc ) {
+      a++;
+      if ( strcmp(argv[a],"standard") == 0 ) {
+	options.method = STANDARD_ELIMINATION;
+      } else if ( strcmp(argv[a],"recursive") == 0 ) {
+	options.method = RECURSIVE_ELIMINATION;
+      } else if ( strcmp(argv[a],"tournament") == 0 ) {
+	options.method = TOURNAMENT_ELIMINATION;
+      } else if ( strcmp(argv[a],"strassen") == 0 ) {
+	options.method = STRASSEN_ELIMINATION;
+      } else if ( strcmp(argv[a],"tuned") == 0 ) {
+	options.method = TUNED_ELIMINATION;
+      } else {
+	usage(argv[0]);
+      }
+    } else if ( strcmp(argv[a],"-l") == 0 && a+1 < argc ) {
+      if ( !route_systems(atoi(argv[++a]),LAPACK_BACKEND) ) {
+	cerr << "This build has no LAPACK backend." << endl;
+	return 1;
+      }
+    } else if ( strcmp(argv[a],"-s") == 0 ) {
+      options.analyze_structure = true;
+    } else if ( strcmp(argv[a],"-c") == 0 && a+1 < argc ) {
+      options.cache_budget = (size_t)atoi(argv[++a]) << 20;
+    } else if ( strcmp(argv[a],"-o") == 0 && a+1 < argc ) {
+      output_name = argv[++a];
+    } else if ( strcmp(argv[a],"-f") == 0 && a+1 < argc ) {
+      a++;
+      if ( strcmp(argv[a],"pretty") == 0 ) {
+	format = PRETTY_OUTPUT;
+      } else if ( strcmp(argv[a],"text") == 0 ) {
+	format = TEXT_OUTPUT;
+      } else if ( strcmp(argv[a],"binary") == 0 ) {
+	format = BINARY_OUTPUT;
+      } else {
+	usage(argv[0]);
+      }
+    } else if ( argv[a][0] == '-' && argv[a][1] != '\0' ) {
+      usage(argv[0]);
+    } else {
+      input_name = argv[a];
+    }
+  }
+  if ( in_flight_limit < 1 ) {
+    usage(argv[0]);
+  }
+  // Reads the tuning profile now, rather than in the middle of the
+  // first solve.
+  tuning_profile();
+
+  ifstream input_file;
+  istream* input = &cin;
+  if ( strcmp(input_name,"-") != 0 ) {
+    input_file.open(input_name);
+    if ( !input_file ) {
+      cerr << "Can't open " << input_name << endl;
+      return 1;
+    }
+    input = &input_file;
+  }
+  ofstream output_file;
+  ostream* output = &cout;
+  if ( output_name != NULL ) {
+    output_file.open(output_name,ios::binary);
+    if ( !output_file ) {
+      cerr << "Can't open " << output_name << endl;
+      return 1;
+    }
+    output = &output_file;
+  }
+
+  // The service queue and the in-flight queue are both bounded, so
+  // the parser waits whenever the solvers or the writer fall behind.
+  options.queue_depth = in_flight_limit;
+  double start = wall_time();
+  long parsed = 0;
+  long unknowns = 0;
+  long written = 0;
+  SolverServiceStatistics statistics;
+  {
+    SolverService service(options);
+    BlockingQueue<future<SolveResult>*> in_flight(in_flight_limit);
+    thread writer(write_solutions,ref(in_flight),ref(*output),format,
+		  ref(written));
+
+    if ( tracing() ) {
+      set_trace_thread_name("parser");
+    }
+    GaussianSystem g_sys;
+    while ( another_system(*input) ) {
+      {
+	TracedScope parsing("parse","io");
+	g_sys.build(*input);
+      }
+      if ( input->fail() ) {
+	cerr << "Couldn't parse system " << parsed << "." << endl;
+	break;
+      }
+      in_flight.push(new future<SolveResult>(service.submit(g_sys)));
+      parsed++;
+      unknowns += g_sys.size();
+    }
+    in_flight.close();
+    writer.join();
+    statistics = service.statistics();
+  }
+  double elapsed = wall_time() - start;
+
+  cerr << "Solved " << written << " systems (" << unknowns
+       << " unknowns) in " << elapsed << " s.\n"
+       << "Throughput: " << written/elapsed << " systems/s.\n"
+       << "Degenerate: " << statistics.degenerate << ".\n"
+       << "Fast paths: " << statistics.fast_paths << ".\n"
+       << "Cache hits: " << statistics.cache_hits << " of "
+       << statistics.cache_hits + statistics.cache_misses << ".\n"
+       << "Mean solve latency: " << statistics.mean_latency << " s."
+       << endl;
+  return (written == parsed) ? 0 : 1;
+}
+// ----------------------------------------------------------------------
@@ -22,26 +22,29 @@ using namespace std;
 // Creates an empty gaussian system with an nxn coefficient matrix
 // and n unknowns.
 GaussianSystem::GaussianSystem(int n) {
+  read_only_view = false;
   // Build the arrays
   initialize_all_arrays(n);
   // Sets the matrix to un-permuted
   initialize_permutation_vector();
-  // Initializes the system to the trivial zero matrix.
+  // Initializes the system to the trivial zero matrix. The matrix
+  // already starts out zero, in parallel if its placement asks, so
+  // only the knowns are left.
   for (int row = 0; row < n; row++) {
-    for (int column = 0; column < n+1; column++) {
-      access(row,column) = 0;
-    }
+    knowns_vector[row] = 0;
   }
 }
 
 // Creates an empty Gaussian system. To be initialized later.
 GaussianSystem::GaussianSystem() {
   system_size = 0; // 0 represents an unitialized system.
+  read_only_view = false;
 }
 
 // Copy constructor. Creates a new Gaussian system that's a copy of
 // the input oone.
 GaussianSystem::GaussianSystem(const GaussianSystem &rhs) {
+  read_only_view = false;
   initialize_all_arrays(rhs.size());
   initialize_permutation_vector();
   for (int row = 0; row < system_size; row++) {
@@ -67,6 +70,7 @@ GaussianSystem::GaussianSystem(ifstream& input_file) {
   // Get the system size and then initialize the arrays.
   int n;
   input_file >> n;
+  read_only_view = false;
   initialize_all_arrays(n);
   initialize_permutation_vector();
   // Start reading in the files.
@@ -77,6 +81,19 @@ GaussianSystem::GaussianSystem(ifstream& input_file) {
   }
 }
 
+// View constructor. Wraps the caller's buffers without copying.
+GaussianSystem::GaussianSystem(int n, double* matrix,
+			       ptrdiff_t leading_dimension,
+			       ArrayLayout layout, double* knowns,
+			       CallerMemory memory/*= OVERWRITE_CALLER_MEMORY*/)
+  : coefficient_matrix(matrix,n,n,leading_dimension,layout),
+    knowns_vector(knowns,n),
+    permutation_vector(n) {
+  system_size = n;
+  read_only_view = (memory == PRESERVE_CALLER_MEMORY);
+  initialize_permutation_vector();
+}
+
 // ----------------------------------------------------------------------
 
 
@@ -86,12 +103,30 @@ GaussianSystem::GaussianSystem(ifstream& input_file) {
 // Initializes the arrays for a system of size n.
 void GaussianSystem::initialize_all_arrays(int n) {
   system_size = n;
-  coefficient_matrix = Dynamic2DArray<double>(n,n);
-  knowns_vector = Dynamic1DArray<double>(n);
-  permutation_vector = Dynamic1DArray<int>(n);
+  read_only_view = false;
+  coefficient_matrix.reset(n,n,default_placement());
+  knowns_vector.reset(n);
+  permutation_vector.reset(n);
   return;
 }
 
+// Copies a read-only view into packed memory of its own, row by
+// row in memory order so the permutation still applies.
+void GaussianSystem::copy_caller_memory() {
+  Dynamic2DArray<double> matrix(system_size,system_size,
+				 default_placement());
+  Dynamic1DArray<double> knowns(system_size);
+  for (int row = 0; row < system_size; row++) {
+    for (int column = 0; column < system_size; column++) {
+      matrix.access(row,column) = coefficient_matrix.get(row,column);
+    }
+    knowns[row] = knowns_vector.get(row);
+  }
+  coefficient_matrix.swap(matrix);
+  knowns_vector.swap(knowns);
+  read_only_view = false;
+}
+
 // Initializes the permutation vector to the identity.
 // WARNING: DO NOT CALL THIS METHOD BEFORE CALLING initialize_all_arrays
 void GaussianSystem::initialize_permutation_vector() {
@@ -131,11 +166,79 @@ void GaussianSystem::swap(int row1, int row2) {
   permutation_vector[row2] = temp_row;
 }
 
+// Returns a pointer to the coefficients of row i, if they are
+// contiguous.
+const double* GaussianSystem::matrix_row(int i) const {
+  assert(i < system_size && i >= 0
+	 && "Coordinates within allocated memory.");
+  if ( coefficient_matrix.column_stride() != 1 ) {
+    return NULL;
+  }
+  return coefficient_matrix.data()
+    + permutation_vector.get(i)*coefficient_matrix.row_stride();
+}
+
+// Makes memory row rows[i] hold row i, for every i.
+void GaussianSystem::set_permutation(const Dynamic1DArray<int>& rows) {
+  assert( rows.length() == system_size && "One memory row per row." );
+  Dynamic1DArray<int> seen(system_size);
+  for (int row = 0; row < system_size; row++) {
+    seen[row] = 0;
+  }
+  for (int row = 0; row < system_size; row++) {
+    int memory_row = rows.get(row);
+    assert( memory_row >= 0 && memory_row < system_size
+	    && seen[memory_row] == 0 && "rows is a permutation." );
+    seen[memory_row] = 1;
+    permutation_vector[row] = memory_row;
+  }
+}
+
+// Physically reorders the rows of the system in memory so that the
+// permutation vector becomes the identity. Follows each cycle of the
+// permutation so only one row of scratch space is needed.
+void GaussianSystem::apply_permutation() {
+  make_writable();
+  coefficient_matrix.pack();
+  Dynamic1DArray<double> scratch_row(system_size + 1);
+  double* matrix = coefficient_matrix.data();
+  double* knowns = knowns_vector.data();
+  // The distance between rows, wide enough for any offset.
+  ptrdiff_t stride = system_size;
+  for (int start = 0; start < system_size; start++) {
+    if (permutation_vector[start] == start) {
+      continue;
+    }
+    // Save the row that will be overwritten first.
+    for (int column = 0; column < system_size; column++) {
+      scratch_row[column] = matrix[start*stride + column];
+    }
+    scratch_row[system_size] = knowns[start];
+    // Walk the cycle, pulling each row into place.
+    int row = start;
+    while (permutation_vector[row] != start) {
+      int source = permutation_vector[row];
+      for (int column = 0; column < system_size; column++) {
+	matrix[row*stride + column] = matrix[source*stride + column];
+      }
+      knowns[row] = knowns[source];
+      permutation_vector[row] = row;
+      row = source;
+    }
+    for (int column = 0; column < system_size; column++) {
+      matrix[row*stride + column] = scratch_row[column];
+    }
+    knowns[row] = scratch_row[system_size];
+    permutation_vector[row] = row;
+  }
+}
+
 // Returns the (i,j)th element of the coefficients matrix by
 // reference.
 double& GaussianSystem::matrix_access(int i, int j) {
   assert(i < system_size && j < system_size && i >= 0 && j >= 0
 	 && "Coordinates within allocated memory.");
+  make_writable();
   return coefficient_matrix.access(permutation_vector[i],j);
 }
 
@@ -143,6 +246,7 @@ double& GaussianSystem::matrix_access(int i, int j) {
 double& GaussianSystem::vector_access(int i) {
   assert(i < system_size && i >= 0
 	 && "Coordinates within allocated memory.");
+  make_writable();
   return knowns_vector[permutation_vector[i]];
 }
 
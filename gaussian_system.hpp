@@ -9,6 +9,14 @@
 
 // Note that some methods are defined inline for speed and ease of use.
 
+// A system can also be a view of a matrix and vector of knowns that
+// the caller already holds, in any layout and with any leading
+// dimension. Then nothing is copied, and elimination and back
+// substitution work on the caller's buffers. See CallerMemory.
+
+// The size of a system is an int, but every offset into its matrix
+// is computed in 64 bits, so systems past 46340 x 46340 work.
+
 // Include guard
 #pragma once
 
@@ -19,6 +27,21 @@
 #include "dynamic_array.hpp" // for dynamic arrays
 using namespace std;
 
+// What a system that views caller memory may do with it.
+enum CallerMemory {
+  // Solve in the caller's buffers, which afterwards hold the reduced
+  // system. Read it through the system, since the rows may have been
+  // reordered and the matrix packed row-major in place. See
+  // apply_permutation().
+  OVERWRITE_CALLER_MEMORY,
+  // Never write to the caller's buffers. They are read in place
+  // until the first write, which copies the system into memory of
+  // its own. So read-only work, like an iterative solve of a
+  // row-major view, costs no copy, and an elimination costs one
+  // fast copy.
+  PRESERVE_CALLER_MEMORY
+};
+
 // A class that holds an n-dimensional matrix equation. Uses an nxn
 // matrix and a n-dimensional vector. Enables row-swapping for
 // Gaussian elimination.
@@ -48,6 +71,15 @@ public: // Constructors, destructors, and assignment operators.
   // Ax = y
   // where the solution is that x_1 = x_2 = x_3 = 1.
   GaussianSystem(ifstream& input_file);
+  // View constructor. Builds an n-dimensional system on the caller's
+  // n x n matrix, laid out as layout with the given leading
+  // dimension, and the caller's n knowns. Nothing is copied. memory
+  // says whether solving may overwrite the buffers. The buffers must
+  // outlive the system, or at least its first write in
+  // PRESERVE_CALLER_MEMORY mode.
+  GaussianSystem(int n, double* matrix, ptrdiff_t leading_dimension,
+		 ArrayLayout layout, double* knowns,
+		 CallerMemory memory = OVERWRITE_CALLER_MEMORY);
   // Assignment operator. Copies one Gaussian System into another.
   GaussianSystem& operator = (const GaussianSystem &rhs) {
     initialize_all_arrays(rhs.size());
@@ -67,6 +99,17 @@ private: // Implementation details.
   Dynamic1DArray<double> knowns_vector; // Vector of knowns. b
   // Keeps track of row swaps so that rows don't actually have to be copied.
   Dynamic1DArray<int> permutation_vector;
+  // True while the arrays are views of caller memory that must not be
+  // written.
+  bool read_only_view;
+  // Copies a read-only view into memory of its own. Called before
+  // anything is written.
+  void make_writable() {
+    if ( read_only_view ) {
+      copy_caller_memory();
+    }
+  }
+  void copy_caller_memory();
   // Initializes the permutation vector to the identity.
   void initialize_permutation_vector();
   // Initializes the arrays for a system of size n.
@@ -76,12 +119,49 @@ public: // Interface.
   int size() const {
     return system_size;
   }
+  // Whether the system is still working on caller memory from the
+  // view constructor.
+  bool is_view() const {
+    return coefficient_matrix.is_view();
+  }
   // Returns true if the system isupper-triangular. False otherwise.
   // To determine if a row element is zero, uses DEFAULT_PRECISION by
   // default
   bool is_upper_triangular() const;
   // Swaps row1 and row2 in the system. Useful for pivoting.
   void swap(int row1, int row2);
+  // The row of memory that holds row i. Swaps only change this.
+  int memory_row(int i) const {
+    return permutation_vector.get(i);
+  }
+  // Returns a pointer to the coefficients of row i, which are
+  // contiguous in memory, or NULL if they aren't, as in a
+  // column-major view. Read only, and no bounds checking.
+  const double* matrix_row(int i) const;
+  // Makes memory row rows[i] hold row i, for every i, without moving
+  // anything in memory. rows must be a permutation of 0..size()-1.
+  // Used to restore a saved system exactly.
+  void set_permutation(const Dynamic1DArray<int>& rows);
+  // Physically reorders the rows of the system in memory so that the
+  // permutation vector becomes the identity. A view of caller memory
+  // is also packed row-major in place first, with
+  // Dynamic2DArray::pack(). The system looks the same through get
+  // and set afterwards. Call this before working on matrix_data()
+  // and vector_data() directly.
+  void apply_permutation();
+  // Returns a pointer to the first element of the coefficient
+  // matrix. Rows are contiguous and size() elements apart, in memory
+  // order. Memory order is row order, and a view is packed, only
+  // after apply_permutation(). No bounds checking, so use with care.
+  double* matrix_data() {
+    make_writable();
+    return coefficient_matrix.data();
+  }
+  // Like matrix_data, but for the vector of knowns.
+  double* vector_data() {
+    make_writable();
+    return knowns_vector.data();
+  }
   // Sets the (i,j)th element of the system. The final
   // column is the vector. The other columns are the coefficient
   // matrix.
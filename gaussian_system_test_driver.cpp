@@ -13,8 +13,25 @@
 #include <cassert>
 #include "dynamic_array.hpp"
 #include "gaussian_system.hpp"
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 using namespace std;
 
+// Reserves bytes of address space that only takes memory where it
+// is touched, for views far bigger than the machine. Returns NULL if
+// the system won't hand out that much.
+static double* reserve_address_space(size_t bytes) {
+#ifdef __linux__
+  void* memory = mmap(NULL,bytes,PROT_READ | PROT_WRITE,
+		      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,-1,0);
+  return memory == MAP_FAILED ? NULL : (double*)memory;
+#else
+  return NULL;
+#endif
+}
+
+
 // Main function
 // ----------------------------------------------------------------------
 int main() {
@@ -67,5 +84,63 @@ int main() {
   testing1.print(cout,0);
   cout << endl;
 
+  cout << "\n\n"
+       << "Testing views of caller memory.\n"
+       << "----------------------------------------------------\n" << endl;
+
+  double matrix[4] = {1, 2, 3, 4};
+  double knowns[2] = {5, 6};
+  cout << "Viewing a 2x2 row-major matrix without overwriting it." << endl;
+  GaussianSystem view(2,matrix,2,ROW_MAJOR,knowns,PRESERVE_CALLER_MEMORY);
+  view.swap(0,1);
+  view.print(cout,0);
+  assert( view.is_view() && view.get(0,0) == 3 && view.get(0,2) == 6
+	  && "Reading and swapping don't copy." );
+  view.set(0,0,30);
+  assert( !view.is_view() && matrix[2] == 3 && view.get(0,0) == 30
+	  && view.get(1,1) == 2 && "The first write copies." );
+  GaussianSystem assigned(2,matrix,2,ROW_MAJOR,knowns,
+			 PRESERVE_CALLER_MEMORY);
+  assigned = view;
+  assert( !assigned.is_view() && assigned.get(0,0) == 30
+	  && matrix[0] == 1 && knowns[0] == 5 && knowns[1] == 6
+	  && "Assigning a system to a view copies it." );
+
+  cout << "Viewing the same memory as a column-major matrix." << endl;
+  GaussianSystem overwrite(2,matrix,2,COLUMN_MAJOR,knowns);
+  overwrite.set(0,1,20);
+  overwrite.print(cout,0);
+  assert( overwrite.is_view() && matrix[2] == 20 && overwrite.get(1,0) == 2
+	  && "Overwriting views write through." );
+
+  cout << "\n\n"
+       << "Testing a system past the old 32-bit limit.\n"
+       << "----------------------------------------------------\n" << endl;
+
+  // 46341^2 coefficients don't fit in an int. Only a few rows of the
+  // view are ever touched.
+  const int n = 46341;
+  size_t bytes = (size_t)n*n*sizeof(double);
+  double* big_matrix = reserve_address_space(bytes);
+  if ( big_matrix == NULL ) {
+    cout << "This machine won't reserve " << bytes << " bytes. Skipping."
+	 << endl;
+  } else {
+    Dynamic1DArray<double> big_knowns(n);
+    GaussianSystem big(n,big_matrix,n,ROW_MAJOR,big_knowns.data());
+    big.set(0,0,1);
+    big.set(n - 1,n - 2,2);
+    big.set(n - 1,n,3);
+    assert( big_matrix[(size_t)(n - 1)*n + n - 2] == 2
+	    && big.matrix_row(n - 1) == big_matrix + (size_t)(n - 1)*n
+	    && "Rows past 2^31 elements are where they should be." );
+    big.swap(0,n - 1);
+    big.apply_permutation();
+    assert( big_matrix[n - 2] == 2 && big_knowns[0] == 3
+	    && big_matrix[(size_t)(n - 1)*n] == 1 && big.get(0,n - 2) == 2
+	    && "Rows are moved across the whole matrix." );
+    munmap(big_matrix,bytes);
+  }
+
   cout << "Test successful." << endl;
 }
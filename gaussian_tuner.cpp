@@ -0,0 +1,94 @@
+// gaussian_tuner.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 16:31:54 (jonah)>
+
+// This file is the command-line auto-tuner. It times every
+// elimination algorithm and block size, the back substitution blocks
+// and thread counts, and the gemm() kernels on this machine, over a
+// range of system sizes, and writes the fastest to a tuning profile
+// that the library reads. See tuning.hpp.
+
+// Usage: gaussian_tuner.bin [options] [sizes...]
+// The default sizes are 64 128 256 512 1024, which take about a
+// minute on one core.
+// Options:
+//   -o FILE         Write the profile to FILE. Default:
+//                   gaussian_tuning.profile, where the library looks
+//                   for it.
+//   -t N            Time each candidate N times and keep the best.
+//                   Default: 3.
+//   -q              Don't print each time.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "dynamic_array.hpp"
+#include "tuning.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Prints how to use the program and quits.
+static void usage(const char* program) {
+  cerr << "Usage: " << program << " [options] [sizes...]\n"
+       << "  -o FILE  Write the profile to FILE. Default: "
+       << DEFAULT_TUNING_PROFILE << ".\n"
+       << "  -t N     Time each candidate N times. Default: 3.\n"
+       << "  -q       Don't print each time."
+       << endl;
+  exit(1);
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+  const char* output_name = DEFAULT_TUNING_PROFILE;
+  int trials = 3;
+  bool quiet = false;
+  vector<int> sizes;
+  for (int a = 1; a < argc; a++) {
+    if ( strcmp(argv[a],"-o") == 0 && a+1 < argc ) {
+      output_name = argv[++a];
+    } else if ( strcmp(argv[a],"-t") == 0 && a+1 < argc ) {
+      trials = atoi(argv[++a]);
+    } else if ( strcmp(argv[a],"-q") == 0 ) {
+      quiet = true;
+    } else if ( argv[a][0] == '-' ) {
+      usage(argv[0]);
+    } else {
+      sizes.push_back(atoi(argv[a]));
+      if ( sizes.back() < 1 ) {
+	usage(argv[0]);
+      }
+    }
+  }
+  if ( trials < 1 ) {
+    usage(argv[0]);
+  }
+  if ( sizes.empty() ) {
+    for (int n = 64; n <= 1024; n *= 2) {
+      sizes.push_back(n);
+    }
+  }
+
+  Dynamic1DArray<int> size_array((int)sizes.size());
+  for (size_t i = 0; i < sizes.size(); i++) {
+    size_array[i] = sizes[i];
+  }
+  TuningProfile profile = run_tuning_trials(size_array,trials,
+					    quiet ? NULL : &cerr);
+  if ( !profile.save(output_name) ) {
+    cerr << "Can't write " << output_name << endl;
+    return 1;
+  }
+  profile.save(cout);
+  return 0;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,486 @@
+// gemm.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 13:27:55 (jonah)>
+
+// This file implements general matrix multiplication with packed
+// panels and a register-blocked micro-kernel.
+
+// The loops are the five around the micro-kernel of Goto's
+// algorithm. Columns of C are taken NC at a time and the inner
+// dimension KC at a time; the KC x NC panel of B is packed once and
+// shared by every thread. Rows of C are taken MC at a time, each
+// thread packing its own MC x KC block of A, scaled by alpha. The
+// micro-kernel then multiplies an MR-row sliver of the A block by
+// an NR-column sliver of the B panel, adding the result into C.
+// Both slivers are zero-padded to full size, so edge tiles go
+// through a scratch tile.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "gemm.hpp"
+#include "parallel_for.hpp"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GEMM_HAVE_X86
+#endif
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Block sizes
+// ----------------------------------------------------------------------
+
+// The micro-kernel tile, MR x NR, and the cache blocks. MC x KC of A
+// stays in L2 and KC x NR of B in L1. MC is a multiple of MR and NC
+// of NR.
+template<typename TYPE> struct GemmShape;
+template<> struct GemmShape<double> {
+  static const int MR = 6;
+  static const int NR = 8;
+  static const int MC = 72;
+  static const int KC = 256;
+  static const int NC = 4080;
+};
+template<> struct GemmShape<float> {
+  static const int MR = 6;
+  static const int NR = 16;
+  static const int MC = 144;
+  static const int KC = 256;
+  static const int NC = 4080;
+};
+
+// Products with fewer multiply-adds than this run on one thread.
+static const double MIN_PARALLEL_WORK = 1 << 21;
+// Packed buffers start on a cache line, so the kernels' loads never
+// straddle two.
+static const size_t CACHE_LINE = 64;
+
+// A scratch buffer for packed panels, aligned to a cache line.
+template<typename TYPE>
+class PackedBuffer {
+public:
+  PackedBuffer(size_t size) : storage(size + CACHE_LINE/sizeof(TYPE)) {}
+  TYPE* data() {
+    uintptr_t address = (uintptr_t)storage.data();
+    address = (address + CACHE_LINE - 1) & ~(uintptr_t)(CACHE_LINE - 1);
+    return (TYPE*)address;
+  }
+private:
+  vector<TYPE> storage;
+};
+// ----------------------------------------------------------------------
+
+
+// Micro-kernels
+// ----------------------------------------------------------------------
+
+// C += A*B for one MR x NR tile. a is an MR-row sliver of packed A
+// and b an NR-column sliver of packed B, both kc long. Rows of c are
+// ldc apart.
+template<typename TYPE>
+struct MicroKernel {
+  typedef void (*Function)(int kc, const TYPE* a, const TYPE* b,
+			   TYPE* c, long ldc);
+};
+
+// The portable kernel. Written so the compiler can keep the tile in
+// registers and vectorize the inner loop for whatever it targets.
+template<typename TYPE>
+static void generic_kernel(int kc, const TYPE* a, const TYPE* b,
+			   TYPE* c, long ldc) {
+  const int MR = GemmShape<TYPE>::MR;
+  const int NR = GemmShape<TYPE>::NR;
+  TYPE tile[MR][NR] = {};
+  for (int p = 0; p < kc; p++) {
+    for (int r = 0; r < MR; r++) {
+      TYPE value = a[r];
+      for (int j = 0; j < NR; j++) {
+	tile[r][j] += value*b[j];
+      }
+    }
+    a += MR;
+    b += NR;
+  }
+  for (int r = 0; r < MR; r++) {
+    for (int j = 0; j < NR; j++) {
+      c[r*ldc + j] += tile[r][j];
+    }
+  }
+}
+
+#ifdef GEMM_HAVE_X86
+// The 6x8 double kernel. Twelve accumulators, two broadcasts' worth
+// of B loads per step, and six broadcasts of A, leaving registers
+// for the loads.
+__attribute__((target("avx2,fma")))
+static void avx2_kernel(int kc, const double* a, const double* b,
+			double* c, long ldc) {
+  for (int r = 0; r < 6; r++) {
+    _mm_prefetch((const char*)(c + r*ldc),_MM_HINT_T0);
+  }
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+  __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+#pragma GCC unroll 4
+  for (int p = 0; p < kc; p++) {
+    __m256d b0 = _mm256_loadu_pd(b);
+    __m256d b1 = _mm256_loadu_pd(b + 4);
+    __m256d value = _mm256_broadcast_sd(a);
+    c00 = _mm256_fmadd_pd(value,b0,c00);
+    c01 = _mm256_fmadd_pd(value,b1,c01);
+    value = _mm256_broadcast_sd(a + 1);
+    c10 = _mm256_fmadd_pd(value,b0,c10);
+    c11 = _mm256_fmadd_pd(value,b1,c11);
+    value = _mm256_broadcast_sd(a + 2);
+    c20 = _mm256_fmadd_pd(value,b0,c20);
+    c21 = _mm256_fmadd_pd(value,b1,c21);
+    value = _mm256_broadcast_sd(a + 3);
+    c30 = _mm256_fmadd_pd(value,b0,c30);
+    c31 = _mm256_fmadd_pd(value,b1,c31);
+    value = _mm256_broadcast_sd(a + 4);
+    c40 = _mm256_fmadd_pd(value,b0,c40);
+    c41 = _mm256_fmadd_pd(value,b1,c41);
+    value = _mm256_broadcast_sd(a + 5);
+    c50 = _mm256_fmadd_pd(value,b0,c50);
+    c51 = _mm256_fmadd_pd(value,b1,c51);
+    a += 6;
+    b += 8;
+  }
+  __m256d rows[6][2] = {{c00,c01}, {c10,c11}, {c20,c21},
+			{c30,c31}, {c40,c41}, {c50,c51}};
+  for (int r = 0; r < 6; r++) {
+    double* row = c + r*ldc;
+    _mm256_storeu_pd(row,_mm256_add_pd(_mm256_loadu_pd(row),rows[r][0]));
+    _mm256_storeu_pd(row + 4,
+		     _mm256_add_pd(_mm256_loadu_pd(row + 4),rows[r][1]));
+  }
+}
+
+// The 6x16 float kernel. The same as the double one, eight floats to
+// a register.
+__attribute__((target("avx2,fma")))
+static void avx2_kernel(int kc, const float* a, const float* b,
+			float* c, long ldc) {
+  __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+  __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+  __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+  __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+  __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+  __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+#pragma GCC unroll 4
+  for (int p = 0; p < kc; p++) {
+    __m256 b0 = _mm256_loadu_ps(b);
+    __m256 b1 = _mm256_loadu_ps(b + 8);
+    __m256 value = _mm256_broadcast_ss(a);
+    c00 = _mm256_fmadd_ps(value,b0,c00);
+    c01 = _mm256_fmadd_ps(value,b1,c01);
+    value = _mm256_broadcast_ss(a + 1);
+    c10 = _mm256_fmadd_ps(value,b0,c10);
+    c11 = _mm256_fmadd_ps(value,b1,c11);
+    value = _mm256_broadcast_ss(a + 2);
+    c20 = _mm256_fmadd_ps(value,b0,c20);
+    c21 = _mm256_fmadd_ps(value,b1,c21);
+    value = _mm256_broadcast_ss(a + 3);
+    c30 = _mm256_fmadd_ps(value,b0,c30);
+    c31 = _mm256_fmadd_ps(value,b1,c31);
+    value = _mm256_broadcast_ss(a + 4);
+    c40 = _mm256_fmadd_ps(value,b0,c40);
+    c41 = _mm256_fmadd_ps(value,b1,c41);
+    value = _mm256_broadcast_ss(a + 5);
+    c50 = _mm256_fmadd_ps(value,b0,c50);
+    c51 = _mm256_fmadd_ps(value,b1,c51);
+    a += 6;
+    b += 16;
+  }
+  __m256 rows[6][2] = {{c00,c01}, {c10,c11}, {c20,c21},
+		       {c30,c31}, {c40,c41}, {c50,c51}};
+  for (int r = 0; r < 6; r++) {
+    float* row = c + r*ldc;
+    _mm256_storeu_ps(row,_mm256_add_ps(_mm256_loadu_ps(row),rows[r][0]));
+    _mm256_storeu_ps(row + 8,
+		     _mm256_add_ps(_mm256_loadu_ps(row + 8),rows[r][1]));
+  }
+}
+#endif
+
+// Whether this processor can run the AVX2 kernels.
+static bool have_avx2() {
+#ifdef GEMM_HAVE_X86
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+  return false;
+#endif
+}
+
+// The kernel chosen by set_gemm_kernel(). Atomic, since a tuning
+// profile can set it while other threads multiply.
+static atomic<GemmKernel> requested_kernel(AUTOMATIC_KERNEL);
+
+GemmKernel gemm_kernel() {
+  GemmKernel kernel = requested_kernel;
+  if ( kernel == AUTOMATIC_KERNEL ) {
+    return have_avx2() ? AVX2_KERNEL : GENERIC_KERNEL;
+  }
+  return kernel;
+}
+
+bool set_gemm_kernel(GemmKernel kernel) {
+  if ( kernel == AVX2_KERNEL && !have_avx2() ) {
+    return false;
+  }
+  requested_kernel = kernel;
+  return true;
+}
+
+// The micro-kernel to use for TYPE.
+template<typename TYPE>
+static typename MicroKernel<TYPE>::Function choose_kernel() {
+#ifdef GEMM_HAVE_X86
+  if ( gemm_kernel() == AVX2_KERNEL ) {
+    return static_cast<typename MicroKernel<TYPE>::Function>(avx2_kernel);
+  }
+#endif
+  return generic_kernel<TYPE>;
+}
+// ----------------------------------------------------------------------
+
+
+// Packing
+// ----------------------------------------------------------------------
+
+// Element (i,p) of op(A) is A[i*row_step + p*column_step], and
+// likewise for B. Transposing just swaps the steps.
+
+// Packs the mc x kc block of alpha op(A) at A into MR-row slivers,
+// each stored column by column. The last sliver is padded with
+// zeros.
+template<typename TYPE>
+static void pack_a(int mc, int kc, const TYPE* A, long row_step,
+		   long column_step, TYPE alpha, TYPE* packed) {
+  const int MR = GemmShape<TYPE>::MR;
+  for (int i = 0; i < mc; i += MR) {
+    int rows = min(MR,mc - i);
+    for (int p = 0; p < kc; p++) {
+      const TYPE* source = A + i*row_step + p*column_step;
+      int r = 0;
+      for (; r < rows; r++) {
+	packed[r] = alpha*source[r*row_step];
+      }
+      for (; r < MR; r++) {
+	packed[r] = 0;
+      }
+      packed += MR;
+    }
+  }
+}
+
+// Packs the kc x nc panel of op(B) at B into NR-column slivers, each
+// stored row by row. The last sliver is padded with zeros.
+template<typename TYPE>
+static void pack_b(int kc, int nc, const TYPE* B, long row_step,
+		   long column_step, TYPE* packed) {
+  const int NR = GemmShape<TYPE>::NR;
+  for (int j = 0; j < nc; j += NR) {
+    int columns = min(NR,nc - j);
+    for (int p = 0; p < kc; p++) {
+      const TYPE* source = B + p*row_step + j*column_step;
+      int c = 0;
+      if ( column_step == 1 ) {
+	for (; c < columns; c++) {
+	  packed[c] = source[c];
+	}
+      } else {
+	for (; c < columns; c++) {
+	  packed[c] = source[c*column_step];
+	}
+      }
+      for (; c < NR; c++) {
+	packed[c] = 0;
+      }
+      packed += NR;
+    }
+  }
+}
+// ----------------------------------------------------------------------
+
+
+// The product
+// ----------------------------------------------------------------------
+
+// C += packed A times packed B for an mc x nc block of C.
+template<typename TYPE>
+static void multiply_block(int mc, int nc, int kc, const TYPE* packed_a,
+			   const TYPE* packed_b, TYPE* C, long ldc,
+			   typename MicroKernel<TYPE>::Function kernel) {
+  const int MR = GemmShape<TYPE>::MR;
+  const int NR = GemmShape<TYPE>::NR;
+  for (int j = 0; j < nc; j += NR) {
+    int columns = min(NR,nc - j);
+    const TYPE* b = packed_b + (long)j*kc;
+    for (int i = 0; i < mc; i += MR) {
+      int rows = min(MR,mc - i);
+      const TYPE* a = packed_a + (long)i*kc;
+      TYPE* c = C + i*ldc + j;
+      if ( rows == MR && columns == NR ) {
+	kernel(kc,a,b,c,ldc);
+	continue;
+      }
+      TYPE tile[MR*NR] = {};
+      kernel(kc,a,b,tile,NR);
+      for (int r = 0; r < rows; r++) {
+	for (int q = 0; q < columns; q++) {
+	  c[r*ldc + q] += tile[r*NR + q];
+	}
+      }
+    }
+  }
+}
+
+// C = alpha op(A) op(B) + beta C, with op(A) and op(B) given by their
+// steps and C row-major.
+template<typename TYPE>
+static void multiply(int m, int n, int k, TYPE alpha,
+		     const TYPE* A, long a_row_step, long a_column_step,
+		     const TYPE* B, long b_row_step, long b_column_step,
+		     TYPE beta, TYPE* C, long ldc, int threads) {
+  const int MC = GemmShape<TYPE>::MC;
+  const int KC = GemmShape<TYPE>::KC;
+  const int NC = GemmShape<TYPE>::NC;
+  const int NR = GemmShape<TYPE>::NR;
+  if ( (double)m*n*k < MIN_PARALLEL_WORK ) {
+    threads = 1;
+  }
+  if ( beta != 1 ) {
+    parallel_for(0,m,threads,[&](int first, int last) {
+	for (int i = first; i < last; i++) {
+	  TYPE* row = C + i*ldc;
+	  for (int j = 0; j < n; j++) {
+	    // Overwrite rather than scale by 0, so NaNs in C don't
+	    // survive.
+	    row[j] = beta == 0 ? 0 : beta*row[j];
+	  }
+	}
+      });
+  }
+  if ( m == 0 || n == 0 || k == 0 || alpha == 0 ) {
+    return;
+  }
+
+  typename MicroKernel<TYPE>::Function kernel = choose_kernel<TYPE>();
+  int panel_width = min(NC,(n + NR - 1)/NR*NR);
+  PackedBuffer<TYPE> packed_b((size_t)KC*panel_width);
+  int blocks = (m + MC - 1)/MC;
+  for (int jc = 0; jc < n; jc += NC) {
+    int nc = min(NC,n - jc);
+    for (int pc = 0; pc < k; pc += KC) {
+      int kc = min(KC,k - pc);
+      pack_b(kc,nc,B + pc*b_row_step + jc*b_column_step,
+	     b_row_step,b_column_step,packed_b.data());
+      parallel_for(0,blocks,threads,[&](int first, int last) {
+	  PackedBuffer<TYPE> packed_a((size_t)MC*kc);
+	  for (int block = first; block < last; block++) {
+	    int ic = block*MC;
+	    int mc = min(MC,m - ic);
+	    pack_a(mc,kc,A + ic*a_row_step + pc*a_column_step,
+		   a_row_step,a_column_step,alpha,packed_a.data());
+	    multiply_block(mc,nc,kc,packed_a.data(),packed_b.data(),
+			   C + ic*ldc + jc,ldc,kernel);
+	  }
+	});
+    }
+  }
+}
+
+// op(X) for a matrix stored with the given row and column steps.
+static void apply_transpose(MatrixTranspose transpose, long& row_step,
+			    long& column_step) {
+  if ( transpose == TRANSPOSE ) {
+    swap(row_step,column_step);
+  }
+}
+
+// The product for 2D arrays. A column-major C is handled as the
+// row-major C^T = op(B)^T op(A)^T.
+template<typename TYPE>
+static void multiply_arrays(TYPE alpha, const Dynamic2DArray<TYPE>& A,
+			    MatrixTranspose transpose_a,
+			    const Dynamic2DArray<TYPE>& B,
+			    MatrixTranspose transpose_b,
+			    TYPE beta, Dynamic2DArray<TYPE>& C,
+			    int threads) {
+  int m = transpose_a == TRANSPOSE ? A.width() : A.height();
+  int k = transpose_a == TRANSPOSE ? A.height() : A.width();
+  int n = transpose_b == TRANSPOSE ? B.height() : B.width();
+  int inner = transpose_b == TRANSPOSE ? B.width() : B.height();
+  assert( k == inner && "The inner dimensions agree." );
+  assert( C.height() == m && C.width() == n && "C is m x n." );
+  long a_row_step = A.row_stride();
+  long a_column_step = A.column_stride();
+  long b_row_step = B.row_stride();
+  long b_column_step = B.column_stride();
+  apply_transpose(transpose_a,a_row_step,a_column_step);
+  apply_transpose(transpose_b,b_row_step,b_column_step);
+  if ( C.column_stride() == 1 || n <= 1 ) {
+    multiply(m,n,k,alpha,A.data(),a_row_step,a_column_step,
+	     B.data(),b_row_step,b_column_step,beta,C.data(),
+	     (long)C.row_stride(),threads);
+  } else {
+    multiply(n,m,k,alpha,B.data(),b_column_step,b_row_step,
+	     A.data(),a_column_step,a_row_step,beta,C.data(),
+	     (long)C.column_stride(),threads);
+  }
+}
+// ----------------------------------------------------------------------
+
+
+// Interface
+// ----------------------------------------------------------------------
+
+void gemm(MatrixTranspose transpose_a, MatrixTranspose transpose_b,
+	  int m, int n, int k, double alpha,
+	  const double* A, int lda, const double* B, int ldb,
+	  double beta, double* C, int ldc, int threads/*= 0*/) {
+  long a_row_step = lda, a_column_step = 1;
+  long b_row_step = ldb, b_column_step = 1;
+  apply_transpose(transpose_a,a_row_step,a_column_step);
+  apply_transpose(transpose_b,b_row_step,b_column_step);
+  multiply(m,n,k,alpha,A,a_row_step,a_column_step,B,b_row_step,
+	   b_column_step,beta,C,(long)ldc,threads);
+}
+
+void gemm(MatrixTranspose transpose_a, MatrixTranspose transpose_b,
+	  int m, int n, int k, float alpha,
+	  const float* A, int lda, const float* B, int ldb,
+	  float beta, float* C, int ldc, int threads/*= 0*/) {
+  long a_row_step = lda, a_column_step = 1;
+  long b_row_step = ldb, b_column_step = 1;
+  apply_transpose(transpose_a,a_row_step,a_column_step);
+  apply_transpose(transpose_b,b_row_step,b_column_step);
+  multiply(m,n,k,alpha,A,a_row_step,a_column_step,B,b_row_step,
+	   b_column_step,beta,C,(long)ldc,threads);
+}
+
+void gemm(double alpha, const Dynamic2DArray<double>& A,
+	  MatrixTranspose transpose_a,
+	  const Dynamic2DArray<double>& B, MatrixTranspose transpose_b,
+	  double beta, Dynamic2DArray<double>& C, int threads/*= 0*/) {
+  multiply_arrays(alpha,A,transpose_a,B,transpose_b,beta,C,threads);
+}
+
+void gemm(float alpha, const Dynamic2DArray<float>& A,
+	  MatrixTranspose transpose_a,
+	  const Dynamic2DArray<float>& B, MatrixTranspose transpose_b,
+	  float beta, Dynamic2DArray<float>& C, int threads/*= 0*/) {
+  multiply_arrays(alpha,A,transpose_a,B,transpose_b,beta,C,threads);
+}
+// ----------------------------------------------------------------------
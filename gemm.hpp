@@ -0,0 +1,83 @@
+// gemm.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 12:41:09 (jonah)>
+
+// This file prototypes general matrix multiplication,
+//     C = alpha op(A) op(B) + beta C,
+// where op(X) is X or its transpose, in double and single precision.
+// Blocked elimination, residuals and multi-RHS solves all come down
+// to it.
+
+// The product is computed the way optimized BLAS libraries do it.
+// Panels of B and blocks of A are packed into contiguous buffers
+// sized for the caches, in the order a small register-blocked
+// micro-kernel reads them. The micro-kernel keeps a 6x8 (double) or
+// 6x16 (float) block of C in registers and streams the panels past
+// it. On processors with AVX2 and FMA it is written with
+// intrinsics; elsewhere a portable kernel with the same shape is
+// used. The choice is made at run time, so one binary runs
+// everywhere. Blocks of rows of C are split over threads.
+
+// This library is designed to be used with the dynamic_array data
+// structure, but also takes raw row-major arrays.
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "dynamic_array.hpp"
+// ----------------------------------------------------------------------
+
+
+// Whether a matrix is used as it is or transposed.
+enum MatrixTranspose {
+  NO_TRANSPOSE,
+  TRANSPOSE
+};
+
+// The micro-kernels gemm() can use.
+enum GemmKernel {
+  AUTOMATIC_KERNEL, // AVX2 if the processor has it, generic if not.
+  GENERIC_KERNEL, // Portable C++. Runs anywhere.
+  AVX2_KERNEL // AVX2 and FMA intrinsics.
+};
+
+// C = alpha op(A) op(B) + beta C for row-major arrays. op(A) is m x k
+// and op(B) is k x n; lda, ldb and ldc are the distances between the
+// rows of A, B and C as stored. If beta is 0, C is overwritten and
+// need not be initialized. C must not overlap A or B. If threads is
+// less than 1, uses default_thread_count(); small products always
+// run on the calling thread.
+void gemm(MatrixTranspose transpose_a, MatrixTranspose transpose_b,
+	  int m, int n, int k, double alpha,
+	  const double* A, int lda, const double* B, int ldb,
+	  double beta, double* C, int ldc, int threads = 0);
+void gemm(MatrixTranspose transpose_a, MatrixTranspose transpose_b,
+	  int m, int n, int k, float alpha,
+	  const float* A, int lda, const float* B, int ldb,
+	  float beta, float* C, int ldc, int threads = 0);
+
+// C = alpha op(A) op(B) + beta C for 2D arrays, which may be row- or
+// column-major views. C must already have the right shape.
+void gemm(double alpha, const Dynamic2DArray<double>& A,
+	  MatrixTranspose transpose_a,
+	  const Dynamic2DArray<double>& B, MatrixTranspose transpose_b,
+	  double beta, Dynamic2DArray<double>& C, int threads = 0);
+void gemm(float alpha, const Dynamic2DArray<float>& A,
+	  MatrixTranspose transpose_a,
+	  const Dynamic2DArray<float>& B, MatrixTranspose transpose_b,
+	  float beta, Dynamic2DArray<float>& C, int threads = 0);
+
+// Chooses the micro-kernel for every later gemm() call. Returns
+// false, and changes nothing, if this processor can't run it. Calls
+// already running finish with the kernel they started with. A tuning
+// profile may choose the kernel too; see tuning.hpp.
+bool set_gemm_kernel(GemmKernel kernel);
+
+// The micro-kernel gemm() uses now. Never AUTOMATIC_KERNEL.
+GemmKernel gemm_kernel();
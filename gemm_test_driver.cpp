@@ -0,0 +1,176 @@
+// gemm_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 13:52:30 (jonah)>
+
+// This file tests general matrix multiplication against the triple
+// loop, over transposes, scalings, edge tiles, layouts, threads and
+// both micro-kernels.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <limits>
+#include <vector>
+#include "dynamic_array.hpp"
+#include "gemm.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// A random rows x columns row-major matrix with leading dimension ld.
+template<typename TYPE>
+static vector<TYPE> random_matrix(int rows, int ld) {
+  vector<TYPE> output((size_t)rows*ld);
+  for (size_t i = 0; i < output.size(); i++) {
+    output[i] = (TYPE)rand()/RAND_MAX - (TYPE)0.5;
+  }
+  return output;
+}
+
+// Checks gemm() against the triple loop for one shape and set of
+// flags. Returns the largest error relative to the size of the sums.
+template<typename TYPE>
+static double check(MatrixTranspose transpose_a, MatrixTranspose transpose_b,
+		    int m, int n, int k, TYPE alpha, TYPE beta, int threads) {
+  int lda = (transpose_a == TRANSPOSE ? m : k) + 3;
+  int ldb = (transpose_b == TRANSPOSE ? k : n) + 1;
+  int ldc = n + 2;
+  vector<TYPE> A = random_matrix<TYPE>(transpose_a == TRANSPOSE ? k : m,lda);
+  vector<TYPE> B = random_matrix<TYPE>(transpose_b == TRANSPOSE ? n : k,ldb);
+  vector<TYPE> C = random_matrix<TYPE>(m,ldc);
+  if ( beta == 0 ) {
+    // Must not leak into the answer.
+    C[0] = numeric_limits<TYPE>::quiet_NaN();
+  }
+  vector<TYPE> expected = C;
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      double sum = 0;
+      for (int p = 0; p < k; p++) {
+	double a = transpose_a == TRANSPOSE ? A[p*lda + i] : A[i*lda + p];
+	double b = transpose_b == TRANSPOSE ? B[j*ldb + p] : B[p*ldb + j];
+	sum += a*b;
+      }
+      expected[i*ldc + j] = alpha*sum + (beta == 0 ? 0 : beta*C[i*ldc + j]);
+    }
+  }
+  gemm(transpose_a,transpose_b,m,n,k,alpha,A.data(),lda,B.data(),ldb,
+       beta,C.data(),ldc,threads);
+  double error = 0;
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < ldc; j++) {
+      double difference = abs(C[i*ldc + j] - expected[i*ldc + j]);
+      if ( j >= n ) {
+	assert( difference == 0 && "Padding between rows is untouched." );
+      }
+      error = max(error,difference/(1 + k));
+    }
+  }
+  return error;
+}
+
+// Runs every combination of transposes on one shape.
+template<typename TYPE>
+static void check_shape(int m, int n, int k, int threads, double tolerance) {
+  MatrixTranspose flags[2] = {NO_TRANSPOSE, TRANSPOSE};
+  for (int a = 0; a < 2; a++) {
+    for (int b = 0; b < 2; b++) {
+      double error = check<TYPE>(flags[a],flags[b],m,n,k,(TYPE)1.5,
+				 (TYPE)-0.5,threads);
+      assert( error < tolerance && "gemm agrees with the triple loop." );
+      error = check<TYPE>(flags[a],flags[b],m,n,k,(TYPE)-1,0,threads);
+      assert( error < tolerance && "beta = 0 overwrites C." );
+    }
+  }
+}
+
+// Runs the shapes that cover full tiles, edge tiles and several
+// cache blocks in each dimension.
+template<typename TYPE>
+static void check_shapes(double tolerance) {
+  check_shape<TYPE>(1,1,1,1,tolerance);
+  check_shape<TYPE>(6,16,8,1,tolerance);
+  check_shape<TYPE>(37,29,53,1,tolerance);
+  check_shape<TYPE>(150,70,300,1,tolerance);
+  check_shape<TYPE>(161,203,517,4,tolerance);
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the gemm library.\n"
+       << "BEGIN." << endl;
+  srand(7);
+  GemmKernel automatic = gemm_kernel();
+  cout << "Automatic kernel: "
+       << (automatic == AVX2_KERNEL ? "AVX2" : "generic") << endl;
+
+  GemmKernel kernels[2] = {GENERIC_KERNEL, AVX2_KERNEL};
+  for (int kernel = 0; kernel < 2; kernel++) {
+    if ( !set_gemm_kernel(kernels[kernel]) ) {
+      cout << "\n\nThis processor can't run the AVX2 kernel." << endl;
+      continue;
+    }
+    cout << "\n\nThe " << (kernel == 0 ? "generic" : "AVX2")
+	 << " kernel in double and single precision." << endl;
+    check_shapes<double>(1E-14);
+    check_shapes<float>(1E-5);
+  }
+  assert( set_gemm_kernel(AUTOMATIC_KERNEL) && gemm_kernel() == automatic );
+
+  cout << "\n\nNothing to multiply only scales C." << endl;
+  vector<double> C(4,2.0);
+  gemm(NO_TRANSPOSE,NO_TRANSPOSE,2,2,0,1.0,NULL,1,NULL,2,3.0,C.data(),2);
+  assert( C[0] == 6 && C[3] == 6 );
+
+  cout << "\n\nRow- and column-major 2D arrays." << endl;
+  int m = 45, n = 31, k = 60;
+  Dynamic2DArray<double> A(m,k);
+  Dynamic2DArray<double> B(k,n);
+  for (int i = 0; i < m; i++) {
+    for (int p = 0; p < k; p++) {
+      A.access(i,p) = (double)rand()/RAND_MAX;
+    }
+  }
+  for (int p = 0; p < k; p++) {
+    for (int j = 0; j < n; j++) {
+      B.access(p,j) = (double)rand()/RAND_MAX;
+    }
+  }
+  Dynamic2DArray<double> product(m,n);
+  gemm(1.0,A,NO_TRANSPOSE,B,NO_TRANSPOSE,0.0,product);
+  // The same product into a column-major view, from a column-major
+  // copy of A^T.
+  vector<double> fortran_c((size_t)m*n);
+  vector<double> fortran_at((size_t)k*m);
+  for (int i = 0; i < m; i++) {
+    for (int p = 0; p < k; p++) {
+      fortran_at[p + (size_t)i*k] = A.get(i,p);
+    }
+  }
+  Dynamic2DArray<double> At(fortran_at.data(),k,m,k,COLUMN_MAJOR);
+  Dynamic2DArray<double> column_major(fortran_c.data(),m,n,m,COLUMN_MAJOR);
+  gemm(1.0,At,TRANSPOSE,B,NO_TRANSPOSE,0.0,column_major);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      double expected = 0;
+      for (int p = 0; p < k; p++) {
+	expected += A.get(i,p)*B.get(p,j);
+      }
+      assert( abs(product.get(i,j) - expected) < 1E-12*k
+	      && abs(fortran_c[i + (size_t)j*m] - expected) < 1E-12*k
+	      && "The layouts give the same product." );
+    }
+  }
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
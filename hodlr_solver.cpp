@@ -0,0 +1,462 @@
+// hodlr_solver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 01:26:53 (jonah)>
+
+// This file implements the HODLR compressed solver.
+
+// The factorization is the usual one for HODLR matrices. Each node
+// is
+//     A = [ A_11  0    ] ( I + [ W_1  0   ] [ 0      V_1^T ] )
+//         [ 0     A_22 ] (     [ 0    W_2 ] [ V_2^T  0     ] )
+// with W_i = A_ii^{-1} U_i. The children are factored first, which
+// gives the W_i by solving with them, and the second factor is
+// inverted by the Woodbury formula, which only needs the small
+// coupling matrix K = I + Z^T W to be factored. Solving with a node
+// solves with both children and then applies
+//     y = c - W K^{-1} Z^T c.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "hodlr_solver.hpp"
+#include "array_algebra.hpp"
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Dense utilities
+// ----------------------------------------------------------------------
+
+// The dot product of a and b, both of length n.
+static double dot(const double* a, const double* b, int n) {
+  double output = 0;
+  for (int i = 0; i < n; i++) {
+    output += a[i]*b[i];
+  }
+  return output;
+}
+
+// Factors the n x n row-major matrix a in place as P a = L U, with
+// partial pivoting. pivots[k] is the row swapped with row k at step
+// k. Returns false if a pivot is exactly zero.
+static bool lu_factor(double* a, int n, int* pivots) {
+  for (int k = 0; k < n; k++) {
+    int pivot = k;
+    for (int i = k + 1; i < n; i++) {
+      if ( abs(a[i*n + k]) > abs(a[pivot*n + k]) ) {
+	pivot = i;
+      }
+    }
+    pivots[k] = pivot;
+    if ( a[pivot*n + k] == 0 ) {
+      return false;
+    }
+    if ( pivot != k ) {
+      swap_ranges(a + k*n, a + (k + 1)*n, a + pivot*n);
+    }
+    double inverse = 1.0/a[k*n + k];
+    for (int i = k + 1; i < n; i++) {
+      double factor = a[i*n + k]*inverse;
+      a[i*n + k] = factor;
+      for (int j = k + 1; j < n; j++) {
+	a[i*n + j] -= factor*a[k*n + j];
+      }
+    }
+  }
+  return true;
+}
+
+// Solves with the factors from lu_factor() in place.
+static void lu_solve(const double* a, int n, const int* pivots, double* x) {
+  for (int k = 0; k < n; k++) {
+    swap(x[k],x[pivots[k]]);
+  }
+  for (int i = 1; i < n; i++) {
+    x[i] -= dot(a + i*n,x,i);
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    x[i] = (x[i] - dot(a + i*n + i + 1,x + i + 1,n - i - 1))/a[i*n + i];
+  }
+}
+// ----------------------------------------------------------------------
+
+
+// Construction
+// ----------------------------------------------------------------------
+
+HodlrMatrix::HodlrMatrix(int n, const MatrixEntries& matrix_entries,
+			 const HodlrOptions& hodlr_options/*= HodlrOptions()*/) {
+  assert( n >= 0 && hodlr_options.leaf_size > 0
+	  && "The size and leaf size make sense." );
+  matrix_size = n;
+  depth = 0;
+  factored = false;
+  options = hodlr_options;
+  entries = &matrix_entries;
+  if ( n > 0 ) {
+    build(0,n,0);
+  }
+  entries = NULL;
+}
+
+HodlrMatrix::HodlrMatrix(const GaussianSystem& g_sys,
+			 const HodlrOptions& hodlr_options/*= HodlrOptions()*/)
+  : HodlrMatrix(g_sys.size(),
+		[&g_sys](int i, int j) { return g_sys.matrix_get(i,j); },
+		hodlr_options) {}
+
+// Builds the node for [begin, begin + size) and everything under it.
+// Returns its index.
+int HodlrMatrix::build(int begin, int size, int level) {
+  int index = nodes.size();
+  nodes.push_back(Node());
+  nodes[index].begin = begin;
+  nodes[index].size = size;
+  nodes[index].children[0] = nodes[index].children[1] = -1;
+  depth = max(depth,level);
+  if ( size <= options.leaf_size ) {
+    vector<double>& dense = nodes[index].dense;
+    dense.resize((size_t)size*size);
+    for (int i = 0; i < size; i++) {
+      for (int j = 0; j < size; j++) {
+	dense[(size_t)i*size + j] = (*entries)(begin + i,begin + j);
+      }
+    }
+    return index;
+  }
+  int half = size/2;
+  LowRankBlock upper = cross_approximation(begin,half,begin + half,
+					   size - half);
+  LowRankBlock lower = cross_approximation(begin + half,size - half,
+					   begin,half);
+  // nodes may move while the children are built.
+  int first = build(begin,half,level + 1);
+  int second = build(begin + half,size - half,level + 1);
+  Node& node = nodes[index];
+  node.children[0] = first;
+  node.children[1] = second;
+  node.upper = upper;
+  node.lower = lower;
+  return index;
+}
+
+// Approximates a block by adaptive cross approximation with partial
+// pivoting. Each step takes the residual of one row, pivots on its
+// largest entry, takes the residual of that column, and adds their
+// outer product. The next row is the one where that column is
+// largest. The Frobenius norm of the approximation is updated as it
+// goes, so stopping costs nothing extra. A residual row of zeros is
+// skipped for the next unused row, at most 8 times running, after
+// which the rest of the block is taken to be zero.
+HodlrMatrix::LowRankBlock
+HodlrMatrix::cross_approximation(int row_begin, int rows,
+				 int column_begin, int columns) const {
+  const int MAX_ZERO_ROWS = 8;
+  LowRankBlock output;
+  output.rows = rows;
+  output.columns = columns;
+  output.rank = 0;
+  int limit = min(rows,columns);
+  if ( options.max_rank > 0 ) {
+    limit = min(limit,options.max_rank);
+  }
+  vector<char> used(rows,0);
+  vector<double> row(columns);
+  vector<double> column(rows);
+  double norm_squared = 0;
+  int pivot_row = 0;
+  int zero_rows = 0;
+  while ( output.rank < limit ) {
+    int rank = output.rank;
+    used[pivot_row] = 1;
+    for (int j = 0; j < columns; j++) {
+      row[j] = (*entries)(row_begin + pivot_row,column_begin + j);
+      for (int l = 0; l < rank; l++) {
+	row[j] -= output.u[(size_t)l*rows + pivot_row]
+	  *output.v[(size_t)l*columns + j];
+      }
+    }
+    int pivot_column = 0;
+    for (int j = 1; j < columns; j++) {
+      if ( abs(row[j]) > abs(row[pivot_column]) ) {
+	pivot_column = j;
+      }
+    }
+    if ( row[pivot_column] == 0 ) {
+      zero_rows++;
+      pivot_row = find(used.begin(),used.end(),0) - used.begin();
+      if ( zero_rows >= MAX_ZERO_ROWS || pivot_row == rows ) {
+	break;
+      }
+      continue;
+    }
+    zero_rows = 0;
+    double inverse = 1.0/row[pivot_column];
+    for (int j = 0; j < columns; j++) {
+      row[j] *= inverse;
+    }
+    for (int i = 0; i < rows; i++) {
+      column[i] = (*entries)(row_begin + i,column_begin + pivot_column);
+      for (int l = 0; l < rank; l++) {
+	column[i] -= output.u[(size_t)l*rows + i]
+	  *output.v[(size_t)l*columns + pivot_column];
+      }
+    }
+
+    // |S + u v^T|^2 = |S|^2 + |u|^2 |v|^2 + 2 sum_l (u_l.u)(v_l.v)
+    double column_squared = dot(column.data(),column.data(),rows);
+    double row_squared = dot(row.data(),row.data(),columns);
+    double cross = 0;
+    for (int l = 0; l < rank; l++) {
+      cross += dot(output.u.data() + (size_t)l*rows,column.data(),rows)
+	*dot(output.v.data() + (size_t)l*columns,row.data(),columns);
+    }
+    norm_squared += column_squared*row_squared + 2*cross;
+    output.u.insert(output.u.end(),column.begin(),column.end());
+    output.v.insert(output.v.end(),row.begin(),row.end());
+    output.rank++;
+    if ( column_squared*row_squared
+	 <= options.tolerance*options.tolerance*abs(norm_squared) ) {
+      break;
+    }
+
+    pivot_row = rows;
+    for (int i = 0; i < rows; i++) {
+      if ( !used[i] && (pivot_row == rows
+			|| abs(column[i]) > abs(column[pivot_row])) ) {
+	pivot_row = i;
+      }
+    }
+    if ( pivot_row == rows ) {
+      break;
+    }
+  }
+  return output;
+}
+// ----------------------------------------------------------------------
+
+
+// Interface
+// ----------------------------------------------------------------------
+
+size_t HodlrMatrix::compressed_entries() const {
+  size_t output = 0;
+  for (size_t k = 0; k < nodes.size(); k++) {
+    const Node& node = nodes[k];
+    if ( node.children[0] < 0 ) {
+      output += (size_t)node.size*node.size;
+    } else {
+      output += node.upper.u.size() + node.upper.v.size()
+	+ node.lower.u.size() + node.lower.v.size();
+    }
+  }
+  return output;
+}
+
+int HodlrMatrix::largest_rank() const {
+  int output = 0;
+  for (size_t k = 0; k < nodes.size(); k++) {
+    output = max(output,max(nodes[k].upper.rank,nodes[k].lower.rank));
+  }
+  return output;
+}
+
+int HodlrMatrix::levels() const {
+  return depth;
+}
+
+void HodlrMatrix::multiply(const double* x, double* y) const {
+  for (int i = 0; i < matrix_size; i++) {
+    y[i] = 0;
+  }
+  if ( matrix_size > 0 ) {
+    multiply_node(0,x,y);
+  }
+}
+
+// Adds the product of node's block with x to y. x and y start at the
+// node's first row.
+void HodlrMatrix::multiply_node(int index, const double* x, double* y) const {
+  const Node& node = nodes[index];
+  if ( node.children[0] < 0 ) {
+    for (int i = 0; i < node.size; i++) {
+      y[i] += dot(node.dense.data() + (size_t)i*node.size,x,node.size);
+    }
+    return;
+  }
+  int half = nodes[node.children[0]].size;
+  multiply_node(node.children[0],x,y);
+  multiply_node(node.children[1],x + half,y + half);
+  // y_1 += U_1 (V_1^T x_2) and y_2 += U_2 (V_2^T x_1)
+  const LowRankBlock* blocks[2] = {&node.upper, &node.lower};
+  const double* inputs[2] = {x + half, x};
+  double* outputs[2] = {y, y + half};
+  for (int b = 0; b < 2; b++) {
+    const LowRankBlock& block = *blocks[b];
+    for (int l = 0; l < block.rank; l++) {
+      double coefficient = dot(block.v.data() + (size_t)l*block.columns,
+			       inputs[b],block.columns);
+      const double* u = block.u.data() + (size_t)l*block.rows;
+      for (int i = 0; i < block.rows; i++) {
+	outputs[b][i] += coefficient*u[i];
+      }
+    }
+  }
+}
+
+bool HodlrMatrix::factor() {
+  factored = (matrix_size == 0) || factor_node(0);
+  return factored;
+}
+
+// Factors node, children first. See the top of the file.
+bool HodlrMatrix::factor_node(int index) {
+  if ( nodes[index].children[0] < 0 ) {
+    Node& node = nodes[index];
+    node.pivots.resize(node.size);
+    return lu_factor(node.dense.data(),node.size,node.pivots.data());
+  }
+  if ( !factor_node(nodes[index].children[0])
+       || !factor_node(nodes[index].children[1]) ) {
+    return false;
+  }
+  Node& node = nodes[index];
+  const LowRankBlock& upper = node.upper;
+  const LowRankBlock& lower = node.lower;
+  node.upper_solved = upper.u;
+  node.lower_solved = lower.u;
+  solve_node(node.children[0],node.upper_solved.data(),upper.rows,
+	     upper.rank);
+  solve_node(node.children[1],node.lower_solved.data(),lower.rows,
+	     lower.rank);
+
+  // K = [ I               V_1^T W_2 ]
+  //     [ V_2^T W_1               I ]
+  int rank = upper.rank + lower.rank;
+  node.dense.assign((size_t)rank*rank,0);
+  node.pivots.resize(rank);
+  for (int a = 0; a < rank; a++) {
+    node.dense[(size_t)a*rank + a] = 1;
+  }
+  for (int a = 0; a < upper.rank; a++) {
+    for (int b = 0; b < lower.rank; b++) {
+      node.dense[(size_t)a*rank + upper.rank + b]
+	= dot(upper.v.data() + (size_t)a*upper.columns,
+	      node.lower_solved.data() + (size_t)b*lower.rows,upper.columns);
+    }
+  }
+  for (int a = 0; a < lower.rank; a++) {
+    for (int b = 0; b < upper.rank; b++) {
+      node.dense[(size_t)(upper.rank + a)*rank + b]
+	= dot(lower.v.data() + (size_t)a*lower.columns,
+	      node.upper_solved.data() + (size_t)b*upper.rows,lower.columns);
+    }
+  }
+  return lu_factor(node.dense.data(),rank,node.pivots.data());
+}
+
+// Solves with node for right_hand_sides vectors in place. Vector c
+// starts at b + c*leading_dimension, at the node's first row.
+void HodlrMatrix::solve_node(int index, double* b, int leading_dimension,
+			     int right_hand_sides) const {
+  const Node& node = nodes[index];
+  if ( node.children[0] < 0 ) {
+    for (int c = 0; c < right_hand_sides; c++) {
+      lu_solve(node.dense.data(),node.size,node.pivots.data(),
+	       b + (size_t)c*leading_dimension);
+    }
+    return;
+  }
+  int half = nodes[node.children[0]].size;
+  solve_node(node.children[0],b,leading_dimension,right_hand_sides);
+  solve_node(node.children[1],b + half,leading_dimension,right_hand_sides);
+  const LowRankBlock& upper = node.upper;
+  const LowRankBlock& lower = node.lower;
+  int rank = upper.rank + lower.rank;
+  if ( rank == 0 ) {
+    return;
+  }
+  vector<double> t(rank);
+  for (int c = 0; c < right_hand_sides; c++) {
+    double* top = b + (size_t)c*leading_dimension;
+    double* bottom = top + half;
+    // t = K^{-1} Z^T c
+    for (int a = 0; a < upper.rank; a++) {
+      t[a] = dot(upper.v.data() + (size_t)a*upper.columns,bottom,
+		 upper.columns);
+    }
+    for (int a = 0; a < lower.rank; a++) {
+      t[upper.rank + a] = dot(lower.v.data() + (size_t)a*lower.columns,top,
+			      lower.columns);
+    }
+    lu_solve(node.dense.data(),rank,node.pivots.data(),t.data());
+    // y = c - W t
+    for (int a = 0; a < upper.rank; a++) {
+      const double* w = node.upper_solved.data() + (size_t)a*upper.rows;
+      for (int i = 0; i < upper.rows; i++) {
+	top[i] -= t[a]*w[i];
+      }
+    }
+    for (int a = 0; a < lower.rank; a++) {
+      const double* w = node.lower_solved.data() + (size_t)a*lower.rows;
+      for (int i = 0; i < lower.rows; i++) {
+	bottom[i] -= t[upper.rank + a]*w[i];
+      }
+    }
+  }
+}
+
+void HodlrMatrix::solve(double* x) const {
+  assert( factored && "The matrix is factored." );
+  if ( matrix_size > 0 ) {
+    solve_node(0,x,matrix_size,1);
+  }
+}
+
+Dynamic1DArray<double>
+HodlrMatrix::solve(const Dynamic1DArray<double>& knowns) const {
+  assert( knowns.length() == matrix_size && "One known per row." );
+  Dynamic1DArray<double> output = knowns;
+  solve(output.data());
+  return output;
+}
+// ----------------------------------------------------------------------
+
+
+// Solving Gaussian systems
+// ----------------------------------------------------------------------
+
+Dynamic1DArray<double> hodlr_solve_system(const GaussianSystem& g_sys,
+					  const HodlrOptions& options
+					  /*= HodlrOptions()*/) {
+  HodlrMatrix matrix(g_sys,options);
+  if ( !matrix.factor() ) {
+    return Dynamic1DArray<double>();
+  }
+  Dynamic1DArray<double> output(g_sys.size());
+  for (int i = 0; i < g_sys.size(); i++) {
+    output[i] = g_sys.vector_get(i);
+  }
+  matrix.solve(output.data());
+  return output;
+}
+
+double relative_residual(const GaussianSystem& g_sys,
+			 const Dynamic1DArray<double>& solution) {
+  assert( solution.length() == g_sys.size() && "One value per unknown." );
+  double residual = norm(knowns(g_sys) - g_sys*solution);
+  double knowns_norm = norm(knowns(g_sys));
+  if ( knowns_norm == 0 ) {
+    return residual;
+  }
+  return residual/knowns_norm;
+}
+// ----------------------------------------------------------------------
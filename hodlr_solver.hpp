@@ -0,0 +1,160 @@
+// hodlr_solver.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 00:41:08 (jonah)>
+
+// This file prototypes a compressed solver for dense matrices whose
+// off-diagonal blocks are numerically low rank, such as the matrices
+// of integral equations and kernel regression. Elimination costs
+// O(n^3) time and O(n^2) memory no matter what. A hierarchically
+// off-diagonal low-rank (HODLR) matrix splits the matrix in two, over
+// and over, keeping each diagonal block at the bottom dense and each
+// off-diagonal block as a product U V^T of thin factors. The factors
+// come from adaptive cross approximation (ACA), which samples only a
+// few rows and columns of each block, so the dense matrix is never
+// built. Factorization and solve then cost about O(k^2 n log^2 n) for
+// off-diagonal ranks k.
+
+// The compression only works if the ordering of the unknowns puts
+// nearby points next to each other, e.g. points sorted along a curve
+// or a space-filling curve. The tolerance trades accuracy for speed:
+// a loose one makes a cheap approximate inverse, which is a good
+// preconditioner for the Krylov solvers in iterative_solvers.hpp.
+
+// This library is designed to be used with the gaussian_system data
+// structure, but only needs a function that returns entries of the
+// matrix.
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The knobs of the compression.
+struct HodlrOptions {
+  // ACA stops adding to an off-diagonal block once the last term
+  // added is this small relative to the whole approximation, in the
+  // Frobenius norm. Smaller is more accurate, with larger ranks.
+  double tolerance;
+  // Blocks this size or smaller are stored dense.
+  int leaf_size;
+  // The largest rank of any off-diagonal block. 0 means no limit but
+  // the size of the block.
+  int max_rank;
+  // Sensible defaults: tolerance 1E-10, leaves of 64, no rank limit.
+  HodlrOptions() {
+    tolerance = 1E-10;
+    leaf_size = 64;
+    max_rank = 0;
+  }
+};
+
+// Returns entry (i,j) of a matrix.
+typedef function<double(int i, int j)> MatrixEntries;
+
+// A HODLR approximation of an n x n matrix, and its factorization.
+class HodlrMatrix {
+public:
+  // Compresses the n x n matrix with the given entries. entries is
+  // only called during construction, about O(k n log n) times.
+  HodlrMatrix(int n, const MatrixEntries& entries,
+	      const HodlrOptions& options = HodlrOptions());
+  // Compresses the coefficient matrix of g_sys. The knowns are
+  // ignored.
+  HodlrMatrix(const GaussianSystem& g_sys,
+	      const HodlrOptions& options = HodlrOptions());
+
+  // The number of rows.
+  int size() const { return matrix_size; }
+  // The number of doubles in the compressed matrix: the dense leaves
+  // and the low-rank factors. The dense matrix has size()^2.
+  size_t compressed_entries() const;
+  // The largest rank of any off-diagonal block.
+  int largest_rank() const;
+  // The number of levels of splitting.
+  int levels() const;
+
+  // Sets y = A x, for the compressed A.
+  void multiply(const double* x, double* y) const;
+
+  // Factors the compressed matrix so it can be solved. Returns false
+  // if a dense leaf or a coupling matrix is exactly singular.
+  bool factor();
+  // Whether factor() has succeeded.
+  bool is_factored() const { return factored; }
+  // Solves A x = knowns for the compressed A. factor() must have
+  // succeeded.
+  Dynamic1DArray<double> solve(const Dynamic1DArray<double>& knowns) const;
+  // Solves in place for the vector x of length size().
+  void solve(double* x) const;
+
+private: // Implementation details.
+  // An approximation U V^T of a rows x columns block. U is rows x
+  // rank and V is columns x rank, both stored by column.
+  struct LowRankBlock {
+    int rows;
+    int columns;
+    int rank;
+    vector<double> u;
+    vector<double> v;
+  };
+  // A diagonal block [begin, begin + size). A leaf holds the dense
+  // block in dense, LU factored in place once factored. Any other
+  // node splits into two children,
+  //     [ A_11     U_1 V_1^T ]
+  //     [ U_2 V_2^T     A_22 ]
+  // and, once factored, holds A_11^{-1} U_1, A_22^{-1} U_2, and in
+  // dense the LU factors of the coupling matrix
+  //     [ I           V_1^T A_22^{-1} U_2 ]
+  //     [ V_2^T A_11^{-1} U_1           I ].
+  struct Node {
+    int begin;
+    int size;
+    int children[2];
+    vector<double> dense;
+    vector<int> pivots;
+    LowRankBlock upper;
+    LowRankBlock lower;
+    vector<double> upper_solved;
+    vector<double> lower_solved;
+  };
+
+  int build(int begin, int size, int level);
+  LowRankBlock cross_approximation(int row_begin, int rows,
+				   int column_begin, int columns) const;
+  void multiply_node(int node, const double* x, double* y) const;
+  bool factor_node(int node);
+  void solve_node(int node, double* b, int leading_dimension,
+		  int right_hand_sides) const;
+
+  int matrix_size;
+  int depth;
+  bool factored;
+  HodlrOptions options;
+  const MatrixEntries* entries; // Only set during construction.
+  vector<Node> nodes;
+};
+
+// Solves g_sys by compressing its coefficient matrix. g_sys is not
+// changed. Returns an empty array if the compressed matrix is
+// singular. Check the answer with relative_residual(), since the
+// compression is only as good as the tolerance.
+Dynamic1DArray<double> hodlr_solve_system(const GaussianSystem& g_sys,
+					  const HodlrOptions& options
+					  = HodlrOptions());
+
+// Returns |b - A x|/|b| for the dense system g_sys, in O(n^2).
+double relative_residual(const GaussianSystem& g_sys,
+			 const Dynamic1DArray<double>& solution);
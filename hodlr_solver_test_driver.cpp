@@ -0,0 +1,170 @@
+// hodlr_solver_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 01:58:20 (jonah)>
+
+// This file tests the HODLR compressed solver on kernel matrices of
+// points along a line, checking it against the dense system.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <vector>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "iterative_solvers.hpp"
+#include "hodlr_solver.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Builds the dense system with the given entries and random knowns.
+static GaussianSystem dense_system(int n, const MatrixEntries& entries) {
+  GaussianSystem output(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      output.matrix_set(i,j,entries(i,j));
+    }
+    output.vector_set(i,(double)rand()/RAND_MAX - 0.5);
+  }
+  return output;
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the hodlr_solver library.\n"
+       << "BEGIN." << endl;
+  srand(3);
+  int n = 1000;
+  // Points in [0,1], in order.
+  vector<double> points(n);
+  for (int i = 0; i < n; i++) {
+    points[i] = (i + 0.5*rand()/RAND_MAX)/n;
+  }
+
+  cout << "\n\nAn exponential kernel. Its off-diagonal blocks have "
+       << "rank one." << endl;
+  MatrixEntries exponential = [&points](int i, int j) {
+    return exp(-abs(points[i] - points[j])) + (i == j ? 1.0 : 0.0);
+  };
+  HodlrOptions options;
+  options.leaf_size = 32;
+  HodlrMatrix compressed(n,exponential,options);
+  cout << "Levels: " << compressed.levels()
+       << ", largest rank: " << compressed.largest_rank()
+       << ", entries: " << compressed.compressed_entries()
+       << " of " << n*n << endl;
+  assert( compressed.levels() == 5 && compressed.largest_rank() <= 2
+	  && compressed.compressed_entries() < (size_t)n*n/10
+	  && "The exponential kernel compresses well." );
+
+  GaussianSystem exponential_system = dense_system(n,exponential);
+  vector<double> x(n);
+  vector<double> y(n);
+  for (int i = 0; i < n; i++) {
+    x[i] = (double)rand()/RAND_MAX;
+  }
+  compressed.multiply(x.data(),y.data());
+  for (int i = 0; i < n; i++) {
+    double expected = 0;
+    for (int j = 0; j < n; j++) {
+      expected += exponential_system.matrix_get(i,j)*x[j];
+    }
+    assert( abs(y[i] - expected) < 1E-9*(1 + abs(expected))
+	    && "The compressed product matches the dense one." );
+  }
+
+  Dynamic1DArray<double> solution = hodlr_solve_system(exponential_system,
+						       options);
+  double residual = relative_residual(exponential_system,solution);
+  cout << "Relative residual: " << residual << endl;
+  assert( residual < 1E-9 && "The solve is accurate." );
+  GaussianSystem copy = exponential_system;
+  Dynamic1DArray<double> reference = solve_system(copy);
+  for (int i = 0; i < n; i++) {
+    assert( abs(solution[i] - reference[i]) < 1E-8*(1 + abs(reference[i]))
+	    && "The solve agrees with elimination." );
+  }
+
+  cout << "\n\nA Gaussian kernel with a nugget, as in kernel regression, "
+       << "at three tolerances." << endl;
+  MatrixEntries gaussian = [&points](int i, int j) {
+    double distance = (points[i] - points[j])/0.2;
+    return exp(-distance*distance) + (i == j ? 0.5 : 0.0);
+  };
+  GaussianSystem gaussian_system = dense_system(n,gaussian);
+  double tolerances[3] = {1E-4, 1E-8, 1E-12};
+  double last_residual = 1;
+  for (int t = 0; t < 3; t++) {
+    options.tolerance = tolerances[t];
+    HodlrMatrix matrix(n,gaussian,options);
+    assert( matrix.factor() && "The kernel matrix factors." );
+    Dynamic1DArray<double> knowns(n);
+    for (int i = 0; i < n; i++) {
+      knowns[i] = gaussian_system.vector_get(i);
+    }
+    residual = relative_residual(gaussian_system,matrix.solve(knowns));
+    cout << "Tolerance " << tolerances[t]
+	 << ": largest rank " << matrix.largest_rank()
+	 << ", relative residual " << residual << endl;
+    assert( residual < 1E3*tolerances[t] && residual < last_residual
+	    && "Tightening the tolerance buys accuracy." );
+    last_residual = residual;
+  }
+
+  cout << "\n\nA loose compression preconditions GMRES." << endl;
+  options.tolerance = 1E-3;
+  HodlrMatrix preconditioner(n,gaussian,options);
+  assert( preconditioner.factor() );
+  IterativeOptions iterative;
+  iterative.tolerance = 1E-12;
+  IterativeResult plain = iterative_solve(gaussian_system,iterative);
+  Dynamic1DArray<double> knowns(n);
+  for (int i = 0; i < n; i++) {
+    knowns[i] = gaussian_system.vector_get(i);
+  }
+  LinearOperator dense_operator = [&gaussian_system,n](const double* in,
+						       double* out) {
+    for (int i = 0; i < n; i++) {
+      out[i] = 0;
+      for (int j = 0; j < n; j++) {
+	out[i] += gaussian_system.matrix_get(i,j)*in[j];
+      }
+    }
+  };
+  LinearOperator approximate_inverse = [&preconditioner,n](const double* in,
+							   double* out) {
+    for (int i = 0; i < n; i++) {
+      out[i] = in[i];
+    }
+    preconditioner.solve(out);
+  };
+  IterativeResult preconditioned = iterative_solve(dense_operator,knowns,
+						   iterative,
+						   approximate_inverse);
+  cout << "Jacobi: " << plain.iterations << " iterations. HODLR: "
+       << preconditioned.iterations << " iterations." << endl;
+  assert( preconditioned.converged && preconditioned.iterations < 10
+	  && preconditioned.iterations < plain.iterations
+	  && "The compressed inverse is a strong preconditioner." );
+
+  cout << "\n\nA singular leaf is reported." << endl;
+  MatrixEntries singular = [&exponential](int i, int j) {
+    return (i == 3 || j == 3) ? 0.0 : exponential(i,j);
+  };
+  HodlrMatrix broken(n,singular,options);
+  assert( !broken.factor() && !broken.is_factored()
+	  && "A zero row makes factor() fail." );
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,511 @@
+// iterative_solvers.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 23:42:30 (jonah)>
+
+// This file implements the Krylov iterative solvers.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "iterative_solvers.hpp"
+#include "parallel_for.hpp"
+#include <cmath>
+#include <cstring>
+#include <cassert>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Matrix-vector products with fewer entries than this run on one
+// thread. Below it, starting threads costs more than it saves.
+static const long PARALLEL_THRESHOLD = 1 << 18;
+
+
+// Vector utilities
+// ----------------------------------------------------------------------
+
+// Four doubles that the compiler keeps in SIMD registers.
+typedef double Double4 __attribute__((vector_size(4*sizeof(double))));
+
+// Returns the dot product of a and b, which have length n. Keeps two
+// vector accumulators going so the loop isn't bound by the latency
+// of one add.
+static double dot(const double* a, const double* b, ptrdiff_t n) {
+  Double4 sum0 = {0,0,0,0};
+  Double4 sum1 = {0,0,0,0};
+  ptrdiff_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    Double4 a0, a1, b0, b1;
+    memcpy(&a0,a + i,sizeof(a0));
+    memcpy(&a1,a + i + 4,sizeof(a1));
+    memcpy(&b0,b + i,sizeof(b0));
+    memcpy(&b1,b + i + 4,sizeof(b1));
+    sum0 += a0*b0;
+    sum1 += a1*b1;
+  }
+  Double4 sum = sum0 + sum1;
+  double output = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+  for (; i < n; i++) {
+    output += a[i]*b[i];
+  }
+  return output;
+}
+
+// Returns the Euclidean norm of a vector of length n.
+static double norm(const double* a, ptrdiff_t n) {
+  return sqrt(dot(a,a,n));
+}
+
+// y = y + alpha*x for vectors of length n.
+static void axpy(double alpha, const double* x, double* y, ptrdiff_t n) {
+  for (ptrdiff_t i = 0; i < n; i++) {
+    y[i] += alpha*x[i];
+  }
+}
+
+// Applies the preconditioner to x, or just copies x if there isn't
+// one.
+static void precondition(const LinearOperator& preconditioner,
+			 const double* x, double* y, ptrdiff_t n) {
+  if ( preconditioner ) {
+    preconditioner(x,y);
+  } else {
+    memcpy(y,x,n*sizeof(double));
+  }
+}
+
+// Starts a result: x = 0, so the residual is b and the relative
+// residual is one. If b is zero, x = 0 is exact.
+static IterativeResult start_result(ptrdiff_t n, double knowns_norm) {
+  IterativeResult output;
+  output.solution.reset(n);
+  for (ptrdiff_t i = 0; i < n; i++) {
+    output.solution[i] = 0;
+  }
+  output.iterations = 0;
+  output.relative_residual = (knowns_norm > 0) ? 1 : 0;
+  output.converged = (knowns_norm == 0);
+  output.history.push_back(output.relative_residual);
+  return output;
+}
+// ----------------------------------------------------------------------
+
+
+// Matrix operators and preconditioners
+// ----------------------------------------------------------------------
+
+// y = A x for an n x n matrix whose row i is the n contiguous values
+// at rows[i]. Rows are split over threads when the matrix is big
+// enough.
+static void dense_product(const double* const* rows, int n, int threads,
+			  const double* x, double* y) {
+  if ( (ptrdiff_t)n*n < PARALLEL_THRESHOLD ) {
+    threads = 1;
+  }
+  parallel_for(0,n,threads,[=](int first, int last) {
+      for (int row = first; row < last; row++) {
+	y[row] = dot(rows[row],x,n);
+      }
+    });
+}
+
+// An incomplete LU factorization with the sparsity pattern of A. L
+// has a unit diagonal and is stored below the diagonal of factors. U
+// is stored on and above it. lower[i] and upper[i] list the columns
+// of row i that may be nonzero below and above the diagonal.
+struct IncompleteLU {
+  int n;
+  Dynamic1DArray<double> factors;
+  vector<vector<int> > lower;
+  vector<vector<int> > upper;
+};
+
+// Computes the ILU(0) factorization of the n x n matrix whose row i
+// is at rows[i].
+static void factor_ilu0(const double* const* rows, int n,
+			IncompleteLU& ilu) {
+  ilu.n = n;
+  ilu.factors.reset((ptrdiff_t)n*n);
+  ilu.lower.assign(n,vector<int>());
+  ilu.upper.assign(n,vector<int>());
+  for (int row = 0; row < n; row++) {
+    memcpy(ilu.factors.data() + (ptrdiff_t)row*n,rows[row],n*sizeof(double));
+    for (int column = 0; column < n; column++) {
+      if ( column != row && rows[row][column] != 0 ) {
+	(column < row ? ilu.lower : ilu.upper)[row].push_back(column);
+      }
+    }
+  }
+
+  // Row-by-row (IKJ) elimination, but only updating entries in the
+  // pattern. in_pattern[j] == row+1 marks the pattern of the current
+  // row.
+  double* lu = ilu.factors.data();
+  vector<int> in_pattern(n,0);
+  for (int row = 0; row < n; row++) {
+    in_pattern[row] = row + 1;
+    for (size_t a = 0; a < ilu.lower[row].size(); a++) {
+      in_pattern[ilu.lower[row][a]] = row + 1;
+    }
+    for (size_t a = 0; a < ilu.upper[row].size(); a++) {
+      in_pattern[ilu.upper[row][a]] = row + 1;
+    }
+    double* lu_row = lu + (ptrdiff_t)row*n;
+    for (size_t a = 0; a < ilu.lower[row].size(); a++) {
+      int k = ilu.lower[row][a];
+      const double* lu_k = lu + (ptrdiff_t)k*n;
+      assert( lu_k[k] != 0 && "ILU(0) needs nonzero pivots." );
+      lu_row[k] /= lu_k[k];
+      for (size_t b = 0; b < ilu.upper[k].size(); b++) {
+	int column = ilu.upper[k][b];
+	if ( in_pattern[column] == row + 1 ) {
+	  lu_row[column] -= lu_row[k]*lu_k[column];
+	}
+      }
+    }
+    assert( lu_row[row] != 0 && "ILU(0) needs nonzero pivots." );
+  }
+}
+
+// y = (LU)^{-1} x by forward and back substitution.
+static void apply_ilu0(const IncompleteLU& ilu, const double* x, double* y) {
+  int n = ilu.n;
+  const double* lu = ilu.factors.data();
+  for (int row = 0; row < n; row++) {
+    double sum = x[row];
+    const double* lu_row = lu + (ptrdiff_t)row*n;
+    for (size_t a = 0; a < ilu.lower[row].size(); a++) {
+      int column = ilu.lower[row][a];
+      sum -= lu_row[column]*y[column];
+    }
+    y[row] = sum;
+  }
+  for (int row = n-1; row >= 0; row--) {
+    double sum = y[row];
+    const double* lu_row = lu + (ptrdiff_t)row*n;
+    for (size_t a = 0; a < ilu.upper[row].size(); a++) {
+      int column = ilu.upper[row][a];
+      sum -= lu_row[column]*y[column];
+    }
+    y[row] = sum/lu_row[row];
+  }
+}
+// ----------------------------------------------------------------------
+
+
+// Krylov methods
+// ----------------------------------------------------------------------
+
+// Preconditioned conjugate gradients. Stops early if p.Ap <= 0,
+// which means the matrix is not positive definite.
+static IterativeResult conjugate_gradient(const LinearOperator& A,
+					  const LinearOperator& M,
+					  const Dynamic1DArray<double>& knowns,
+					  const IterativeOptions& options) {
+  ptrdiff_t n = knowns.length();
+  const double* b = knowns.data();
+  double knowns_norm = norm(b,n);
+  IterativeResult output = start_result(n,knowns_norm);
+  if ( output.converged ) {
+    return output;
+  }
+  double* x = output.solution.data();
+  Dynamic1DArray<double> r(knowns), z(n), p(n), Ap(n);
+  precondition(M,r.data(),z.data(),n);
+  memcpy(p.data(),z.data(),n*sizeof(double));
+  double rz = dot(r.data(),z.data(),n);
+
+  while ( output.iterations < options.max_iterations ) {
+    A(p.data(),Ap.data());
+    double curvature = dot(p.data(),Ap.data(),n);
+    if ( !(curvature > 0) ) {
+      break;
+    }
+    double alpha = rz/curvature;
+    axpy(alpha,p.data(),x,n);
+    axpy(-alpha,Ap.data(),r.data(),n);
+    output.iterations++;
+    output.relative_residual = norm(r.data(),n)/knowns_norm;
+    output.history.push_back(output.relative_residual);
+    if ( output.relative_residual <= options.tolerance ) {
+      output.converged = true;
+      break;
+    }
+    precondition(M,r.data(),z.data(),n);
+    double rz_next = dot(r.data(),z.data(),n);
+    double beta = rz_next/rz;
+    rz = rz_next;
+    for (ptrdiff_t i = 0; i < n; i++) {
+      p[i] = z[i] + beta*p[i];
+    }
+  }
+  return output;
+}
+
+// Right-preconditioned BiCGSTAB. Stops early if rho, r_hat.v or
+// omega vanishes, the ways the method can break down.
+static IterativeResult bicgstab(const LinearOperator& A,
+				const LinearOperator& M,
+				const Dynamic1DArray<double>& knowns,
+				const IterativeOptions& options) {
+  ptrdiff_t n = knowns.length();
+  const double* b = knowns.data();
+  double knowns_norm = norm(b,n);
+  IterativeResult output = start_result(n,knowns_norm);
+  if ( output.converged ) {
+    return output;
+  }
+  double* x = output.solution.data();
+  Dynamic1DArray<double> r(knowns), r_hat(knowns), p(n), v(n);
+  Dynamic1DArray<double> p_hat(n), s(n), s_hat(n), t(n);
+  for (ptrdiff_t i = 0; i < n; i++) {
+    p[i] = v[i] = 0;
+  }
+  double rho = 1, alpha = 1, omega = 1;
+
+  while ( output.iterations < options.max_iterations ) {
+    double rho_next = dot(r_hat.data(),r.data(),n);
+    if ( rho_next == 0 ) {
+      break;
+    }
+    double beta = (rho_next/rho)*(alpha/omega);
+    rho = rho_next;
+    for (ptrdiff_t i = 0; i < n; i++) {
+      p[i] = r[i] + beta*(p[i] - omega*v[i]);
+    }
+    precondition(M,p.data(),p_hat.data(),n);
+    A(p_hat.data(),v.data());
+    double r_hat_v = dot(r_hat.data(),v.data(),n);
+    if ( r_hat_v == 0 ) {
+      break;
+    }
+    alpha = rho/r_hat_v;
+    for (ptrdiff_t i = 0; i < n; i++) {
+      s[i] = r[i] - alpha*v[i];
+    }
+    output.iterations++;
+    double s_norm = norm(s.data(),n);
+    if ( s_norm/knowns_norm <= options.tolerance ) {
+      axpy(alpha,p_hat.data(),x,n);
+      output.relative_residual = s_norm/knowns_norm;
+      output.history.push_back(output.relative_residual);
+      output.converged = true;
+      break;
+    }
+    precondition(M,s.data(),s_hat.data(),n);
+    A(s_hat.data(),t.data());
+    double t_norm_squared = dot(t.data(),t.data(),n);
+    omega = (t_norm_squared > 0) ? dot(t.data(),s.data(),n)/t_norm_squared : 0;
+    axpy(alpha,p_hat.data(),x,n);
+    axpy(omega,s_hat.data(),x,n);
+    for (ptrdiff_t i = 0; i < n; i++) {
+      r[i] = s[i] - omega*t[i];
+    }
+    output.relative_residual = norm(r.data(),n)/knowns_norm;
+    output.history.push_back(output.relative_residual);
+    if ( output.relative_residual <= options.tolerance ) {
+      output.converged = true;
+      break;
+    }
+    if ( omega == 0 ) {
+      break;
+    }
+  }
+  return output;
+}
+
+// Right-preconditioned restarted GMRES. The Arnoldi basis is built by
+// modified Gram-Schmidt, and the little least-squares problem is kept
+// triangular with Givens rotations, so the residual norm is known
+// after every iteration without forming x.
+static IterativeResult gmres(const LinearOperator& A,
+			     const LinearOperator& M,
+			     const Dynamic1DArray<double>& knowns,
+			     const IterativeOptions& options) {
+  ptrdiff_t n = knowns.length();
+  const double* b = knowns.data();
+  double knowns_norm = norm(b,n);
+  IterativeResult output = start_result(n,knowns_norm);
+  if ( output.converged ) {
+    return output;
+  }
+  double* x = output.solution.data();
+  int m = (options.restart < 1) ? 1 : options.restart;
+  if ( m > n ) {
+    m = (int)n;
+  }
+  // Row j is the jth basis vector.
+  Dynamic1DArray<double> basis((ptrdiff_t)(m+1)*n);
+  Dynamic1DArray<double> hessenberg((m+1)*m); // H(i,j) at i*m + j.
+  Dynamic1DArray<double> cosines(m), sines(m), g(m+1), y(m);
+  Dynamic1DArray<double> r(n), z(n), w(n);
+
+  while ( output.iterations < options.max_iterations ) {
+    // r = b - A x.
+    A(x,r.data());
+    for (ptrdiff_t i = 0; i < n; i++) {
+      r[i] = b[i] - r[i];
+    }
+    double beta = norm(r.data(),n);
+    output.relative_residual = beta/knowns_norm;
+    if ( output.relative_residual <= options.tolerance ) {
+      output.converged = true;
+      break;
+    }
+    for (ptrdiff_t i = 0; i < n; i++) {
+      basis[i] = r[i]/beta;
+    }
+    for (int i = 0; i <= m; i++) {
+      g[i] = 0;
+    }
+    g[0] = beta;
+
+    int columns = 0;
+    bool finished = false;
+    for (int j = 0; j < m && output.iterations < options.max_iterations; j++) {
+      double* v_j = basis.data() + j*n;
+      double* v_next = basis.data() + (j+1)*n;
+      precondition(M,v_j,z.data(),n);
+      A(z.data(),w.data());
+      for (int i = 0; i <= j; i++) {
+	double h = dot(w.data(),basis.data() + i*n,n);
+	hessenberg[i*m + j] = h;
+	axpy(-h,basis.data() + i*n,w.data(),n);
+      }
+      double h_next = norm(w.data(),n);
+      if ( h_next > 0 ) {
+	for (ptrdiff_t i = 0; i < n; i++) {
+	  v_next[i] = w[i]/h_next;
+	}
+      }
+
+      // Rotate the new column into triangular form.
+      for (int i = 0; i < j; i++) {
+	double upper = hessenberg[i*m + j];
+	double lower = hessenberg[(i+1)*m + j];
+	hessenberg[i*m + j] = cosines[i]*upper + sines[i]*lower;
+	hessenberg[(i+1)*m + j] = -sines[i]*upper + cosines[i]*lower;
+      }
+      double diagonal = hessenberg[j*m + j];
+      double radius = hypot(diagonal,h_next);
+      cosines[j] = (radius > 0) ? diagonal/radius : 1;
+      sines[j] = (radius > 0) ? h_next/radius : 0;
+      hessenberg[j*m + j] = radius;
+      g[j+1] = -sines[j]*g[j];
+      g[j] = cosines[j]*g[j];
+
+      columns = j + 1;
+      output.iterations++;
+      output.relative_residual = abs(g[j+1])/knowns_norm;
+      output.history.push_back(output.relative_residual);
+      if ( output.relative_residual <= options.tolerance || h_next == 0 ) {
+	finished = true;
+	break;
+      }
+    }
+
+    // Solve the triangular system H y = g and update x += M V y.
+    for (int i = columns-1; i >= 0; i--) {
+      double sum = g[i];
+      for (int k = i+1; k < columns; k++) {
+	sum -= hessenberg[i*m + k]*y[k];
+      }
+      y[i] = (hessenberg[i*m + i] != 0) ? sum/hessenberg[i*m + i] : 0;
+    }
+    for (ptrdiff_t i = 0; i < n; i++) {
+      w[i] = 0;
+    }
+    for (int k = 0; k < columns; k++) {
+      axpy(y[k],basis.data() + k*n,w.data(),n);
+    }
+    precondition(M,w.data(),z.data(),n);
+    axpy(1,z.data(),x,n);
+    if ( finished ) {
+      output.converged = output.relative_residual <= options.tolerance;
+      break;
+    }
+  }
+  return output;
+}
+// ----------------------------------------------------------------------
+
+
+// Interface
+// ----------------------------------------------------------------------
+
+// Solves A x = b with a user-supplied operator.
+IterativeResult iterative_solve(const LinearOperator& matrix_operator,
+				const Dynamic1DArray<double>& knowns,
+				const IterativeOptions& options,
+				const LinearOperator& preconditioner) {
+  switch ( options.method ) {
+  case CONJUGATE_GRADIENT:
+    return conjugate_gradient(matrix_operator,preconditioner,knowns,options);
+  case BICGSTAB:
+    return bicgstab(matrix_operator,preconditioner,knowns,options);
+  default:
+    return gmres(matrix_operator,preconditioner,knowns,options);
+  }
+}
+
+// Solves a stored system. The products read the rows in place, in
+// logical row order, wherever they are contiguous. Only a system with
+// column-major storage is copied, once, into a row-major block.
+IterativeResult iterative_solve(const GaussianSystem& g_sys,
+				const IterativeOptions& options) {
+  int n = g_sys.size();
+  Dynamic1DArray<double> knowns(n);
+  vector<const double*> rows(n);
+  bool contiguous = true;
+  for (int row = 0; row < n; row++) {
+    knowns[row] = g_sys.vector_get(row);
+    rows[row] = g_sys.matrix_row(row);
+    contiguous = contiguous && rows[row] != NULL;
+  }
+  Dynamic1DArray<double> matrix;
+  if ( !contiguous ) {
+    matrix.reset((ptrdiff_t)n*n);
+    for (int row = 0; row < n; row++) {
+      for (int column = 0; column < n; column++) {
+	matrix[(ptrdiff_t)row*n + column] = g_sys.matrix_get(row,column);
+      }
+      rows[row] = matrix.data() + (ptrdiff_t)row*n;
+    }
+  }
+  const double* const* row_values = rows.data();
+  int threads = options.threads;
+  LinearOperator matrix_operator = [=](const double* x, double* y) {
+    dense_product(row_values,n,threads,x,y);
+  };
+
+  LinearOperator preconditioner;
+  Dynamic1DArray<double> inverse_diagonal;
+  IncompleteLU ilu;
+  if ( options.preconditioner == JACOBI_PRECONDITIONER ) {
+    // A zero on the diagonal is left alone rather than inverted.
+    inverse_diagonal.reset(n);
+    for (int i = 0; i < n; i++) {
+      double diagonal = rows[i][i];
+      inverse_diagonal[i] = (diagonal != 0) ? 1/diagonal : 1;
+    }
+    const double* inverse = inverse_diagonal.data();
+    preconditioner = [=](const double* x, double* y) {
+      for (int i = 0; i < n; i++) {
+	y[i] = inverse[i]*x[i];
+      }
+    };
+  } else if ( options.preconditioner == ILU0_PRECONDITIONER ) {
+    factor_ilu0(row_values,n,ilu);
+    const IncompleteLU* factors = &ilu;
+    preconditioner = [=](const double* x, double* y) {
+      apply_ilu0(*factors,x,y);
+    };
+  }
+  return iterative_solve(matrix_operator,knowns,options,preconditioner);
+}
+// ----------------------------------------------------------------------
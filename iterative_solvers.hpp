@@ -0,0 +1,128 @@
+// iterative_solvers.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 16:22:07 (jonah)>
+
+// This file prototypes Krylov iterative solvers, an alternative to
+// Gaussian elimination for large, well-conditioned systems.
+// Elimination always costs O(n^3). A Krylov method costs one
+// matrix-vector product, O(n^2), per iteration, and a good one
+// converges in a few dozen iterations. Three methods are provided:
+// the conjugate gradient method for symmetric positive definite
+// matrices, and BiCGSTAB and restarted GMRES for general ones. Each
+// can use a Jacobi or ILU(0) preconditioner.
+
+// This library is designed to be used with the gaussian_system data
+// structure. There is also a matrix-free version, which only needs a
+// function that applies the matrix to a vector.
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <vector>
+#include <functional>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The Krylov methods available.
+enum KrylovMethod {
+  // The conjugate gradient method. Only for symmetric positive
+  // definite matrices. The cheapest per iteration.
+  CONJUGATE_GRADIENT,
+  // The stabilized biconjugate gradient method. For general
+  // matrices. Two matrix-vector products per iteration and short
+  // recurrences, so memory use is flat.
+  BICGSTAB,
+  // The generalized minimal residual method, restarted every
+  // IterativeOptions::restart iterations. For general matrices. The
+  // residual never grows, but each iteration between restarts costs
+  // a little more than the last.
+  GMRES
+};
+
+// The preconditioners available for a stored matrix.
+enum Preconditioner {
+  NO_PRECONDITIONER,
+  // Divides by the diagonal. Cheap, and often enough for diagonally
+  // dominant matrices.
+  JACOBI_PRECONDITIONER,
+  // Incomplete LU factorization with no fill: L and U only have
+  // nonzeros where A does. Much stronger than Jacobi. For a dense
+  // matrix this is an ordinary LU factorization without pivoting.
+  ILU0_PRECONDITIONER
+};
+
+// The knobs of an iterative solve.
+struct IterativeOptions {
+  KrylovMethod method;
+  Preconditioner preconditioner;
+  // The solve has converged when |b - Ax| <= tolerance*|b|.
+  double tolerance;
+  // The most iterations to run before giving up. For GMRES this
+  // counts inner iterations, not restarts.
+  int max_iterations;
+  // The number of GMRES iterations between restarts.
+  int restart;
+  // The number of threads for matrix-vector products. Less than 1
+  // means one per hardware thread. Small matrices always use one.
+  int threads;
+  // Sensible defaults: GMRES(30) with Jacobi, tolerance 1E-10, at most
+  // 1000 iterations.
+  IterativeOptions() {
+    method = GMRES;
+    preconditioner = JACOBI_PRECONDITIONER;
+    tolerance = 1E-10;
+    max_iterations = 1000;
+    restart = 30;
+    threads = 0;
+  }
+};
+
+// The outcome of an iterative solve.
+struct IterativeResult {
+  // Whether the tolerance was reached.
+  bool converged;
+  // The number of iterations run.
+  int iterations;
+  // The final relative residual |b - Ax|/|b|.
+  double relative_residual;
+  // The relative residual before the first iteration and after each
+  // one. For BiCGSTAB and GMRES these are the residuals the method
+  // itself tracks, which can drift slightly from the true residual.
+  vector<double> history;
+  // The approximate solution x.
+  Dynamic1DArray<double> solution;
+};
+
+// A linear operator y = Op(x) on vectors of some fixed length. x and
+// y never overlap.
+typedef function<void(const double* x, double* y)> LinearOperator;
+
+
+// Solves the system g_sys iteratively, starting from x = 0. g_sys is
+// not changed. Never raises an error: if the method breaks down or
+// runs out of iterations, the result says it did not converge and
+// holds the best solution found. Asking for ILU(0) on a matrix with
+// a zero pivot raises an error.
+IterativeResult iterative_solve(const GaussianSystem& g_sys,
+				const IterativeOptions& options
+				= IterativeOptions());
+
+// Solves A x = b iteratively, where A is the n x n matrix applied by
+// matrix_operator. A is never stored. preconditioner, if given,
+// should apply an approximate inverse of A. options.preconditioner
+// and options.threads are ignored.
+IterativeResult iterative_solve(const LinearOperator& matrix_operator,
+				const Dynamic1DArray<double>& knowns,
+				const IterativeOptions& options
+				= IterativeOptions(),
+				const LinearOperator& preconditioner
+				= LinearOperator());
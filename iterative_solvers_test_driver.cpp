@@ -0,0 +1,221 @@
+// iterative_solvers_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 23:43:10 (jonah)>
+
+// This file tests the Krylov iterative solvers against Gaussian
+// elimination.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <vector>
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "iterative_solvers.hpp"
+#include "test_systems.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Solves g_sys with the given method and preconditioner and checks
+// the answer against exact.
+static void check_method(const GaussianSystem& g_sys,
+			 const Dynamic1DArray<double>& exact,
+			 KrylovMethod method, Preconditioner preconditioner,
+			 const char* name) {
+  IterativeOptions options;
+  options.method = method;
+  options.preconditioner = preconditioner;
+  options.tolerance = 1E-12;
+  IterativeResult result = iterative_solve(g_sys,options);
+  cout << name << ": " << result.iterations << " iterations, residual "
+       << result.relative_residual << endl;
+  assert( result.converged && "The solver converges." );
+  assert( (int)result.history.size() == result.iterations + 1
+	  && "There is one history entry per iteration." );
+  assert( max_difference(result.solution,exact) < 1E-8
+	  && "The solution matches elimination." );
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the iterative_solvers library.\n"
+       << "BEGIN." << endl;
+
+  cout << "\n\nSolving a symmetric positive definite tridiagonal system."
+       << endl;
+  int testing1_size = 50;
+  GaussianSystem testing1(testing1_size);
+  for (int i = 0; i < testing1_size; i++) {
+    for (int j = 0; j < testing1_size; j++) {
+      testing1.matrix_set(i,j,(i == j) ? 2.5 : (abs(i-j) == 1) ? -1 : 0);
+    }
+    testing1.vector_set(i,sin(i + 1.0));
+  }
+  GaussianSystem reduced1 = testing1;
+  Dynamic1DArray<double> exact1 = solve_system(reduced1,RECURSIVE_ELIMINATION);
+  check_method(testing1,exact1,CONJUGATE_GRADIENT,NO_PRECONDITIONER,"CG");
+  check_method(testing1,exact1,CONJUGATE_GRADIENT,JACOBI_PRECONDITIONER,
+	       "CG + Jacobi");
+  check_method(testing1,exact1,CONJUGATE_GRADIENT,ILU0_PRECONDITIONER,
+	       "CG + ILU(0)");
+  check_method(testing1,exact1,BICGSTAB,JACOBI_PRECONDITIONER,
+	       "BiCGSTAB + Jacobi");
+  check_method(testing1,exact1,GMRES,ILU0_PRECONDITIONER,"GMRES + ILU(0)");
+
+  cout << "\n\nChecking that ILU(0) is exact for a tridiagonal matrix."
+       << endl;
+  IterativeOptions exact_options;
+  exact_options.method = GMRES;
+  exact_options.preconditioner = ILU0_PRECONDITIONER;
+  exact_options.tolerance = 1E-12;
+  IterativeResult exact_result = iterative_solve(testing1,exact_options);
+  assert( exact_result.iterations == 1
+	  && "A tridiagonal matrix has no fill, so ILU(0) is LU." );
+  cout << "It is." << endl;
+
+  cout << "\n\nSolving a nonsymmetric diagonally dominant system." << endl;
+  int testing2_size = 60;
+  GaussianSystem testing2(testing2_size);
+  srand(2);
+  for (int i = 0; i < testing2_size; i++) {
+    for (int j = 0; j <= testing2_size; j++) {
+      testing2.set(i,j,2.0*rand()/RAND_MAX - 1.0);
+    }
+    testing2.matrix_set(i,i,testing2_size/2.0);
+  }
+  GaussianSystem reduced2 = testing2;
+  Dynamic1DArray<double> exact2 = solve_system(reduced2,RECURSIVE_ELIMINATION);
+  check_method(testing2,exact2,BICGSTAB,NO_PRECONDITIONER,"BiCGSTAB");
+  check_method(testing2,exact2,BICGSTAB,ILU0_PRECONDITIONER,
+	       "BiCGSTAB + ILU(0)");
+  check_method(testing2,exact2,GMRES,NO_PRECONDITIONER,"GMRES");
+  check_method(testing2,exact2,GMRES,JACOBI_PRECONDITIONER,"GMRES + Jacobi");
+
+  cout << "\n\nSolving views of caller memory and a pivoted system."
+       << endl;
+  // The row-major view and the swapped system are read in place; the
+  // column-major view is copied. All three must agree.
+  vector<double> row_major((size_t)testing2_size*testing2_size);
+  vector<double> column_major(row_major.size());
+  vector<double> knowns2(testing2_size);
+  for (int i = 0; i < testing2_size; i++) {
+    for (int j = 0; j < testing2_size; j++) {
+      row_major[(size_t)i*testing2_size + j] = testing2.matrix_get(i,j);
+      column_major[(size_t)j*testing2_size + i] = testing2.matrix_get(i,j);
+    }
+    knowns2[i] = testing2.vector_get(i);
+  }
+  vector<double> row_major_copy = row_major;
+  GaussianSystem row_view(testing2_size,row_major.data(),testing2_size,
+			  ROW_MAJOR,knowns2.data(),PRESERVE_CALLER_MEMORY);
+  GaussianSystem column_view(testing2_size,column_major.data(),
+			     testing2_size,COLUMN_MAJOR,knowns2.data(),
+			     PRESERVE_CALLER_MEMORY);
+  // swapped holds each pair of rows of testing2 the other way round
+  // in memory, and its permutation vector puts them back.
+  GaussianSystem swapped(testing2_size);
+  for (int i = 0; i < testing2_size; i++) {
+    for (int j = 0; j <= testing2_size; j++) {
+      swapped.set(i ^ 1,j,testing2.get(i,j));
+    }
+  }
+  for (int i = 0; i < testing2_size; i += 2) {
+    swapped.swap(i,i + 1);
+  }
+  check_method(row_view,exact2,GMRES,ILU0_PRECONDITIONER,
+	       "Row-major view, GMRES + ILU(0)");
+  check_method(column_view,exact2,BICGSTAB,JACOBI_PRECONDITIONER,
+	       "Column-major view, BiCGSTAB + Jacobi");
+  check_method(swapped,exact2,GMRES,JACOBI_PRECONDITIONER,
+	       "Swapped rows, GMRES + Jacobi");
+  assert( row_major == row_major_copy
+	  && "A preserved view is never written." );
+
+  cout << "\n\nRestarting GMRES every 4 iterations." << endl;
+  IterativeOptions restart_options;
+  restart_options.method = GMRES;
+  restart_options.restart = 4;
+  restart_options.tolerance = 1E-12;
+  IterativeResult restarted = iterative_solve(testing2,restart_options);
+  cout << "Convergence history:";
+  for (size_t i = 0; i < restarted.history.size(); i++) {
+    cout << " " << restarted.history[i];
+    assert( (i == 0 || restarted.history[i] <= restarted.history[i-1]*(1+1E-8))
+	    && "The GMRES residual never grows." );
+  }
+  cout << endl;
+  assert( restarted.converged
+	  && max_difference(restarted.solution,exact2) < 1E-8
+	  && "Restarted GMRES still converges." );
+
+  cout << "\n\nBiCGSTAB breaking down on a rotation." << endl;
+  // With b = (1,0), A b is orthogonal to the shadow residual b, so
+  // the very first step would divide by zero.
+  GaussianSystem rotation(2);
+  rotation.matrix_set(0,1,1);
+  rotation.matrix_set(1,0,-1);
+  rotation.vector_set(0,1);
+  IterativeOptions breakdown_options;
+  breakdown_options.method = BICGSTAB;
+  breakdown_options.preconditioner = NO_PRECONDITIONER;
+  IterativeResult broke_down = iterative_solve(rotation,breakdown_options);
+  assert( !broke_down.converged
+	  && isfinite(broke_down.solution[0])
+	  && isfinite(broke_down.solution[1])
+	  && "A breakdown stops with a finite solution." );
+  cout << "Stopped after " << broke_down.iterations << " iterations."
+       << endl;
+
+  cout << "\n\nGiving up after 2 iterations." << endl;
+  IterativeOptions short_options;
+  short_options.method = CONJUGATE_GRADIENT;
+  short_options.preconditioner = NO_PRECONDITIONER;
+  short_options.max_iterations = 2;
+  IterativeResult gave_up = iterative_solve(testing1,short_options);
+  assert( !gave_up.converged && gave_up.iterations == 2
+	  && "The iteration limit is respected." );
+  cout << "Stopped with residual " << gave_up.relative_residual << endl;
+
+  cout << "\n\nSolving a matrix-free 1D Laplacian with 1000 unknowns."
+       << endl;
+  int testing3_size = 1000;
+  LinearOperator laplacian = [=](const double* x, double* y) {
+    for (int i = 0; i < testing3_size; i++) {
+      y[i] = 2.01*x[i];
+      if ( i > 0 ) {
+	y[i] -= x[i-1];
+      }
+      if ( i < testing3_size-1 ) {
+	y[i] -= x[i+1];
+      }
+    }
+  };
+  Dynamic1DArray<double> knowns3(testing3_size);
+  for (int i = 0; i < testing3_size; i++) {
+    knowns3[i] = cos(0.01*i);
+  }
+  IterativeOptions free_options;
+  free_options.method = CONJUGATE_GRADIENT;
+  free_options.tolerance = 1E-10;
+  IterativeResult free_result = iterative_solve(laplacian,knowns3,
+						free_options);
+  Dynamic1DArray<double> check3(testing3_size);
+  laplacian(free_result.solution.data(),check3.data());
+  cout << free_result.iterations << " iterations, residual "
+       << free_result.relative_residual << endl;
+  assert( free_result.converged && max_difference(check3,knowns3) < 1E-8
+	  && "The matrix-free solve satisfies the equation." );
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,313 @@
+// least_squares.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 14:58:43 (jonah)>
+
+// This file implements the blocked Householder QR least-squares
+// solver.
+
+// Each panel of nb columns is factored one column at a time. Then
+// the reflections are copied out into V, an (m - k) x nb unit lower
+// trapezoidal matrix, and T is built column by column as in LAPACK's
+// dlarft:
+//     T(0:i,i) = -tau_i T(0:i,0:i) V(:,0:i)^T v_i,   T(i,i) = tau_i.
+// The rest of the matrix, C, is then updated by
+//     C = (I - V T V^T)^T C = C - V (T^T (V^T C)),
+// where V^T C and the product with V are gemm() calls and only the
+// nb x nb triangular product is done by hand.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "least_squares.hpp"
+#include "gemm.hpp"
+#include <cmath>
+#include <cassert>
+#include <cfloat>
+#include <vector>
+#include <algorithm>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The system
+// ----------------------------------------------------------------------
+
+LeastSquaresSystem::LeastSquaresSystem(int rows, int columns)
+  : matrix(rows,columns), knowns(rows) {
+  assert( 0 <= columns && columns <= rows
+	  && "There are at least as many equations as unknowns." );
+  fill(matrix.data(),matrix.data() + (size_t)rows*columns,0.0);
+  fill(knowns.data(),knowns.data() + rows,0.0);
+}
+
+LeastSquaresSystem::LeastSquaresSystem() {}
+
+void LeastSquaresSystem::print(ostream& out) const {
+  for (int i = 0; i < rows(); i++) {
+    for (int j = 0; j < columns(); j++) {
+      out << matrix_get(i,j) << " ";
+    }
+    out << "| " << vector_get(i) << endl;
+  }
+}
+// ----------------------------------------------------------------------
+
+
+// Single reflections
+// ----------------------------------------------------------------------
+
+// Builds the reflection that zeroes column j of the m x n row-major
+// matrix a below the diagonal. Leaves beta on the diagonal and v
+// below it, and returns tau. tau is 0, and nothing changes, if the
+// column is already zero below the diagonal.
+static double make_reflection(double* a, int m, int n, int j) {
+  double alpha = a[(size_t)j*n + j];
+  // Scaled, so the sum of squares can't overflow or underflow.
+  double scale = 0;
+  for (int i = j + 1; i < m; i++) {
+    scale = max(scale,abs(a[(size_t)i*n + j]));
+  }
+  if ( scale == 0 ) {
+    return 0;
+  }
+  double sum = 0;
+  for (int i = j + 1; i < m; i++) {
+    double element = a[(size_t)i*n + j]/scale;
+    sum += element*element;
+  }
+  double beta = -copysign(hypot(alpha,scale*sqrt(sum)),alpha);
+  double factor = 1.0/(alpha - beta);
+  for (int i = j + 1; i < m; i++) {
+    a[(size_t)i*n + j] *= factor;
+  }
+  a[(size_t)j*n + j] = beta;
+  return (beta - alpha)/beta;
+}
+
+// Applies the reflection stored in column j of a to columns first to
+// last - 1, rows j to m - 1. The rows are walked in order, so every
+// inner loop is contiguous.
+static void apply_reflection(double* a, int m, int n, int j, double tau,
+			     int first, int last, double* work) {
+  int width = last - first;
+  if ( tau == 0 || width <= 0 ) {
+    return;
+  }
+  // work = v^T C
+  double* top = a + (size_t)j*n + first;
+  copy(top,top + width,work);
+  for (int i = j + 1; i < m; i++) {
+    double v = a[(size_t)i*n + j];
+    const double* row = a + (size_t)i*n + first;
+    for (int c = 0; c < width; c++) {
+      work[c] += v*row[c];
+    }
+  }
+  // C -= tau v work
+  for (int c = 0; c < width; c++) {
+    top[c] -= tau*work[c];
+  }
+  for (int i = j + 1; i < m; i++) {
+    double v = tau*a[(size_t)i*n + j];
+    double* row = a + (size_t)i*n + first;
+    for (int c = 0; c < width; c++) {
+      row[c] -= v*work[c];
+    }
+  }
+}
+// ----------------------------------------------------------------------
+
+
+// Blocks of reflections
+// ----------------------------------------------------------------------
+
+// Copies the reflections of columns k to k + nb - 1 out of a into v,
+// (m - k) x nb and row-major, with the implied ones and zeros filled
+// in.
+static void copy_reflections(const double* a, int m, int n, int k, int nb,
+			     double* v) {
+  for (int i = k; i < m; i++) {
+    double* row = v + (size_t)(i - k)*nb;
+    for (int c = 0; c < nb; c++) {
+      int column = k + c;
+      row[c] = i > column ? a[(size_t)i*n + column] : (i == column ? 1 : 0);
+    }
+  }
+}
+
+// Builds the nb x nb upper triangular T, row-major, with
+// H_1 ... H_nb = I - V T V^T for the rows x nb matrix v.
+static void form_t(const double* v, int rows, int nb, const double* tau,
+		   double* t) {
+  fill(t,t + (size_t)nb*nb,0.0);
+  vector<double> z(nb);
+  for (int c = 0; c < nb; c++) {
+    // z = V(:,0:c)^T v_c. v_c is zero above row c.
+    fill(z.begin(),z.begin() + c,0.0);
+    for (int i = c; i < rows; i++) {
+      const double* row = v + (size_t)i*nb;
+      for (int s = 0; s < c; s++) {
+	z[s] += row[s]*row[c];
+      }
+    }
+    // T(0:c,c) = -tau_c T(0:c,0:c) z
+    for (int r = 0; r < c; r++) {
+      double sum = 0;
+      for (int s = r; s < c; s++) {
+	sum += t[(size_t)r*nb + s]*z[s];
+      }
+      t[(size_t)r*nb + c] = -tau[c]*sum;
+    }
+    t[(size_t)c*nb + c] = tau[c];
+  }
+}
+
+// C = (I - V T V^T)^T C for the rows x width block c of a matrix
+// whose rows are ldc apart. w is nb x width scratch.
+static void apply_block(const double* v, const double* t, int rows, int nb,
+			double* c, int width, int ldc, double* w,
+			int threads) {
+  // W = V^T C
+  gemm(TRANSPOSE,NO_TRANSPOSE,nb,width,rows,1.0,v,nb,c,ldc,0.0,w,width,
+       threads);
+  // W = T^T W. Row r of the result needs rows 0 to r of W, so go
+  // from the bottom up and work in place.
+  for (int r = nb - 1; r >= 0; r--) {
+    double* out = w + (size_t)r*width;
+    double diagonal = t[(size_t)r*nb + r];
+    for (int j = 0; j < width; j++) {
+      out[j] *= diagonal;
+    }
+    for (int s = 0; s < r; s++) {
+      double factor = t[(size_t)s*nb + r];
+      const double* in = w + (size_t)s*width;
+      for (int j = 0; j < width; j++) {
+	out[j] += factor*in[j];
+      }
+    }
+  }
+  // C = C - V W
+  gemm(NO_TRANSPOSE,NO_TRANSPOSE,rows,width,nb,-1.0,v,nb,w,width,1.0,c,ldc,
+       threads);
+}
+// ----------------------------------------------------------------------
+
+
+// Solving
+// ----------------------------------------------------------------------
+
+void qr_factorization(LeastSquaresSystem& ls_sys, Dynamic1DArray<double>& tau,
+		      int block_size/*= DEFAULT_QR_BLOCK_SIZE*/,
+		      int threads/*= 0*/) {
+  assert( block_size > 0 && "Panels have at least one column." );
+  int m = ls_sys.rows();
+  int n = ls_sys.columns();
+  double* a = ls_sys.matrix_data();
+  tau.reset(n);
+  int nb_max = min(block_size,max(n,1));
+  vector<double> work(max(n,1));
+  vector<double> v((size_t)m*nb_max);
+  vector<double> t((size_t)nb_max*nb_max);
+  vector<double> w((size_t)nb_max*max(n - nb_max,1));
+  for (int k = 0; k < n; k += block_size) {
+    int nb = min(block_size,n - k);
+    // The panel, one column at a time.
+    for (int j = k; j < k + nb; j++) {
+      tau[j] = make_reflection(a,m,n,j);
+      apply_reflection(a,m,n,j,tau[j],j + 1,k + nb,work.data());
+    }
+    // The rest of the matrix, all at once.
+    int width = n - k - nb;
+    if ( width == 0 ) {
+      continue;
+    }
+    if ( nb == 1 ) {
+      apply_reflection(a,m,n,k,tau[k],k + 1,n,work.data());
+      continue;
+    }
+    copy_reflections(a,m,n,k,nb,v.data());
+    form_t(v.data(),m - k,nb,tau.data() + k,t.data());
+    apply_block(v.data(),t.data(),m - k,nb,a + (size_t)k*n + k + nb,width,n,
+		w.data(),threads);
+  }
+}
+
+void apply_qt(LeastSquaresSystem& ls_sys, const Dynamic1DArray<double>& tau) {
+  int m = ls_sys.rows();
+  int n = ls_sys.columns();
+  assert( tau.length() == n && "There is a tau for every column." );
+  const double* a = ls_sys.matrix_data();
+  double* b = ls_sys.vector_data();
+  for (int j = 0; j < n; j++) {
+    if ( tau.get(j) == 0 ) {
+      continue;
+    }
+    double sum = b[j];
+    for (int i = j + 1; i < m; i++) {
+      sum += a[(size_t)i*n + j]*b[i];
+    }
+    sum *= tau.get(j);
+    b[j] -= sum;
+    for (int i = j + 1; i < m; i++) {
+      b[i] -= sum*a[(size_t)i*n + j];
+    }
+  }
+}
+
+Dynamic1DArray<double> qr_back_substitution(const LeastSquaresSystem& ls_sys) {
+  int m = ls_sys.rows();
+  int n = ls_sys.columns();
+  const double* r = ls_sys.matrix_data();
+  const double* b = ls_sys.vector_data();
+  // The columns are independent to working precision if no diagonal
+  // element of R is tiny next to the biggest.
+  double largest = 0;
+  for (int i = 0; i < n; i++) {
+    largest = max(largest,abs(r[(size_t)i*n + i]));
+  }
+  for (int i = 0; i < n; i++) {
+    if ( !(abs(r[(size_t)i*n + i]) > m*DBL_EPSILON*largest) ) {
+      return Dynamic1DArray<double>();
+    }
+  }
+  Dynamic1DArray<double> x(n);
+  for (int i = n - 1; i >= 0; i--) {
+    const double* row = r + (size_t)i*n;
+    double sum = b[i];
+    for (int j = i + 1; j < n; j++) {
+      sum -= row[j]*x[j];
+    }
+    x[i] = sum/row[i];
+  }
+  return x;
+}
+
+Dynamic1DArray<double> least_squares_solve(LeastSquaresSystem& ls_sys,
+					   int block_size
+					   /*= DEFAULT_QR_BLOCK_SIZE*/,
+					   int threads/*= 0*/) {
+  Dynamic1DArray<double> tau;
+  qr_factorization(ls_sys,tau,block_size,threads);
+  apply_qt(ls_sys,tau);
+  return qr_back_substitution(ls_sys);
+}
+
+double residual_norm(const LeastSquaresSystem& ls_sys,
+		     const Dynamic1DArray<double>& x) {
+  int m = ls_sys.rows();
+  int n = ls_sys.columns();
+  assert( x.length() == n && "There is a value for every unknown." );
+  const double* a = ls_sys.matrix_data();
+  double sum = 0;
+  for (int i = 0; i < m; i++) {
+    double residual = ls_sys.vector_get(i);
+    for (int j = 0; j < n; j++) {
+      residual -= a[(size_t)i*n + j]*x.get(j);
+    }
+    sum += residual*residual;
+  }
+  return sqrt(sum);
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,112 @@
+// least_squares.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 14:20:17 (jonah)>
+
+// This file prototypes a solver for overdetermined systems, m
+// equations in n <= m unknowns, in the least-squares sense: it finds
+// the x that minimizes |b - Ax|. Curve fits and calibrations are
+// problems like this.
+
+// Forming the normal equations A^T A x = A^T b and solving them by
+// elimination squares the condition number of the problem, so a fit
+// that is only mildly ill-conditioned loses half its digits. Instead
+// A is factored as A = QR, with Q orthogonal and R upper triangular,
+// by Householder reflections, and the solution is R x = (Q^T b) in
+// its first n rows. That costs about the same, 2mn^2 - 2n^3/3 flops,
+// and is as accurate as the data allows.
+
+// The factorization is blocked. The reflections of a panel of
+// columns are built one at a time, then collected in the compact WY
+// form
+//     H_1 H_2 ... H_nb = I - V T V^T,
+// with V the reflection vectors and T a small upper triangular
+// matrix. The panel is applied to the rest of the matrix by two
+// gemm() calls, so most of the flops run in the fast, threaded
+// matrix multiply.
+
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include "dynamic_array.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The number of columns in a panel when none is asked for.
+const int DEFAULT_QR_BLOCK_SIZE = 32;
+
+// A class that holds an m x n system of equations, Ax = b, with at
+// least as many equations as unknowns.
+class LeastSquaresSystem {
+public: // Constructors
+  // Creates an empty system of rows equations in columns unknowns.
+  // rows must be at least columns.
+  LeastSquaresSystem(int rows, int columns);
+  // Creates an empty 0 x 0 system. To be initialized later.
+  LeastSquaresSystem();
+
+public: // Access
+  // The number of equations, m.
+  int rows() const { return matrix.height(); }
+  // The number of unknowns, n.
+  int columns() const { return matrix.width(); }
+  // Entry (i,j) of the matrix.
+  double matrix_get(int i, int j) const { return matrix.get(i,j); }
+  void matrix_set(int i, int j, double value) { matrix.access(i,j) = value; }
+  // Entry i of the knowns.
+  double vector_get(int i) const { return knowns.get(i); }
+  void vector_set(int i, double value) { knowns[i] = value; }
+  // The matrix, m x n and row-major, with rows columns() apart.
+  double* matrix_data() { return matrix.data(); }
+  const double* matrix_data() const { return matrix.data(); }
+  // The m knowns.
+  double* vector_data() { return knowns.data(); }
+  const double* vector_data() const { return knowns.data(); }
+  // Prints the system, one equation per row, with the knowns last.
+  void print(ostream& out) const;
+
+private:
+  Dynamic2DArray<double> matrix;
+  Dynamic1DArray<double> knowns;
+};
+
+// Factors the matrix of ls_sys in place as A = QR. Afterwards R is on
+// and above the diagonal. Below the diagonal, column j holds the
+// reflection vector v_j, whose first element, 1, is implied, and
+// tau[j] its scale, so H_j = I - tau[j] v_j v_j^T and Q = H_1 ... H_n.
+// The knowns are untouched. block_size is the panel width; 1 makes
+// the plain unblocked factorization. If threads is less than 1, uses
+// default_thread_count().
+void qr_factorization(LeastSquaresSystem& ls_sys, Dynamic1DArray<double>& tau,
+		      int block_size = DEFAULT_QR_BLOCK_SIZE, int threads = 0);
+
+// Overwrites the knowns of a system factored by qr_factorization()
+// with Q^T b. Their first n elements then are R x, and the norm of
+// the rest is the norm of the least-squares residual.
+void apply_qt(LeastSquaresSystem& ls_sys, const Dynamic1DArray<double>& tau);
+
+// Solves a system factored by qr_factorization() whose knowns hold
+// Q^T b, by back substitution with R. Returns an empty array if R is
+// singular to working precision, i.e. the columns of the matrix are
+// linearly dependent and the least-squares solution isn't unique.
+Dynamic1DArray<double> qr_back_substitution(const LeastSquaresSystem& ls_sys);
+
+// Factors, applies Q^T and back-substitutes. Returns the x that
+// minimizes |b - Ax|, or an empty array if the columns are linearly
+// dependent. Like solve_system(), leaves ls_sys reduced.
+Dynamic1DArray<double> least_squares_solve(LeastSquaresSystem& ls_sys,
+					   int block_size
+					   = DEFAULT_QR_BLOCK_SIZE,
+					   int threads = 0);
+
+// |b - Ax| for a system that hasn't been factored.
+double residual_norm(const LeastSquaresSystem& ls_sys,
+		     const Dynamic1DArray<double>& x);
@@ -0,0 +1,201 @@
+// least_squares_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 15:21:06 (jonah)>
+
+// This file tests the blocked Householder QR least-squares solver:
+// exact and inconsistent systems, the factors themselves, every
+// panel width, and an ill-conditioned polynomial fit that the normal
+// equations get wrong.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "least_squares.hpp"
+#include "test_systems.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// A random m x n system.
+static LeastSquaresSystem random_system(int m, int n) {
+  LeastSquaresSystem output(m,n);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      output.matrix_set(i,j,(double)rand()/RAND_MAX - 0.5);
+    }
+    output.vector_set(i,(double)rand()/RAND_MAX - 0.5);
+  }
+  return output;
+}
+
+// Solves the normal equations A^T A x = A^T b by elimination.
+static Dynamic1DArray<double> normal_equations(const LeastSquaresSystem& ls) {
+  int n = ls.columns();
+  GaussianSystem g_sys(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j <= n; j++) {
+      double sum = 0;
+      for (int p = 0; p < ls.rows(); p++) {
+	sum += ls.matrix_get(p,i)
+	  *(j < n ? ls.matrix_get(p,j) : ls.vector_get(p));
+      }
+      g_sys.set(i,j,sum);
+    }
+  }
+  return solve_system(g_sys);
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the least_squares library.\n"
+       << "BEGIN." << endl;
+  srand(11);
+
+  cout << "\n\nA square system has the same solution as elimination."
+       << endl;
+  int n = 40;
+  LeastSquaresSystem square = random_system(n,n);
+  GaussianSystem g_sys(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      g_sys.matrix_set(i,j,square.matrix_get(i,j));
+    }
+    g_sys.vector_set(i,square.vector_get(i));
+  }
+  Dynamic1DArray<double> expected = solve_system(g_sys);
+  Dynamic1DArray<double> x = least_squares_solve(square);
+  assert( max_difference(x,expected) < 1E-10 );
+
+  cout << "\n\nA consistent tall system is solved exactly." << endl;
+  int m = 300;
+  n = 70;
+  LeastSquaresSystem tall = random_system(m,n);
+  Dynamic1DArray<double> truth(n);
+  for (int j = 0; j < n; j++) {
+    truth[j] = j - 0.5*n;
+  }
+  for (int i = 0; i < m; i++) {
+    double sum = 0;
+    for (int j = 0; j < n; j++) {
+      sum += tall.matrix_get(i,j)*truth[j];
+    }
+    tall.vector_set(i,sum);
+  }
+  LeastSquaresSystem copy = tall;
+  x = least_squares_solve(copy);
+  assert( max_difference(x,truth) < 1E-11 );
+  assert( residual_norm(tall,x) < 1E-11 );
+
+  cout << "\n\nQ R is the matrix, and Q^T b holds the residual." << endl;
+  LeastSquaresSystem inconsistent = random_system(m,n);
+  LeastSquaresSystem factors = inconsistent;
+  Dynamic1DArray<double> tau;
+  qr_factorization(factors,tau,16);
+  // Rebuild A column by column: A e_j = Q (R e_j), applying the
+  // reflections last to first.
+  for (int j = 0; j < n; j++) {
+    Dynamic1DArray<double> column(m);
+    for (int i = 0; i < m; i++) {
+      column[i] = i <= j ? factors.matrix_get(i,j) : 0;
+    }
+    for (int k = n - 1; k >= 0; k--) {
+      double sum = column[k];
+      for (int i = k + 1; i < m; i++) {
+	sum += factors.matrix_get(i,k)*column[i];
+      }
+      sum *= tau[k];
+      column[k] -= sum;
+      for (int i = k + 1; i < m; i++) {
+	column[i] -= sum*factors.matrix_get(i,k);
+      }
+    }
+    for (int i = 0; i < m; i++) {
+      assert( abs(column[i] - inconsistent.matrix_get(i,j)) < 1E-13
+	      && "Q R reproduces A." );
+    }
+  }
+  apply_qt(factors,tau);
+  x = qr_back_substitution(factors);
+  double tail = 0;
+  for (int i = n; i < m; i++) {
+    tail += factors.vector_get(i)*factors.vector_get(i);
+  }
+  assert( abs(sqrt(tail) - residual_norm(inconsistent,x)) < 1E-12
+	  && "The bottom of Q^T b is the residual." );
+  // The residual is orthogonal to every column of A.
+  for (int j = 0; j < n; j++) {
+    double sum = 0;
+    for (int i = 0; i < m; i++) {
+      double residual = inconsistent.vector_get(i);
+      for (int k = 0; k < n; k++) {
+	residual -= inconsistent.matrix_get(i,k)*x[k];
+      }
+      sum += inconsistent.matrix_get(i,j)*residual;
+    }
+    assert( abs(sum) < 1E-12 && "A^T r = 0." );
+  }
+  assert( max_difference(x,normal_equations(inconsistent)) < 1E-10
+	  && "A well-conditioned fit agrees with the normal equations." );
+
+  cout << "\n\nEvery panel width and thread count gives the same answer."
+       << endl;
+  int widths[6] = {1, 2, 7, 32, 70, 200};
+  for (int w = 0; w < 6; w++) {
+    for (int threads = 1; threads <= 4; threads += 3) {
+      LeastSquaresSystem blocked = inconsistent;
+      Dynamic1DArray<double> y = least_squares_solve(blocked,widths[w],
+						     threads);
+      assert( max_difference(x,y) < 1E-12 );
+    }
+  }
+
+  cout << "\n\nA degree 11 polynomial fit, which squares badly." << endl;
+  m = 200;
+  n = 12;
+  LeastSquaresSystem fit(m,n);
+  Dynamic1DArray<double> coefficients(n);
+  for (int j = 0; j < n; j++) {
+    coefficients[j] = 1 + j%3;
+  }
+  for (int i = 0; i < m; i++) {
+    double t = (double)i/(m - 1);
+    double power = 1;
+    double value = 0;
+    for (int j = 0; j < n; j++) {
+      fit.matrix_set(i,j,power);
+      value += coefficients[j]*power;
+      power *= t;
+    }
+    fit.vector_set(i,value);
+  }
+  double normal_error = max_difference(normal_equations(fit),coefficients);
+  copy = fit;
+  double qr_error = max_difference(least_squares_solve(copy),coefficients);
+  cout << "Normal equations error: " << normal_error << "\n"
+       << "QR error:               " << qr_error << endl;
+  assert( qr_error < 1E-5 && qr_error*100 < normal_error
+	  && "QR keeps the digits the normal equations lose." );
+
+  cout << "\n\nDependent columns have no unique solution." << endl;
+  LeastSquaresSystem dependent = random_system(50,5);
+  for (int i = 0; i < 50; i++) {
+    dependent.matrix_set(i,4,dependent.matrix_get(i,1)
+			 - 2*dependent.matrix_get(i,3));
+  }
+  assert( least_squares_solve(dependent).length() == 0 );
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
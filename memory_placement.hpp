@@ -0,0 +1,233 @@
+// memory_placement.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 21:04:10 (jonah)>
+
+// This file defines memory placement policies for big arrays, like
+// the coefficient matrix of a GaussianSystem. By default an array is
+// one new[] block, and the thread that first writes to it decides
+// where every page lives: on a multi-socket machine, all on one NUMA
+// node, in 4 KB pages that thrash the TLB. A placement can ask for
+//   -- huge pages, with MAP_HUGETLB if huge pages are reserved and
+//      transparent huge pages via madvise otherwise,
+//   -- parallel first touch, where the array is zeroed in the same
+//      row chunks parallel_for() hands out, so each chunk's pages
+//      land on the node of the thread that will work on it,
+//   -- thread pinning, so parallel_for() threads stay on the
+//      processors, and hence the nodes, that touched their rows.
+// If libnuma is available (the Makefile defines HAVE_LIBNUMA), it is
+// used to order the processors node by node. Everything falls back
+// quietly to ordinary allocation when a request can't be met.
+
+// Include guard
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include "parallel_for.hpp"
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sched.h>
+#endif
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#endif
+using namespace std;
+
+// The size of a huge page on x86-64.
+const size_t HUGE_PAGE_SIZE = 2 << 20;
+
+// How to place a big array in memory. The default is an ordinary
+// allocation.
+struct MemoryPlacement {
+  // Back the array with huge pages where possible.
+  bool huge_pages;
+  // Zero the array in parallel, one chunk of rows per thread, exactly
+  // as parallel_for() with the same number of threads would split
+  // the rows.
+  bool first_touch;
+  // Pin parallel_for() threads to processors, node by node. Pinning
+  // is process-wide, so allocating doesn't turn it on: call
+  // apply_thread_pinning() once, before building placed arrays.
+  bool pin_threads;
+  // The number of threads for the first touch. Less than 1 means one
+  // per hardware thread.
+  int threads;
+  MemoryPlacement() {
+    huge_pages = false;
+    first_touch = false;
+    pin_threads = false;
+    threads = 0;
+  }
+};
+
+// The placement GaussianSystem uses for its coefficient matrix.
+// Change it before building systems. Ordinary allocation by default.
+inline MemoryPlacement& default_placement() {
+  static MemoryPlacement placement;
+  return placement;
+}
+
+// The number of NUMA nodes. Always 1 without libnuma.
+inline int numa_node_count() {
+#ifdef HAVE_LIBNUMA
+  if ( numa_available() >= 0 ) {
+    int nodes = numa_num_configured_nodes();
+    return (nodes > 0) ? nodes : 1;
+  }
+#endif
+  return 1;
+}
+
+// The processors this process may run on, node by node when libnuma
+// is available and in numeric order otherwise.
+inline vector<int> processors_by_node() {
+  vector<int> output;
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if ( sched_getaffinity(0,sizeof(allowed),&allowed) == 0 ) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if ( CPU_ISSET(cpu,&allowed) ) {
+	output.push_back(cpu);
+      }
+    }
+  }
+#endif
+  if ( output.empty() ) {
+    for (int cpu = 0; cpu < default_thread_count(); cpu++) {
+      output.push_back(cpu);
+    }
+  }
+#ifdef HAVE_LIBNUMA
+  if ( numa_available() >= 0 ) {
+    vector<int> by_node;
+    for (int node = 0; node <= numa_max_node(); node++) {
+      for (size_t i = 0; i < output.size(); i++) {
+	if ( numa_node_of_cpu(output[i]) == node ) {
+	  by_node.push_back(output[i]);
+	}
+      }
+    }
+    if ( by_node.size() == output.size() ) {
+      output = by_node;
+    }
+  }
+#endif
+  return output;
+}
+
+// Turns parallel_for() thread pinning on or off to match
+// placement. With pinning on, chunk t of every loop runs on the t-th
+// processor of processors_by_node(), so contiguous row chunks map to
+// contiguous nodes. Not thread safe, like set_thread_pinning(), so
+// call it before starting parallel work.
+inline void apply_thread_pinning(const MemoryPlacement& placement) {
+  set_thread_pinning(placement.pin_threads ? processors_by_node()
+		     : vector<int>());
+}
+
+// Zeroes bytes of memory, split into rows of row_bytes, in parallel
+// by row chunks. With huge pages, a page shared by two chunks goes
+// to whichever thread touches it first.
+inline void first_touch(void* memory, size_t bytes, size_t row_bytes,
+			const MemoryPlacement& placement) {
+  char* start = (char*)memory;
+  if ( row_bytes == 0 ) {
+    row_bytes = bytes;
+  }
+  int rows = (int)((bytes + row_bytes - 1)/row_bytes);
+  parallel_for(0,rows,placement.threads,[=](int first, int last) {
+      size_t offset = first*row_bytes;
+      size_t end = min(bytes,last*row_bytes);
+      memset(start + offset,0,end - offset);
+    });
+}
+
+// Allocates bytes of memory placed as asked. row_bytes is the size
+// of one row, for the first touch. Sets mapped_bytes to the length
+// to hand to placed_release(). Returns NULL if the placement asks for
+// nothing special or the memory can't be had, in which case the
+// caller should just use new[]. Placed memory starts out zero.
+inline void* placed_allocate(size_t bytes, size_t row_bytes,
+			     const MemoryPlacement& placement,
+			     size_t& mapped_bytes) {
+  mapped_bytes = 0;
+#ifdef __linux__
+  if ( bytes == 0 || !(placement.huge_pages || placement.first_touch) ) {
+    return NULL;
+  }
+  int protection = PROT_READ | PROT_WRITE;
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  size_t length = bytes;
+  void* memory = MAP_FAILED;
+  if ( placement.huge_pages ) {
+    length = (bytes + HUGE_PAGE_SIZE - 1)/HUGE_PAGE_SIZE*HUGE_PAGE_SIZE;
+#ifdef MAP_HUGETLB
+    memory = mmap(NULL,length,protection,flags | MAP_HUGETLB,-1,0);
+#endif
+    if ( memory == MAP_FAILED ) {
+      // No huge pages reserved. Ask for transparent ones instead.
+      memory = mmap(NULL,length,protection,flags,-1,0);
+#ifdef MADV_HUGEPAGE
+      if ( memory != MAP_FAILED ) {
+	madvise(memory,length,MADV_HUGEPAGE);
+      }
+#endif
+    }
+  } else {
+    memory = mmap(NULL,length,protection,flags,-1,0);
+  }
+  if ( memory == MAP_FAILED ) {
+    return NULL;
+  }
+  mapped_bytes = length;
+  if ( placement.first_touch ) {
+    first_touch(memory,bytes,row_bytes,placement);
+  }
+  return memory;
+#else
+  return NULL;
+#endif
+}
+
+// Returns memory from placed_allocate() to the system.
+inline void placed_release(void* memory, size_t mapped_bytes) {
+#ifdef __linux__
+  if ( memory != NULL && mapped_bytes > 0 ) {
+    munmap(memory,mapped_bytes);
+  }
+#endif
+}
+
+// Returns how many bytes of the mapping that holds memory are backed
+// by huge pages, from /proc/self/smaps. Returns 0 if that can't be
+// found out.
+inline size_t huge_page_bytes(const void* memory) {
+  size_t output = 0;
+#ifdef __linux__
+  FILE* smaps = fopen("/proc/self/smaps","r");
+  if ( smaps == NULL ) {
+    return 0;
+  }
+  char line[256];
+  bool inside = false;
+  unsigned long address = (unsigned long)memory;
+  while ( fgets(line,sizeof(line),smaps) != NULL ) {
+    unsigned long first, last;
+    size_t kilobytes;
+    if ( sscanf(line,"%lx-%lx ",&first,&last) == 2 && strchr(line,':') ) {
+      inside = (first <= address && address < last);
+    } else if ( inside
+		&& (sscanf(line,"AnonHugePages: %zu kB",&kilobytes) == 1
+		    || sscanf(line,"Private_Hugetlb: %zu kB",&kilobytes) == 1) ) {
+      output += kilobytes*1024;
+    }
+  }
+  fclose(smaps);
+#endif
+  return output;
+}
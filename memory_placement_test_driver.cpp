@@ -0,0 +1,145 @@
+// memory_placement_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 20:11:45 (jonah)>
+
+// This file tests the memory placement policies. Whether huge pages
+// or more than one NUMA node are actually available depends on the
+// machine, so those are reported rather than required.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <vector>
+#include "dynamic_array.hpp"
+#include "memory_placement.hpp"
+#include "parallel_for.hpp"
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Fills an nxn Gaussian system with a fixed, well-conditioned pattern.
+static void fill_system(GaussianSystem& g_sys) {
+  int n = g_sys.size();
+  for (int row = 0; row < n; row++) {
+    for (int column = 0; column <= n; column++) {
+      double diagonal = (row == column) ? n : 0;
+      g_sys.set(row,column,sin(1.0 + row*n + column) + diagonal);
+    }
+  }
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the memory_placement library.\n"
+       << "BEGIN." << endl;
+
+  cout << "\n\nLooking at the machine." << endl;
+  vector<int> processors = processors_by_node();
+  cout << "NUMA nodes: " << numa_node_count() << "\n"
+       << "Processors, node by node:";
+  for (size_t i = 0; i < processors.size(); i++) {
+    cout << " " << processors[i];
+  }
+  cout << endl;
+  assert( !processors.empty() && "There is at least one processor." );
+
+  cout << "\n\nAllocating 8 MB with huge pages and a parallel first touch."
+       << endl;
+  MemoryPlacement placement;
+  placement.huge_pages = true;
+  placement.first_touch = true;
+  placement.threads = 3;
+  size_t bytes = 8 << 20;
+  size_t mapped_bytes;
+  char* memory = (char*)placed_allocate(bytes,4096,placement,mapped_bytes);
+  assert( memory != NULL && mapped_bytes >= bytes
+	  && "Placed memory is available on Linux." );
+  assert( mapped_bytes % HUGE_PAGE_SIZE == 0
+	  && "Huge-page mappings are whole huge pages." );
+  for (size_t i = 0; i < bytes; i += 4093) {
+    assert( memory[i] == 0 && "Placed memory starts out zero." );
+    memory[i] = 1;
+  }
+  cout << "Bytes in huge pages: " << huge_page_bytes(memory) << endl;
+  placed_release(memory,mapped_bytes);
+
+  cout << "\n\nChecking that nothing special means an ordinary allocation."
+       << endl;
+  memory = (char*)placed_allocate(bytes,4096,MemoryPlacement(),mapped_bytes);
+  assert( memory == NULL && mapped_bytes == 0
+	  && "The default placement leaves allocation to new[]." );
+  cout << "It does." << endl;
+
+  cout << "\n\nMaking a placed 300x301 Dynamic2DArray." << endl;
+  Dynamic2DArray<double> placed(300,301,placement);
+  for (int row = 0; row < placed.height(); row++) {
+    for (int column = 0; column < placed.width(); column++) {
+      assert( placed.get(row,column) == 0 && "The array starts out zero." );
+      placed.set(row,column,row - column);
+    }
+  }
+  Dynamic2DArray<double> copy = placed;
+  assert( copy.get(299,300) == -1 && "Placed arrays copy." );
+  placed.reset(10,10,placement);
+  assert( placed.get(9,9) == 0 && "Placed arrays reset." );
+  cout << "It works." << endl;
+
+  cout << "\n\nPinning parallel_for threads." << endl;
+  placement.pin_threads = true;
+  apply_thread_pinning(placement);
+  cpu_set_t before, after;
+  sched_getaffinity(0,sizeof(before),&before);
+  int threads = 4;
+  vector<int> where(threads,-1);
+  parallel_for(0,threads,threads,[&](int first, int last) {
+      for (int t = first; t < last; t++) {
+	where[t] = sched_getcpu();
+      }
+    });
+  for (int t = 0; t < threads; t++) {
+    cout << "Chunk " << t << " ran on processor " << where[t] << endl;
+    assert( where[t] == processors[t % processors.size()]
+	    && "Each chunk runs on its own pinned processor." );
+  }
+  sched_getaffinity(0,sizeof(after),&after);
+  assert( CPU_EQUAL(&before,&after)
+	  && "The calling thread gets its processors back." );
+
+  cout << "\n\nSolving a 200x200 system stored with the placement." << endl;
+  GaussianSystem ordinary(200);
+  fill_system(ordinary);
+  default_placement() = placement;
+  GaussianSystem placed_system(200);
+  for (int row = 0; row < 200; row++) {
+    for (int column = 0; column <= 200; column++) {
+      assert( placed_system.get(row,column) == 0
+	      && "A new system starts out zero." );
+    }
+  }
+  fill_system(placed_system);
+  default_placement() = MemoryPlacement();
+  apply_thread_pinning(MemoryPlacement());
+  Dynamic1DArray<double> expected = solve_system(ordinary,
+						 TOURNAMENT_ELIMINATION);
+  Dynamic1DArray<double> solution = solve_system(placed_system,
+						 TOURNAMENT_ELIMINATION);
+  for (int i = 0; i < expected.length(); i++) {
+    assert( solution[i] == expected[i]
+	    && "Placement doesn't change the answer." );
+  }
+  cout << "Same answer." << endl;
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,124 @@
+// parallel_for.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 21:02:37 (jonah)>
+
+// This file defines a tiny helper for splitting a loop over
+// threads. Used by the parallel pieces of the Gaussian elimination
+// package.
+
+// Include guard
+#pragma once
+
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#endif
+using namespace std;
+
+// The number of threads to use when the caller doesn't say. One per
+// hardware thread.
+inline int default_thread_count() {
+  int output = thread::hardware_concurrency();
+  return (output > 0) ? output : 1;
+}
+
+// The processors parallel_for pins its threads to, in order. Empty,
+// the default, means no pinning. See apply_thread_pinning() in
+// memory_placement.hpp.
+inline vector<int>& pinned_processors() {
+  static vector<int> processors;
+  return processors;
+}
+
+// Turns pinning on for the given processors, or off if there are
+// none. Not thread safe, so call it before starting parallel work.
+inline void set_thread_pinning(const vector<int>& processors) {
+  pinned_processors() = processors;
+}
+
+// Pins the calling thread to pinned processor number index, wrapping
+// around. Does nothing if pinning is off or the system says no.
+inline void pin_current_thread(int index) {
+#ifdef __linux__
+  const vector<int>& processors = pinned_processors();
+  if ( processors.empty() ) {
+    return;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(processors[index % processors.size()],&set);
+  sched_setaffinity(0,sizeof(set),&set);
+#endif
+}
+
+// Pins the calling thread like pin_current_thread() for as long as
+// it lives, and then gives the thread back the processors it had.
+class ScopedPin {
+public:
+  ScopedPin(int index) {
+#ifdef __linux__
+    pinned = !pinned_processors().empty()
+      && sched_getaffinity(0,sizeof(saved),&saved) == 0;
+    if ( pinned ) {
+      pin_current_thread(index);
+    }
+#endif
+  }
+  ~ScopedPin() {
+#ifdef __linux__
+    if ( pinned ) {
+      sched_setaffinity(0,sizeof(saved),&saved);
+    }
+#endif
+  }
+private:
+#ifdef __linux__
+  bool pinned;
+  cpu_set_t saved;
+#endif
+  ScopedPin(const ScopedPin&);
+  ScopedPin& operator = (const ScopedPin&);
+};
+
+// Splits [begin,end) into one contiguous chunk per thread and calls
+// body(chunk_begin,chunk_end) on each chunk. The calling thread does
+// the first chunk itself. Returns once every chunk is done. If
+// threads is less than 1, uses default_thread_count(). If pinning is
+// on, the thread doing chunk t is pinned to pinned processor t, so
+// the same rows always run in the same place. The calling thread is
+// only pinned while it does its chunk, and a loop run on one thread
+// isn't pinned at all.
+template<typename BODY>
+void parallel_for(int begin, int end, int threads, const BODY& body) {
+  if ( threads < 1 ) {
+    threads = default_thread_count();
+  }
+  int length = end - begin;
+  if ( threads > length ) {
+    threads = length;
+  }
+  if ( threads <= 1 ) {
+    if ( length > 0 ) {
+      body(begin,end);
+    }
+    return;
+  }
+  vector<thread> workers;
+  for (int t = 1; t < threads; t++) {
+    int chunk_begin = begin + (int)((long long)length*t/threads);
+    int chunk_end = begin + (int)((long long)length*(t+1)/threads);
+    workers.push_back(thread([&body,t,chunk_begin,chunk_end]() {
+	  pin_current_thread(t);
+	  body(chunk_begin,chunk_end);
+	}));
+  }
+  {
+    ScopedPin pin(0);
+    body(begin,begin + length/threads);
+  }
+  for (size_t t = 0; t < workers.size(); t++) {
+    workers[t].join();
+  }
+}
@@ -0,0 +1,287 @@
+// perf_counters.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 21:30:44 (jonah)>
+
+// This file implements the perf_event_open profiling layer.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "perf_counters.hpp"
+#include "wall_time.hpp"
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <iomanip>
+#include <fstream>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The active profiler. Off by default.
+PerfProfiler* elimination_profiler = NULL;
+
+
+// Names
+// ----------------------------------------------------------------------
+
+const char* perf_event_name(PerfEvent event) {
+  static const char* names[PERF_EVENT_COUNT] = {
+    "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses",
+    "dTLB-misses", "fp-ops", "page-faults"
+  };
+  return names[event];
+}
+
+const char* elimination_phase_name(EliminationPhase phase) {
+  static const char* names[ELIMINATION_PHASE_COUNT] = {
+    "pivot", "row_reduce", "panel", "triangular_solve", "trailing_update",
+    "forward_substitution", "back_substitution"
+  };
+  return names[phase];
+}
+// ----------------------------------------------------------------------
+
+
+// Counters
+// ----------------------------------------------------------------------
+
+// Whether this is an Intel processor, whose raw floating-point
+// events we know.
+static bool intel_processor() {
+  ifstream cpuinfo("/proc/cpuinfo");
+  string line;
+  while ( getline(cpuinfo,line) ) {
+    if ( line.compare(0,9,"vendor_id") == 0 ) {
+      return line.find("GenuineIntel") != string::npos;
+    }
+  }
+  return false;
+}
+
+// Opens every counter it can.
+PerfCounters::PerfCounters() {
+  for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+    opened[e] = false;
+  }
+#ifdef __linux__
+  // Generic cache events are type | (operation << 8) | (result << 16).
+  unsigned long long read_miss = (PERF_COUNT_HW_CACHE_OP_READ << 8)
+    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  open_counter(PERF_TYPE_HARDWARE,PERF_COUNT_HW_CPU_CYCLES,CYCLES_EVENT,1);
+  open_counter(PERF_TYPE_HARDWARE,PERF_COUNT_HW_INSTRUCTIONS,
+	       INSTRUCTIONS_EVENT,1);
+  open_counter(PERF_TYPE_HARDWARE,PERF_COUNT_HW_BRANCH_MISSES,
+	       BRANCH_MISSES_EVENT,1);
+  open_counter(PERF_TYPE_HW_CACHE,PERF_COUNT_HW_CACHE_L1D | read_miss,
+	       L1D_MISSES_EVENT,1);
+  open_counter(PERF_TYPE_HARDWARE,PERF_COUNT_HW_CACHE_MISSES,
+	       LLC_MISSES_EVENT,1);
+  open_counter(PERF_TYPE_HW_CACHE,PERF_COUNT_HW_CACHE_DTLB | read_miss,
+	       DTLB_MISSES_EVENT,1);
+  if ( intel_processor() ) {
+    // FP_ARITH_INST_RETIRED (event 0xC7): scalar, 128-bit, 256-bit
+    // and 512-bit packed double, worth 1, 2, 4 and 8 operations.
+    unsigned long long umasks[4] = {0x01, 0x04, 0x10, 0x40};
+    double widths[4] = {1, 2, 4, 8};
+    for (int i = 0; i < 4; i++) {
+      open_counter(PERF_TYPE_RAW,(umasks[i] << 8) | 0xC7,
+		   FP_OPERATIONS_EVENT,widths[i]);
+    }
+  } else if ( reason.empty() ) {
+    reason = "fp-ops: only known for Intel processors";
+  }
+  open_counter(PERF_TYPE_SOFTWARE,PERF_COUNT_SW_PAGE_FAULTS,
+	       PAGE_FAULTS_EVENT,1);
+#else
+  reason = "perf_event_open is Linux only";
+#endif
+}
+
+// Closes the counters.
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (size_t i = 0; i < sources.size(); i++) {
+    close(sources[i].descriptor);
+  }
+#endif
+}
+
+// Opens one counter for this thread, user space only.
+bool PerfCounters::open_counter(unsigned type, unsigned long long config,
+				PerfEvent event, double weight) {
+#ifdef __linux__
+  perf_event_attr attributes;
+  memset(&attributes,0,sizeof(attributes));
+  attributes.size = sizeof(attributes);
+  attributes.type = type;
+  attributes.config = config;
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+  attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+    | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  int descriptor = syscall(SYS_perf_event_open,&attributes,0,-1,-1,0);
+  if ( descriptor < 0 ) {
+    if ( reason.empty() ) {
+      reason = string(perf_event_name(event)) + ": " + strerror(errno);
+    }
+    return false;
+  }
+  Source source;
+  source.descriptor = descriptor;
+  source.event = event;
+  source.weight = weight;
+  sources.push_back(source);
+  opened[event] = true;
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Reads the running totals.
+void PerfCounters::read(double counts[PERF_EVENT_COUNT]) const {
+  for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+    counts[e] = 0;
+  }
+#ifdef __linux__
+  for (size_t i = 0; i < sources.size(); i++) {
+    unsigned long long values[3]; // value, time enabled, time running
+    if ( ::read(sources[i].descriptor,values,sizeof(values))
+	 != (ssize_t)sizeof(values) ) {
+      continue;
+    }
+    double value = values[0];
+    if ( values[2] > 0 && values[2] < values[1] ) {
+      value *= (double)values[1]/values[2];
+    }
+    counts[sources[i].event] += sources[i].weight*value;
+  }
+#endif
+}
+// ----------------------------------------------------------------------
+
+
+// Profiler
+// ----------------------------------------------------------------------
+
+PerfProfiler::PerfProfiler() {
+  clear();
+}
+
+void PerfProfiler::clear() {
+  for (int p = 0; p < ELIMINATION_PHASE_COUNT; p++) {
+    phases[p].calls = 0;
+    phases[p].seconds = 0;
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+      phases[p].counts[e] = 0;
+    }
+  }
+}
+
+// Counters are read before the clock on the way in and after it on
+// the way out, so the time doesn't include the reads.
+void PerfProfiler::begin(EliminationPhase phase) {
+  perf_counters.read(start_counts[phase]);
+  start_times[phase] = wall_time();
+}
+
+void PerfProfiler::end(EliminationPhase phase) {
+  double elapsed = wall_time() - start_times[phase];
+  double counts[PERF_EVENT_COUNT];
+  perf_counters.read(counts);
+  phases[phase].calls++;
+  phases[phase].seconds += elapsed;
+  for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+    phases[phase].counts[e] += counts[e] - start_counts[phase][e];
+  }
+}
+
+// Formats a ratio for the report, or n/a if the inputs weren't
+// counted.
+static string format_ratio(bool counted, double numerator,
+			   double denominator) {
+  if ( !counted || !(denominator > 0) ) {
+    return "n/a";
+  }
+  char text[32];
+  snprintf(text,sizeof(text),"%.3g",numerator/denominator);
+  return text;
+}
+
+void PerfProfiler::report(ostream& output, double flop_estimate) const {
+  const PerfCounters& c = perf_counters;
+  output << "Counters:";
+  for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+    if ( c.available((PerfEvent)e) ) {
+      output << " " << perf_event_name((PerfEvent)e);
+    }
+  }
+  if ( !c.unavailable_reason().empty() ) {
+    output << "\nUnavailable: " << c.unavailable_reason();
+  }
+  output << "\n"
+	 << setw(22) << "phase" << setw(9) << "calls" << setw(11) << "seconds"
+	 << setw(8) << "IPC" << setw(9) << "L1/ki" << setw(9) << "dTLB/ki"
+	 << setw(9) << "GB/s" << setw(9) << "GFLOP/s" << setw(9) << "flop/B"
+	 << setw(9) << "faults" << "\n";
+
+  PhaseCounts total;
+  total.calls = 0;
+  total.seconds = 0;
+  for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+    total.counts[e] = 0;
+  }
+  for (int p = 0; p <= ELIMINATION_PHASE_COUNT; p++) {
+    bool total_row = (p == ELIMINATION_PHASE_COUNT);
+    const PhaseCounts& counts = total_row ? total : phases[p];
+    if ( !total_row ) {
+      if ( counts.calls == 0 ) {
+	continue;
+      }
+      total.calls += counts.calls;
+      total.seconds += counts.seconds;
+      for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+	total.counts[e] += counts.counts[e];
+      }
+    }
+    const double* n = counts.counts;
+    double bytes = 64*n[LLC_MISSES_EVENT];
+    bool have_flops = c.available(FP_OPERATIONS_EVENT);
+    double flops = n[FP_OPERATIONS_EVENT];
+    if ( total_row && !have_flops && flop_estimate > 0 ) {
+      have_flops = true;
+      flops = flop_estimate;
+    }
+    output << setw(22)
+	   << (total_row ? "total" : elimination_phase_name((EliminationPhase)p))
+	   << setw(9) << counts.calls
+	   << setw(11) << format_ratio(true,counts.seconds,1)
+	   << setw(8) << format_ratio(c.available(CYCLES_EVENT)
+			       && c.available(INSTRUCTIONS_EVENT),
+			       n[INSTRUCTIONS_EVENT],n[CYCLES_EVENT])
+	   << setw(9) << format_ratio(c.available(L1D_MISSES_EVENT)
+			       && c.available(INSTRUCTIONS_EVENT),
+			       1000*n[L1D_MISSES_EVENT],n[INSTRUCTIONS_EVENT])
+	   << setw(9) << format_ratio(c.available(DTLB_MISSES_EVENT)
+			       && c.available(INSTRUCTIONS_EVENT),
+			       1000*n[DTLB_MISSES_EVENT],n[INSTRUCTIONS_EVENT])
+	   << setw(9) << format_ratio(c.available(LLC_MISSES_EVENT),
+			       bytes/1E9,counts.seconds)
+	   << setw(9) << format_ratio(have_flops,flops/1E9,counts.seconds)
+	   << setw(9) << format_ratio(have_flops && c.available(LLC_MISSES_EVENT),
+			       flops,bytes)
+	   << setw(9) << format_ratio(c.available(PAGE_FAULTS_EVENT),
+			       n[PAGE_FAULTS_EVENT],1)
+	   << "\n";
+  }
+  output.flush();
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,194 @@
+// perf_counters.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 20:52:06 (jonah)>
+
+// This file prototypes an optional profiling layer built on the Linux
+// perf_event_open hardware counters. Wall-clock time alone can't say
+// whether a phase of the elimination is limited by memory bandwidth,
+// TLB misses or branch mispredictions. The counters can. The
+// elimination routines mark their phases, and when a profiler is
+// active each phase is timed and counted. Derived metrics such as
+// IPC, bandwidth and arithmetic intensity are printed by report().
+
+// Counters are often unavailable: in containers and virtual machines
+// without a PMU, or when perf_event_paranoid forbids them. Then the
+// missing counters read as unavailable, the metrics that need them
+// print as n/a, and the wall-clock times are still collected.
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <string>
+#include <vector>
+#include "trace.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The events counted.
+enum PerfEvent {
+  CYCLES_EVENT,
+  INSTRUCTIONS_EVENT,
+  BRANCH_MISSES_EVENT,
+  L1D_MISSES_EVENT, // L1 data cache read misses
+  LLC_MISSES_EVENT, // last-level cache misses
+  DTLB_MISSES_EVENT, // data TLB read misses
+  // Double-precision floating-point operations, with packed
+  // instructions weighted by their width. Only on Intel processors.
+  FP_OPERATIONS_EVENT,
+  PAGE_FAULTS_EVENT, // a software event, so usually available
+  PERF_EVENT_COUNT
+};
+
+// The name of an event, for printing.
+const char* perf_event_name(PerfEvent event);
+
+
+// A set of counters for the calling thread, counting user-space
+// work only. The counters run from construction on. Threads started
+// later are not counted.
+class PerfCounters {
+public: // Constructors and destructors.
+  // Opens every counter it can.
+  PerfCounters();
+  // Closes the counters.
+  ~PerfCounters();
+private: // Counters belong to one owner.
+  PerfCounters(const PerfCounters &rhs);
+  PerfCounters& operator = (const PerfCounters &rhs);
+
+private: // Implementation details.
+  // One open counter. Several sources can add up to one event.
+  struct Source {
+    int descriptor;
+    PerfEvent event;
+    double weight;
+  };
+  vector<Source> sources;
+  bool opened[PERF_EVENT_COUNT];
+  string reason; // Why the first counter that failed did.
+  // Opens one counter and records it as a source of event.
+  bool open_counter(unsigned type, unsigned long long config,
+		    PerfEvent event, double weight);
+
+public: // Interface.
+  // Whether the event is being counted.
+  bool available(PerfEvent event) const {
+    return opened[event];
+  }
+  // Whether any event is being counted.
+  bool any_available() const {
+    return !sources.empty();
+  }
+  // Why a counter could not be opened, or empty if they all could.
+  const string& unavailable_reason() const {
+    return reason;
+  }
+  // Reads the running totals into counts, scaled up if the kernel
+  // had to share the hardware between counters. Unavailable events
+  // read zero.
+  void read(double counts[PERF_EVENT_COUNT]) const;
+};
+
+
+// The phases of elimination that are profiled.
+enum EliminationPhase {
+  PIVOT_PHASE, // pivot() in standard elimination
+  ROW_REDUCE_PHASE, // row_reduce() in standard elimination
+  PANEL_PHASE, // one pivoted column of recursive LU
+  TRIANGULAR_SOLVE_PHASE, // A12 = L11^{-1} A12 in recursive LU
+  TRAILING_UPDATE_PHASE, // A22 = A22 - L21*A12 in recursive LU
+  FORWARD_SUBSTITUTION_PHASE, // forward_substitution()
+  BACK_SUBSTITUTION_PHASE, // back_substitution()
+  ELIMINATION_PHASE_COUNT
+};
+
+// The name of a phase, for printing.
+const char* elimination_phase_name(EliminationPhase phase);
+
+// The totals for one phase.
+struct PhaseCounts {
+  long calls;
+  double seconds;
+  double counts[PERF_EVENT_COUNT];
+};
+
+
+// Collects times and counts for each elimination phase. Set
+// elimination_profiler to one to turn profiling on.
+class PerfProfiler {
+public: // Constructors.
+  PerfProfiler();
+private: // Not copyable, like PerfCounters.
+  PerfProfiler(const PerfProfiler &rhs);
+  PerfProfiler& operator = (const PerfProfiler &rhs);
+
+private: // Implementation details.
+  PerfCounters perf_counters;
+  PhaseCounts phases[ELIMINATION_PHASE_COUNT];
+  double start_counts[ELIMINATION_PHASE_COUNT][PERF_EVENT_COUNT];
+  double start_times[ELIMINATION_PHASE_COUNT];
+
+public: // Interface.
+  // Starts and stops a phase. Different phases may nest, but a phase
+  // may not nest inside itself.
+  void begin(EliminationPhase phase);
+  void end(EliminationPhase phase);
+  // The totals so far for a phase.
+  const PhaseCounts& phase(EliminationPhase phase) const {
+    return phases[phase];
+  }
+  // The counters in use.
+  const PerfCounters& counters() const {
+    return perf_counters;
+  }
+  // Zeroes all the totals.
+  void clear();
+  // Prints a table of the phases that ran, with derived metrics:
+  // IPC, L1 and dTLB misses per thousand instructions, bandwidth
+  // from last-level misses (64 bytes each), floating-point rate,
+  // arithmetic intensity, and page faults. If flop_estimate is
+  // positive, it is used as the floating-point operation count of the
+  // whole run when the hardware can't count them, for the total row.
+  void report(ostream& output, double flop_estimate = 0) const;
+};
+
+// The profiler the elimination routines report to. NULL, the
+// default, means no profiling, and each phase then costs one test
+// of this pointer.
+extern PerfProfiler* elimination_profiler;
+
+// Marks a phase for elimination_profiler, if there is one, for as
+// long as it is in scope. Also records it in the timeline trace, if
+// tracing is on. See trace.hpp.
+class ProfiledPhase {
+public:
+  ProfiledPhase(EliminationPhase phase) {
+    this->phase = phase;
+    profiler = elimination_profiler;
+    if ( profiler != NULL ) {
+      profiler->begin(phase);
+    }
+    trace_start = tracing() ? trace_clock() : 0;
+  }
+  ~ProfiledPhase() {
+    if ( trace_start != 0 ) {
+      trace_event(elimination_phase_name(phase),"elimination",trace_start,
+		  trace_clock());
+    }
+    if ( profiler != NULL ) {
+      profiler->end(phase);
+    }
+  }
+private:
+  EliminationPhase phase;
+  PerfProfiler* profiler;
+  long long trace_start;
+};
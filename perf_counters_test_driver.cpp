@@ -0,0 +1,98 @@
+// perf_counters_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 21:52:19 (jonah)>
+
+// This file tests the perf_event_open profiling layer. Which counters
+// open depends on the machine, so they are reported rather than
+// required. The phase bookkeeping is checked either way.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cassert>
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "perf_counters.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Fills an nxn Gaussian system with uniform random numbers in [-1,1].
+static void fill_system(GaussianSystem& g_sys, unsigned seed) {
+  srand(seed);
+  for (int row = 0; row < g_sys.size(); row++) {
+    for (int column = 0; column <= g_sys.size(); column++) {
+      g_sys.set(row,column,2.0*rand()/RAND_MAX - 1.0);
+    }
+  }
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the perf_counters library.\n"
+       << "BEGIN." << endl;
+
+  cout << "\n\nOpening the counters." << endl;
+  PerfProfiler profiler;
+  const PerfCounters& counters = profiler.counters();
+  for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+    cout << perf_event_name((PerfEvent)e) << ": "
+	 << (counters.available((PerfEvent)e) ? "yes" : "no") << endl;
+  }
+  if ( !counters.unavailable_reason().empty() ) {
+    cout << "First failure: " << counters.unavailable_reason() << endl;
+  }
+
+  cout << "\n\nChecking that nothing is counted while profiling is off."
+       << endl;
+  GaussianSystem testing1(100);
+  fill_system(testing1,1);
+  assert( elimination_profiler == NULL && "Profiling is off by default." );
+  solve_system(testing1);
+  assert( profiler.phase(PIVOT_PHASE).calls == 0
+	  && "An inactive profiler sees nothing." );
+  cout << "Nothing is." << endl;
+
+  cout << "\n\nProfiling standard elimination of a 200x200 system." << endl;
+  int size = 200;
+  GaussianSystem testing2(size);
+  fill_system(testing2,2);
+  elimination_profiler = &profiler;
+  solve_system(testing2);
+  elimination_profiler = NULL;
+  profiler.report(cout,2.0/3*size*size*size);
+  assert( profiler.phase(PIVOT_PHASE).calls == size
+	  && profiler.phase(ROW_REDUCE_PHASE).calls == size
+	  && profiler.phase(BACK_SUBSTITUTION_PHASE).calls == 1
+	  && "Each phase is counted once per call." );
+  assert( profiler.phase(ROW_REDUCE_PHASE).seconds > 0
+	  && "Phases are timed." );
+  if ( counters.available(INSTRUCTIONS_EVENT) ) {
+    assert( profiler.phase(ROW_REDUCE_PHASE).counts[INSTRUCTIONS_EVENT] > 0
+	    && "Instructions are counted." );
+  }
+
+  cout << "\n\nProfiling recursive elimination of the same size." << endl;
+  profiler.clear();
+  GaussianSystem testing3(size);
+  fill_system(testing3,2);
+  elimination_profiler = &profiler;
+  solve_system(testing3,RECURSIVE_ELIMINATION);
+  elimination_profiler = NULL;
+  profiler.report(cout,2.0/3*size*size*size);
+  assert( profiler.phase(PIVOT_PHASE).calls == 0
+	  && profiler.phase(PANEL_PHASE).calls == size
+	  && profiler.phase(TRAILING_UPDATE_PHASE).calls == size - 1
+	  && profiler.phase(FORWARD_SUBSTITUTION_PHASE).calls == 1
+	  && "The recursive phases are counted." );
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,231 @@
+// solution_writer.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 23:02:20 (jonah)>
+
+// This file implements fast writers for solutions and systems.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "solution_writer.hpp"
+#include "parallel_for.hpp"
+#include "trace.hpp"
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <unistd.h>
+#include <errno.h>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The most characters to_chars needs for a double in shortest form,
+// plus a separator.
+static const int MAX_NUMBER_LENGTH = 32;
+
+
+// Constructors and destructors
+// ----------------------------------------------------------------------
+
+// Writes to an open file descriptor.
+BufferedWriter::BufferedWriter(int file_descriptor, size_t buffer_size)
+  : buffer(buffer_size > MAX_NUMBER_LENGTH ? buffer_size
+	   : MAX_NUMBER_LENGTH) {
+  descriptor = file_descriptor;
+  stream = NULL;
+  used = 0;
+  failed = false;
+}
+
+// Writes to an output stream.
+BufferedWriter::BufferedWriter(ostream& output_stream, size_t buffer_size)
+  : buffer(buffer_size > MAX_NUMBER_LENGTH ? buffer_size
+	   : MAX_NUMBER_LENGTH) {
+  descriptor = -1;
+  stream = &output_stream;
+  used = 0;
+  failed = false;
+}
+
+// Flushes whatever is left.
+BufferedWriter::~BufferedWriter() {
+  flush();
+}
+// ----------------------------------------------------------------------
+
+
+// Interface
+// ----------------------------------------------------------------------
+
+// Appends count raw bytes. Big writes skip the buffer.
+void BufferedWriter::write(const char* bytes, size_t count) {
+  size_t capacity = buffer.length();
+  if ( used + count > capacity ) {
+    flush();
+  }
+  if ( count >= capacity ) {
+    if ( stream != NULL ) {
+      stream->write(bytes,count);
+      failed = failed || !stream->good();
+      return;
+    }
+    while ( count > 0 ) {
+      ssize_t done = ::write(descriptor,bytes,count);
+      if ( done < 0 && errno == EINTR ) {
+	continue;
+      }
+      if ( done <= 0 ) {
+	failed = true;
+	return;
+      }
+      bytes += done;
+      count -= done;
+    }
+    return;
+  }
+  memcpy(buffer.data() + used,bytes,count);
+  used += count;
+}
+
+// Appends a double in the shortest form that reads back exactly.
+void BufferedWriter::write_number(double value) {
+  if ( used + MAX_NUMBER_LENGTH > (size_t)buffer.length() ) {
+    flush();
+  }
+  char* start = buffer.data() + used;
+  to_chars_result result = to_chars(start,start + MAX_NUMBER_LENGTH,value);
+  used += result.ptr - start;
+}
+
+// Appends an integer.
+void BufferedWriter::write_number(long value) {
+  if ( used + MAX_NUMBER_LENGTH > (size_t)buffer.length() ) {
+    flush();
+  }
+  char* start = buffer.data() + used;
+  to_chars_result result = to_chars(start,start + MAX_NUMBER_LENGTH,value);
+  used += result.ptr - start;
+}
+
+// Sends everything buffered so far to the destination.
+void BufferedWriter::flush() {
+  if ( used == 0 ) {
+    return;
+  }
+  TracedScope traced("write","io");
+  size_t count = used;
+  used = 0;
+  if ( stream != NULL ) {
+    stream->write(buffer.data(),count);
+    stream->flush();
+    failed = failed || !stream->good();
+    return;
+  }
+  const char* bytes = buffer.data();
+  while ( count > 0 ) {
+    ssize_t done = ::write(descriptor,bytes,count);
+    if ( done < 0 && errno == EINTR ) {
+      continue;
+    }
+    if ( done <= 0 ) {
+      failed = true;
+      return;
+    }
+    bytes += done;
+    count -= done;
+  }
+}
+// ----------------------------------------------------------------------
+
+
+// Writers
+// ----------------------------------------------------------------------
+
+// Writes a solution as compact text.
+void write_solution_text(BufferedWriter& writer,
+			 const Dynamic1DArray<double>& solutions_vector,
+			 int threads/*= 0*/,
+			 int parallel_threshold/*= 1 << 16*/) {
+  ptrdiff_t length = solutions_vector.length();
+  const double* values = solutions_vector.data();
+  writer.write_number((long)length);
+  writer.put('\n');
+  if ( length == 0 ) {
+    return;
+  }
+  if ( threads < 1 ) {
+    threads = default_thread_count();
+  }
+  if ( length < parallel_threshold || threads == 1 ) {
+    for (ptrdiff_t i = 0; i < length; i++) {
+      writer.write_number(values[i]);
+      writer.put((i == length-1) ? '\n' : ' ');
+    }
+    return;
+  }
+
+  // Each thread formats a chunk into its own scratch space. Then the
+  // chunks are appended in order.
+  vector<Dynamic1DArray<char> > chunks(threads);
+  vector<size_t> chunk_used(threads,0);
+  parallel_for(0,threads,threads,[&](int begin, int end) {
+      for (int t = begin; t < end; t++) {
+	ptrdiff_t first = length*t/threads;
+	ptrdiff_t last = length*(t+1)/threads;
+	chunks[t].reset((last - first)*MAX_NUMBER_LENGTH);
+	char* cursor = chunks[t].data();
+	for (ptrdiff_t i = first; i < last; i++) {
+	  cursor = to_chars(cursor,cursor + MAX_NUMBER_LENGTH,values[i]).ptr;
+	  *cursor++ = (i == length-1) ? '\n' : ' ';
+	}
+	chunk_used[t] = cursor - chunks[t].data();
+      }
+    });
+  for (int t = 0; t < threads; t++) {
+    if ( chunk_used[t] > 0 ) {
+      writer.write(chunks[t].data(),chunk_used[t]);
+    }
+  }
+}
+
+// Writes a solution as raw binary.
+void write_solution_binary(BufferedWriter& writer,
+			   const Dynamic1DArray<double>& solutions_vector) {
+  int64_t length = solutions_vector.length();
+  writer.write((const char*)&length,sizeof(length));
+  if ( length > 0 ) {
+    writer.write((const char*)solutions_vector.data(),length*sizeof(double));
+  }
+}
+
+// Writes a system as compact text in the format build() reads.
+void write_system_text(BufferedWriter& writer, const GaussianSystem& g_sys) {
+  int size = g_sys.size();
+  writer.write_number((long)size);
+  writer.put('\n');
+  for (int row = 0; row < size; row++) {
+    for (int column = 0; column <= size; column++) {
+      writer.write_number(g_sys.get(row,column));
+      writer.put((column == size) ? '\n' : ' ');
+    }
+  }
+}
+
+// Writes a system as raw binary.
+void write_system_binary(BufferedWriter& writer, const GaussianSystem& g_sys) {
+  int64_t size = g_sys.size();
+  writer.write((const char*)&size,sizeof(size));
+  Dynamic1DArray<double> row_values(size + 1);
+  for (int row = 0; row < size; row++) {
+    for (int column = 0; column <= size; column++) {
+      row_values[column] = g_sys.get(row,column);
+    }
+    writer.write((const char*)row_values.data(),(size + 1)*sizeof(double));
+  }
+}
+// ----------------------------------------------------------------------
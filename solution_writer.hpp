@@ -0,0 +1,102 @@
+// solution_writer.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 15:31:40 (jonah)>
+
+// This file prototypes fast writers for solutions and systems. They
+// sit alongside the pretty printers print_solution() and
+// GaussianSystem::print(), which are nice to read but slow: every
+// value goes through iostream manipulators and every call ends with
+// a flush. These writers format numbers with to_chars, collect the
+// bytes in a big buffer, and hand them to a file descriptor or
+// stream only when the buffer fills.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstddef>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// A write buffer in front of a file descriptor or an output
+// stream. Nothing is written until the buffer fills, flush() is
+// called, or the writer is destroyed.
+class BufferedWriter {
+public: // Constructors and destructors.
+  // Writes to an open file descriptor, such as 1 for standard output.
+  // The descriptor is not closed afterwards.
+  BufferedWriter(int file_descriptor, size_t buffer_size = 1 << 20);
+  // Writes to an output stream.
+  BufferedWriter(ostream& stream, size_t buffer_size = 1 << 20);
+  // Flushes whatever is left.
+  ~BufferedWriter();
+private: // Two writers sharing one destination would interleave badly.
+  BufferedWriter(const BufferedWriter &rhs);
+  BufferedWriter& operator = (const BufferedWriter &rhs);
+
+private: // Implementation details.
+  int descriptor; // The file descriptor, or -1 when writing to stream.
+  ostream* stream;
+  Dynamic1DArray<char> buffer;
+  size_t used; // How many bytes of the buffer are full.
+  bool failed; // Whether a write has failed.
+
+public: // Interface.
+  // Appends count raw bytes.
+  void write(const char* bytes, size_t count);
+  // Appends one character.
+  void put(char c) {
+    if ( used == (size_t)buffer.length() ) {
+      flush();
+    }
+    buffer.data()[used++] = c;
+  }
+  // Appends a number as text. Doubles use the shortest form that
+  // reads back to exactly the same value.
+  void write_number(double value);
+  void write_number(long value);
+  // Sends everything buffered so far to the destination.
+  void flush();
+  // Returns false if anything could not be written.
+  bool good() const {
+    return !failed;
+  }
+};
+
+
+// Writes a solution as compact text: the number of unknowns on one
+// line, then the values separated by spaces on the next. Every value
+// reads back exactly. A vector of length zero, such as the output of
+// solve_system() on a degenerate system, is just "0". Vectors longer
+// than parallel_threshold are formatted in chunks by several threads
+// at once. threads less than 1 means one per hardware thread.
+void write_solution_text(BufferedWriter& writer,
+			 const Dynamic1DArray<double>& solutions_vector,
+			 int threads = 0,
+			 int parallel_threshold = 1 << 16);
+
+// Writes a solution as raw binary: the number of unknowns as a 64-bit
+// integer, then the values as doubles, all in the machine's own byte
+// order.
+void write_solution_binary(BufferedWriter& writer,
+			   const Dynamic1DArray<double>& solutions_vector);
+
+// Writes a system as compact text in exactly the format build()
+// reads. Every value reads back exactly.
+void write_system_text(BufferedWriter& writer, const GaussianSystem& g_sys);
+
+// Writes a system as raw binary: the size as a 64-bit integer, then
+// each row of the augmented matrix [A|b] as doubles.
+void write_system_binary(BufferedWriter& writer, const GaussianSystem& g_sys);
@@ -0,0 +1,124 @@
+// solution_writer_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 15:58:12 (jonah)>
+
+// This file tests the fast solution and system writers. Everything
+// written as text should read back to exactly the same values.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <cassert>
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "solution_writer.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the solution_writer library.\n"
+       << "BEGIN." << endl;
+
+  cout << "\n\nWriting the simple 2x2 system and its solution as text."
+       << endl;
+  GaussianSystem testing1;
+  ifstream infile;
+  infile.open("test_system.txt");
+  infile >> testing1;
+  GaussianSystem original1 = testing1;
+  Dynamic1DArray<double> solution1 = solve_system(testing1);
+  {
+    BufferedWriter writer(1,64); // Standard output, tiny buffer.
+    write_system_text(writer,original1);
+    write_solution_text(writer,solution1);
+  }
+
+  cout << "\n\nChecking that a system survives a round trip." << endl;
+  int testing2_size = 7;
+  GaussianSystem testing2(testing2_size);
+  for (int i = 0; i < testing2_size; i++) {
+    for (int j = 0; j <= testing2_size; j++) {
+      testing2.set(i,j,exp(sin(1.0 + i*j))/3.0);
+    }
+  }
+  ostringstream system_text;
+  {
+    BufferedWriter writer(system_text);
+    write_system_text(writer,testing2);
+  }
+  istringstream system_input(system_text.str());
+  GaussianSystem read_back;
+  system_input >> read_back;
+  assert( read_back.size() == testing2_size && "The size reads back." );
+  for (int i = 0; i < testing2_size; i++) {
+    for (int j = 0; j <= testing2_size; j++) {
+      assert( read_back.get(i,j) == testing2.get(i,j)
+	      && "Every value reads back exactly." );
+    }
+  }
+  cout << "It does." << endl;
+
+  cout << "\n\nChecking that the parallel path writes the same bytes."
+       << endl;
+  int testing3_length = 10001;
+  Dynamic1DArray<double> testing3(testing3_length);
+  for (int i = 0; i < testing3_length; i++) {
+    testing3[i] = (i % 7 == 0) ? i : 1.0/(i + 0.5);
+  }
+  ostringstream serial_text, parallel_text;
+  {
+    BufferedWriter serial(serial_text,100);
+    write_solution_text(serial,testing3,1);
+    BufferedWriter parallel(parallel_text,100);
+    write_solution_text(parallel,testing3,3,1000);
+  }
+  assert( serial_text.str() == parallel_text.str()
+	  && "Serial and parallel formatting agree." );
+  istringstream solution_input(parallel_text.str());
+  int length;
+  solution_input >> length;
+  assert( length == testing3_length && "The length reads back." );
+  for (int i = 0; i < testing3_length; i++) {
+    double value;
+    solution_input >> value;
+    assert( value == testing3[i] && "Every value reads back exactly." );
+  }
+  cout << "It does." << endl;
+
+  cout << "\n\nChecking the binary writers." << endl;
+  ostringstream binary;
+  {
+    BufferedWriter writer(binary);
+    write_solution_binary(writer,testing3);
+    write_system_binary(writer,testing2);
+  }
+  string bytes = binary.str();
+  size_t expected_bytes = sizeof(int64_t) + testing3_length*sizeof(double)
+    + sizeof(int64_t) + testing2_size*(testing2_size + 1)*sizeof(double);
+  assert( bytes.size() == expected_bytes && "The binary sizes are right." );
+  int64_t binary_length;
+  memcpy(&binary_length,bytes.data(),sizeof(binary_length));
+  assert( binary_length == testing3_length && "The length is first." );
+  double last_value;
+  memcpy(&last_value,bytes.data() + sizeof(int64_t)
+	 + (testing3_length-1)*sizeof(double),sizeof(double));
+  assert( last_value == testing3[testing3_length-1]
+	  && "The values follow." );
+  cout << "They work." << endl;
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
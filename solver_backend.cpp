@@ -0,0 +1,143 @@
+// solver_backend.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 17:36:48 (jonah)>
+
+// This file implements the backend routing rules and the LAPACK
+// backend.
+
+// LAPACK is column-major and the system is row-major, and dgetrf on
+// the row-major memory would factor A^T, pivoting over columns. So
+// the matrix is transposed in place, factored, and transposed back,
+// which leaves the unit lower triangle L below the diagonal and U on
+// and above it, with the rows swapped as ipiv says. The same swaps
+// are applied to the knowns, and forward_substitution() finishes the
+// job.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "solver_backend.hpp"
+#include "gaussian_elimination.hpp"
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+#ifdef HAVE_LAPACK
+// LAPACK's LU factorization with partial pivoting.
+extern "C" void dgetrf_(const int* m, const int* n, double* a,
+			const int* lda, int* ipiv, int* info);
+#endif
+
+
+// Routing
+// ----------------------------------------------------------------------
+
+// The rules, by smallest size, guarded by their mutex. Whether there
+// are any is kept apart, so that with none, the usual case, the many
+// small solves of a solver service never touch the mutex.
+static mutex routes_mutex;
+static map<int,SolverBackend> routes;
+static atomic<bool> any_routes(false);
+
+bool backend_available(SolverBackend backend) {
+#ifdef HAVE_LAPACK
+  return backend == NATIVE_BACKEND || backend == LAPACK_BACKEND;
+#else
+  return backend == NATIVE_BACKEND;
+#endif
+}
+
+const char* backend_name(SolverBackend backend) {
+  return backend == LAPACK_BACKEND ? "lapack" : "native";
+}
+
+bool route_systems(int min_size, SolverBackend backend) {
+  if ( !backend_available(backend) ) {
+    return false;
+  }
+  lock_guard<mutex> lock(routes_mutex);
+  routes[min_size] = backend;
+  any_routes = true;
+  return true;
+}
+
+void clear_backend_routes() {
+  lock_guard<mutex> lock(routes_mutex);
+  routes.clear();
+  any_routes = false;
+}
+
+SolverBackend backend_for(int size) {
+  if ( !any_routes ) {
+    return NATIVE_BACKEND;
+  }
+  lock_guard<mutex> lock(routes_mutex);
+  map<int,SolverBackend>::const_iterator above = routes.upper_bound(size);
+  if ( above == routes.begin() ) {
+    return NATIVE_BACKEND;
+  }
+  return prev(above)->second;
+}
+// ----------------------------------------------------------------------
+
+
+// LAPACK
+// ----------------------------------------------------------------------
+
+#ifdef HAVE_LAPACK
+// Transposes the size x size matrix in place, a tile at a time, so
+// both sides of each swap stay in cache.
+static void transpose(double* matrix, ptrdiff_t size) {
+  const int TILE = 32;
+  for (ptrdiff_t i0 = 0; i0 < size; i0 += TILE) {
+    for (ptrdiff_t j0 = 0; j0 <= i0; j0 += TILE) {
+      ptrdiff_t i_end = min(i0 + TILE,size);
+      for (ptrdiff_t i = i0; i < i_end; i++) {
+	ptrdiff_t j_end = min(j0 + TILE,i);
+	for (ptrdiff_t j = j0; j < j_end; j++) {
+	  swap(matrix[i*size + j],matrix[j*size + i]);
+	}
+      }
+    }
+  }
+}
+#endif
+
+bool lapack_gaussian_elimination(GaussianSystem& g_sys) {
+  assert( backend_available(LAPACK_BACKEND)
+	  && "The LAPACK backend was built in." );
+#ifdef HAVE_LAPACK
+  int size = g_sys.size();
+  if ( size == 0 ) {
+    return true;
+  }
+  g_sys.apply_permutation();
+  double* matrix = g_sys.matrix_data();
+  double* knowns = g_sys.vector_data();
+  vector<int> ipiv(size);
+  int info = 0;
+  transpose(matrix,size);
+  dgetrf_(&size,&size,matrix,&size,ipiv.data(),&info);
+  transpose(matrix,size);
+  assert( info >= 0 && "dgetrf was called correctly." );
+  // ipiv counts from one.
+  for (int j = 0; j < size; j++) {
+    swap(knowns[j],knowns[ipiv[j] - 1]);
+  }
+  forward_substitution(g_sys);
+  return info == 0;
+#else
+  (void)g_sys;
+  return false;
+#endif
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,67 @@
+// solver_backend.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 17:14:05 (jonah)>
+
+// This file prototypes the solver backends. gaussian_elimination(),
+// and so solve_system() and everything built on them, hand each
+// system to a backend chosen by its size:
+//   - The native backend is this package's own elimination, with the
+//     algorithm the caller's EliminationMethod asks for.
+//   - The LAPACK backend factors with the installed LAPACK's dgetrf,
+//     which on a vendor or OpenBLAS build is hard to beat for big
+//     systems, but costs a copy and a library call that tiny systems
+//     don't make back. It is only built if the Makefile finds
+//     -llapack, in which case HAVE_LAPACK is defined.
+// Every system goes to the native backend until routing rules say
+// otherwise. The reduced system a backend leaves is the same either
+// way, U and the transformed knowns, so back substitution and
+// everything after it stay native.
+
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "gaussian_system.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The backends a system can be eliminated by.
+enum SolverBackend {
+  NATIVE_BACKEND, // gaussian_elimination() in this package.
+  LAPACK_BACKEND // dgetrf from the installed LAPACK.
+};
+
+// Whether backend was built in. The native backend always is.
+bool backend_available(SolverBackend backend);
+
+// The backend's name, for reports.
+const char* backend_name(SolverBackend backend);
+
+// Sends every system of min_size unknowns or more to backend, up to
+// the next larger min_size with a rule of its own. e.g., after
+//     route_systems(200,LAPACK_BACKEND);
+//     route_systems(5000,NATIVE_BACKEND);
+// systems of 200 to 4999 unknowns go to LAPACK. Returns false, and
+// changes nothing, if backend isn't available. Thread safe, but
+// eliminations already running finish on the backend they started on.
+bool route_systems(int min_size, SolverBackend backend);
+
+// Removes every rule, so every system goes to the native backend.
+void clear_backend_routes();
+
+// The backend the rules choose for a system of size unknowns.
+SolverBackend backend_for(int size);
+
+// Reduces g_sys to U and the transformed knowns with LAPACK's dgetrf,
+// leaving it as gaussian_elimination() would. The rows are physically
+// permuted afterwards. Returns false if a column has no pivot, like
+// the native methods. Must only be called if the LAPACK backend is
+// available. Any threading is LAPACK's own.
+bool lapack_gaussian_elimination(GaussianSystem& g_sys);
@@ -0,0 +1,146 @@
+// solver_backend_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 17:58:27 (jonah)>
+
+// This file tests the solver backends: the routing rules, and the
+// LAPACK backend cross-checked against native elimination on random,
+// degenerate and caller-memory systems.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <vector>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "solver_backend.hpp"
+#include "test_systems.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The largest difference between the upper triangles and knowns of
+// two reduced systems.
+static double reduced_difference(const GaussianSystem& a,
+				 const GaussianSystem& b) {
+  double output = 0;
+  for (int i = 0; i < a.size(); i++) {
+    for (int j = i; j <= a.size(); j++) {
+      output = max(output,abs(a.get(i,j) - b.get(i,j)));
+    }
+  }
+  return output;
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the solver_backend library.\n"
+       << "BEGIN." << endl;
+  srand(17);
+
+  cout << "\n\nWith no rules, everything is native." << endl;
+  assert( backend_available(NATIVE_BACKEND) );
+  assert( backend_for(1) == NATIVE_BACKEND
+	  && backend_for(100000) == NATIVE_BACKEND );
+  assert( route_systems(10,NATIVE_BACKEND) );
+  clear_backend_routes();
+
+  if ( !backend_available(LAPACK_BACKEND) ) {
+    cout << "\n\nLAPACK wasn't found, so its backend isn't built." << endl;
+    assert( !route_systems(100,LAPACK_BACKEND)
+	    && backend_for(100) == NATIVE_BACKEND );
+    cout << "\n\nThis concludes the test." << endl;
+    return 0;
+  }
+
+  cout << "\n\nRules cover sizes up to the next rule." << endl;
+  assert( route_systems(200,LAPACK_BACKEND) );
+  assert( route_systems(5000,NATIVE_BACKEND) );
+  assert( backend_for(199) == NATIVE_BACKEND );
+  assert( backend_for(200) == LAPACK_BACKEND );
+  assert( backend_for(4999) == LAPACK_BACKEND );
+  assert( backend_for(5000) == NATIVE_BACKEND );
+  clear_backend_routes();
+  assert( backend_for(300) == NATIVE_BACKEND );
+
+  cout << "\n\nLAPACK reduces systems as native elimination does." << endl;
+  int sizes[7] = {1, 2, 5, 33, 100, 257, 600};
+  for (int s = 0; s < 7; s++) {
+    int n = sizes[s];
+    GaussianSystem original = random_system(n);
+    GaussianSystem native = original;
+    GaussianSystem lapack = original;
+    assert( gaussian_elimination(native,RECURSIVE_ELIMINATION) );
+    assert( lapack_gaussian_elimination(lapack) );
+    assert( lapack.is_upper_triangular() );
+    double difference = reduced_difference(native,lapack);
+    double solution_difference = max_difference(back_substitution(native),
+						back_substitution(lapack));
+    cout << n << " unknowns: reduced systems differ by " << difference
+	 << ", solutions by " << solution_difference << endl;
+    assert( difference < 1E-11*n && solution_difference < 1E-8
+	    && "The backends agree." );
+  }
+
+  cout << "\n\nThe rules route solve_system() and every method." << endl;
+  assert( route_systems(50,LAPACK_BACKEND) );
+  EliminationMethod methods[5] = {STANDARD_ELIMINATION,
+				  RECURSIVE_ELIMINATION,
+				  TOURNAMENT_ELIMINATION,
+				  STRASSEN_ELIMINATION, TUNED_ELIMINATION};
+  for (int n = 20; n <= 80; n += 60) {
+    GaussianSystem original = random_system(n);
+    GaussianSystem reference = original;
+    Dynamic1DArray<double> expected = solve_system(reference);
+    for (int m = 0; m < 5; m++) {
+      GaussianSystem routed = original;
+      Dynamic1DArray<double> x = solve_system(routed,methods[m]);
+      assert( max_difference(x,expected) < 1E-10 );
+    }
+  }
+  clear_backend_routes();
+
+  cout << "\n\nA degenerate system is degenerate to both." << endl;
+  GaussianSystem degenerate = random_system(40);
+  for (int i = 0; i < 40; i++) {
+    degenerate.set(i,17,degenerate.get(i,3) + degenerate.get(i,9));
+    degenerate.set(i,25,0);
+  }
+  GaussianSystem native_degenerate = degenerate;
+  assert( !gaussian_elimination(native_degenerate) );
+  assert( !lapack_gaussian_elimination(degenerate) );
+
+  cout << "\n\nA column-major view of caller memory." << endl;
+  int n = 70;
+  int ld = n + 5;
+  vector<double> matrix((size_t)ld*n);
+  vector<double> knowns(n);
+  GaussianSystem copy(n);
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < n; i++) {
+      matrix[i + (size_t)j*ld] = 2.0*rand()/RAND_MAX - 1.0;
+      copy.set(i,j,matrix[i + (size_t)j*ld]);
+    }
+  }
+  for (int i = 0; i < n; i++) {
+    knowns[i] = i;
+    copy.set(i,n,i);
+  }
+  GaussianSystem view(n,matrix.data(),ld,COLUMN_MAJOR,knowns.data());
+  assert( lapack_gaussian_elimination(view) );
+  assert( gaussian_elimination(copy) );
+  assert( max_difference(back_substitution(view),back_substitution(copy))
+	  < 1E-10 );
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,336 @@
+// solver_service.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 23:46:15 (jonah)>
+
+// This file implements an in-process solver service. Any thread can
+// submit a Gaussian system and get back a future that will hold the
+// solution.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "solver_service.hpp"
+#include "parallel_for.hpp"
+#include "structure_analysis.hpp"
+#include "solver_backend.hpp"
+#include "trace.hpp"
+#include "wall_time.hpp"
+#include <chrono>
+#include <cmath>
+#include <cassert>
+#include <float.h>
+#include <algorithm>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+
+// Constructors and destructors
+// ----------------------------------------------------------------------
+
+// Starts the workers.
+SolverService::SolverService(const SolverServiceOptions& options)
+  : settings(options),
+    queue(options.queue_depth > 0 ? options.queue_depth : 1) {
+  cache = NULL;
+  if ( settings.cache_budget > 0 ) {
+    cache = new FactorizationCache(settings.cache_budget);
+  }
+  stopping = false;
+  waiting_submitters = 0;
+  start_time = wall_time();
+  submitted_count = 0;
+  rejected_count = 0;
+  completed_count = 0;
+  degenerate_count = 0;
+  fast_path_count = 0;
+  idle_workers = 0;
+  batch_count = 0;
+  batched_request_count = 0;
+  total_latency = 0;
+  largest_latency = 0;
+  if ( settings.max_batch < 1 ) {
+    settings.max_batch = 1;
+  }
+  int threads = settings.worker_threads;
+  if ( threads < 1 ) {
+    threads = default_thread_count();
+  }
+  for (int t = 0; t < threads; t++) {
+    workers.push_back(thread(&SolverService::work,this));
+  }
+}
+
+// Finishes every request already submitted and stops the workers.
+SolverService::~SolverService() {
+  shutdown();
+  delete cache;
+}
+// ----------------------------------------------------------------------
+
+
+// Implementation details
+// ----------------------------------------------------------------------
+
+// Tries to queue request and wakes a worker if it worked.
+bool SolverService::enqueue(Request* request) {
+  if ( !queue.try_push(request) ) {
+    return false;
+  }
+  // Taking the lock means a worker can't be between checking the
+  // queue and going to sleep, so the wake-up can't be lost.
+  { lock_guard<mutex> lock(work_mutex); }
+  work_available.notify_one();
+  return true;
+}
+
+// Whether requests of this size are solved together with
+// batched_solve() when several are popped at once.
+bool SolverService::batchable(int size) const {
+  return cache == NULL && !settings.analyze_structure && size > 0
+    && size <= settings.batch_size_limit
+    && backend_for(size) == NATIVE_BACKEND;
+}
+
+// What each worker thread runs. Pops a request. If it could be
+// batched and no other worker is idle, pops up to max_batch more.
+// Runs of same-size small systems are solved together, and anything
+// else one by one. While a worker is idle, the others take one
+// request at a time, so nothing waits behind a batch that an idle
+// worker could have solved.
+void SolverService::work() {
+  if ( tracing() ) {
+    set_trace_thread_name("solver worker");
+  }
+  vector<Request*> popped;
+  for (;;) {
+    Request* request;
+    if ( !queue.try_pop(request) ) {
+      TracedScope idle("idle","scheduling");
+      unique_lock<mutex> lock(work_mutex);
+      idle_workers++;
+      work_available.wait(lock,[this]() {
+	  return stopping.load() || queue.approximate_size() > 0;
+	});
+      idle_workers--;
+      if ( stopping.load() && queue.approximate_size() == 0 ) {
+	return;
+      }
+      continue;
+    }
+    popped.clear();
+    popped.push_back(request);
+    if ( batchable(request->system.size()) ) {
+      while ( (int)popped.size() < settings.max_batch
+	      && idle_workers.load() == 0
+	      && queue.try_pop(request) ) {
+	popped.push_back(request);
+      }
+    }
+    if ( waiting_submitters.load() > 0 ) {
+      { lock_guard<mutex> lock(room_mutex); }
+      room_available.notify_all();
+    }
+
+    stable_sort(popped.begin(),popped.end(),[](Request* a, Request* b) {
+	return a->system.size() < b->system.size();
+      });
+    size_t first = 0;
+    while ( first < popped.size() ) {
+      int size = popped[first]->system.size();
+      size_t last = first + 1;
+      while ( last < popped.size() && popped[last]->system.size() == size ) {
+	last++;
+      }
+      if ( last - first > 1 && batchable(size) ) {
+	solve_batch(popped.data() + first,(int)(last - first));
+      } else {
+	for (size_t r = first; r < last; r++) {
+	  solve(popped[r]);
+	}
+      }
+      first = last;
+    }
+  }
+}
+
+// Solves one request, fulfils its promise and counts it. Checks the
+// diagonal itself rather than letting back_substitution() assert.
+// structured_solve() does the same check.
+void SolverService::solve(Request* request) {
+  TracedScope traced("solve","scheduling");
+  SolveResult result;
+  result.status = DEGENERATE;
+  GaussianSystem& g_sys = request->system;
+  // With a cache, general systems go to the cache instead. The
+  // analysis is made once and handed on.
+  StructureAnalysis analysis;
+  bool structured = false;
+  if ( settings.analyze_structure ) {
+    analysis = analyze_structure(g_sys);
+    structured = (cache == NULL
+		  || analysis.structure != GENERAL_STRUCTURE);
+  }
+  if ( structured ) {
+    // The workers already run in parallel, so groups are solved one
+    // at a time.
+    if ( structured_solve(g_sys,analysis,result.solution,settings.method,
+			  1) ) {
+      result.status = SOLVED;
+    }
+    if ( analysis.structure != GENERAL_STRUCTURE ) {
+      fast_path_count++;
+    }
+  } else if ( cache != NULL ) {
+    if ( cache->solve(g_sys,result.solution) ) {
+      result.status = SOLVED;
+    }
+  } else if ( gaussian_elimination(g_sys,settings.method) ) {
+    result.status = SOLVED;
+    for (int i = 0; i < g_sys.size(); i++) {
+      if ( !(abs(g_sys.matrix_get(i,i)) > DBL_EPSILON) ) {
+	result.status = DEGENERATE;
+      }
+    }
+    if ( result.status == SOLVED ) {
+      // The workers are the parallelism. One thread each.
+      result.solution = back_substitution(g_sys,false,1);
+    }
+  }
+  finish(request,result);
+}
+
+// Solves count requests of the same size together with
+// batched_solve(), and finishes each one.
+void SolverService::solve_batch(Request** requests, int count) {
+  TracedScope traced("solve_batch","scheduling");
+  vector<const GaussianSystem*> systems(count);
+  for (int r = 0; r < count; r++) {
+    systems[r] = &requests[r]->system;
+  }
+  vector<Dynamic1DArray<double> > solutions(count);
+  batched_solve(systems.data(),count,solutions.data());
+  batch_count++;
+  batched_request_count += count;
+  for (int r = 0; r < count; r++) {
+    SolveResult result;
+    result.status = (solutions[r].length() > 0) ? SOLVED : DEGENERATE;
+    result.solution = solutions[r];
+    finish(requests[r],result);
+  }
+}
+
+// Fulfils the promise of request with result, counts it, and frees
+// the request.
+void SolverService::finish(Request* request, const SolveResult& result) {
+  if ( result.status == DEGENERATE ) {
+    degenerate_count++;
+  }
+
+  long long latency = (long long)((wall_time() - request->submit_time)*1E9);
+  total_latency += latency;
+  long long largest = largest_latency.load();
+  while ( latency > largest
+	  && !largest_latency.compare_exchange_weak(largest,latency) ) {
+  }
+  request->result.set_value(result);
+  completed_count++;
+  delete request;
+}
+// ----------------------------------------------------------------------
+
+
+// Interface
+// ----------------------------------------------------------------------
+
+// Queues a copy of g_sys for solving and returns a future for the
+// result. If the queue is full, waits until there is room.
+future<SolveResult> SolverService::submit(const GaussianSystem& g_sys) {
+  assert( !stopping.load() && "The service is running." );
+  Request* request = new Request;
+  request->system = g_sys;
+  request->submit_time = wall_time();
+  future<SolveResult> output = request->result.get_future();
+  submitted_count++;
+  if ( !enqueue(request) ) {
+    TracedScope blocked("submit_wait","scheduling");
+    waiting_submitters++;
+    unique_lock<mutex> lock(room_mutex);
+    while ( !enqueue(request) ) {
+      room_available.wait_for(lock,chrono::milliseconds(1));
+    }
+    lock.unlock();
+    waiting_submitters--;
+  }
+  return output;
+}
+
+// Like submit, but never waits.
+bool SolverService::try_submit(const GaussianSystem& g_sys,
+			       future<SolveResult>& result) {
+  assert( !stopping.load() && "The service is running." );
+  Request* request = new Request;
+  request->system = g_sys;
+  request->submit_time = wall_time();
+  future<SolveResult> output = request->result.get_future();
+  submitted_count++;
+  if ( !enqueue(request) ) {
+    submitted_count--;
+    rejected_count++;
+    delete request;
+    return false;
+  }
+  result = move(output);
+  return true;
+}
+
+// A snapshot of the counters.
+SolverServiceStatistics SolverService::statistics() const {
+  SolverServiceStatistics output;
+  output.submitted = submitted_count.load();
+  output.rejected = rejected_count.load();
+  output.completed = completed_count.load();
+  output.degenerate = degenerate_count.load();
+  output.fast_paths = fast_path_count.load();
+  output.batches = batch_count.load();
+  output.batched_requests = batched_request_count.load();
+  output.cache_hits = 0;
+  output.cache_misses = 0;
+  output.cache_evictions = 0;
+  if ( cache != NULL ) {
+    FactorizationCacheStatistics cached = cache->statistics();
+    output.cache_hits = cached.hits;
+    output.cache_misses = cached.misses;
+    output.cache_evictions = cached.evictions;
+  }
+  output.queued = queue.approximate_size();
+  output.mean_latency = 0;
+  if ( output.completed > 0 ) {
+    output.mean_latency = total_latency.load()*1E-9/output.completed;
+  }
+  output.max_latency = largest_latency.load()*1E-9;
+  output.throughput = output.completed/(wall_time() - start_time);
+  return output;
+}
+
+// Finishes every request already submitted and stops the workers.
+void SolverService::shutdown() {
+  {
+    lock_guard<mutex> lock(work_mutex);
+    if ( stopping.load() && workers.empty() ) {
+      return;
+    }
+    stopping = true;
+  }
+  work_available.notify_all();
+  for (size_t t = 0; t < workers.size(); t++) {
+    workers[t].join();
+  }
+  workers.clear();
+}
+// ----------------------------------------------------------------------
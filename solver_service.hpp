@@ -0,0 +1,178 @@
+// solver_service.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 21:30:52 (jonah)>
+
+// This file prototypes an in-process solver service. Any thread can
+// submit a Gaussian system and get back a future that will hold the
+// solution. Submissions go through a lock-free queue to a pool of
+// worker threads. When requests pile up, small systems of the same
+// size are solved together by batched_solve(). Unlike
+// solve_system(), nothing is ever printed.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "bounded_queue.hpp"
+#include "factorization_cache.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Whether a solve worked.
+enum SolveStatus {
+  SOLVED, // The solution is in the result.
+  DEGENERATE // The system is degenerate. The solution is empty.
+};
+
+// The outcome of one solve.
+struct SolveResult {
+  SolveStatus status;
+  Dynamic1DArray<double> solution;
+};
+
+// The knobs of a solver service.
+struct SolverServiceOptions {
+  // The number of worker threads. 0 means one per hardware thread.
+  int worker_threads;
+  // The most requests that can wait in the queue at once. Rounded up
+  // to a power of two.
+  int queue_depth;
+  // The most requests a worker takes in one batch. A worker only
+  // takes more than one while no other worker is idle.
+  int max_batch;
+  // Only systems up to this size are batched. Batches are solved by
+  // batched_solve(), which is standard elimination whatever the
+  // method. Systems routed to another backend, and every system when
+  // there is a cache or structure analysis, are never batched.
+  int batch_size_limit;
+  // The elimination algorithm the workers use.
+  EliminationMethod method;
+  // Run analyze_structure() on each system first and take its fast
+  // path, if any. See structure_analysis.hpp.
+  bool analyze_structure;
+  // Keep the LU factors of recent matrices in a FactorizationCache
+  // of this many bytes, so a matrix that comes back with new knowns
+  // is only substituted. Cached solves always factor by recursive LU,
+  // whatever the method. Systems that take a structural fast path
+  // skip the cache. 0 means no cache.
+  size_t cache_budget;
+  // Sets the defaults.
+  SolverServiceOptions() {
+    worker_threads = 0;
+    queue_depth = 1024;
+    max_batch = 16;
+    batch_size_limit = 64;
+    method = STANDARD_ELIMINATION;
+    analyze_structure = false;
+    cache_budget = 0;
+  }
+};
+
+// Counters for a solver service. Times are in seconds.
+struct SolverServiceStatistics {
+  long submitted; // Requests accepted into the queue.
+  long rejected; // Requests turned away by try_submit() when full.
+  long completed; // Requests whose futures are ready.
+  long degenerate; // Completed requests that were degenerate.
+  long fast_paths; // Requests solved without eliminating the whole system.
+  long batches; // Calls to batched_solve().
+  long batched_requests; // Requests solved by batched_solve().
+  long cache_hits; // Requests solved with cached factors.
+  long cache_misses; // Requests that were factored and cached.
+  long cache_evictions; // Factorizations dropped from the cache.
+  long queued; // Roughly how many requests are waiting right now.
+  double mean_latency; // From submission to a ready future.
+  double max_latency;
+  double throughput; // Completed requests per second since start.
+};
+
+// A pool of threads that solves Gaussian systems on request.
+class SolverService {
+public: // Constructors and destructors.
+  // Starts the workers.
+  SolverService(const SolverServiceOptions& options
+		= SolverServiceOptions());
+  // Finishes every request already submitted and stops the workers.
+  ~SolverService();
+private: // A running service can't be copied.
+  SolverService(const SolverService &rhs);
+  SolverService& operator = (const SolverService &rhs);
+
+private: // Implementation details.
+  // A submitted system and the promise of its result.
+  struct Request {
+    GaussianSystem system;
+    promise<SolveResult> result;
+    double submit_time;
+  };
+  SolverServiceOptions settings;
+  BoundedQueue<Request*> queue;
+  vector<thread> workers;
+  // NULL if there is no cache.
+  FactorizationCache* cache;
+  atomic<bool> stopping;
+  // Idle workers sleep here until something is submitted.
+  mutex work_mutex;
+  condition_variable work_available;
+  // Blocked submitters sleep here until a worker makes room.
+  mutex room_mutex;
+  condition_variable room_available;
+  atomic<int> waiting_submitters;
+  // Workers asleep waiting for requests.
+  atomic<int> idle_workers;
+  // Counters. Latencies are kept in nanoseconds.
+  double start_time;
+  atomic<long> submitted_count;
+  atomic<long> rejected_count;
+  atomic<long> completed_count;
+  atomic<long> degenerate_count;
+  atomic<long> fast_path_count;
+  atomic<long> batch_count;
+  atomic<long> batched_request_count;
+  atomic<long long> total_latency;
+  atomic<long long> largest_latency;
+  // Tries to queue request and wakes a worker if it worked.
+  bool enqueue(Request* request);
+  // What each worker thread runs.
+  void work();
+  // Whether requests of this size may be solved together.
+  bool batchable(int size) const;
+  // Solves one request, fulfils its promise and counts it.
+  void solve(Request* request);
+  // Solves count requests of the same size together.
+  void solve_batch(Request** requests, int count);
+  // Fulfils a request's promise, counts it and frees it.
+  void finish(Request* request, const SolveResult& result);
+
+public: // Interface.
+  // Queues a copy of g_sys for solving and returns a future for the
+  // result. If the queue is full, waits until there is room.
+  future<SolveResult> submit(const GaussianSystem& g_sys);
+  // Like submit, but never waits. If the queue is full, returns false
+  // and leaves result alone.
+  bool try_submit(const GaussianSystem& g_sys, future<SolveResult>& result);
+  // A snapshot of the counters.
+  SolverServiceStatistics statistics() const;
+  // Finishes every request already submitted and stops the
+  // workers. Nothing may be submitted afterwards. Called by the
+  // destructor.
+  void shutdown();
+};
@@ -0,0 +1,200 @@
+// solver_service_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 14:20:37 (jonah)>
+
+// This file tests the solver service. Several threads submit systems
+// at once and the results are checked against solving in place.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <thread>
+#include <vector>
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "solver_service.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Makes an nxn system from a seed, with a strong diagonal so it is
+// never degenerate.
+static GaussianSystem made_up_system(int n, int seed) {
+  GaussianSystem output(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j <= n; j++) {
+      output.set(i,j,sin(seed + 3.0*i + 7.0*j) + ((i == j) ? n : 0));
+    }
+  }
+  return output;
+}
+
+// Checks a result against solving the same system in place.
+static void check(const GaussianSystem& original, SolveResult result) {
+  assert( result.status == SOLVED && "The system was solved." );
+  GaussianSystem reduced = original;
+  gaussian_elimination(reduced);
+  Dynamic1DArray<double> expected = back_substitution(reduced);
+  for (int i = 0; i < expected.length(); i++) {
+    assert( abs(expected[i] - result.solution[i]) < 1E-12
+	    && "The service and solving in place agree." );
+  }
+}
+
+// Prints the counters of a service.
+static void print_statistics(const SolverServiceStatistics& statistics) {
+  cout << "Submitted:        " << statistics.submitted << "\n"
+       << "Rejected:         " << statistics.rejected << "\n"
+       << "Completed:        " << statistics.completed << "\n"
+       << "Degenerate:       " << statistics.degenerate << "\n"
+       << "Fast paths:       " << statistics.fast_paths << "\n"
+       << "Batches:          " << statistics.batches << "\n"
+       << "Batched requests: " << statistics.batched_requests << "\n"
+       << "Cache hits:       " << statistics.cache_hits << "\n"
+       << "Cache misses:     " << statistics.cache_misses << "\n"
+       << "Mean latency:     " << statistics.mean_latency << " s\n"
+       << "Max latency:      " << statistics.max_latency << " s\n"
+       << "Throughput:       " << statistics.throughput << " solves/s"
+       << endl;
+}
+// ----------------------------------------------------------------------
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the solver_service library.\n"
+       << "BEGIN." << endl;
+
+  cout << "\n\nFour threads each submit 200 systems of mixed sizes\n"
+       << "to a service with 2 workers and a queue of depth 16." << endl;
+  int submitters = 4;
+  int per_submitter = 200;
+  {
+    SolverServiceOptions options;
+    options.worker_threads = 2;
+    options.queue_depth = 16;
+    SolverService service(options);
+    vector<thread> threads;
+    for (int t = 0; t < submitters; t++) {
+      threads.push_back(thread([&service,t,per_submitter]() {
+	    vector<future<SolveResult> > results;
+	    for (int k = 0; k < per_submitter; k++) {
+	      results.push_back(service.submit(made_up_system(3 + k % 4,
+							      t*1000 + k)));
+	    }
+	    for (int k = 0; k < per_submitter; k++) {
+	      check(made_up_system(3 + k % 4,t*1000 + k),results[k].get());
+	    }
+	  }));
+    }
+    for (int t = 0; t < submitters; t++) {
+      threads[t].join();
+    }
+    SolverServiceStatistics statistics = service.statistics();
+    print_statistics(statistics);
+    assert( statistics.completed == submitters*per_submitter
+	    && "Every request was completed." );
+  }
+
+  cout << "\n\nA degenerate system comes back DEGENERATE, quietly."
+       << endl;
+  {
+    SolverService service;
+    GaussianSystem degenerate(3); // All zeros.
+    future<SolveResult> result;
+    bool accepted = service.try_submit(degenerate,result);
+    assert( accepted && "An empty queue has room." );
+    SolveResult outcome = result.get();
+    assert( outcome.status == DEGENERATE && "The system is degenerate." );
+    assert( outcome.solution.length() == 0 && "There is no solution." );
+    print_statistics(service.statistics());
+  }
+
+  cout << "\n\nWith structure analysis on, a triangular system takes a\n"
+       << "fast path and a general one doesn't." << endl;
+  {
+    SolverServiceOptions options;
+    options.analyze_structure = true;
+    SolverService service(options);
+    GaussianSystem general = made_up_system(6,42);
+    GaussianSystem triangular = general;
+    for (int i = 0; i < 6; i++) {
+      for (int j = 0; j < i; j++) {
+	triangular.set(i,j,0);
+      }
+    }
+    future<SolveResult> general_result = service.submit(general);
+    future<SolveResult> triangular_result = service.submit(triangular);
+    check(general,general_result.get());
+    check(triangular,triangular_result.get());
+    SolverServiceStatistics statistics = service.statistics();
+    print_statistics(statistics);
+    assert( statistics.fast_paths == 1 && "Only one took a fast path." );
+  }
+
+  cout << "\n\nWith a factorization cache, a matrix that comes back with\n"
+       << "new knowns is only factored once." << endl;
+  {
+    SolverServiceOptions options;
+    options.cache_budget = 1 << 20;
+    options.worker_threads = 2;
+    SolverService service(options);
+    GaussianSystem repeated = made_up_system(20,7);
+    vector<GaussianSystem> systems;
+    vector<future<SolveResult> > results;
+    for (int k = 0; k < 10; k++) {
+      for (int i = 0; i < 20; i++) {
+	repeated.set(i,20,sin(1.0 + i + 20*k));
+      }
+      systems.push_back(repeated);
+      results.push_back(service.submit(repeated));
+    }
+    for (int k = 0; k < 10; k++) {
+      check(systems[k],results[k].get());
+    }
+    SolverServiceStatistics statistics = service.statistics();
+    print_statistics(statistics);
+    assert( statistics.cache_hits + statistics.cache_misses == 10
+	    && statistics.cache_misses <= 2
+	    && "Each worker factors the matrix at most once." );
+  }
+
+  cout << "\n\nSmall systems that queue up behind a big one are\n"
+       << "solved together." << endl;
+  {
+    SolverServiceOptions options;
+    options.worker_threads = 1;
+    SolverService service(options);
+    future<SolveResult> big = service.submit(made_up_system(400,1));
+    vector<future<SolveResult> > results;
+    for (int k = 0; k < 40; k++) {
+      results.push_back(service.submit(k == 17 ? GaussianSystem(8)
+				       : made_up_system(8,k)));
+    }
+    check(made_up_system(400,1),big.get());
+    for (int k = 0; k < 40; k++) {
+      if ( k == 17 ) {
+	assert( results[k].get().status == DEGENERATE
+		&& "A degenerate system in a batch is reported." );
+      } else {
+	check(made_up_system(8,k),results[k].get());
+      }
+    }
+    SolverServiceStatistics statistics = service.statistics();
+    print_statistics(statistics);
+    assert( statistics.batches > 0 && statistics.batched_requests > 1
+	    && statistics.degenerate == 1
+	    && "The waiting systems were solved together." );
+  }
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
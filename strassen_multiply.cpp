@@ -0,0 +1,193 @@
+// strassen_multiply.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 23:28:45 (jonah)>
+
+// This file implements dense matrix multiplication by Strassen's
+// recursion.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "strassen_multiply.hpp"
+#include "dynamic_array.hpp"
+#include <algorithm>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Block helpers
+// ----------------------------------------------------------------------
+
+// Z = X + sign*Y for rows x columns blocks.
+static void combine(int rows, int columns,
+		    const double* X, int ldx,
+		    const double* Y, int ldy, double sign,
+		    double* Z, int ldz) {
+  for (int i = 0; i < rows; i++) {
+    const double* x = X + (ptrdiff_t)i*ldx;
+    const double* y = Y + (ptrdiff_t)i*ldy;
+    double* z = Z + (ptrdiff_t)i*ldz;
+    for (int j = 0; j < columns; j++) {
+      z[j] = x[j] + sign*y[j];
+    }
+  }
+}
+
+// Z = sign*M if overwrite, otherwise Z = Z + sign*M.
+static void accumulate(int rows, int columns,
+		       const double* M, int ldm, double sign,
+		       double* Z, int ldz, bool overwrite) {
+  for (int i = 0; i < rows; i++) {
+    const double* source = M + (ptrdiff_t)i*ldm;
+    double* target = Z + (ptrdiff_t)i*ldz;
+    if ( overwrite ) {
+      for (int j = 0; j < columns; j++) {
+	target[j] = sign*source[j];
+      }
+    } else {
+      for (int j = 0; j < columns; j++) {
+	target[j] += sign*source[j];
+      }
+    }
+  }
+}
+// ----------------------------------------------------------------------
+
+
+// Products
+// ----------------------------------------------------------------------
+
+// C = A*B by the classical triple loop, in i-k-j order so the inner
+// loop runs along rows of B and C.
+void classical_multiply(int m, int k, int n,
+			const double* A, int lda,
+			const double* B, int ldb,
+			double* C, int ldc) {
+  for (int i = 0; i < m; i++) {
+    double* __restrict c = C + (ptrdiff_t)i*ldc;
+    for (int j = 0; j < n; j++) {
+      c[j] = 0;
+    }
+    for (int p = 0; p < k; p++) {
+      double a = A[(ptrdiff_t)i*lda + p];
+      const double* __restrict b = B + (ptrdiff_t)p*ldb;
+      for (int j = 0; j < n; j++) {
+	c[j] += a*b[j];
+      }
+    }
+  }
+}
+
+// C = A*B by Strassen's recursion.
+void strassen_multiply(int m, int k, int n,
+		       const double* A, int lda,
+		       const double* B, int ldb,
+		       double* C, int ldc,
+		       int cutoff) {
+  int smallest = min(m,min(k,n));
+  if ( smallest < cutoff || smallest < 2 ) {
+    classical_multiply(m,k,n,A,lda,B,ldb,C,ldc);
+    return;
+  }
+
+  // The even part of each dimension is split in half. Odd leftovers
+  // are handled classically at the end.
+  int half_m = m/2;
+  int half_k = k/2;
+  int half_n = n/2;
+  const double* A11 = A;
+  const double* A12 = A + half_k;
+  const double* A21 = A + (ptrdiff_t)half_m*lda;
+  const double* A22 = A21 + half_k;
+  const double* B11 = B;
+  const double* B12 = B + half_n;
+  const double* B21 = B + (ptrdiff_t)half_k*ldb;
+  const double* B22 = B21 + half_n;
+  double* C11 = C;
+  double* C12 = C + half_n;
+  double* C21 = C + (ptrdiff_t)half_m*ldc;
+  double* C22 = C21 + half_n;
+
+  Dynamic1DArray<double> S((ptrdiff_t)half_m*half_k);
+  Dynamic1DArray<double> T((ptrdiff_t)half_k*half_n);
+  Dynamic1DArray<double> M((ptrdiff_t)half_m*half_n);
+  double* s = S.data();
+  double* t = T.data();
+  double* p = M.data();
+
+  // M1 = (A11 + A22)(B11 + B22). C11 = C22 = M1.
+  combine(half_m,half_k,A11,lda,A22,lda,1,s,half_k);
+  combine(half_k,half_n,B11,ldb,B22,ldb,1,t,half_n);
+  strassen_multiply(half_m,half_k,half_n,s,half_k,t,half_n,p,half_n,cutoff);
+  accumulate(half_m,half_n,p,half_n,1,C11,ldc,true);
+  accumulate(half_m,half_n,p,half_n,1,C22,ldc,true);
+
+  // M2 = (A21 + A22) B11. C21 = M2, C22 -= M2.
+  combine(half_m,half_k,A21,lda,A22,lda,1,s,half_k);
+  strassen_multiply(half_m,half_k,half_n,s,half_k,B11,ldb,p,half_n,cutoff);
+  accumulate(half_m,half_n,p,half_n,1,C21,ldc,true);
+  accumulate(half_m,half_n,p,half_n,-1,C22,ldc,false);
+
+  // M3 = A11 (B12 - B22). C12 = M3, C22 += M3.
+  combine(half_k,half_n,B12,ldb,B22,ldb,-1,t,half_n);
+  strassen_multiply(half_m,half_k,half_n,A11,lda,t,half_n,p,half_n,cutoff);
+  accumulate(half_m,half_n,p,half_n,1,C12,ldc,true);
+  accumulate(half_m,half_n,p,half_n,1,C22,ldc,false);
+
+  // M4 = A22 (B21 - B11). C11 += M4, C21 += M4.
+  combine(half_k,half_n,B21,ldb,B11,ldb,-1,t,half_n);
+  strassen_multiply(half_m,half_k,half_n,A22,lda,t,half_n,p,half_n,cutoff);
+  accumulate(half_m,half_n,p,half_n,1,C11,ldc,false);
+  accumulate(half_m,half_n,p,half_n,1,C21,ldc,false);
+
+  // M5 = (A11 + A12) B22. C11 -= M5, C12 += M5.
+  combine(half_m,half_k,A11,lda,A12,lda,1,s,half_k);
+  strassen_multiply(half_m,half_k,half_n,s,half_k,B22,ldb,p,half_n,cutoff);
+  accumulate(half_m,half_n,p,half_n,-1,C11,ldc,false);
+  accumulate(half_m,half_n,p,half_n,1,C12,ldc,false);
+
+  // M6 = (A21 - A11)(B11 + B12). C22 += M6.
+  combine(half_m,half_k,A21,lda,A11,lda,-1,s,half_k);
+  combine(half_k,half_n,B11,ldb,B12,ldb,1,t,half_n);
+  strassen_multiply(half_m,half_k,half_n,s,half_k,t,half_n,p,half_n,cutoff);
+  accumulate(half_m,half_n,p,half_n,1,C22,ldc,false);
+
+  // M7 = (A12 - A22)(B21 + B22). C11 += M7.
+  combine(half_m,half_k,A12,lda,A22,lda,-1,s,half_k);
+  combine(half_k,half_n,B21,ldb,B22,ldb,1,t,half_n);
+  strassen_multiply(half_m,half_k,half_n,s,half_k,t,half_n,p,half_n,cutoff);
+  accumulate(half_m,half_n,p,half_n,1,C11,ldc,false);
+
+  // Peel off the odd leftovers. An odd k adds a rank-one update to
+  // the even block. An odd n leaves the last column, and an odd m the
+  // last row, which are computed directly.
+  int even_m = 2*half_m;
+  int even_k = 2*half_k;
+  int even_n = 2*half_n;
+  if ( even_k < k ) {
+    const double* b = B + (ptrdiff_t)(k-1)*ldb;
+    for (int i = 0; i < even_m; i++) {
+      double a = A[(ptrdiff_t)i*lda + k-1];
+      double* c = C + (ptrdiff_t)i*ldc;
+      for (int j = 0; j < even_n; j++) {
+	c[j] += a*b[j];
+      }
+    }
+  }
+  if ( even_n < n ) {
+    for (int i = 0; i < m; i++) {
+      double sum = 0;
+      for (int q = 0; q < k; q++) {
+	sum += A[(ptrdiff_t)i*lda + q]*B[(ptrdiff_t)q*ldb + n-1];
+      }
+      C[(ptrdiff_t)i*ldc + n-1] = sum;
+    }
+  }
+  if ( even_m < m ) {
+    classical_multiply(1,k,even_n,A + (ptrdiff_t)(m-1)*lda,lda,B,ldb,
+		       C + (ptrdiff_t)(m-1)*ldc,ldc);
+  }
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,43 @@
+// strassen_multiply.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 18:02:44 (jonah)>
+
+// This file prototypes dense matrix multiplication by Strassen's
+// recursion. Strassen multiplies 2x2 block matrices with 7 block
+// products instead of 8, so the flop count falls from O(n^3) to
+// O(n^2.81). The price is extra additions and temporaries, which only
+// pay off for big matrices, and a somewhat weaker error bound: the
+// error is bounded normwise rather than entry by entry. The recursion
+// stops at a cutoff and finishes with the classical product.
+
+// Used by the Gaussian elimination library for the trailing-matrix
+// updates of recursive LU factorization.
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// All matrices below are row-major. A is m x k with rows lda apart,
+// B is k x n with rows ldb apart, and C is m x n with rows ldc
+// apart. C must not overlap A or B.
+
+// C = A*B by the classical triple loop.
+void classical_multiply(int m, int k, int n,
+			const double* A, int lda,
+			const double* B, int ldb,
+			double* C, int ldc);
+
+// C = A*B by Strassen's recursion. Halves every dimension while all
+// three are at least cutoff, peeling off a row or column when one is
+// odd, and uses classical_multiply() below that. The temporaries
+// need about (m*k + k*n + m*n)/4 doubles at the top level, and
+// roughly a third as much again over the levels below.
+void strassen_multiply(int m, int k, int n,
+		       const double* A, int lda,
+		       const double* B, int ldb,
+		       double* C, int ldc,
+		       int cutoff);
@@ -0,0 +1,88 @@
+// strassen_multiply_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 18:57:30 (jonah)>
+
+// This file tests Strassen multiplication against the classical
+// product.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include "dynamic_array.hpp"
+#include "strassen_multiply.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Multiplies random m x k and k x n matrices both ways, with the
+// given cutoff, and returns the largest difference relative to the
+// largest entry of the product. The matrices are stored with padded
+// rows to check the leading dimensions.
+static double compare(int m, int k, int n, int cutoff) {
+  int padding = 3;
+  Dynamic1DArray<double> A(m*(k + padding));
+  Dynamic1DArray<double> B(k*(n + padding));
+  Dynamic1DArray<double> classical(m*n);
+  Dynamic1DArray<double> strassen(m*(n + padding));
+  for (int i = 0; i < A.length(); i++) {
+    A[i] = 2.0*rand()/RAND_MAX - 1.0;
+  }
+  for (int i = 0; i < B.length(); i++) {
+    B[i] = 2.0*rand()/RAND_MAX - 1.0;
+  }
+  classical_multiply(m,k,n,A.data(),k + padding,B.data(),n + padding,
+		     classical.data(),n);
+  strassen_multiply(m,k,n,A.data(),k + padding,B.data(),n + padding,
+		    strassen.data(),n + padding,cutoff);
+  double largest = 0;
+  double difference = 0;
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      largest = max(largest,abs(classical[i*n + j]));
+      difference = max(difference,abs(classical[i*n + j]
+				      - strassen[i*(n + padding) + j]));
+    }
+  }
+  return difference/largest;
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the strassen_multiply library.\n"
+       << "BEGIN." << endl;
+  srand(3);
+
+  cout << "\n\nMultiplying 2x2 matrices with one level of recursion."
+       << endl;
+  double A[4] = {1, 2, 3, 4};
+  double B[4] = {5, 6, 7, 8};
+  double C[4];
+  strassen_multiply(2,2,2,A,2,B,2,C,2,1);
+  cout << "[ " << C[0] << " " << C[1] << " ]\n"
+       << "[ " << C[2] << " " << C[3] << " ]" << endl;
+  assert( C[0] == 19 && C[1] == 22 && C[2] == 43 && C[3] == 50
+	  && "Strassen gets the textbook example right." );
+
+  cout << "\n\nComparing with the classical product." << endl;
+  int shapes[6][3] = {{64,64,64}, {65,65,65}, {67,45,53},
+		      {128,33,97}, {1,40,40}, {200,150,170}};
+  for (int s = 0; s < 6; s++) {
+    double difference = compare(shapes[s][0],shapes[s][1],shapes[s][2],8);
+    cout << shapes[s][0] << "x" << shapes[s][1] << " times "
+	 << shapes[s][1] << "x" << shapes[s][2]
+	 << ": relative difference " << difference << endl;
+    assert( difference < 1E-12 && "Strassen agrees with the classical product." );
+  }
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
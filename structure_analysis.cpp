@@ -0,0 +1,456 @@
+// structure_analysis.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 23:35:05 (jonah)>
+
+// This file implements the structure analysis pass and the fast
+// paths it routes systems to.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "structure_analysis.hpp"
+#include "parallel_for.hpp"
+#include <cmath>
+#include <float.h>
+#include <atomic>
+#include <algorithm>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Names
+// ----------------------------------------------------------------------
+
+const char* matrix_structure_name(MatrixStructure structure) {
+  static const char* names[] = {
+    "diagonal", "permuted_diagonal", "upper_triangular", "lower_triangular",
+    "structurally_singular", "block_diagonal", "block_triangular", "general"
+  };
+  return names[structure];
+}
+
+void print_structure(ostream& output, const StructureAnalysis& analysis) {
+  output << matrix_structure_name(analysis.structure);
+  if ( !analysis.groups.empty() ) {
+    size_t blocks = 0;
+    for (size_t g = 0; g < analysis.groups.size(); g++) {
+      blocks += analysis.groups[g].size();
+    }
+    output << ": " << analysis.groups.size() << " groups, "
+	   << blocks << " blocks, largest " << analysis.largest_block;
+  }
+}
+// ----------------------------------------------------------------------
+
+
+// Analysis
+// ----------------------------------------------------------------------
+
+// Finds the representative of element in a union-find forest, halving
+// paths as it goes.
+static int find_root(vector<int>& parent, int element) {
+  while ( parent[element] != element ) {
+    parent[element] = parent[parent[element]];
+    element = parent[element];
+  }
+  return element;
+}
+
+// Splits the rows of one group into strongly connected components
+// of the graph with an edge from row i to row j whenever A_ij is
+// nonzero, by Tarjan's algorithm, without recursion so long chains
+// can't overflow the stack. Needs a zero-free diagonal, so that
+// equation i can stand for unknown i. A component is finished only
+// after every component it depends on, so they come out in the
+// order they must be solved. Every row of the matrix is scanned once,
+// so this is O(n) per row.
+static vector<StructureBlock> strong_components(const GaussianSystem& g_sys,
+						const vector<int>& rows) {
+  int n = g_sys.size();
+  vector<StructureBlock> output;
+  vector<int> index(n,-1);
+  vector<int> lowest(n,0);
+  vector<int> cursor(n,0);
+  vector<bool> on_stack(n,false);
+  vector<int> stack;
+  vector<int> path;
+  int counter = 0;
+  for (size_t r = 0; r < rows.size(); r++) {
+    if ( index[rows[r]] >= 0 ) {
+      continue;
+    }
+    path.push_back(rows[r]);
+    index[rows[r]] = lowest[rows[r]] = counter++;
+    stack.push_back(rows[r]);
+    on_stack[rows[r]] = true;
+    while ( !path.empty() ) {
+      int v = path.back();
+      if ( cursor[v] < n ) {
+	int w = cursor[v]++;
+	if ( w == v || g_sys.matrix_get(v,w) == 0 ) {
+	  continue;
+	}
+	if ( index[w] < 0 ) {
+	  path.push_back(w);
+	  index[w] = lowest[w] = counter++;
+	  stack.push_back(w);
+	  on_stack[w] = true;
+	} else if ( on_stack[w] ) {
+	  lowest[v] = min(lowest[v],index[w]);
+	}
+	continue;
+      }
+      path.pop_back();
+      if ( !path.empty() ) {
+	lowest[path.back()] = min(lowest[path.back()],lowest[v]);
+      }
+      if ( lowest[v] == index[v] ) {
+	StructureBlock block;
+	int w;
+	do {
+	  w = stack.back();
+	  stack.pop_back();
+	  on_stack[w] = false;
+	  block.rows.push_back(w);
+	} while ( w != v );
+	sort(block.rows.begin(),block.rows.end());
+	block.columns = block.rows;
+	output.push_back(block);
+      }
+    }
+  }
+  return output;
+}
+
+// The size of the biggest block in a group.
+static int largest_in(const vector<StructureBlock>& group) {
+  int output = 0;
+  for (size_t b = 0; b < group.size(); b++) {
+    output = max(output,(int)group[b].rows.size());
+  }
+  return output;
+}
+
+// Analyzes the structure of the coefficient matrix in one pass.
+StructureAnalysis analyze_structure(const GaussianSystem& g_sys) {
+  int n = g_sys.size();
+  StructureAnalysis output;
+  output.structure = GENERAL_STRUCTURE;
+  output.largest_block = n;
+
+  // A first row and column free of zeros tie every equation to every
+  // other and rule out the triangular shapes, so the answer is
+  // general without reading the rest. Dense systems stop here.
+  bool dense_cross = n >= 2;
+  for (int i = 0; i < n && dense_cross; i++) {
+    dense_cross = g_sys.matrix_get(0,i) != 0 && g_sys.matrix_get(i,0) != 0;
+  }
+  if ( dense_cross ) {
+    return output;
+  }
+
+  // One pass: counts, triangularity, and the connected pieces of the
+  // bipartite graph of rows and columns. Rows are elements 0..n-1 of
+  // the union-find forest and columns are n..2n-1.
+  vector<int> row_count(n,0);
+  vector<int> column_count(n,0);
+  vector<int> last_column(n,-1);
+  vector<int> parent(2*n);
+  for (int i = 0; i < 2*n; i++) {
+    parent[i] = i;
+  }
+  bool below = false;
+  bool above = false;
+  for (int row = 0; row < n; row++) {
+    int row_root = find_root(parent,row);
+    for (int column = 0; column < n; column++) {
+      if ( g_sys.matrix_get(row,column) == 0 ) {
+	continue;
+      }
+      row_count[row]++;
+      column_count[column]++;
+      last_column[row] = column;
+      below = below || (column < row);
+      above = above || (column > row);
+      int column_root = find_root(parent,n + column);
+      if ( column_root != row_root ) {
+	parent[column_root] = row_root;
+      }
+    }
+  }
+
+  bool permuted_diagonal = true;
+  for (int i = 0; i < n; i++) {
+    if ( row_count[i] == 0 || column_count[i] == 0 ) {
+      output.structure = STRUCTURALLY_SINGULAR_STRUCTURE;
+      output.largest_block = 0;
+      return output;
+    }
+    permuted_diagonal = permuted_diagonal
+      && row_count[i] == 1 && column_count[i] == 1;
+  }
+  if ( !below || !above || permuted_diagonal ) {
+    if ( !below && !above ) {
+      output.structure = DIAGONAL_STRUCTURE;
+    } else if ( permuted_diagonal ) {
+      output.structure = PERMUTED_DIAGONAL_STRUCTURE;
+      output.diagonal_columns = last_column;
+    } else if ( !below ) {
+      output.structure = UPPER_TRIANGULAR_STRUCTURE;
+    } else {
+      output.structure = LOWER_TRIANGULAR_STRUCTURE;
+    }
+    output.largest_block = 0;
+    return output;
+  }
+
+  // Gather the connected pieces. A piece with more rows than
+  // columns, or fewer, is singular whatever its values.
+  vector<int> piece_of_root(2*n,-1);
+  vector<StructureBlock> pieces;
+  for (int i = 0; i < 2*n; i++) {
+    int root = find_root(parent,i);
+    if ( piece_of_root[root] < 0 ) {
+      piece_of_root[root] = pieces.size();
+      pieces.push_back(StructureBlock());
+    }
+    StructureBlock& piece = pieces[piece_of_root[root]];
+    if ( i < n ) {
+      piece.rows.push_back(i);
+    } else {
+      piece.columns.push_back(i - n);
+    }
+  }
+  for (size_t p = 0; p < pieces.size(); p++) {
+    if ( pieces[p].rows.size() != pieces[p].columns.size() ) {
+      output.structure = STRUCTURALLY_SINGULAR_STRUCTURE;
+      output.largest_block = 0;
+      return output;
+    }
+  }
+
+  // Split each piece further into block triangular form, if its
+  // diagonal is free of zeros. Finding a row permutation that makes
+  // it so would need a maximum matching, which isn't worth it here.
+  for (size_t p = 0; p < pieces.size(); p++) {
+    bool zero_free = true;
+    for (size_t r = 0; r < pieces[p].rows.size() && zero_free; r++) {
+      int row = pieces[p].rows[r];
+      zero_free = (g_sys.matrix_get(row,row) != 0);
+    }
+    if ( zero_free && pieces[p].rows.size() > 1 ) {
+      output.groups.push_back(strong_components(g_sys,pieces[p].rows));
+    } else {
+      output.groups.push_back(vector<StructureBlock>(1,pieces[p]));
+    }
+  }
+
+  if ( output.groups.size() == 1 && output.groups[0].size() == 1 ) {
+    output.groups.clear();
+    return output;
+  }
+  output.structure = (output.groups.size() > 1) ? BLOCK_DIAGONAL_STRUCTURE
+    : BLOCK_TRIANGULAR_STRUCTURE;
+  // Biggest first, so the threads that solve groups finish together.
+  stable_sort(output.groups.begin(),output.groups.end(),
+	      [](const vector<StructureBlock>& a,
+		 const vector<StructureBlock>& b) {
+		return largest_in(a) > largest_in(b);
+	      });
+  output.largest_block = largest_in(output.groups[0]);
+  return output;
+}
+// ----------------------------------------------------------------------
+
+
+// Solving
+// ----------------------------------------------------------------------
+
+// Whether a pivot is big enough to divide by. The same test the
+// solver service uses.
+static bool usable_pivot(double pivot) {
+  return abs(pivot) > DBL_EPSILON;
+}
+
+// Eliminates g_sys and back substitutes without printing
+// anything. Returns false if the system is degenerate.
+static bool eliminate(GaussianSystem& g_sys, EliminationMethod method,
+		      Dynamic1DArray<double>& solution) {
+  if ( !gaussian_elimination(g_sys,method) ) {
+    return false;
+  }
+  for (int i = 0; i < g_sys.size(); i++) {
+    if ( !usable_pivot(g_sys.matrix_get(i,i)) ) {
+      return false;
+    }
+  }
+  solution = back_substitution(g_sys);
+  return true;
+}
+
+// Solves the blocks of one group in order, writing their unknowns
+// into x. block_of_column says which block each unknown belongs
+// to. Entries of a row outside its own block can only involve
+// unknowns of earlier blocks in the same group, which are already
+// in x. Returns false if a block is degenerate.
+static bool solve_group(const GaussianSystem& g_sys,
+			const vector<StructureBlock>& group,
+			const vector<int>& block_of_column,
+			EliminationMethod method, double* x) {
+  int n = g_sys.size();
+  for (size_t b = 0; b < group.size(); b++) {
+    const StructureBlock& block = group[b];
+    int m = block.rows.size();
+    int id = block_of_column[block.columns[0]];
+    GaussianSystem piece(m);
+    for (int i = 0; i < m; i++) {
+      int row = block.rows[i];
+      double known = g_sys.vector_get(row);
+      for (int column = 0; column < n; column++) {
+	double entry = g_sys.matrix_get(row,column);
+	if ( entry != 0 && block_of_column[column] != id ) {
+	  known -= entry*x[column];
+	}
+      }
+      piece.vector_set(i,known);
+      for (int k = 0; k < m; k++) {
+	piece.matrix_set(i,k,g_sys.matrix_get(row,block.columns[k]));
+      }
+    }
+    Dynamic1DArray<double> y;
+    if ( m == 1 ) {
+      if ( !usable_pivot(piece.matrix_get(0,0)) ) {
+	return false;
+      }
+      y.reset(1);
+      y[0] = piece.vector_get(0)/piece.matrix_get(0,0);
+    } else if ( !eliminate(piece,method,y) ) {
+      return false;
+    }
+    for (int k = 0; k < m; k++) {
+      x[block.columns[k]] = y[k];
+    }
+  }
+  return true;
+}
+
+// Solves g_sys by the fast path analyze_structure() picks.
+bool structured_solve(GaussianSystem& g_sys,
+		      Dynamic1DArray<double>& solution,
+		      EliminationMethod method/*= STANDARD_ELIMINATION*/,
+		      int threads/*= 0*/,
+		      StructureAnalysis* analysis/*= NULL*/) {
+  StructureAnalysis found = analyze_structure(g_sys);
+  if ( analysis != NULL ) {
+    *analysis = found;
+  }
+  return structured_solve(g_sys,found,solution,method,threads);
+}
+
+// Solves g_sys by the fast path found says to take.
+bool structured_solve(GaussianSystem& g_sys, const StructureAnalysis& found,
+		      Dynamic1DArray<double>& solution,
+		      EliminationMethod method/*= STANDARD_ELIMINATION*/,
+		      int threads/*= 0*/) {
+  int n = g_sys.size();
+  Dynamic1DArray<double> x(n);
+  bool nondegenerate = true;
+
+  switch ( found.structure ) {
+  case DIAGONAL_STRUCTURE:
+    for (int i = 0; i < n && nondegenerate; i++) {
+      nondegenerate = usable_pivot(g_sys.matrix_get(i,i));
+      x[i] = g_sys.vector_get(i)/g_sys.matrix_get(i,i);
+    }
+    break;
+  case PERMUTED_DIAGONAL_STRUCTURE:
+    for (int i = 0; i < n && nondegenerate; i++) {
+      int column = found.diagonal_columns[i];
+      nondegenerate = usable_pivot(g_sys.matrix_get(i,column));
+      x[column] = g_sys.vector_get(i)/g_sys.matrix_get(i,column);
+    }
+    break;
+  case UPPER_TRIANGULAR_STRUCTURE:
+    for (int i = 0; i < n && nondegenerate; i++) {
+      nondegenerate = usable_pivot(g_sys.matrix_get(i,i));
+    }
+    if ( nondegenerate ) {
+      x = back_substitution(g_sys);
+    }
+    break;
+  case LOWER_TRIANGULAR_STRUCTURE:
+    for (int i = 0; i < n && nondegenerate; i++) {
+      nondegenerate = usable_pivot(g_sys.matrix_get(i,i));
+      double known = g_sys.vector_get(i);
+      for (int j = 0; j < i; j++) {
+	known -= g_sys.matrix_get(i,j)*x[j];
+      }
+      x[i] = known/g_sys.matrix_get(i,i);
+    }
+    break;
+  case STRUCTURALLY_SINGULAR_STRUCTURE:
+    nondegenerate = false;
+    break;
+  case BLOCK_DIAGONAL_STRUCTURE:
+  case BLOCK_TRIANGULAR_STRUCTURE: {
+    vector<int> block_of_column(n);
+    int blocks = 0;
+    for (size_t g = 0; g < found.groups.size(); g++) {
+      for (size_t b = 0; b < found.groups[g].size(); b++, blocks++) {
+	const vector<int>& columns = found.groups[g][b].columns;
+	for (size_t k = 0; k < columns.size(); k++) {
+	  block_of_column[columns[k]] = blocks;
+	}
+      }
+    }
+    // Groups share no unknowns, so threads take whole groups, biggest
+    // first, as they come free.
+    atomic<int> next_group(0);
+    atomic<bool> all_solved(true);
+    int groups = found.groups.size();
+    if ( threads < 1 ) {
+      threads = default_thread_count();
+    }
+    double* unknowns = x.data();
+    parallel_for(0,min(threads,groups),threads,[&](int first, int last) {
+	for (int g = next_group++; g < groups; g = next_group++) {
+	  if ( !solve_group(g_sys,found.groups[g],block_of_column,method,
+			    unknowns) ) {
+	    all_solved = false;
+	  }
+	}
+      });
+    nondegenerate = all_solved.load();
+    break;
+  }
+  case GENERAL_STRUCTURE:
+    nondegenerate = eliminate(g_sys,method,x);
+    break;
+  }
+
+  solution = nondegenerate ? x : Dynamic1DArray<double>(0);
+  return nondegenerate;
+}
+
+// Like solve_system(), but takes the fast path.
+Dynamic1DArray<double> structured_solve_system(GaussianSystem& g_sys,
+					       EliminationMethod method
+					       /*= STANDARD_ELIMINATION*/,
+					       int threads/*= 0*/,
+					       StructureAnalysis* analysis
+					       /*= NULL*/) {
+  Dynamic1DArray<double> output(0);
+  if ( !structured_solve(g_sys,output,method,threads,analysis) ) {
+    cout << "Matrix degenerate and back substitution not possible.\n"
+	 << "Here's the best I can do:\n"
+	 << g_sys
+	 << endl;
+  }
+  return output;
+}
+// ----------------------------------------------------------------------
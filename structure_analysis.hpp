@@ -0,0 +1,143 @@
+// structure_analysis.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 23:36:20 (jonah)>
+
+// This file prototypes a structure analysis pass that routes systems
+// to fast paths. Many systems are already triangular, diagonal, a
+// permuted diagonal, or several decoupled subsystems glued
+// together. Full elimination costs O(n^3) on all of them. One pass
+// over the matrix finds out which case applies, and then
+//   -- triangular systems go straight to substitution, O(n^2),
+//   -- diagonal and permuted diagonal systems are solved elementwise,
+//   -- block-diagonal systems, under any row and column permutation,
+//      are split into independent subsystems solved in parallel,
+//   -- reducible systems, whose equations can be put in block
+//      triangular order, are solved block by block.
+// Everything else is eliminated as usual.
+
+// Structure is decided by exact zeros, since treating a tiny entry
+// as zero would change the answer. The matrix is stored densely, so
+// the pass may read every entry: O(n^2), which is still a small
+// fraction of an elimination. A system whose first row and column
+// have no zeros is general, and only those are read. solve_system()
+// runs the pass on every system, so this is what a dense system
+// pays.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <vector>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The structures the analysis recognizes, from cheapest to solve to
+// most expensive.
+enum MatrixStructure {
+  // Nonzeros only on the diagonal. Solved elementwise.
+  DIAGONAL_STRUCTURE,
+  // Exactly one nonzero in every row and every column. Solved
+  // elementwise.
+  PERMUTED_DIAGONAL_STRUCTURE,
+  // Nonzeros only on and above the diagonal. Solved by
+  // back_substitution().
+  UPPER_TRIANGULAR_STRUCTURE,
+  // Nonzeros only on and below the diagonal. Solved by forward
+  // substitution.
+  LOWER_TRIANGULAR_STRUCTURE,
+  // Some set of rows has nonzeros in fewer columns than there are
+  // rows, such as a row of zeros. The system is degenerate whatever
+  // the values.
+  STRUCTURALLY_SINGULAR_STRUCTURE,
+  // More than one set of equations that share no unknowns. Each
+  // is solved on its own, in parallel.
+  BLOCK_DIAGONAL_STRUCTURE,
+  // One set of equations, but they can be ordered so that each block
+  // only involves its own unknowns and those of the blocks before
+  // it. Solved block by block, substituting as it goes.
+  BLOCK_TRIANGULAR_STRUCTURE,
+  // None of the above. Eliminated as a whole.
+  GENERAL_STRUCTURE
+};
+
+// The name of a structure, for printing.
+const char* matrix_structure_name(MatrixStructure structure);
+
+// A square piece of the system: the equations in rows, in the
+// unknowns in columns. Both are in the order of the original
+// system.
+struct StructureBlock {
+  vector<int> rows;
+  vector<int> columns;
+};
+
+// What analyze_structure() found.
+struct StructureAnalysis {
+  MatrixStructure structure;
+  // For PERMUTED_DIAGONAL_STRUCTURE, the column of the nonzero in
+  // each row. Empty otherwise.
+  vector<int> diagonal_columns;
+  // For BLOCK_DIAGONAL_STRUCTURE and BLOCK_TRIANGULAR_STRUCTURE, the
+  // independent groups of equations. Each group is a list of blocks
+  // in the order they must be solved. Groups of one block are
+  // eliminated whole. Empty otherwise.
+  vector< vector<StructureBlock> > groups;
+  // The size of the largest block that has to be eliminated. n for
+  // a general system, 0 when nothing is eliminated.
+  int largest_block;
+};
+
+// Analyzes the structure of the coefficient matrix of g_sys in one
+// pass. Rows are taken in the order get() shows them. Leaves g_sys
+// alone.
+StructureAnalysis analyze_structure(const GaussianSystem& g_sys);
+
+// Prints a one-line summary of an analysis, like
+// "block_diagonal: 3 groups, 5 blocks, largest 40".
+void print_structure(ostream& output, const StructureAnalysis& analysis);
+
+// Solves g_sys by the fast path analyze_structure() picks. Blocks
+// that have to be eliminated use method. threads is the number of
+// threads that solve independent groups at once, one per hardware
+// thread if less than 1. If analysis is not NULL, it is filled in,
+// so the caller can report the path taken. Nothing is printed.
+// Returns false, and leaves solution empty, if the system is
+// degenerate, using the same test as the solver service: a pivot no
+// bigger than DBL_EPSILON. g_sys is left reduced if the general path
+// is taken and is otherwise untouched.
+bool structured_solve(GaussianSystem& g_sys,
+		      Dynamic1DArray<double>& solution,
+		      EliminationMethod method = STANDARD_ELIMINATION,
+		      int threads = 0, StructureAnalysis* analysis = NULL);
+
+// Like structured_solve(), but takes the path an analysis of g_sys
+// already made, so a caller that has analyzed the system for its own
+// reasons doesn't pay for the pass twice.
+bool structured_solve(GaussianSystem& g_sys,
+		      const StructureAnalysis& analysis,
+		      Dynamic1DArray<double>& solution,
+		      EliminationMethod method = STANDARD_ELIMINATION,
+		      int threads = 0);
+
+// Like solve_system(), but takes the fast path structured_solve()
+// picks. If the system is degenerate, says so like solve_system()
+// and returns an empty vector.
+Dynamic1DArray<double> structured_solve_system(GaussianSystem& g_sys,
+					       EliminationMethod method
+					       = STANDARD_ELIMINATION,
+					       int threads = 0,
+					       StructureAnalysis* analysis
+					       = NULL);
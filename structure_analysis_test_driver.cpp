@@ -0,0 +1,208 @@
+// structure_analysis_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 23:38:50 (jonah)>
+
+// This file tests the structure analysis and its fast paths. Every
+// fast path is checked against ordinary elimination of a copy.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <vector>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "structure_analysis.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Returns a random number in [1,2], or in [-2,-1], so it is never
+// zero.
+static double nonzero() {
+  double magnitude = 1.0 + (double)rand()/RAND_MAX;
+  return (rand() % 2) ? magnitude : -magnitude;
+}
+
+// Solves g_sys by the structured path, checks that the analysis
+// found the expected structure, and checks the answer against
+// ordinary elimination of a copy. Returns the analysis.
+static StructureAnalysis check(const GaussianSystem& g_sys,
+			       MatrixStructure expected) {
+  GaussianSystem structured = g_sys;
+  GaussianSystem ordinary = g_sys;
+  StructureAnalysis analysis;
+  Dynamic1DArray<double> solution;
+  bool solved = structured_solve(structured,solution,STANDARD_ELIMINATION,
+				 3,&analysis);
+  cout << "Found ";
+  print_structure(cout,analysis);
+  cout << endl;
+  assert( analysis.structure == expected && "The structure is recognized." );
+  assert( solved && "The system is solved." );
+  Dynamic1DArray<double> reference = solve_system(ordinary,
+						  STANDARD_ELIMINATION,false);
+  for (int i = 0; i < g_sys.size(); i++) {
+    assert( abs(solution[i] - reference[i]) < 1E-10*(1 + abs(reference[i]))
+	    && "The fast path agrees with elimination." );
+  }
+  return analysis;
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the structure_analysis library.\n"
+       << "BEGIN." << endl;
+  srand(5);
+  int n = 30;
+
+  cout << "\n\nA diagonal system." << endl;
+  GaussianSystem diagonal(n);
+  for (int i = 0; i < n; i++) {
+    diagonal.set(i,i,nonzero());
+    diagonal.set(i,n,nonzero());
+  }
+  GaussianSystem before = diagonal;
+  Dynamic1DArray<double> solution;
+  structured_solve(diagonal,solution);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j <= n; j++) {
+      assert( diagonal.get(i,j) == before.get(i,j)
+	      && "Fast paths leave the system alone." );
+    }
+  }
+  check(diagonal,DIAGONAL_STRUCTURE);
+
+  cout << "\n\nA permuted diagonal system." << endl;
+  GaussianSystem permuted(n);
+  for (int i = 0; i < n; i++) {
+    permuted.set(i,(i + 11) % n,nonzero());
+    permuted.set(i,n,nonzero());
+  }
+  StructureAnalysis analysis = check(permuted,PERMUTED_DIAGONAL_STRUCTURE);
+  assert( analysis.diagonal_columns[0] == 11
+	  && "The column of each nonzero is recorded." );
+
+  cout << "\n\nUpper and lower triangular systems." << endl;
+  GaussianSystem upper(n);
+  GaussianSystem lower(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = i; j < n; j++) {
+      upper.set(i,j,nonzero()/(1 + j - i));
+      lower.set(j,i,nonzero()/(1 + j - i));
+    }
+    upper.set(i,i,4*n);
+    lower.set(i,i,4*n);
+    upper.set(i,n,nonzero());
+    lower.set(i,n,nonzero());
+  }
+  check(upper,UPPER_TRIANGULAR_STRUCTURE);
+  check(lower,LOWER_TRIANGULAR_STRUCTURE);
+
+  cout << "\n\nThree decoupled subsystems with scrambled rows and columns."
+       << endl;
+  // Unknown j belongs to subsystem j % 3. Rows are shuffled by
+  // storing equation i in row (i*7) % n.
+  GaussianSystem decoupled(n);
+  for (int i = 0; i < n; i++) {
+    int row = (i*7) % n;
+    for (int j = 0; j < n; j++) {
+      if ( j % 3 == i % 3 ) {
+	decoupled.set(row,j,nonzero() + (i == j ? 2*n : 0));
+      }
+    }
+    decoupled.set(row,n,nonzero());
+  }
+  analysis = check(decoupled,BLOCK_DIAGONAL_STRUCTURE);
+  assert( analysis.groups.size() == 3 && analysis.largest_block == n/3
+	  && "The three subsystems are found." );
+
+  cout << "\n\nA reducible system: two blocks, the second coupled to "
+       << "the first." << endl;
+  GaussianSystem reducible(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      bool first_block = (i < n/2 && j < n/2);
+      bool second_block = (i >= n/2 && j >= n/2);
+      bool coupling = (i >= n/2 && j < n/2);
+      if ( first_block || second_block || coupling ) {
+	reducible.set(i,j,nonzero() + (i == j ? 2*n : 0));
+      }
+    }
+    reducible.set(i,n,nonzero());
+  }
+  analysis = check(reducible,BLOCK_TRIANGULAR_STRUCTURE);
+  assert( analysis.groups.size() == 1 && analysis.groups[0].size() == 2
+	  && analysis.groups[0][0].rows[0] == 0
+	  && "The independent block is solved first." );
+
+  cout << "\n\nA general system." << endl;
+  GaussianSystem general(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j <= n; j++) {
+      general.set(i,j,nonzero());
+    }
+  }
+  check(general,GENERAL_STRUCTURE);
+
+  cout << "\n\nAn arrowhead system, general from its first row and column."
+       << endl;
+  GaussianSystem arrowhead(n);
+  for (int i = 0; i < n; i++) {
+    arrowhead.set(0,i,nonzero());
+    arrowhead.set(i,0,nonzero());
+    arrowhead.set(i,i,2*n);
+    arrowhead.set(i,n,nonzero());
+  }
+  check(arrowhead,GENERAL_STRUCTURE);
+
+  cout << "\n\nsolve_system() takes the fast path by itself." << endl;
+  GaussianSystem by_default = lower;
+  Dynamic1DArray<double> lower_solution;
+  structured_solve(lower,lower_solution);
+  Dynamic1DArray<double> default_solution = solve_system(by_default);
+  for (int i = 0; i < n; i++) {
+    assert( default_solution[i] == lower_solution[i]
+	    && "solve_system() substitutes like structured_solve()." );
+    for (int j = 0; j <= n; j++) {
+      assert( by_default.get(i,j) == lower.get(i,j)
+	      && "The lower triangular system isn't eliminated." );
+    }
+  }
+
+  cout << "\n\nA system with a row of zeros." << endl;
+  GaussianSystem singular = general;
+  for (int j = 0; j < n; j++) {
+    singular.set(4,j,0);
+  }
+  bool solved = structured_solve(singular,solution,STANDARD_ELIMINATION,1,
+				 &analysis);
+  cout << "Found ";
+  print_structure(cout,analysis);
+  cout << endl;
+  assert( !solved && solution.length() == 0
+	  && analysis.structure == STRUCTURALLY_SINGULAR_STRUCTURE
+	  && "Structural singularity is caught without elimination." );
+
+  cout << "\n\nA degenerate block in a block-diagonal system." << endl;
+  GaussianSystem bad_block = decoupled;
+  // Rows 1 and 22 hold equations 13 and 16, of the same subsystem.
+  for (int j = 0; j < n; j++) {
+    bad_block.set(1,j,bad_block.get(22,j));
+  }
+  solved = structured_solve(bad_block,solution);
+  assert( !solved && "A degenerate block makes the system degenerate." );
+  cout << "Reported degenerate." << endl;
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
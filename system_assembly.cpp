@@ -0,0 +1,170 @@
+// system_assembly.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 21:52:40 (jonah)>
+
+// This file implements assembly of Gaussian systems from batches of
+// element contributions, by row blocks.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "system_assembly.hpp"
+#include "parallel_for.hpp"
+#include "trace.hpp"
+#include <cassert>
+#include <algorithm>
+#include <vector>
+#include <utility>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Batches
+// ----------------------------------------------------------------------
+
+AssemblyBatch::AssemblyBatch() {
+  clear();
+}
+
+void AssemblyBatch::add(int size, const int* indices, const double* matrix,
+			const double* vector) {
+  assert( size >= 0 && "Elements touch a number of unknowns." );
+  for (int i = 0; i < size; i++) {
+    assert( indices[i] >= 0 && "Unknowns are numbered from zero." );
+    largest = max(largest,indices[i]);
+  }
+  all_indices.insert(all_indices.end(),indices,indices + size);
+  all_matrices.insert(all_matrices.end(),matrix,matrix + (size_t)size*size);
+  if ( vector != NULL ) {
+    all_vectors.insert(all_vectors.end(),vector,vector + size);
+  } else {
+    all_vectors.insert(all_vectors.end(),size,0.0);
+  }
+  starts.push_back((int)all_indices.size());
+  matrix_starts.push_back(all_matrices.size());
+}
+
+void AssemblyBatch::add(const Dynamic1DArray<int>& indices,
+			const Dynamic2DArray<double>& matrix,
+			const Dynamic1DArray<double>& vector) {
+  int size = indices.length();
+  assert( matrix.height() == size && matrix.width() == size
+	  && vector.length() == size
+	  && "An element's matrix and vector match its unknowns." );
+  std::vector<double> entries((size_t)size*size);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      entries[(size_t)i*size + j] = matrix.get(i,j);
+    }
+  }
+  add(size,indices.data(),entries.data(),vector.data());
+}
+
+void AssemblyBatch::clear() {
+  starts.assign(1,0);
+  matrix_starts.assign(1,0);
+  all_indices.clear();
+  all_matrices.clear();
+  all_vectors.clear();
+  largest = -1;
+}
+// ----------------------------------------------------------------------
+
+
+// Assembly
+// ----------------------------------------------------------------------
+
+// Batches with fewer adds than this aren't worth starting threads
+// for.
+static const long long MIN_PARALLEL_ASSEMBLY = 1 << 15;
+
+void assemble(GaussianSystem& g_sys, const AssemblyBatch& batch,
+	      int threads/*= 0*/) {
+  TracedScope traced("assemble","assembly");
+  ptrdiff_t size = g_sys.size();
+  assert( batch.largest_index() < size
+	  && "Every element touches unknowns of the system." );
+  int elements = batch.elements();
+  if ( elements == 0 ) {
+    return;
+  }
+  g_sys.apply_permutation();
+  double* matrix = g_sys.matrix_data();
+  double* knowns = g_sys.vector_data();
+
+  long long work = 0;
+  for (int e = 0; e < elements; e++) {
+    work += (long long)batch.element_size(e)*(batch.element_size(e) + 1);
+  }
+  if ( threads < 1 ) {
+    threads = default_thread_count();
+  }
+  if ( work < MIN_PARALLEL_ASSEMBLY || size < 2 ) {
+    threads = 1;
+  }
+  threads = (int)min((ptrdiff_t)threads,size);
+
+  // Adds row i of element e.
+  auto add_row = [&](int e, int i) {
+    int k = batch.element_size(e);
+    const int* indices = batch.element_indices(e);
+    ptrdiff_t row = indices[i];
+    double* target = matrix + row*size;
+    const double* source = batch.element_matrix(e) + (size_t)i*k;
+    for (int j = 0; j < k; j++) {
+      target[indices[j]] += source[j];
+    }
+    knowns[row] += batch.element_vector(e)[i];
+  };
+  if ( threads == 1 ) {
+    for (int e = 0; e < elements; e++) {
+      for (int i = 0; i < batch.element_size(e); i++) {
+	add_row(e,i);
+      }
+    }
+    return;
+  }
+
+  // Thread t owns rows [first[t],first[t + 1]), the chunks
+  // parallel_for() would hand out. A counting sort buckets the
+  // element rows by owner in one pass, keeping batch order within
+  // each bucket, so each thread only sees its own rows.
+  vector<ptrdiff_t> first(threads + 1);
+  for (int t = 0; t <= threads; t++) {
+    first[t] = size*t/threads;
+  }
+  vector<int> owner(size);
+  for (int t = 0; t < threads; t++) {
+    fill(owner.begin() + first[t],owner.begin() + first[t + 1],t);
+  }
+  vector<size_t> bucket_start(threads + 1,0);
+  for (int e = 0; e < elements; e++) {
+    const int* indices = batch.element_indices(e);
+    for (int i = 0; i < batch.element_size(e); i++) {
+      bucket_start[owner[indices[i]] + 1]++;
+    }
+  }
+  for (int t = 0; t < threads; t++) {
+    bucket_start[t + 1] += bucket_start[t];
+  }
+  // Each entry is an element and one of its rows.
+  vector<pair<int,int> > buckets(bucket_start[threads]);
+  vector<size_t> next(bucket_start.begin(),bucket_start.end() - 1);
+  for (int e = 0; e < elements; e++) {
+    const int* indices = batch.element_indices(e);
+    for (int i = 0; i < batch.element_size(e); i++) {
+      buckets[next[owner[indices[i]]]++] = make_pair(e,i);
+    }
+  }
+
+  parallel_for(0,threads,threads,[&](int begin, int end) {
+      for (int t = begin; t < end; t++) {
+	for (size_t b = bucket_start[t]; b < bucket_start[t + 1]; b++) {
+	  add_row(buckets[b].first,buckets[b].second);
+	}
+      }
+    });
+}
+// ----------------------------------------------------------------------
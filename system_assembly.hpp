@@ -0,0 +1,101 @@
+// system_assembly.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 21:53:12 (jonah)>
+
+// This file prototypes parallel assembly of a Gaussian system from
+// element contributions, the way finite-element and finite-volume
+// codes build theirs. Each element touches a few unknowns and brings
+// a small dense matrix and vector, which are added into the rows and
+// columns of those unknowns:
+//     A(indices[i],indices[j]) += matrix(i,j),
+//     b(indices[i]) += vector(i).
+// Done one entry at a time through GaussianSystem::access(), every
+// add pays a permutation lookup and a bounds check, on one thread.
+
+// Here contributions are collected into an AssemblyBatch and added by
+// assemble(). The rows of the system are split into one contiguous
+// block per thread. One pass over the batch sorts the element rows
+// into a bucket per block, in batch order, and each thread then adds
+// only the rows in its own bucket. No two threads ever write the
+// same entry, so there are no locks, atomics or per-thread copies of
+// the system. And every entry gets its contributions in batch order
+// whatever the number of threads, so the sums are the same, bit for
+// bit, as adding the elements one at a time. Assembly is
+// deterministic with no extra option.
+
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <vector>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// A batch of element contributions, stored end to end.
+class AssemblyBatch {
+public: // Constructors
+  // Creates an empty batch.
+  AssemblyBatch();
+
+public: // Building
+  // Adds an element of size unknowns. indices holds the size global
+  // unknowns it touches, which may repeat; matrix the size x size
+  // contribution, row-major; and vector the size contributions to the
+  // knowns, or NULL if there are none. Everything is copied.
+  void add(int size, const int* indices, const double* matrix,
+	   const double* vector);
+  // The same for arrays. matrix may be a view in either layout.
+  void add(const Dynamic1DArray<int>& indices,
+	   const Dynamic2DArray<double>& matrix,
+	   const Dynamic1DArray<double>& vector);
+  // Empties the batch, keeping its memory for the next one.
+  void clear();
+
+public: // Access
+  // The number of elements.
+  int elements() const { return (int)starts.size() - 1; }
+  // The number of unknowns element e touches.
+  int element_size(int e) const { return starts[e + 1] - starts[e]; }
+  // The unknowns element e touches.
+  const int* element_indices(int e) const {
+    return all_indices.data() + starts[e];
+  }
+  // Element e's matrix, row-major.
+  const double* element_matrix(int e) const {
+    return all_matrices.data() + matrix_starts[e];
+  }
+  // Element e's contributions to the knowns.
+  const double* element_vector(int e) const {
+    return all_vectors.data() + starts[e];
+  }
+  // The largest unknown any element touches, or -1 if none.
+  int largest_index() const { return largest; }
+
+private:
+  // Element e's indices and vector run from starts[e] to
+  // starts[e + 1], and its matrix from matrix_starts[e].
+  vector<int> starts;
+  vector<size_t> matrix_starts;
+  vector<int> all_indices;
+  vector<double> all_matrices;
+  vector<double> all_vectors;
+  int largest;
+};
+
+// Adds every element of batch into g_sys, on top of what is already
+// there. Every index must be an unknown of g_sys. If threads is less
+// than 1, uses default_thread_count(); small batches always run on
+// the calling thread. The sums don't depend on threads. Like the
+// eliminations, works on raw memory, so the rows of g_sys are
+// physically permuted, and a view packed, afterwards.
+void assemble(GaussianSystem& g_sys, const AssemblyBatch& batch,
+	      int threads = 0);
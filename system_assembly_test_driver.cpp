@@ -0,0 +1,195 @@
+// system_assembly_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 20:31:44 (jonah)>
+
+// This file tests assembling Gaussian systems from element
+// contributions: against adding through access(), bit for bit over
+// thread counts, on top of permuted and view systems, and by solving
+// an assembled finite-element problem.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <vector>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "system_assembly.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// A batch of count random elements of 1 to 8 unknowns of n, some
+// with repeated unknowns and some without vectors.
+static AssemblyBatch random_batch(int n, int count) {
+  AssemblyBatch output;
+  for (int e = 0; e < count; e++) {
+    int k = 1 + rand()%8;
+    vector<int> indices(k);
+    vector<double> matrix((size_t)k*k);
+    vector<double> element_vector(k);
+    for (int i = 0; i < k; i++) {
+      indices[i] = rand()%n;
+      element_vector[i] = 2.0*rand()/RAND_MAX - 1.0;
+    }
+    for (size_t i = 0; i < matrix.size(); i++) {
+      matrix[i] = 2.0*rand()/RAND_MAX - 1.0;
+    }
+    output.add(k,indices.data(),matrix.data(),
+	       e%5 == 0 ? NULL : element_vector.data());
+  }
+  return output;
+}
+
+// Adds batch into g_sys one entry at a time through access().
+static void assemble_by_access(GaussianSystem& g_sys,
+			       const AssemblyBatch& batch) {
+  for (int e = 0; e < batch.elements(); e++) {
+    int k = batch.element_size(e);
+    const int* indices = batch.element_indices(e);
+    for (int i = 0; i < k; i++) {
+      for (int j = 0; j < k; j++) {
+	g_sys.access(indices[i],indices[j])
+	  += batch.element_matrix(e)[i*k + j];
+      }
+      g_sys.access(indices[i],g_sys.size())
+	+= batch.element_vector(e)[i];
+    }
+  }
+}
+
+// Whether two systems hold exactly the same numbers.
+static bool identical(const GaussianSystem& a, const GaussianSystem& b) {
+  for (int i = 0; i < a.size(); i++) {
+    for (int j = 0; j <= a.size(); j++) {
+      if ( a.get(i,j) != b.get(i,j) ) {
+	return false;
+      }
+    }
+  }
+  return true;
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the system_assembly library.\n"
+       << "BEGIN." << endl;
+  srand(23);
+
+  cout << "\n\nA batch keeps its elements." << endl;
+  AssemblyBatch batch;
+  assert( batch.elements() == 0 && batch.largest_index() == -1 );
+  int pair[2] = {4, 1};
+  double pair_matrix[4] = {1, 2, 3, 4};
+  double pair_vector[2] = {5, 6};
+  batch.add(2,pair,pair_matrix,pair_vector);
+  Dynamic1DArray<int> triple(3);
+  Dynamic2DArray<double> triple_matrix(3,3);
+  Dynamic1DArray<double> triple_vector(3);
+  for (int i = 0; i < 3; i++) {
+    triple[i] = 2*i;
+    triple_vector[i] = -i;
+    for (int j = 0; j < 3; j++) {
+      triple_matrix.access(i,j) = 10*i + j;
+    }
+  }
+  batch.add(triple,triple_matrix,triple_vector);
+  assert( batch.elements() == 2 && batch.largest_index() == 4 );
+  assert( batch.element_size(0) == 2 && batch.element_size(1) == 3 );
+  assert( batch.element_indices(1)[2] == 4
+	  && batch.element_matrix(1)[5] == 12
+	  && batch.element_vector(1)[2] == -2 );
+  GaussianSystem small(5);
+  assemble(small,batch);
+  assert( small.get(4,4) == 1 + 22 && small.get(4,1) == 2
+	  && small.get(1,4) == 3 && small.get(1,1) == 4
+	  && small.get(0,2) == 1 && small.get(4,5) == 5 - 2 );
+  batch.clear();
+  assert( batch.elements() == 0 && batch.largest_index() == -1 );
+
+  cout << "\n\nEvery thread count gives the serial sums, bit for bit."
+       << endl;
+  int n = 300;
+  AssemblyBatch random = random_batch(n,20000);
+  GaussianSystem start(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j <= n; j++) {
+      start.set(i,j,(i == j) ? 1.0 : 0.001*(i - j));
+    }
+  }
+  GaussianSystem expected = start;
+  assemble_by_access(expected,random);
+  for (int threads = 1; threads <= 8; threads++) {
+    GaussianSystem assembled = start;
+    assemble(assembled,random,threads);
+    assert( identical(assembled,expected) );
+  }
+
+  cout << "\n\nA permuted system is assembled by its logical rows." << endl;
+  GaussianSystem permuted = start;
+  GaussianSystem permuted_expected = start;
+  for (int i = 0; i < n; i += 7) {
+    permuted.swap(i,n - 1 - i);
+    permuted_expected.swap(i,n - 1 - i);
+  }
+  assemble_by_access(permuted_expected,random);
+  assemble(permuted,random,4);
+  assert( identical(permuted,permuted_expected) );
+
+  cout << "\n\nA column-major view of caller memory." << endl;
+  vector<double> matrix((size_t)n*n,0.0);
+  vector<double> knowns(n,0.0);
+  GaussianSystem view(n,matrix.data(),n,COLUMN_MAJOR,knowns.data());
+  GaussianSystem view_expected(n);
+  assemble_by_access(view_expected,random);
+  assemble(view,random,3);
+  assert( identical(view,view_expected) );
+
+  cout << "\n\nA 1D finite-element problem, -u'' = 1, u(0) = u(1) = 0."
+       << endl;
+  // Linear elements on a uniform mesh of m cells. The unknowns are
+  // the m - 1 interior nodes; the boundary nodes are left out of
+  // each element. The exact nodal values are x(1 - x)/2.
+  int m = 400;
+  int unknowns = m - 1;
+  double h = 1.0/m;
+  AssemblyBatch mesh;
+  for (int cell = 0; cell < m; cell++) {
+    // Nodes cell and cell + 1 are unknowns cell - 1 and cell.
+    int nodes[2] = {cell - 1, cell};
+    double stiffness[4] = {1/h, -1/h, -1/h, 1/h};
+    double load[2] = {h/2, h/2};
+    int first = (cell == 0) ? 1 : 0;
+    int last = (cell == m - 1) ? 1 : 2;
+    if ( last - first == 2 ) {
+      mesh.add(2,nodes,stiffness,load);
+    } else {
+      double single[1] = {1/h};
+      mesh.add(1,nodes + first,single,load);
+    }
+  }
+  GaussianSystem fem(unknowns);
+  assemble(fem,mesh);
+  bool solvable = gaussian_elimination(fem,RECURSIVE_ELIMINATION);
+  assert( solvable && "The stiffness matrix is non-degenerate." );
+  Dynamic1DArray<double> u = back_substitution(fem);
+  double error = 0;
+  for (int i = 0; i < unknowns; i++) {
+    double x = (i + 1)*h;
+    error = max(error,abs(u[i] - x*(1 - x)/2));
+  }
+  cout << "Largest nodal error: " << error << endl;
+  assert( error < 1E-10 && "Linear elements are exact at the nodes." );
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,42 @@
+// test_systems.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 22:26:13 (jonah)>
+
+// This file defines the helpers the test drivers and the benchmark
+// driver share: random systems and comparing solutions.
+
+// Include guard
+#pragma once
+
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+using namespace std;
+
+// A random system of n unknowns, with entries from rand() between -1
+// and 1.
+inline GaussianSystem random_system(int n) {
+  GaussianSystem output(n);
+  for (int row = 0; row < n; row++) {
+    for (int column = 0; column < n+1; column++) {
+      output.set(row,column,2.0*rand()/RAND_MAX - 1.0);
+    }
+  }
+  return output;
+}
+
+// The largest absolute difference between two vectors of the same
+// length.
+inline double max_difference(const Dynamic1DArray<double>& a,
+			     const Dynamic1DArray<double>& b) {
+  assert( a.length() == b.length() && "The vectors are the same length." );
+  double output = 0;
+  for (ptrdiff_t i = 0; i < a.length(); i++) {
+    output = max(output,abs(a.get(i) - b.get(i)));
+  }
+  return output;
+}
@@ -0,0 +1,353 @@
+// tournament_pivoting.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 12:31:09 (jonah)>
+
+// This file implements communication-avoiding Gaussian elimination
+// with tournament pivoting, as in CALU.
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "tournament_pivoting.hpp"
+#include "gaussian_elimination.hpp"
+#include "parallel_for.hpp"
+#include <cmath>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Utilities. These work directly on the row-major memory of the
+// system. matrix is the coefficient matrix, knowns is the vector of
+// knowns, and size is the size of the system, which is also the
+// distance between rows. size is a ptrdiff_t so that offsets like
+// row*size can't overflow.
+// ----------------------------------------------------------------------
+
+// Swaps two rows of the system in memory, knowns included.
+static void swap_rows(double* matrix, double* knowns, ptrdiff_t size,
+		      int row1, int row2) {
+  double* first = matrix + row1*size;
+  double* second = matrix + row2*size;
+  for (int column = 0; column < size; column++) {
+    double temp = first[column];
+    first[column] = second[column];
+    second[column] = temp;
+  }
+  double temp = knowns[row1];
+  knowns[row1] = knowns[row2];
+  knowns[row2] = temp;
+}
+
+// One match of the tournament. Picks pivot rows among the count rows
+// listed in candidates by partial pivoting on a copy of their entries
+// in columns [first,first+width). The matrix itself is untouched. On
+// return the winners are at the front of candidates, in pivot order.
+// Returns the number of winners.
+static int play_off(const double* matrix, ptrdiff_t size, int first,
+		    int width, int* candidates, int count) {
+  int winners = min(count,width);
+  Dynamic2DArray<double> copy(count,width);
+  double* a = copy.data();
+  for (int r = 0; r < count; r++) {
+    for (int c = 0; c < width; c++) {
+      a[r*width + c] = matrix[candidates[r]*size + first + c];
+    }
+  }
+  for (int j = 0; j < winners; j++) {
+    int largest_row = j;
+    double largest_value = abs(a[j*width + j]);
+    for (int r = j; r < count; r++) {
+      if (abs(a[r*width + j]) > largest_value) {
+	largest_row = r;
+	largest_value = abs(a[r*width + j]);
+      }
+    }
+    if ( largest_row != j ) {
+      for (int c = 0; c < width; c++) {
+	double temp = a[j*width + c];
+	a[j*width + c] = a[largest_row*width + c];
+	a[largest_row*width + c] = temp;
+      }
+      int temp = candidates[j];
+      candidates[j] = candidates[largest_row];
+      candidates[largest_row] = temp;
+    }
+    if ( largest_value == 0 ) {
+      continue; // Nothing to eliminate with. Row j wins by default.
+    }
+    for (int r = j + 1; r < count; r++) {
+      double multiplier = a[r*width + j]/a[j*width + j];
+      for (int c = j + 1; c < width; c++) {
+	a[r*width + c] -= multiplier*a[j*width + c];
+      }
+    }
+  }
+  return winners;
+}
+
+// Factors the square block of rows and columns [first,last) with no
+// pivoting at all. Returns false, leaving the block half-done, if it
+// meets a zero pivot.
+static bool factor_top_block(double* matrix, ptrdiff_t size, int first,
+			     int last) {
+  for (int j = first; j < last; j++) {
+    double pivot = matrix[j*size + j];
+    if ( pivot == 0 ) {
+      return false;
+    }
+    for (int row = j + 1; row < last; row++) {
+      double* target = matrix + row*size;
+      target[j] /= pivot;
+      for (int column = j + 1; column < last; column++) {
+	target[column] -= target[j]*matrix[j*size + column];
+      }
+    }
+  }
+  return true;
+}
+
+// Factors the panel of columns [first,last) by ordinary partial
+// pivoting. The fallback when the tournament winners don't work out.
+// Returns false if any column had no pivot.
+static bool factor_panel_partial_pivoting(double* matrix, double* knowns,
+					  ptrdiff_t size, int first, int last) {
+  bool nondegenerate = true;
+  for (int j = first; j < last; j++) {
+    int largest_row = j;
+    double largest_value = abs(matrix[j*size + j]);
+    for (int row = j; row < size; row++) {
+      if (abs(matrix[row*size + j]) > largest_value) {
+	largest_row = row;
+	largest_value = abs(matrix[row*size + j]);
+      }
+    }
+    if ( !(largest_value > 0) ) {
+      nondegenerate = false;
+      continue;
+    }
+    if ( largest_row != j ) {
+      swap_rows(matrix,knowns,size,j,largest_row);
+    }
+    for (int row = j + 1; row < size; row++) {
+      double* target = matrix + row*size;
+      target[j] /= matrix[j*size + j];
+      for (int column = j + 1; column < last; column++) {
+	target[column] -= target[j]*matrix[j*size + column];
+      }
+    }
+  }
+  return nondegenerate;
+}
+
+// Runs the tournament for the panel of columns [first,last) and
+// swaps the winners to the top of the panel. row_blocks is the number
+// of leaves of the tree. Returns the number of levels in the tree,
+// which is the number of synchronizations it took.
+static int tournament(double* matrix, double* knowns, ptrdiff_t size,
+		      int first, int last, int row_blocks,
+		      Dynamic1DArray<int>& candidates) {
+  int width = last - first;
+  int rows = size - first;
+  int blocks = max(1,min(row_blocks,rows/width));
+
+  // Each list is a run of candidates: list_start[b] is where it
+  // begins and list_count[b] is how many rows it holds.
+  Dynamic1DArray<int> list_start(blocks);
+  Dynamic1DArray<int> list_count(blocks);
+  for (int i = 0; i < rows; i++) {
+    candidates[i] = first + i;
+  }
+  for (int b = 0; b < blocks; b++) {
+    list_start[b] = (int)((long long)rows*b/blocks);
+    list_count[b] = (int)((long long)rows*(b+1)/blocks) - list_start[b];
+  }
+
+  // The leaves. Every block picks its own candidates.
+  int* candidate_data = candidates.data();
+  int* start = list_start.data();
+  int* count = list_count.data();
+  parallel_for(0,blocks,blocks,[&](int begin, int end) {
+      for (int b = begin; b < end; b++) {
+	count[b] = play_off(matrix,size,first,width,
+			    candidate_data + start[b],count[b]);
+      }
+    });
+  int levels = 1;
+
+  // Play the candidates off pairwise until one list is left.
+  while ( blocks > 1 ) {
+    int pairs = blocks/2;
+    parallel_for(0,pairs,pairs,[&](int begin, int end) {
+	for (int p = begin; p < end; p++) {
+	  int left = 2*p;
+	  int right = 2*p + 1;
+	  // Move the right winners up against the left winners.
+	  for (int k = 0; k < count[right]; k++) {
+	    candidate_data[start[left] + count[left] + k]
+	      = candidate_data[start[right] + k];
+	  }
+	  count[left] = play_off(matrix,size,first,width,
+				 candidate_data + start[left],
+				 count[left] + count[right]);
+	}
+      });
+    for (int p = 0; p < pairs; p++) {
+      start[p] = start[2*p];
+      count[p] = count[2*p];
+    }
+    if ( blocks % 2 == 1 ) {
+      start[pairs] = start[blocks-1];
+      count[pairs] = count[blocks-1];
+    }
+    blocks = pairs + blocks % 2;
+    levels++;
+  }
+
+  // Swap the winners to the top of the panel, in pivot order.
+  int* winners = candidate_data + start[0];
+  for (int t = 0; t < width; t++) {
+    int target = first + t;
+    int row = winners[t];
+    if ( row != target ) {
+      swap_rows(matrix,knowns,size,target,row);
+      for (int s = t + 1; s < width; s++) {
+	if ( winners[s] == target ) {
+	  winners[s] = row;
+	}
+      }
+    }
+  }
+  return levels;
+}
+// ----------------------------------------------------------------------
+
+
+// Performs Gaussian elimination on g_sys with tournament pivoting.
+// ----------------------------------------------------------------------
+bool tournament_gaussian_elimination(GaussianSystem& g_sys,
+				     int panel_width/*= 32*/,
+				     int row_blocks/*= 0*/,
+				     PivotingDiagnostics* diagnostics/*= NULL*/) {
+  ptrdiff_t size = g_sys.size();
+  PivotingDiagnostics report;
+  report.growth_factor = 0;
+  report.largest_multiplier = 0;
+  report.panels = 0;
+  report.synchronizations = 0;
+  report.fallback_panels = 0;
+  if ( panel_width < 1 ) {
+    panel_width = 1;
+  }
+  if ( row_blocks < 1 ) {
+    row_blocks = default_thread_count();
+  }
+  int threads = default_thread_count();
+
+  g_sys.apply_permutation();
+  double* matrix = g_sys.matrix_data();
+  double* knowns = g_sys.vector_data();
+  double largest_original = 0;
+  for (ptrdiff_t k = 0; k < size*size; k++) {
+    largest_original = max(largest_original,abs(matrix[k]));
+  }
+
+  bool nondegenerate = true;
+  Dynamic1DArray<int> candidates(size);
+  for (int first = 0; first < size; first += panel_width) {
+    int last = min(first + panel_width, g_sys.size());
+    report.panels++;
+    report.synchronizations += tournament(matrix,knowns,size,first,last,
+					  row_blocks,candidates);
+
+    // Eliminate the panel with the winners as pivots. The top block
+    // needs no pivoting, and every row below is then a triangular
+    // solve of its own.
+    Dynamic2DArray<double> top_block(last - first,last - first);
+    for (int row = first; row < last; row++) {
+      for (int column = first; column < last; column++) {
+	top_block.access(row - first,column - first)
+	  = matrix[row*size + column];
+      }
+    }
+    if ( factor_top_block(matrix,size,first,last) ) {
+      parallel_for(last,size,threads,[&](int begin, int end) {
+	  for (int row = begin; row < end; row++) {
+	    double* target = matrix + row*size;
+	    for (int j = first; j < last; j++) {
+	      target[j] /= matrix[j*size + j];
+	      for (int column = j + 1; column < last; column++) {
+		target[column] -= target[j]*matrix[j*size + column];
+	      }
+	    }
+	  }
+	});
+    } else {
+      // A winner had a zero pivot. Put the block back and fall back
+      // on partial pivoting for this panel.
+      for (int row = first; row < last; row++) {
+	for (int column = first; column < last; column++) {
+	  matrix[row*size + column]
+	    = top_block.get(row - first,column - first);
+	}
+      }
+      report.fallback_panels++;
+      nondegenerate = factor_panel_partial_pivoting(matrix,knowns,size,
+						    first,last)
+	&& nondegenerate;
+    }
+
+    // The rows of U to the right of the panel: A12 = L11^{-1} A12.
+    parallel_for(last,size,threads,[&](int begin, int end) {
+	for (int row = first + 1; row < last; row++) {
+	  double* target = matrix + row*size;
+	  for (int k = first; k < row; k++) {
+	    const double* source = matrix + k*size;
+	    for (int column = begin; column < end; column++) {
+	      target[column] -= target[k]*source[column];
+	    }
+	  }
+	}
+      });
+
+    // The trailing update: A22 = A22 - L21*U12.
+    parallel_for(last,size,threads,[&](int begin, int end) {
+	for (int row = begin; row < end; row++) {
+	  double* target = matrix + row*size;
+	  for (int k = first; k < last; k++) {
+	    const double* source = matrix + k*size;
+	    for (int column = last; column < size; column++) {
+	      target[column] -= target[k]*source[column];
+	    }
+	  }
+	}
+      });
+  }
+
+  // Diagnostics, while the multipliers are still there.
+  double largest_reduced = 0;
+  for (int row = 0; row < size; row++) {
+    for (int column = 0; column < size; column++) {
+      double value = abs(matrix[row*size + column]);
+      if ( column < row ) {
+	report.largest_multiplier = max(report.largest_multiplier,value);
+      } else {
+	largest_reduced = max(largest_reduced,value);
+      }
+    }
+  }
+  if ( largest_original > 0 ) {
+    report.growth_factor = largest_reduced/largest_original;
+  }
+  if ( diagnostics != NULL ) {
+    *diagnostics = report;
+  }
+
+  forward_substitution(g_sys);
+  return nondegenerate;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,65 @@
+// tournament_pivoting.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 12:31:09 (jonah)>
+
+// This file prototypes communication-avoiding Gaussian elimination
+// with tournament pivoting, as in CALU. Ordinary partial pivoting
+// scans a whole column and synchronizes before every column of a
+// panel. Tournament pivoting picks all the pivots of a panel at once
+// with a reduction tree, so a panel needs O(log P) synchronizations
+// instead of O(b).
+
+// This library is designed to be used with the gaussian_system data
+// structure.
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Stability diagnostics for a tournament-pivoted elimination.
+// Tournament pivoting is not quite as stable as partial pivoting, so
+// check these before trusting it with a new class of matrices.
+struct PivotingDiagnostics {
+  // The largest entry of U over the largest entry of A. Partial
+  // pivoting is usually well under 10 for sensible matrices.
+  double growth_factor;
+  // The largest multiplier |l_ij|. Partial pivoting guarantees this
+  // is at most 1. Tournament pivoting can exceed it.
+  double largest_multiplier;
+  // The number of panels factored.
+  int panels;
+  // The number of synchronization points used to choose pivots, over
+  // all panels. Partial pivoting would use one per column.
+  int synchronizations;
+  // The number of panels where a tournament winner had a zero pivot,
+  // so the panel fell back on ordinary partial pivoting.
+  int fallback_panels;
+};
+
+
+// Performs Gaussian elimination on g_sys with tournament pivoting.
+// The columns are factored in panels of panel_width. For each panel,
+// the rows below the diagonal are split into row_blocks blocks. Each
+// block picks panel_width candidate pivot rows by partial pivoting on
+// its own, in parallel. The candidates are then played off pairwise
+// up a binary tree, and the winners are swapped to the top of the
+// panel. The panel is eliminated using the winners as pivots. If
+// row_blocks is less than 1, uses one block per hardware thread. If
+// diagnostics is not NULL, fills it in. Works on raw memory, so the
+// rows of g_sys are physically permuted afterwards. Returns true if
+// back substitution is possible.
+bool tournament_gaussian_elimination(GaussianSystem& g_sys,
+				     int panel_width = 32,
+				     int row_blocks = 0,
+				     PivotingDiagnostics* diagnostics = NULL);
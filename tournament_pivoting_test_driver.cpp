@@ -0,0 +1,113 @@
+// tournament_pivoting_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-18 13:05:51 (jonah)>
+
+// This file tests the tournament pivoting library against ordinary
+// partial pivoting.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <float.h>
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "tournament_pivoting.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Prints the diagnostics of a tournament-pivoted elimination.
+static void print_diagnostics(const PivotingDiagnostics& diagnostics) {
+  cout << "Growth factor:      " << diagnostics.growth_factor << "\n"
+       << "Largest multiplier: " << diagnostics.largest_multiplier << "\n"
+       << "Panels:             " << diagnostics.panels << "\n"
+       << "Synchronizations:   " << diagnostics.synchronizations << "\n"
+       << "Fallback panels:    " << diagnostics.fallback_panels << endl;
+}
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the tournament_pivoting library.\n"
+       << "BEGIN." << endl;
+
+  cout << "\n\nSolving the 3x3 system from the elimination test." << endl;
+  GaussianSystem testing1(3);
+  testing1.matrix_set(0,0,2);
+  testing1.matrix_set(0,1,4);
+  testing1.matrix_set(0,2,-2);
+  testing1.matrix_set(1,0,4);
+  testing1.matrix_set(1,1,9);
+  testing1.matrix_set(1,2,-3);
+  testing1.matrix_set(2,0,-2);
+  testing1.matrix_set(2,1,-3);
+  testing1.matrix_set(2,2,7);
+  testing1.vector_set(0,2);
+  testing1.vector_set(1,8);
+  testing1.vector_set(2,10);
+  Dynamic1DArray<double> solution1
+    = solve_system(testing1,TOURNAMENT_ELIMINATION);
+  print_solution(cout,solution1,DBL_EPSILON);
+  assert( abs(solution1[0] + 1) < 1E-12
+	  && abs(solution1[1] - 2) < 1E-12
+	  && abs(solution1[2] - 2) < 1E-12
+	  && "The solution is (-1,2,2)." );
+
+  cout << "\n\nSolving a random 150x150 system in panels of 8\n"
+       << "with 4 row blocks, and comparing with partial pivoting."
+       << endl;
+  int testing2_size = 150;
+  GaussianSystem testing2(testing2_size);
+  srand(2);
+  for (int i = 0; i < testing2_size; i++) {
+    for (int j = 0; j <= testing2_size; j++) {
+      testing2.set(i,j,2.0*rand()/RAND_MAX - 1.0);
+    }
+  }
+  GaussianSystem standard = testing2;
+  GaussianSystem tournament = testing2;
+  PivotingDiagnostics diagnostics;
+  bool nondegenerate = tournament_gaussian_elimination(tournament,8,4,
+						       &diagnostics);
+  assert( nondegenerate && "The system is non-degenerate." );
+  assert( tournament.is_upper_triangular()
+	  && "The system is upper triangular." );
+  gaussian_elimination(standard);
+  print_diagnostics(diagnostics);
+  cout << "Partial pivoting growth factor: "
+       << growth_factor(testing2,standard) << endl;
+  assert( diagnostics.panels == 19 && "150 columns make 19 panels." );
+  assert( diagnostics.synchronizations < testing2_size
+	  && "Fewer synchronizations than columns." );
+
+  Dynamic1DArray<double> expected = back_substitution(standard);
+  Dynamic1DArray<double> solution2 = back_substitution(tournament);
+  double difference = 0;
+  for (int i = 0; i < testing2_size; i++) {
+    difference = max(difference,abs(expected[i] - solution2[i]));
+  }
+  cout << "The largest difference from partial pivoting is "
+       << difference << endl;
+  assert( difference < 1E-8 && "Tournament and partial pivoting agree." );
+
+  cout << "\n\nA system whose first column is zero is degenerate." << endl;
+  GaussianSystem testing3(4);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 1; j <= 4; j++) {
+      testing3.set(i,j,i + j*j);
+    }
+  }
+  nondegenerate = tournament_gaussian_elimination(testing3,2,2,&diagnostics);
+  assert( !nondegenerate && "The system is degenerate." );
+  print_diagnostics(diagnostics);
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
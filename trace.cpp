@@ -0,0 +1,261 @@
+// trace.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 18:54:13 (jonah)>
+
+// This file implements timeline tracing: the per-thread ring
+// buffers, their recycling, and the Chrome trace-event writer.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "trace.hpp"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Buffers
+// ----------------------------------------------------------------------
+
+atomic<bool> tracing_enabled(false);
+
+// One complete event.
+struct TraceRecord {
+  const char* name;
+  const char* category;
+  long long start;
+  long long duration;
+};
+
+// The ring buffer of one thread, or of a line of threads that ran
+// one after another. Only its thread writes events and written;
+// everything else is guarded by trace_mutex.
+struct TraceBuffer {
+  vector<TraceRecord> events;
+  atomic<long long> written;
+  // written when the trace was last cleared.
+  long long cleared;
+  int lane;
+  string thread_name;
+};
+
+// Every buffer ever made, and the ones free for a new thread. They
+// live until exit, so the trace can be written then.
+static mutex trace_mutex;
+static vector<TraceBuffer*> buffers;
+static vector<TraceBuffer*> free_buffers;
+
+// Hands a thread's buffer back when the thread exits.
+struct BufferHandle {
+  TraceBuffer* buffer;
+  BufferHandle() : buffer(NULL) {}
+  ~BufferHandle() {
+    if ( buffer != NULL ) {
+      lock_guard<mutex> lock(trace_mutex);
+      free_buffers.push_back(buffer);
+    }
+  }
+};
+static thread_local BufferHandle thread_buffer;
+
+// The calling thread's buffer, found or made on its first event.
+static TraceBuffer* current_buffer() {
+  if ( thread_buffer.buffer != NULL ) {
+    return thread_buffer.buffer;
+  }
+  lock_guard<mutex> lock(trace_mutex);
+  TraceBuffer* buffer;
+  if ( !free_buffers.empty() ) {
+    buffer = free_buffers.back();
+    free_buffers.pop_back();
+  } else {
+    buffer = new TraceBuffer;
+    buffer->events.resize(TRACE_BUFFER_EVENTS);
+    buffer->written = 0;
+    buffer->cleared = 0;
+    buffer->lane = (int)buffers.size() + 1;
+    buffers.push_back(buffer);
+  }
+  thread_buffer.buffer = buffer;
+  return buffer;
+}
+// ----------------------------------------------------------------------
+
+
+// Recording
+// ----------------------------------------------------------------------
+
+void start_tracing() {
+  tracing_enabled = true;
+}
+
+void stop_tracing() {
+  tracing_enabled = false;
+}
+
+void clear_trace() {
+  lock_guard<mutex> lock(trace_mutex);
+  for (size_t b = 0; b < buffers.size(); b++) {
+    buffers[b]->cleared = buffers[b]->written.load(memory_order_acquire);
+  }
+}
+
+long long trace_clock() {
+  return chrono::duration_cast<chrono::nanoseconds>
+    (chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void trace_event(const char* name, const char* category,
+		 long long start, long long end) {
+  TraceBuffer* buffer = current_buffer();
+  long long index = buffer->written.load(memory_order_relaxed);
+  TraceRecord& record = buffer->events[index % TRACE_BUFFER_EVENTS];
+  record.name = name;
+  record.category = category;
+  record.start = start;
+  record.duration = end - start;
+  buffer->written.store(index + 1,memory_order_release);
+}
+
+void set_trace_thread_name(const char* name) {
+  TraceBuffer* buffer = current_buffer();
+  lock_guard<mutex> lock(trace_mutex);
+  buffer->thread_name = name;
+}
+
+long long trace_events_recorded() {
+  lock_guard<mutex> lock(trace_mutex);
+  long long output = 0;
+  for (size_t b = 0; b < buffers.size(); b++) {
+    output += buffers[b]->written.load(memory_order_acquire)
+      - buffers[b]->cleared;
+  }
+  return output;
+}
+
+long long trace_events_dropped() {
+  lock_guard<mutex> lock(trace_mutex);
+  long long output = 0;
+  for (size_t b = 0; b < buffers.size(); b++) {
+    long long kept = buffers[b]->written.load(memory_order_acquire)
+      - buffers[b]->cleared;
+    output += max(0LL,kept - TRACE_BUFFER_EVENTS);
+  }
+  return output;
+}
+// ----------------------------------------------------------------------
+
+
+// Writing
+// ----------------------------------------------------------------------
+
+// Writes text as a JSON string.
+static void write_json_string(ostream& output, const char* text) {
+  output << '"';
+  for (const char* c = text; *c != '\0'; c++) {
+    if ( *c == '"' || *c == '\\' ) {
+      output << '\\' << *c;
+    } else if ( (unsigned char)*c < 0x20 ) {
+      char escape[8];
+      snprintf(escape,sizeof(escape),"\\u%04x",(unsigned char)*c);
+      output << escape;
+    } else {
+      output << *c;
+    }
+  }
+  output << '"';
+}
+
+bool write_trace(ostream& output) {
+  lock_guard<mutex> lock(trace_mutex);
+  // Times are written in microseconds from the earliest event.
+  long long origin = 0;
+  bool have_origin = false;
+  for (size_t b = 0; b < buffers.size(); b++) {
+    TraceBuffer& buffer = *buffers[b];
+    long long end = buffer.written.load(memory_order_acquire);
+    long long begin = max(buffer.cleared,end - TRACE_BUFFER_EVENTS);
+    for (long long i = begin; i < end; i++) {
+      long long start = buffer.events[i % TRACE_BUFFER_EVENTS].start;
+      if ( !have_origin || start < origin ) {
+	origin = start;
+	have_origin = true;
+      }
+    }
+  }
+
+  output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  char number[64];
+  for (size_t b = 0; b < buffers.size(); b++) {
+    TraceBuffer& buffer = *buffers[b];
+    if ( !buffer.thread_name.empty() ) {
+      output << (first ? "\n" : ",\n")
+	     << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+	     << buffer.lane << ",\"args\":{\"name\":";
+      write_json_string(output,buffer.thread_name.c_str());
+      output << "}}";
+      first = false;
+    }
+    long long end = buffer.written.load(memory_order_acquire);
+    long long begin = max(buffer.cleared,end - TRACE_BUFFER_EVENTS);
+    for (long long i = begin; i < end; i++) {
+      const TraceRecord& record = buffer.events[i % TRACE_BUFFER_EVENTS];
+      output << (first ? "\n" : ",\n") << "{\"name\":";
+      write_json_string(output,record.name);
+      output << ",\"cat\":";
+      write_json_string(output,record.category);
+      snprintf(number,sizeof(number),",\"ts\":%.3f,\"dur\":%.3f",
+	       (record.start - origin)/1E3,record.duration/1E3);
+      output << ",\"ph\":\"X\"" << number << ",\"pid\":1,\"tid\":"
+	     << buffer.lane << "}";
+      first = false;
+    }
+  }
+  output << "\n]}" << endl;
+  return output.good();
+}
+
+bool write_trace(const char* filename) {
+  ofstream output(filename);
+  return output && write_trace(output);
+}
+// ----------------------------------------------------------------------
+
+
+// Tracing from the environment
+// ----------------------------------------------------------------------
+
+// The file named by the environment, written at exit.
+static string trace_filename;
+
+static void write_trace_at_exit() {
+  stop_tracing();
+  if ( !write_trace(trace_filename.c_str()) ) {
+    cerr << "Couldn't write the trace to " << trace_filename << endl;
+  }
+}
+
+// Starts tracing before main() if the environment asks for it. Last
+// in the file, so everything above is constructed first.
+static bool trace_from_environment() {
+  const char* filename = getenv(TRACE_VARIABLE);
+  if ( filename == NULL || filename[0] == '\0' ) {
+    return false;
+  }
+  trace_filename = filename;
+  atexit(write_trace_at_exit);
+  start_tracing();
+  return true;
+}
+static bool traced_from_environment = trace_from_environment();
+// ----------------------------------------------------------------------
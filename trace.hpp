@@ -0,0 +1,110 @@
+// trace.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 18:25:40 (jonah)>
+
+// This file prototypes timeline tracing. perf_counters.hpp adds up
+// where the time went; a trace shows when, on which thread, so a
+// batch of solves that runs slow can be seen stalling on a queue or
+// leaving threads idle. Traced scopes record a complete event, name,
+// start and duration, into a ring buffer of the thread they run on,
+// and write_trace() dumps every buffer as Chrome trace-event JSON,
+// which chrome://tracing and https://ui.perfetto.dev display.
+
+// The elimination phases of ProfiledPhase are traced, as are solves,
+// idle waits and blocked submits in the solver service, parsing and
+// waiting in gaussian_solver, and buffered writes.
+
+// Tracing is off unless the environment variable GAUSSIAN_TRACE names
+// a file, in which case it starts before main() and the trace is
+// written to that file at exit, or start_tracing() is called. Off, a
+// traced scope costs one relaxed load of a flag.
+
+// Each buffer has a single writer, its thread, and publishes events
+// by a release store of its count, so recording takes no lock. A
+// buffer keeps the last TRACE_BUFFER_EVENTS events and overwrites the
+// oldest. Buffers are recycled when their threads exit, so the short
+// lived threads of parallel_for() reuse a few lanes rather than
+// allocating one each.
+
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <atomic>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The environment variable that turns tracing on, naming the file to
+// write at exit.
+const char* const TRACE_VARIABLE = "GAUSSIAN_TRACE";
+
+// The events each thread's buffer keeps.
+const int TRACE_BUFFER_EVENTS = 1 << 14;
+
+// Whether traced scopes record. Use tracing() to read it.
+extern atomic<bool> tracing_enabled;
+
+// Whether traced scopes record.
+inline bool tracing() {
+  return tracing_enabled.load(memory_order_relaxed);
+}
+
+// Turns recording on or off. Events already recorded are kept.
+void start_tracing();
+void stop_tracing();
+
+// Throws away every event recorded so far.
+void clear_trace();
+
+// The trace clock, in nanoseconds since some fixed point.
+long long trace_clock();
+
+// Records a complete event on the calling thread's buffer. name and
+// category must outlive the trace, e.g. string literals. start and
+// end are from trace_clock().
+void trace_event(const char* name, const char* category,
+		 long long start, long long end);
+
+// Names the calling thread's lane in the trace. Copied.
+void set_trace_thread_name(const char* name);
+
+// The number of events recorded since the last clear_trace(), and
+// how many of them were overwritten before they could be written.
+long long trace_events_recorded();
+long long trace_events_dropped();
+
+// Writes every buffer as Chrome trace-event JSON. Events still being
+// recorded while this runs may come out torn, so call it when traced
+// work is done. Returns false if the write fails.
+bool write_trace(ostream& output);
+bool write_trace(const char* filename);
+
+// Records an event for as long as it is in scope, if tracing was on
+// when it started. name and category are as for trace_event().
+class TracedScope {
+public:
+  TracedScope(const char* name, const char* category) {
+    start = tracing() ? trace_clock() : 0;
+    this->name = name;
+    this->category = category;
+  }
+  ~TracedScope() {
+    if ( start != 0 ) {
+      trace_event(name,category,start,trace_clock());
+    }
+  }
+private: // Scopes don't move.
+  TracedScope(const TracedScope &rhs);
+  TracedScope& operator = (const TracedScope &rhs);
+  long long start;
+  const char* name;
+  const char* category;
+};
@@ -0,0 +1,170 @@
+// trace_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 19:20:02 (jonah)>
+
+// This file tests timeline tracing: turning it on and off, the
+// elimination phases and solver service events it records, threads
+// and their names, full ring buffers, and the JSON it writes.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <future>
+#include <cstdlib>
+#include <cassert>
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "solver_service.hpp"
+#include "solution_writer.hpp"
+#include "trace.hpp"
+#include "test_systems.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The number of times text appears in trace.
+static int occurrences(const string& trace, const string& text) {
+  int output = 0;
+  for (size_t at = trace.find(text); at != string::npos;
+       at = trace.find(text,at + 1)) {
+    output++;
+  }
+  return output;
+}
+
+// The trace as a string.
+static string trace_text() {
+  stringstream output;
+  assert( write_trace(output) );
+  return output.str();
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the trace library.\n"
+       << "BEGIN." << endl;
+  srand(19);
+  // Whatever the environment says, the tests decide.
+  stop_tracing();
+  clear_trace();
+
+  cout << "\n\nNothing is recorded while tracing is off." << endl;
+  GaussianSystem g_sys = random_system(50);
+  GaussianSystem copy = g_sys;
+  gaussian_elimination(copy);
+  back_substitution(copy);
+  { TracedScope scope("untraced","test"); }
+  assert( trace_events_recorded() == 0 );
+
+  cout << "\n\nElimination phases, one event per scope." << endl;
+  start_tracing();
+  assert( tracing() );
+  copy = g_sys;
+  gaussian_elimination(copy,STANDARD_ELIMINATION);
+  back_substitution(copy);
+  stop_tracing();
+  string trace = trace_text();
+  int pivots = occurrences(trace,"\"name\":\"pivot\"");
+  int reductions = occurrences(trace,"\"name\":\"row_reduce\"");
+  cout << pivots << " pivots, " << reductions << " row reductions, "
+       << trace_events_recorded() << " events." << endl;
+  assert( pivots == 50 && reductions == 50 );
+  assert( occurrences(trace,"\"name\":\"back_substitution\"") == 1 );
+  assert( trace_events_recorded() == 101 );
+  assert( occurrences(trace,"\"ph\":\"X\"") == 101 );
+  assert( trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[") == 0
+	  && trace.substr(trace.size() - 4) == "\n]}\n" );
+  assert( occurrences(trace,"{") == occurrences(trace,"}") );
+
+  cout << "\n\nScopes nest, and names are escaped." << endl;
+  clear_trace();
+  assert( trace_events_recorded() == 0 );
+  start_tracing();
+  {
+    TracedScope outer("outer \"quoted\"","test");
+    TracedScope inner("inner","test");
+  }
+  stop_tracing();
+  trace = trace_text();
+  assert( trace.find("\"name\":\"outer \\\"quoted\\\"\",\"cat\":\"test\"")
+	  != string::npos );
+  // The inner scope ends first, so it's recorded first.
+  assert( trace.find("\"inner\"") < trace.find("outer") );
+
+  cout << "\n\nEach thread has its own named lane." << endl;
+  clear_trace();
+  start_tracing();
+  vector<thread> threads;
+  for (int t = 0; t < 3; t++) {
+    threads.push_back(thread([]() {
+	  set_trace_thread_name("helper");
+	  for (int e = 0; e < 10; e++) {
+	    TracedScope scope("work","test");
+	  }
+	}));
+  }
+  for (size_t t = 0; t < threads.size(); t++) {
+    threads[t].join();
+  }
+  stop_tracing();
+  assert( trace_events_recorded() == 30 );
+  trace = trace_text();
+  assert( occurrences(trace,"\"name\":\"work\"") == 30 );
+  assert( occurrences(trace,"\"args\":{\"name\":\"helper\"}") >= 1 );
+
+  cout << "\n\nA full buffer keeps the newest events." << endl;
+  clear_trace();
+  thread flood([]() {
+      long long now = trace_clock();
+      for (int e = 0; e < TRACE_BUFFER_EVENTS + 100; e++) {
+	trace_event(e < 100 ? "old" : "new","test",now + e,now + e + 1);
+      }
+    });
+  flood.join();
+  assert( trace_events_recorded() == TRACE_BUFFER_EVENTS + 100 );
+  assert( trace_events_dropped() == 100 );
+  trace = trace_text();
+  assert( occurrences(trace,"\"name\":\"old\"") == 0 );
+  assert( occurrences(trace,"\"name\":\"new\"") == TRACE_BUFFER_EVENTS );
+
+  cout << "\n\nThe solver service traces solves and waits." << endl;
+  clear_trace();
+  start_tracing();
+  {
+    SolverServiceOptions options;
+    options.worker_threads = 2;
+    SolverService service(options);
+    vector<future<SolveResult> > results;
+    for (int s = 0; s < 20; s++) {
+      results.push_back(service.submit(random_system(10 + s)));
+    }
+    for (size_t s = 0; s < results.size(); s++) {
+      assert( results[s].get().status == SOLVED );
+    }
+  }
+  ostringstream written;
+  {
+    BufferedWriter writer(written);
+    writer.write("0 1\n",4);
+  }
+  stop_tracing();
+  trace = trace_text();
+  assert( occurrences(trace,"\"name\":\"solve\",\"cat\":\"scheduling\"")
+	  == 20 );
+  assert( occurrences(trace,"\"name\":\"pivot\"") == 20*10 + 190 );
+  assert( occurrences(trace,"\"args\":{\"name\":\"solver worker\"}") >= 1 );
+  assert( occurrences(trace,"\"name\":\"write\",\"cat\":\"io\"") == 1 );
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
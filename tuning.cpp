@@ -0,0 +1,417 @@
+// tuning.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 22:10:05 (jonah)>
+
+// This file implements the tuning layer: the heuristic, tuning
+// profiles and their files, the profile the library uses, and the
+// timed trials that make a profile.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include "tuning.hpp"
+#include "tournament_pivoting.hpp"
+#include "parallel_for.hpp"
+#include "wall_time.hpp"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <cassert>
+#include <climits>
+#include <random>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <algorithm>
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Names
+// ----------------------------------------------------------------------
+
+// The name of each method in a profile, in the order of the enum.
+static const char* const METHOD_NAMES[] = {
+  "standard", "recursive", "tournament", "strassen"
+};
+static const int METHOD_NAME_COUNT = 4;
+
+// The name of each kernel in a profile, in the order of the enum.
+static const char* const KERNEL_NAMES[] = {"automatic", "generic", "avx2"};
+static const int KERNEL_NAME_COUNT = 3;
+
+// Looks name up in names. Returns its index, or -1 if it isn't there.
+static int find_name(const char* const names[], int count,
+		     const string& name) {
+  for (int i = 0; i < count; i++) {
+    if ( name == names[i] ) {
+      return i;
+    }
+  }
+  return -1;
+}
+// ----------------------------------------------------------------------
+
+
+// Profiles
+// ----------------------------------------------------------------------
+
+TuningParameters heuristic_parameters(int size) {
+  TuningParameters output;
+  output.method = size < 16 ? STANDARD_ELIMINATION : RECURSIVE_ELIMINATION;
+  output.strassen_cutoff = DEFAULT_STRASSEN_CUTOFF;
+  output.panel_width = 32;
+  output.substitution_block = 64;
+  output.substitution_threads = 0;
+  return output;
+}
+
+TuningProfile::TuningProfile() : gemm_kernel_choice(AUTOMATIC_KERNEL) {}
+
+TuningParameters TuningProfile::parameters(int size) const {
+  if ( table.empty() ) {
+    return heuristic_parameters(size);
+  }
+  map<int,TuningParameters>::const_iterator above = table.lower_bound(size);
+  if ( above == table.begin() ) {
+    return above->second;
+  }
+  map<int,TuningParameters>::const_iterator below = prev(above);
+  if ( above == table.end() ) {
+    return below->second;
+  }
+  // Nearer by ratio: size/below against above/size.
+  return (double)size*size < (double)below->first*above->first
+    ? below->second : above->second;
+}
+
+void TuningProfile::set(int size, const TuningParameters& parameters) {
+  assert( size > 0 && parameters.method != TUNED_ELIMINATION
+	  && "Parameters are for a real size and a real method." );
+  table[size] = parameters;
+}
+
+bool TuningProfile::load(istream& input) {
+  map<int,TuningParameters> new_table;
+  GemmKernel new_kernel = AUTOMATIC_KERNEL;
+  string line;
+  while ( getline(input,line) ) {
+    istringstream fields(line);
+    string first;
+    if ( !(fields >> first) || first[0] == '#' ) {
+      continue;
+    }
+    string extra;
+    if ( first == "kernel" ) {
+      string name;
+      fields >> name;
+      int kernel = find_name(KERNEL_NAMES,KERNEL_NAME_COUNT,name);
+      if ( kernel < 0 || fields >> extra ) {
+	return false;
+      }
+      new_kernel = (GemmKernel)kernel;
+      continue;
+    }
+    char* end;
+    long size = strtol(first.c_str(),&end,10);
+    string method_name;
+    TuningParameters parameters;
+    if ( *end != '\0' || size < 1 || size > INT_MAX
+	 || !(fields >> method_name >> parameters.strassen_cutoff
+	      >> parameters.panel_width >> parameters.substitution_block
+	      >> parameters.substitution_threads)
+	 || fields >> extra ) {
+      return false;
+    }
+    int method = find_name(METHOD_NAMES,METHOD_NAME_COUNT,method_name);
+    if ( method < 0 || parameters.strassen_cutoff < 1
+	 || parameters.panel_width < 1
+	 || parameters.substitution_block < 1 ) {
+      return false;
+    }
+    parameters.method = (EliminationMethod)method;
+    new_table[(int)size] = parameters;
+  }
+  if ( !input.eof() ) {
+    return false;
+  }
+  table.swap(new_table);
+  gemm_kernel_choice = new_kernel;
+  return true;
+}
+
+bool TuningProfile::load(const char* filename) {
+  ifstream input(filename);
+  return input && load(input);
+}
+
+bool TuningProfile::save(ostream& output) const {
+  output << "# Tuning profile written by gaussian_tuner.\n"
+	 << "kernel " << KERNEL_NAMES[gemm_kernel_choice] << "\n"
+	 << "# size method strassen_cutoff panel_width block threads\n";
+  for (map<int,TuningParameters>::const_iterator entry = table.begin();
+       entry != table.end(); entry++) {
+    const TuningParameters& p = entry->second;
+    output << entry->first << " " << METHOD_NAMES[p.method] << " "
+	   << p.strassen_cutoff << " " << p.panel_width << " "
+	   << p.substitution_block << " " << p.substitution_threads << "\n";
+  }
+  output.flush();
+  return output.good();
+}
+
+bool TuningProfile::save(const char* filename) const {
+  ofstream output(filename);
+  return output && save(output);
+}
+// ----------------------------------------------------------------------
+
+
+// The library's profile
+// ----------------------------------------------------------------------
+
+// Every profile the library has used. The current one is published
+// through current_profile, so reading it takes no lock. Old ones are
+// kept, since a solve may still be reading one; they are small and
+// rarely replaced. Only publishing takes the mutex.
+static mutex profile_mutex;
+static vector<unique_ptr<const TuningProfile> > profiles;
+static atomic<const TuningProfile*> current_profile(NULL);
+static once_flag profile_once;
+
+// Makes a copy of profile the library's. If use_kernel is set, also
+// applies its kernel.
+static void publish(const TuningProfile& profile, bool use_kernel) {
+  lock_guard<mutex> lock(profile_mutex);
+  profiles.push_back(unique_ptr<const TuningProfile>
+		     (new TuningProfile(profile)));
+  current_profile.store(profiles.back().get(),memory_order_release);
+  if ( use_kernel ) {
+    set_gemm_kernel(profile.kernel());
+  }
+}
+
+// Reads the profile. Run once, by call_once.
+static void read_profile() {
+  const char* filename = getenv(TUNING_PROFILE_VARIABLE);
+  if ( filename == NULL || filename[0] == '\0' ) {
+    filename = DEFAULT_TUNING_PROFILE;
+  }
+  TuningProfile profile;
+  bool loaded = profile.load(filename);
+  publish(loaded ? profile : TuningProfile(),loaded);
+}
+
+// The library's profile, read first if need be.
+static const TuningProfile& library_profile() {
+  call_once(profile_once,read_profile);
+  return *current_profile.load(memory_order_acquire);
+}
+
+TuningParameters tuned_parameters(int size) {
+  return library_profile().parameters(size);
+}
+
+void set_tuning_profile(const TuningProfile& profile) {
+  // Read the file first, so it can't replace this profile later.
+  call_once(profile_once,read_profile);
+  publish(profile,true);
+}
+
+TuningProfile tuning_profile() {
+  return library_profile();
+}
+// ----------------------------------------------------------------------
+
+
+// Trials
+// ----------------------------------------------------------------------
+
+// A random system of n unknowns. Has its own generator, so the
+// caller's rand() sequence is left alone.
+static GaussianSystem trial_system(int n) {
+  GaussianSystem output(n);
+  minstd_rand generator(n);
+  uniform_real_distribution<double> element(-1.0,1.0);
+  for (int row = 0; row < n; row++) {
+    for (int column = 0; column < n+1; column++) {
+      output.set(row,column,element(generator));
+    }
+  }
+  return output;
+}
+
+// Eliminates g_sys as parameters say.
+static bool eliminate(GaussianSystem& g_sys,
+		      const TuningParameters& parameters) {
+  if ( parameters.method == TOURNAMENT_ELIMINATION ) {
+    return tournament_gaussian_elimination(g_sys,parameters.panel_width);
+  }
+  if ( parameters.method == STRASSEN_ELIMINATION ) {
+    return strassen_gaussian_elimination(g_sys,parameters.strassen_cutoff);
+  }
+  return gaussian_elimination(g_sys,parameters.method);
+}
+
+// The best of trials times to eliminate a copy of system.
+static double time_elimination(const GaussianSystem& system,
+			       const TuningParameters& parameters,
+			       int trials) {
+  double best = 0;
+  for (int t = 0; t < trials; t++) {
+    GaussianSystem copy = system;
+    double start = wall_time();
+    bool nondegenerate = eliminate(copy,parameters);
+    double elapsed = wall_time() - start;
+    assert( nondegenerate && "Trial systems can be solved." );
+    best = (t == 0) ? elapsed : min(best,elapsed);
+  }
+  return best;
+}
+
+// The best of trials times to back-substitute the reduced system.
+static double time_substitution(const GaussianSystem& reduced,
+				int block, int threads, int trials) {
+  int n = reduced.size();
+  double best = 0;
+  for (int t = 0; t < trials; t++) {
+    Dynamic2DArray<double> knowns(n,1);
+    for (int i = 0; i < n; i++) {
+      knowns.access(i,0) = reduced.vector_get(i);
+    }
+    double start = wall_time();
+    triangular_solve(reduced,knowns,threads,false,block);
+    double elapsed = wall_time() - start;
+    best = (t == 0) ? elapsed : min(best,elapsed);
+  }
+  return best;
+}
+
+// Writes a line about one candidate to progress, if there is one.
+static void report(ostream* progress, int n, const string& candidate,
+		   double seconds) {
+  if ( progress != NULL ) {
+    *progress << n << " " << candidate << ": " << seconds << " s" << endl;
+  }
+}
+
+// The best of trials times to multiply two 256 x 256 matrices with
+// the current kernel.
+static double time_gemm(int trials) {
+  const int n = 256;
+  vector<double> a((size_t)n*n,0.5), b((size_t)n*n,0.25), c((size_t)n*n);
+  double best = 0;
+  for (int t = 0; t < trials; t++) {
+    double start = wall_time();
+    gemm(NO_TRANSPOSE,NO_TRANSPOSE,n,n,n,1.0,a.data(),n,b.data(),n,
+	 0.0,c.data(),n,1);
+    double elapsed = wall_time() - start;
+    best = (t == 0) ? elapsed : min(best,elapsed);
+  }
+  return best;
+}
+
+TuningProfile run_tuning_trials(const Dynamic1DArray<int>& sizes,
+				int trials/*= 3*/,
+				ostream* progress/*= NULL*/) {
+  assert( trials > 0 && "At least one trial per candidate." );
+  TuningProfile output;
+
+  // The kernel goes first, since it changes every other time.
+  GemmKernel previous = gemm_kernel();
+  GemmKernel kernels[2] = {GENERIC_KERNEL, AVX2_KERNEL};
+  double best_time = 0;
+  for (int k = 0; k < 2; k++) {
+    if ( !set_gemm_kernel(kernels[k]) ) {
+      continue;
+    }
+    double seconds = time_gemm(trials);
+    report(progress,256,string("gemm ") + KERNEL_NAMES[kernels[k]],seconds);
+    if ( k == 0 || seconds < best_time ) {
+      best_time = seconds;
+      output.set_kernel(kernels[k]);
+    }
+  }
+  set_gemm_kernel(output.kernel());
+
+  for (int s = 0; s < sizes.length(); s++) {
+    int n = sizes.get(s);
+    assert( n > 0 && "Systems have at least one unknown." );
+    GaussianSystem system = trial_system(n);
+
+    // The elimination candidates.
+    vector<TuningParameters> candidates;
+    TuningParameters base = heuristic_parameters(n);
+    if ( n <= 256 ) {
+      base.method = STANDARD_ELIMINATION;
+      candidates.push_back(base);
+    }
+    base.method = RECURSIVE_ELIMINATION;
+    candidates.push_back(base);
+    int panels[3] = {16, 32, 64};
+    for (int p = 0; p < 3; p++) {
+      TuningParameters candidate = base;
+      candidate.method = TOURNAMENT_ELIMINATION;
+      candidate.panel_width = panels[p];
+      candidates.push_back(candidate);
+    }
+    // Strassen only does anything with updates of at least the cutoff
+    // in every dimension.
+    for (int cutoff = 64; 2*cutoff <= n; cutoff *= 2) {
+      TuningParameters candidate = base;
+      candidate.method = STRASSEN_ELIMINATION;
+      candidate.strassen_cutoff = cutoff;
+      candidates.push_back(candidate);
+    }
+    TuningParameters best = candidates[0];
+    best_time = 0;
+    for (size_t c = 0; c < candidates.size(); c++) {
+      double seconds = time_elimination(system,candidates[c],trials);
+      ostringstream name;
+      name << METHOD_NAMES[candidates[c].method];
+      if ( candidates[c].method == TOURNAMENT_ELIMINATION ) {
+	name << " panel " << candidates[c].panel_width;
+      } else if ( candidates[c].method == STRASSEN_ELIMINATION ) {
+	name << " cutoff " << candidates[c].strassen_cutoff;
+      }
+      report(progress,n,name.str(),seconds);
+      if ( c == 0 || seconds < best_time ) {
+	best_time = seconds;
+	best = candidates[c];
+      }
+    }
+
+    // The back substitution candidates, on the reduced system.
+    GaussianSystem reduced = system;
+    eliminate(reduced,best);
+    int thread_counts[2] = {1, default_thread_count()};
+    int thread_candidates = (thread_counts[1] > 1) ? 2 : 1;
+    best_time = 0;
+    bool first = true;
+    for (int block = 16; block <= 256; block *= 2) {
+      for (int t = 0; t < thread_candidates; t++) {
+	double seconds = time_substitution(reduced,block,thread_counts[t],
+					   trials);
+	ostringstream name;
+	name << "substitution block " << block << " threads "
+	     << thread_counts[t];
+	report(progress,n,name.str(),seconds);
+	if ( first || seconds < best_time ) {
+	  first = false;
+	  best_time = seconds;
+	  best.substitution_block = block;
+	  best.substitution_threads = thread_counts[t];
+	}
+      }
+    }
+    output.set(n,best);
+  }
+
+  set_gemm_kernel(previous);
+  return output;
+}
+// ----------------------------------------------------------------------
@@ -0,0 +1,131 @@
+// tuning.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 15:48:12 (jonah)>
+
+// This file prototypes the tuning layer, which picks the elimination
+// algorithm, its block sizes, the back substitution block and thread
+// count, and the gemm() micro-kernel for each system size.
+
+// The best choices depend on the machine: its caches, its cores and
+// whether it has AVX2. The gaussian_tuner tool finds them by timing
+// each candidate on random systems over a range of sizes and writes
+// what wins to a tuning profile. The library reads the profile the
+// first time it needs it, from the file named by the environment
+// variable GAUSSIAN_TUNING_PROFILE, or else gaussian_tuning.profile in
+// the working directory. With no profile, a built-in heuristic is
+// used, which is what the defaults elsewhere amount to.
+
+// The profile is plain text. Lines starting with # are comments. A
+// line
+//     kernel avx2
+// names the gemm() kernel (avx2, generic or automatic), and each line
+//     size method strassen_cutoff panel_width block threads
+// gives the parameters for systems of that size, where method is
+// standard, recursive, tournament or strassen. A system between two
+// tuned sizes gets the parameters of the nearer one, by ratio.
+
+// To use the tuned parameters, eliminate with TUNED_ELIMINATION.
+// triangular_solve() and back_substitution() use the tuned block and
+// thread count unless they are given others.
+
+// ----------------------------------------------------------------------
+
+
+// Include guard
+#pragma once
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <map>
+#include "dynamic_array.hpp"
+#include "gaussian_elimination.hpp"
+#include "gemm.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// The profile read when none has been set, if the environment
+// variable below doesn't name another.
+const char* const DEFAULT_TUNING_PROFILE = "gaussian_tuning.profile";
+const char* const TUNING_PROFILE_VARIABLE = "GAUSSIAN_TUNING_PROFILE";
+
+// The tunable parameters for one system size.
+struct TuningParameters {
+  // The elimination algorithm. Never TUNED_ELIMINATION.
+  EliminationMethod method;
+  // The cutoff for STRASSEN_ELIMINATION.
+  int strassen_cutoff;
+  // The panel width for TOURNAMENT_ELIMINATION.
+  int panel_width;
+  // The order of the diagonal blocks in triangular_solve().
+  int substitution_block;
+  // The threads for triangular_solve(). Less than 1 means one per
+  // hardware thread.
+  int substitution_threads;
+};
+
+// The parameters to use for a size nobody has tuned for. Recursive
+// elimination is faster than standard from about 16 unknowns up.
+TuningParameters heuristic_parameters(int size);
+
+// A table of tuned parameters by system size, and a gemm() kernel.
+class TuningProfile {
+public: // Constructors
+  // Creates an empty profile, which gives the heuristic for every
+  // size and the automatic kernel.
+  TuningProfile();
+
+public: // Access
+  // Whether no size has been tuned.
+  bool empty() const { return table.empty(); }
+  // The number of sizes tuned.
+  int entries() const { return (int)table.size(); }
+  // The parameters for systems of size unknowns: those of the nearest
+  // tuned size, or the heuristic if the profile is empty.
+  TuningParameters parameters(int size) const;
+  // Sets the parameters tuned for size.
+  void set(int size, const TuningParameters& parameters);
+  // The kernel gemm() should use.
+  GemmKernel kernel() const { return gemm_kernel_choice; }
+  void set_kernel(GemmKernel kernel) { gemm_kernel_choice = kernel; }
+
+public: // Files
+  // Reads a profile in the format above, replacing this one. Returns
+  // false, and leaves this profile alone, if the input is malformed.
+  bool load(istream& input);
+  bool load(const char* filename);
+  // Writes the profile in the format above. Returns false if the
+  // write fails.
+  bool save(ostream& output) const;
+  bool save(const char* filename) const;
+
+private:
+  map<int,TuningParameters> table;
+  GemmKernel gemm_kernel_choice;
+};
+
+// The parameters the library uses for systems of size unknowns.
+// The first call reads the profile as described at the top of this
+// file and, if it names a kernel, passes it to set_gemm_kernel().
+// Thread safe, and after the first call it takes no lock.
+TuningParameters tuned_parameters(int size);
+
+// Replaces the profile the library uses, and applies its kernel. Thread
+// safe, but solves already running keep the parameters they started
+// with.
+void set_tuning_profile(const TuningProfile& profile);
+
+// A copy of the profile the library uses.
+TuningProfile tuning_profile();
+
+// Times every candidate on random systems of each of the sizes and
+// returns a profile of the fastest. Each candidate is run trials times
+// and the best time is kept. If progress is not NULL, a line per
+// candidate is written to it. Leaves the gemm() kernel as it found
+// it. Takes a few seconds per size in the hundreds, and grows as the
+// cube of the size.
+TuningProfile run_tuning_trials(const Dynamic1DArray<int>& sizes,
+				int trials = 3, ostream* progress = NULL);
@@ -0,0 +1,219 @@
+// tuning_test_driver.cpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 16:52:20 (jonah)>
+
+// This file tests the tuning layer: the heuristic, looking up sizes,
+// reading and writing profiles, solving with TUNED_ELIMINATION and a
+// short run of the trials.
+
+// ----------------------------------------------------------------------
+
+
+// Includes
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "dynamic_array.hpp"
+#include "gaussian_system.hpp"
+#include "gaussian_elimination.hpp"
+#include "gemm.hpp"
+#include "tuning.hpp"
+#include "test_systems.hpp"
+using namespace std;
+// ----------------------------------------------------------------------
+
+
+// Parameters with every field set.
+static TuningParameters make_parameters(EliminationMethod method,
+					int cutoff, int panel, int block,
+					int threads) {
+  TuningParameters output;
+  output.method = method;
+  output.strassen_cutoff = cutoff;
+  output.panel_width = panel;
+  output.substitution_block = block;
+  output.substitution_threads = threads;
+  return output;
+}
+
+// Whether two sets of parameters are the same.
+static bool same(const TuningParameters& a, const TuningParameters& b) {
+  return a.method == b.method && a.strassen_cutoff == b.strassen_cutoff
+    && a.panel_width == b.panel_width
+    && a.substitution_block == b.substitution_block
+    && a.substitution_threads == b.substitution_threads;
+}
+
+// Solves a copy of g_sys by method and back substitution.
+static Dynamic1DArray<double> solve(const GaussianSystem& g_sys,
+				    EliminationMethod method) {
+  GaussianSystem copy = g_sys;
+  bool nondegenerate = gaussian_elimination(copy,method);
+  assert( nondegenerate && "The random system can be solved." );
+  return back_substitution(copy);
+}
+
+
+// Main function
+// ----------------------------------------------------------------------
+int main() {
+  cout << "Testing the tuning library.\n"
+       << "BEGIN." << endl;
+  srand(13);
+  // Whatever profile is lying around, the tests use their own.
+  set_tuning_profile(TuningProfile());
+
+  cout << "\n\nThe heuristic and the empty profile." << endl;
+  assert( heuristic_parameters(8).method == STANDARD_ELIMINATION );
+  assert( heuristic_parameters(500).method == RECURSIVE_ELIMINATION );
+  TuningProfile profile;
+  assert( profile.empty() && profile.kernel() == AUTOMATIC_KERNEL );
+  assert( same(profile.parameters(500),heuristic_parameters(500))
+	  && same(tuned_parameters(500),heuristic_parameters(500))
+	  && "With no profile, the heuristic." );
+
+  cout << "\n\nA size gets the parameters of the nearest tuned size."
+       << endl;
+  TuningParameters small = make_parameters(STANDARD_ELIMINATION,256,32,16,1);
+  TuningParameters middle = make_parameters(TOURNAMENT_ELIMINATION,256,8,
+					    32,2);
+  TuningParameters large = make_parameters(STRASSEN_ELIMINATION,64,32,
+					   128,0);
+  profile.set(64,small);
+  profile.set(256,middle);
+  profile.set(1024,large);
+  profile.set_kernel(GENERIC_KERNEL);
+  assert( profile.entries() == 3 );
+  assert( same(profile.parameters(1),small) );
+  assert( same(profile.parameters(127),small) );
+  assert( same(profile.parameters(129),middle) );
+  assert( same(profile.parameters(256),middle) );
+  assert( same(profile.parameters(511),middle) );
+  assert( same(profile.parameters(513),large) );
+  assert( same(profile.parameters(100000),large) );
+
+  cout << "\n\nA profile survives being written and read." << endl;
+  stringstream file;
+  assert( profile.save(file) );
+  cout << file.str();
+  TuningProfile reread;
+  assert( reread.load(file) );
+  assert( reread.entries() == 3 && reread.kernel() == GENERIC_KERNEL );
+  int sizes[3] = {64, 256, 1024};
+  for (int s = 0; s < 3; s++) {
+    assert( same(reread.parameters(sizes[s]),profile.parameters(sizes[s])) );
+  }
+
+  cout << "\n\nMalformed profiles are rejected whole." << endl;
+  const char* bad[5] = {
+    "64 standard 256 32 16\n", // Too few fields.
+    "64 standard 256 32 16 1 9\n", // Too many.
+    "64 sideways 256 32 16 1\n", // No such method.
+    "kernel sse\n", // No such kernel.
+    "-4 recursive 256 32 16 1\n" // No such size.
+  };
+  for (int b = 0; b < 5; b++) {
+    stringstream bad_file;
+    bad_file << "# comment\n" << "128 recursive 256 32 64 0\n" << bad[b];
+    assert( !reread.load(bad_file) );
+    assert( reread.entries() == 3 && "A bad file changes nothing." );
+  }
+  stringstream comments("# only a comment\n\n   \n");
+  assert( reread.load(comments) && reread.empty()
+	  && reread.kernel() == AUTOMATIC_KERNEL );
+  assert( !reread.load("no_such_directory/profile") );
+
+  cout << "\n\nTUNED_ELIMINATION follows the library's profile." << endl;
+  GemmKernel automatic = gemm_kernel();
+  set_tuning_profile(profile);
+  assert( gemm_kernel() == GENERIC_KERNEL && "The profile sets the kernel." );
+  assert( tuning_profile().entries() == 3 );
+  int test_sizes[5] = {5, 64, 200, 300, 700};
+  for (int s = 0; s < 5; s++) {
+    GaussianSystem g_sys = random_system(test_sizes[s]);
+    Dynamic1DArray<double> tuned = solve(g_sys,TUNED_ELIMINATION);
+    Dynamic1DArray<double> standard = solve(g_sys,STANDARD_ELIMINATION);
+    double difference = max_difference(tuned,standard);
+    cout << test_sizes[s] << " unknowns, method "
+	 << profile.parameters(test_sizes[s]).method
+	 << ": difference " << difference << endl;
+    assert( difference < 1E-8 && "Every tuned method solves the system." );
+  }
+  set_tuning_profile(TuningProfile());
+  assert( gemm_kernel() == automatic );
+
+  cout << "\n\nReaders see a whole profile while it is replaced." << endl;
+  {
+    TuningProfile first;
+    first.set(100,make_parameters(STANDARD_ELIMINATION,256,32,16,1));
+    TuningProfile second;
+    second.set(100,make_parameters(RECURSIVE_ELIMINATION,128,16,32,2));
+    set_tuning_profile(first);
+    atomic<bool> done(false);
+    atomic<int> torn(0);
+    vector<thread> readers;
+    for (int t = 0; t < 3; t++) {
+      readers.push_back(thread([&]() {
+	    while ( !done.load() ) {
+	      TuningParameters p = tuned_parameters(100);
+	      if ( !same(p,first.parameters(100))
+		   && !same(p,second.parameters(100)) ) {
+		torn++;
+	      }
+	    }
+	  }));
+    }
+    for (int swaps = 0; swaps < 200; swaps++) {
+      set_tuning_profile(swaps%2 == 0 ? first : second);
+    }
+    done = true;
+    for (size_t t = 0; t < readers.size(); t++) {
+      readers[t].join();
+    }
+    assert( torn.load() == 0 && "Every read is of one profile or the other." );
+    set_tuning_profile(TuningProfile());
+  }
+
+  cout << "\n\nEvery substitution block and thread count agrees." << endl;
+  GaussianSystem reduced = random_system(150);
+  gaussian_elimination(reduced,RECURSIVE_ELIMINATION);
+  Dynamic1DArray<double> expected = back_substitution(reduced,false,1);
+  int blocks[5] = {1, 7, 64, 150, 500};
+  for (int b = 0; b < 5; b++) {
+    for (int threads = 1; threads <= 4; threads += 3) {
+      Dynamic2DArray<double> knowns(150,1);
+      for (int i = 0; i < 150; i++) {
+	knowns.access(i,0) = reduced.vector_get(i);
+      }
+      triangular_solve(reduced,knowns,threads,false,blocks[b]);
+      for (int i = 0; i < 150; i++) {
+	assert( abs(knowns.get(i,0) - expected.get(i)) < 1E-10 );
+      }
+    }
+  }
+
+  cout << "\n\nA short run of the trials." << endl;
+  Dynamic1DArray<int> trial_sizes(2);
+  trial_sizes[0] = 20;
+  trial_sizes[1] = 130;
+  TuningProfile trial = run_tuning_trials(trial_sizes,1,&cout);
+  assert( trial.entries() == 2 && gemm_kernel() == automatic
+	  && "The trials leave the kernel alone." );
+  for (int s = 0; s < 2; s++) {
+    TuningParameters found = trial.parameters(trial_sizes[s]);
+    assert( found.method != TUNED_ELIMINATION
+	    && found.substitution_block >= 16
+	    && found.substitution_block <= 256 );
+  }
+  trial.save(cout);
+
+  cout << "\n\nThis concludes the test." << endl;
+  return 0;
+}
+// ----------------------------------------------------------------------
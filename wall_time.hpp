@@ -0,0 +1,20 @@
+// wall_time.hpp
+
+// Author: Jonah Miller (jonah.maxwell.miller@gmail.com)
+// Time-stamp: <2026-10-19 22:24:51 (jonah)>
+
+// This file defines the wall clock the Gaussian elimination package
+// times things with: latencies, checkpoint intervals, tuning trials
+// and benchmarks.
+
+// Include guard
+#pragma once
+
+#include <chrono>
+using namespace std;
+
+// Returns the wall-clock time in seconds since some fixed point.
+inline double wall_time() {
+  return chrono::duration<double>(chrono::steady_clock::now()
+				  .time_since_epoch()).count();
+}